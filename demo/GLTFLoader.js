@@ -1065,9 +1065,20 @@ THREE.GLTFLoader = ( function () {
 			var count = extensionDef.count;
 			var stride = extensionDef.byteStride;
 
-			var result = new ArrayBuffer(count * stride);
 			var source = new Uint8Array(buffer, byteOffset, byteLength);
 
+			if ( decoder.decodeGltfBufferAsync ) {
+
+				return decoder.decodeGltfBufferAsync( count, stride, source, extensionDef.mode, extensionDef.filter ).then( function ( res ) {
+
+					return res.buffer;
+
+				} );
+
+			}
+
+			var result = new ArrayBuffer(count * stride);
+
 			decoder.decodeGltfBuffer(new Uint8Array(result), count, stride, source, extensionDef.mode, extensionDef.filter);
 			return result;
 
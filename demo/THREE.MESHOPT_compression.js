@@ -25,9 +25,16 @@ var MESHOPT_compression = (function () {
             	var count = extensionDef.count;
             	var stride = extensionDef.byteStride;
 
-            	var result = new ArrayBuffer(count * stride);
             	var source = new Uint8Array(res[0], byteOffset, byteLength);
 
+            	if (decoder.decodeGltfBufferAsync) {
+            		return decoder.decodeGltfBufferAsync(count, stride, source, extensionDef.mode, extensionDef.filter).then(function (result) {
+            			return result.buffer;
+            		});
+            	}
+
+            	var result = new ArrayBuffer(count * stride);
+
             	decoder.decodeGltfBuffer(new Uint8Array(result), count, stride, source, extensionDef.mode, extensionDef.filter);
             	return result;
             });
@@ -28,6 +28,9 @@ var MESHOPT_compression = /** @class */ (function () {
                 var source = res[0];
                 var count = extensionDef.count;
                 var stride = extensionDef.byteStride;
+                if (decoder.decodeGltfBufferAsync) {
+                    return decoder.decodeGltfBufferAsync(count, stride, source, extensionDef.mode, extensionDef.filter);
+                }
                 var result = new Uint8Array(new ArrayBuffer(count * stride));
                 decoder.decodeGltfBuffer(result, count, stride, source, extensionDef.mode, extensionDef.filter);
                 return Promise.resolve(result);
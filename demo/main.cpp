@@ -1,6 +1,7 @@
 #include "../src/meshoptimizer.h"
 
 #include <assert.h>
+#include <float.h>
 #include <math.h>
 #include <stdio.h>
 #include <string.h>
@@ -273,6 +274,22 @@ void optCacheStrip(Mesh& mesh)
 	meshopt_optimizeVertexCacheStrip(&mesh.indices[0], &mesh.indices[0], mesh.indices.size(), mesh.vertices.size());
 }
 
+void optCacheIntel(Mesh& mesh)
+{
+	meshopt_optimizeVertexCacheProfile(&mesh.indices[0], &mesh.indices[0], mesh.indices.size(), mesh.vertices.size(), meshopt_VertexCacheIntel);
+}
+
+void optCacheMobile(Mesh& mesh)
+{
+	meshopt_optimizeVertexCacheProfile(&mesh.indices[0], &mesh.indices[0], mesh.indices.size(), mesh.vertices.size(), meshopt_VertexCacheMobile);
+}
+
+void optCachePartitioned(Mesh& mesh)
+{
+	meshopt_spatialSortTriangles(&mesh.indices[0], &mesh.indices[0], mesh.indices.size(), &mesh.vertices[0].px, mesh.vertices.size(), sizeof(Vertex));
+	meshopt_optimizeVertexCachePartitioned(&mesh.indices[0], &mesh.indices[0], mesh.indices.size(), mesh.vertices.size(), 8, NULL, NULL);
+}
+
 void optOverdraw(Mesh& mesh)
 {
 	// use worst-case ACMR threshold so that overdraw optimizer can sort *all* triangles
@@ -281,6 +298,13 @@ void optOverdraw(Mesh& mesh)
 	meshopt_optimizeOverdraw(&mesh.indices[0], &mesh.indices[0], mesh.indices.size(), &mesh.vertices[0].px, mesh.vertices.size(), sizeof(Vertex), kThreshold);
 }
 
+void optOverdrawParallel(Mesh& mesh)
+{
+	// same threshold as optOverdraw so that the results are comparable
+	const float kThreshold = 3.f;
+	meshopt_optimizeOverdrawParallel(&mesh.indices[0], &mesh.indices[0], mesh.indices.size(), &mesh.vertices[0].px, mesh.vertices.size(), sizeof(Vertex), kThreshold, NULL, NULL);
+}
+
 void optFetch(Mesh& mesh)
 {
 	meshopt_optimizeVertexFetch(&mesh.vertices[0], &mesh.indices[0], mesh.indices.size(), &mesh.vertices[0], mesh.vertices.size(), sizeof(Vertex));
@@ -395,6 +419,54 @@ void simplify(const Mesh& mesh, float threshold = 0.2f)
 	       int(mesh.indices.size() / 3), int(lod.indices.size() / 3), (end - start) * 1000);
 }
 
+void simplifyAttr(const Mesh& mesh, float threshold = 0.2f)
+{
+	Mesh lod;
+
+	double start = timestamp();
+
+	size_t target_index_count = size_t(mesh.indices.size() * threshold);
+	float target_error = 1e-2f;
+
+	// normals and texture coordinates are 5 consecutive floats after position
+	const float attr_weights[5] = {1e-2f, 1e-2f, 1e-2f, 1e-2f, 1e-2f};
+
+	lod.indices.resize(mesh.indices.size()); // note: simplify needs space for index_count elements in the destination array, not target_index_count
+	lod.indices.resize(meshopt_simplifyWithAttributes(&lod.indices[0], &mesh.indices[0], mesh.indices.size(), &mesh.vertices[0].px, mesh.vertices.size(), sizeof(Vertex), &mesh.vertices[0].nx, sizeof(Vertex), attr_weights, 5, target_index_count, target_error));
+
+	lod.vertices.resize(lod.indices.size() < mesh.vertices.size() ? lod.indices.size() : mesh.vertices.size()); // note: this is just to reduce the cost of resize()
+	lod.vertices.resize(meshopt_optimizeVertexFetch(&lod.vertices[0], &lod.indices[0], lod.indices.size(), &mesh.vertices[0], mesh.vertices.size(), sizeof(Vertex)));
+
+	double end = timestamp();
+
+	printf("%-9s: %d triangles => %d triangles in %.2f msec\n",
+	       "SimplifyA",
+	       int(mesh.indices.size() / 3), int(lod.indices.size() / 3), (end - start) * 1000);
+}
+
+void simplifyPartitioned(const Mesh& mesh, float threshold = 0.2f)
+{
+	Mesh lod;
+
+	double start = timestamp();
+
+	size_t target_index_count = size_t(mesh.indices.size() * threshold);
+	float target_error = 1e-2f;
+
+	// note: this uses the serial scheduler; applications can pass a scheduler that runs partitions on a thread pool
+	lod.indices.resize(mesh.indices.size());
+	lod.indices.resize(meshopt_simplifyPartitioned(&lod.indices[0], &mesh.indices[0], mesh.indices.size(), &mesh.vertices[0].px, mesh.vertices.size(), sizeof(Vertex), target_index_count, target_error, 8, NULL, NULL));
+
+	lod.vertices.resize(lod.indices.size() < mesh.vertices.size() ? lod.indices.size() : mesh.vertices.size()); // note: this is just to reduce the cost of resize()
+	lod.vertices.resize(meshopt_optimizeVertexFetch(&lod.vertices[0], &lod.indices[0], lod.indices.size(), &mesh.vertices[0], mesh.vertices.size(), sizeof(Vertex)));
+
+	double end = timestamp();
+
+	printf("%-9s: %d triangles => %d triangles in %.2f msec\n",
+	       "SimplifyM",
+	       int(mesh.indices.size() / 3), int(lod.indices.size() / 3), (end - start) * 1000);
+}
+
 void simplifySloppy(const Mesh& mesh, float threshold = 0.2f)
 {
 	Mesh lod;
@@ -404,7 +476,7 @@ void simplifySloppy(const Mesh& mesh, float threshold = 0.2f)
 	size_t target_index_count = size_t(mesh.indices.size() * threshold);
 
 	lod.indices.resize(target_index_count); // note: simplifySloppy, unlike simplify, is guaranteed to output results that don't exceed the requested target_index_count
-	lod.indices.resize(meshopt_simplifySloppy(&lod.indices[0], &mesh.indices[0], mesh.indices.size(), &mesh.vertices[0].px, mesh.vertices.size(), sizeof(Vertex), target_index_count));
+	lod.indices.resize(meshopt_simplifySloppy(&lod.indices[0], &mesh.indices[0], mesh.indices.size(), &mesh.vertices[0].px, mesh.vertices.size(), sizeof(Vertex), target_index_count, FLT_MAX, NULL));
 
 	lod.vertices.resize(lod.indices.size() < mesh.vertices.size() ? lod.indices.size() : mesh.vertices.size()); // note: this is just to reduce the cost of resize()
 	lod.vertices.resize(meshopt_optimizeVertexFetch(&lod.vertices[0], &lod.indices[0], lod.indices.size(), &mesh.vertices[0], mesh.vertices.size(), sizeof(Vertex)));
@@ -444,6 +516,10 @@ void simplifyComplete(const Mesh& mesh)
 
 	lods[0] = mesh.indices;
 
+	// the simplifier keeps the state between LODs so that each LOD continues from the previous one without repeating the setup
+	// the error is still measured relative to the base level; simplifying each LOD from the base level sometimes produces better results, but is slower
+	meshopt_Simplifier* simplifier = meshopt_createSimplifier(&mesh.indices[0], mesh.indices.size(), &mesh.vertices[0].px, mesh.vertices.size(), sizeof(Vertex));
+
 	for (size_t i = 1; i < lod_count; ++i)
 	{
 		std::vector<unsigned int>& lod = lods[i];
@@ -452,17 +528,12 @@ void simplifyComplete(const Mesh& mesh)
 		size_t target_index_count = size_t(mesh.indices.size() * threshold) / 3 * 3;
 		float target_error = 1e-2f;
 
-		// we can simplify all the way from base level or from the last result
-		// simplifying from the base level sometimes produces better results, but simplifying from last level is faster
-		const std::vector<unsigned int>& source = lods[i - 1];
-
-		if (source.size() < target_index_count)
-			target_index_count = source.size();
-
-		lod.resize(source.size());
-		lod.resize(meshopt_simplify(&lod[0], &source[0], source.size(), &mesh.vertices[0].px, mesh.vertices.size(), sizeof(Vertex), target_index_count, target_error));
+		lod.resize(lods[i - 1].size());
+		lod.resize(meshopt_simplifyNext(simplifier, &lod[0], target_index_count, target_error));
 	}
 
+	meshopt_destroySimplifier(simplifier);
+
 	double middle = timestamp();
 
 	// optimize each individual LOD for vertex cache & overdraw
@@ -555,11 +626,13 @@ void optimize(const Mesh& mesh, const char* name, void (*optf)(Mesh& mesh))
 	meshopt_VertexFetchStatistics vfs = meshopt_analyzeVertexFetch(&copy.indices[0], copy.indices.size(), copy.vertices.size(), sizeof(Vertex));
 	meshopt_OverdrawStatistics os = meshopt_analyzeOverdraw(&copy.indices[0], copy.indices.size(), &copy.vertices[0].px, copy.vertices.size(), sizeof(Vertex));
 
-	meshopt_VertexCacheStatistics vcs_nv = meshopt_analyzeVertexCache(&copy.indices[0], copy.indices.size(), copy.vertices.size(), 32, 32, 32);
-	meshopt_VertexCacheStatistics vcs_amd = meshopt_analyzeVertexCache(&copy.indices[0], copy.indices.size(), copy.vertices.size(), 14, 64, 128);
-	meshopt_VertexCacheStatistics vcs_intel = meshopt_analyzeVertexCache(&copy.indices[0], copy.indices.size(), copy.vertices.size(), 128, 0, 0);
+	meshopt_VertexCacheStatistics vcs_nv = meshopt_analyzeVertexCacheProfile(&copy.indices[0], copy.indices.size(), copy.vertices.size(), meshopt_VertexCacheNvidia);
+	meshopt_VertexCacheStatistics vcs_amd = meshopt_analyzeVertexCacheProfile(&copy.indices[0], copy.indices.size(), copy.vertices.size(), meshopt_VertexCacheAmd);
+	meshopt_VertexCacheStatistics vcs_intel = meshopt_analyzeVertexCacheProfile(&copy.indices[0], copy.indices.size(), copy.vertices.size(), meshopt_VertexCacheIntel);
+	meshopt_VertexCacheStatistics vcs_apple = meshopt_analyzeVertexCacheProfile(&copy.indices[0], copy.indices.size(), copy.vertices.size(), meshopt_VertexCacheApple);
+	meshopt_VertexCacheStatistics vcs_mobile = meshopt_analyzeVertexCacheProfile(&copy.indices[0], copy.indices.size(), copy.vertices.size(), meshopt_VertexCacheMobile);
 
-	printf("%-9s: ACMR %f ATVR %f (NV %f AMD %f Intel %f) Overfetch %f Overdraw %f in %.2f msec\n", name, vcs.acmr, vcs.atvr, vcs_nv.atvr, vcs_amd.atvr, vcs_intel.atvr, vfs.overfetch, os.overdraw, (end - start) * 1000);
+	printf("%-9s: ACMR %f ATVR %f (NV %f AMD %f Intel %f Apple %f Mobile %f) Overfetch %f Overdraw %f in %.2f msec\n", name, vcs.acmr, vcs.atvr, vcs_nv.atvr, vcs_amd.atvr, vcs_intel.atvr, vcs_apple.atvr, vcs_mobile.atvr, vfs.overfetch, os.overdraw, (end - start) * 1000);
 }
 
 template <typename T>
@@ -685,14 +758,25 @@ void encodeVertex(const Mesh& mesh, const char* pvn)
 	       (double(result.size() * sizeof(PV)) / (1 << 30)) / (end - middle));
 }
 
-void stripify(const Mesh& mesh, bool use_restart, char desc)
+void stripify(const Mesh& mesh, bool use_restart, char desc, size_t chunk_size = 0)
 {
 	unsigned int restart_index = use_restart ? ~0u : 0;
 
 	// note: input mesh is assumed to be optimized for vertex cache and vertex fetch
 	double start = timestamp();
-	std::vector<unsigned int> strip(meshopt_stripifyBound(mesh.indices.size()));
-	strip.resize(meshopt_stripify(&strip[0], &mesh.indices[0], mesh.indices.size(), mesh.vertices.size(), restart_index));
+	std::vector<unsigned int> strip;
+
+	if (chunk_size)
+	{
+		strip.resize(meshopt_stripifyParallelBound(mesh.indices.size(), chunk_size));
+		strip.resize(meshopt_stripifyParallel(&strip[0], &mesh.indices[0], mesh.indices.size(), mesh.vertices.size(), restart_index, chunk_size, NULL, NULL));
+	}
+	else
+	{
+		strip.resize(meshopt_stripifyBound(mesh.indices.size()));
+		strip.resize(meshopt_stripify(&strip[0], &mesh.indices[0], mesh.indices.size(), mesh.vertices.size(), restart_index));
+	}
+
 	double end = timestamp();
 
 	Mesh copy = mesh;
@@ -747,15 +831,19 @@ void shadow(const Mesh& mesh)
 	       (end - start) * 1000);
 }
 
-void meshlets(const Mesh& mesh)
+void meshlets(const Mesh& mesh, bool spatial)
 {
 	const size_t max_vertices = 64;
 	const size_t max_triangles = 126;
+	const float cone_weight = 0.25f;
 
 	// note: input mesh is assumed to be optimized for vertex cache and vertex fetch
 	double start = timestamp();
 	std::vector<meshopt_Meshlet> meshlets(meshopt_buildMeshletsBound(mesh.indices.size(), max_vertices, max_triangles));
-	meshlets.resize(meshopt_buildMeshlets(&meshlets[0], &mesh.indices[0], mesh.indices.size(), mesh.vertices.size(), max_vertices, max_triangles));
+	if (spatial)
+		meshlets.resize(meshopt_buildMeshletsSpatial(&meshlets[0], &mesh.indices[0], mesh.indices.size(), &mesh.vertices[0].px, mesh.vertices.size(), sizeof(Vertex), max_vertices, max_triangles, cone_weight));
+	else
+		meshlets.resize(meshopt_buildMeshlets(&meshlets[0], &mesh.indices[0], mesh.indices.size(), mesh.vertices.size(), max_vertices, max_triangles));
 	double end = timestamp();
 
 	double avg_vertices = 0;
@@ -774,8 +862,8 @@ void meshlets(const Mesh& mesh)
 	avg_vertices /= double(meshlets.size());
 	avg_triangles /= double(meshlets.size());
 
-	printf("Meshlets : %d meshlets (avg vertices %.1f, avg triangles %.1f, not full %d) in %.2f msec\n",
-	       int(meshlets.size()), avg_vertices, avg_triangles, int(not_full), (end - start) * 1000);
+	printf("Meshlets%c: %d meshlets (avg vertices %.1f, avg triangles %.1f, not full %d) in %.2f msec\n",
+	       spatial ? 'S' : ' ', int(meshlets.size()), avg_vertices, avg_triangles, int(not_full), (end - start) * 1000);
 
 	float camera[3] = {100, 100, 100};
 
@@ -812,18 +900,50 @@ void meshlets(const Mesh& mesh)
 	}
 	double endc = timestamp();
 
-	printf("ConeCull : rejected apex %d (%.1f%%) / center %d (%.1f%%), trivially accepted %d (%.1f%%) in %.2f msec\n",
-	       int(rejected), double(rejected) / double(meshlets.size()) * 100,
+	printf("ConeCull%c: rejected apex %d (%.1f%%) / center %d (%.1f%%), trivially accepted %d (%.1f%%) in %.2f msec\n",
+	       spatial ? 'S' : ' ', int(rejected), double(rejected) / double(meshlets.size()) * 100,
 	       int(rejected_alt), double(rejected_alt) / double(meshlets.size()) * 100,
 	       int(accepted), double(accepted) / double(meshlets.size()) * 100,
 	       (endc - startc) * 1000);
-	printf("ConeCull8: rejected apex %d (%.1f%%) / center %d (%.1f%%), trivially accepted %d (%.1f%%) in %.2f msec\n",
-	       int(rejected_s8), double(rejected_s8) / double(meshlets.size()) * 100,
+	printf("ConeCul8%c: rejected apex %d (%.1f%%) / center %d (%.1f%%), trivially accepted %d (%.1f%%) in %.2f msec\n",
+	       spatial ? 'S' : ' ', int(rejected_s8), double(rejected_s8) / double(meshlets.size()) * 100,
 	       int(rejected_alt_s8), double(rejected_alt_s8) / double(meshlets.size()) * 100,
 	       int(accepted_s8), double(accepted_s8) / double(meshlets.size()) * 100,
 	       (endc - startc) * 1000);
 }
 
+void meshletsPacked(const Mesh& mesh)
+{
+	const size_t max_vertices = 64;
+	const size_t max_triangles = 124;
+
+	double start = timestamp();
+	size_t max_meshlets = meshopt_buildMeshletsBound(mesh.indices.size(), max_vertices, max_triangles);
+	std::vector<meshopt_PackedMeshlet> meshlets(max_meshlets);
+	std::vector<unsigned int> meshlet_vertices(max_meshlets * max_vertices);
+	std::vector<unsigned char> meshlet_triangles(max_meshlets * max_triangles * 3);
+
+	meshlets.resize(meshopt_buildMeshletsPacked(&meshlets[0], &meshlet_vertices[0], &meshlet_triangles[0], &mesh.indices[0], mesh.indices.size(), &mesh.vertices[0].px, mesh.vertices.size(), sizeof(Vertex), max_vertices, max_triangles, 0.25f));
+
+	const meshopt_PackedMeshlet& last = meshlets.back();
+	meshlet_vertices.resize(last.vertex_offset + last.vertex_count);
+	meshlet_triangles.resize(last.triangle_offset + ((last.triangle_count * 3 + 3) & ~3));
+	double end = timestamp();
+
+	size_t packed_size = meshlets.size() * sizeof(meshopt_PackedMeshlet) + meshlet_vertices.size() * sizeof(unsigned int) + meshlet_triangles.size();
+	size_t fixed_size = meshlets.size() * sizeof(meshopt_Meshlet);
+
+	printf("MeshletsP: %d meshlets, %.1f KB (fixed layout %.1f KB) in %.2f msec\n",
+	       int(meshlets.size()), double(packed_size) / 1024, double(fixed_size) / 1024, (end - start) * 1000);
+
+	double startb = timestamp();
+	std::vector<meshopt_Bounds> bounds(meshlets.size());
+	meshopt_computeMeshletBoundsPacked(&bounds[0], &meshlets[0], meshlets.size(), &meshlet_vertices[0], &meshlet_triangles[0], &mesh.vertices[0].px, mesh.vertices.size(), sizeof(Vertex), NULL, NULL);
+	double endb = timestamp();
+
+	printf("BoundsP  : %d meshlets in %.2f msec\n", int(bounds.size()), (endb - startb) * 1000);
+}
+
 void spatialSort(const Mesh& mesh)
 {
 	typedef PackedVertexOct PV;
@@ -907,7 +1027,7 @@ void processDeinterleaved(const char* path)
 {
 	// Most algorithms in the library work out of the box with deinterleaved geometry, but some require slightly special treatment;
 	// this code runs a simplified version of complete opt. pipeline using deinterleaved geo. There's no compression performed but you
-	// can trivially run it by quantizing all elements and running meshopt_encodeVertexBuffer once for each vertex stream.
+	// can trivially run it by quantizing all elements and running meshopt_encodeVertexBufferMulti on all vertex streams.
 	fastObjMesh* obj = fast_obj_read(path);
 	if (!obj)
 	{
@@ -972,22 +1092,24 @@ void processDeinterleaved(const char* path)
 	meshopt_remapIndexBuffer(&indices[0], NULL, total_indices, &remap[0]);
 
 	std::vector<float> pos(total_vertices * 3);
-	meshopt_remapVertexBuffer(&pos[0], &unindexed_pos[0], total_indices, sizeof(float) * 3, &remap[0]);
-
 	std::vector<float> nrm(total_vertices * 3);
-	meshopt_remapVertexBuffer(&nrm[0], &unindexed_nrm[0], total_indices, sizeof(float) * 3, &remap[0]);
-
 	std::vector<float> uv(total_vertices * 2);
-	meshopt_remapVertexBuffer(&uv[0], &unindexed_uv[0], total_indices, sizeof(float) * 2, &remap[0]);
+
+	void* destinations[] = {&pos[0], &nrm[0], &uv[0]};
+	meshopt_remapVertexBufferMulti(destinations, total_indices, streams, sizeof(streams) / sizeof(streams[0]), &remap[0]);
 
 	double reindex = timestamp();
 
 	meshopt_optimizeVertexCache(&indices[0], &indices[0], total_indices, total_vertices);
 
-	meshopt_optimizeVertexFetchRemap(&remap[0], &indices[0], total_indices, total_vertices);
-	meshopt_remapVertexBuffer(&pos[0], &pos[0], total_vertices, sizeof(float) * 3, &remap[0]);
-	meshopt_remapVertexBuffer(&nrm[0], &nrm[0], total_vertices, sizeof(float) * 3, &remap[0]);
-	meshopt_remapVertexBuffer(&uv[0], &uv[0], total_vertices, sizeof(float) * 2, &remap[0]);
+	// all streams are reordered in place in a single pass over the indices
+	meshopt_Stream indexed_streams[] = {
+	    {&pos[0], sizeof(float) * 3, sizeof(float) * 3},
+	    {&nrm[0], sizeof(float) * 3, sizeof(float) * 3},
+	    {&uv[0], sizeof(float) * 2, sizeof(float) * 2},
+	};
+
+	meshopt_optimizeVertexFetchMulti(destinations, &indices[0], total_indices, total_vertices, indexed_streams, sizeof(indexed_streams) / sizeof(indexed_streams[0]));
 
 	double optimize = timestamp();
 
@@ -1003,6 +1125,13 @@ void processDeinterleaved(const char* path)
 
 	printf("Deintrlvd: %d vertices, reindexed in %.2f msec, optimized in %.2f msec, generated & optimized shadow indices in %.2f msec\n",
 	       int(total_vertices), (reindex - start) * 1000, (optimize - reindex) * 1000, (shadow - optimize) * 1000);
+
+	// 16 KB 4-way cache with 64-byte lines approximates a typical GPU L1
+	unsigned int stream_bytes[3] = {};
+	meshopt_VertexFetchStatistics vfs = meshopt_analyzeVertexFetchMulti(stream_bytes, &indices[0], total_indices, total_vertices, indexed_streams, sizeof(indexed_streams) / sizeof(indexed_streams[0]), 64, 16 * 1024, 4);
+
+	printf("Deintrlvd: Overfetch %f (position %.1f KB, normal %.1f KB, uv %.1f KB)\n",
+	       vfs.overfetch, double(stream_bytes[0]) / 1024, double(stream_bytes[1]) / 1024, double(stream_bytes[2]) / 1024);
 }
 
 void process(const char* path)
@@ -1016,7 +1145,11 @@ void process(const char* path)
 	optimize(mesh, "Cache", optCache);
 	optimize(mesh, "CacheFifo", optCacheFifo);
 	optimize(mesh, "CacheStrp", optCacheStrip);
+	optimize(mesh, "CacheIntl", optCacheIntel);
+	optimize(mesh, "CacheMobl", optCacheMobile);
+	optimize(mesh, "CachePart", optCachePartitioned);
 	optimize(mesh, "Overdraw", optOverdraw);
+	optimize(mesh, "OverdrawP", optOverdrawParallel);
 	optimize(mesh, "Fetch", optFetch);
 	optimize(mesh, "FetchMap", optFetchRemap);
 	optimize(mesh, "Complete", optComplete);
@@ -1032,8 +1165,11 @@ void process(const char* path)
 	stripify(copy, false, ' ');
 	stripify(copy, true, 'R');
 	stripify(copystrip, true, 'S');
+	stripify(copystrip, true, 'P', 4096);
 
-	meshlets(copy);
+	meshlets(copy, false);
+	meshlets(copy, true);
+	meshletsPacked(copy);
 	shadow(copy);
 
 	encodeIndex(copy, ' ');
@@ -1049,6 +1185,8 @@ void process(const char* path)
 	encodeVertex<PackedVertexOct>(copy, "O");
 
 	simplify(mesh);
+	simplifyAttr(mesh);
+	simplifyPartitioned(mesh);
 	simplifySloppy(mesh);
 	simplifyComplete(mesh);
 	simplifyPoints(mesh);
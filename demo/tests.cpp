@@ -1,9 +1,12 @@
 #include "../src/meshoptimizer.h"
 
 #include <assert.h>
+#include <float.h>
+#include <math.h>
 #include <stdlib.h>
 #include <string.h>
 
+#include <algorithm>
 #include <vector>
 
 // This file uses assert() to verify algorithm correctness
@@ -490,6 +493,115 @@ static void decodeVertexLarge()
 	assert(memcmp(decoded, data, sizeof(data)) == 0);
 }
 
+static void decodeVertexRange()
+{
+	const size_t vertex_count = 1000;
+	const size_t vertex_size = 16;
+
+	std::vector<unsigned char> data(vertex_count * vertex_size);
+
+	for (size_t i = 0; i < data.size(); ++i)
+		data[i] = (unsigned char)((i / vertex_size) * (i % vertex_size + 1));
+
+	std::vector<unsigned char> buffer(meshopt_encodeVertexBufferBound(vertex_count, vertex_size));
+	buffer.resize(meshopt_encodeVertexBuffer(&buffer[0], buffer.size(), &data[0], vertex_count, vertex_size));
+
+	std::vector<unsigned char> table(meshopt_encodeVertexSeekTableBound(vertex_count, vertex_size));
+	assert(meshopt_encodeVertexSeekTable(&table[0], table.size(), &buffer[0], buffer.size(), &data[0], vertex_count, vertex_size) == table.size());
+
+	// decode ranges that are aligned and misaligned with respect to internal blocks; vertices outside of the range must not be touched
+	const size_t ranges[][2] = {{0, 1000}, {0, 256}, {256, 512}, {100, 300}, {999, 1}, {0, 0}, {700, 300}};
+
+	for (size_t r = 0; r < sizeof(ranges) / sizeof(ranges[0]); ++r)
+	{
+		size_t offset = ranges[r][0], count = ranges[r][1];
+
+		std::vector<unsigned char> decoded(vertex_count * vertex_size, 0xcc);
+		assert(meshopt_decodeVertexBufferRange(&decoded[0], vertex_count, vertex_size, offset, count, &buffer[0], buffer.size(), &table[0], table.size()) == 0);
+
+		for (size_t i = 0; i < decoded.size(); ++i)
+		{
+			bool inside = i >= offset * vertex_size && i < (offset + count) * vertex_size;
+			assert(decoded[i] == (inside ? data[i] : 0xcc));
+		}
+	}
+
+	// check that decoder doesn't accept a table for a different vertex count
+	std::vector<unsigned char> decoded(vertex_count * vertex_size);
+	assert(meshopt_decodeVertexBufferRange(&decoded[0], vertex_count, vertex_size, 0, vertex_count, &buffer[0], buffer.size(), &table[0], table.size() - 1) < 0);
+
+	// check that decoder doesn't accept extra bytes after a valid stream when decoding the last range
+	std::vector<unsigned char> largebuffer(buffer);
+	largebuffer.push_back(0);
+
+	assert(meshopt_decodeVertexBufferRange(&decoded[0], vertex_count, vertex_size, 500, 500, &largebuffer[0], largebuffer.size(), &table[0], table.size()) < 0);
+}
+
+static void decodeVertexStream()
+{
+	const size_t vertex_count = 1000;
+	const size_t vertex_size = 16;
+
+	std::vector<unsigned char> data(vertex_count * vertex_size);
+
+	for (size_t i = 0; i < data.size(); ++i)
+		data[i] = (unsigned char)((i / vertex_size) * (i % vertex_size + 1));
+
+	std::vector<unsigned char> buffer(meshopt_encodeVertexBufferBound(vertex_count, vertex_size));
+	buffer.resize(meshopt_encodeVertexBuffer(&buffer[0], buffer.size(), &data[0], vertex_count, vertex_size));
+
+	// feed the stream in chunks of different sizes, keeping the bytes that the decoder didn't consume
+	const size_t chunks[] = {1, 13, 1000, buffer.size()};
+
+	for (size_t c = 0; c < sizeof(chunks) / sizeof(chunks[0]); ++c)
+	{
+		for (int first = 0; first < 2; ++first)
+		{
+			meshopt_VertexDecoder decoder;
+			meshopt_decodeVertexStreamInit(&decoder, vertex_count, vertex_size, first ? &data[0] : NULL);
+
+			std::vector<unsigned char> decoded(vertex_count * vertex_size);
+			std::vector<unsigned char> pending;
+
+			size_t offset = 0;
+			int result = 1;
+
+			while (result == 1)
+			{
+				assert(offset < buffer.size());
+
+				size_t chunk = buffer.size() - offset < chunks[c] ? buffer.size() - offset : chunks[c];
+				pending.insert(pending.end(), buffer.begin() + offset, buffer.begin() + offset + chunk);
+				offset += chunk;
+
+				size_t consumed = 0;
+				result = meshopt_decodeVertexStream(&decoder, &decoded[0], &pending[0], pending.size(), &consumed);
+				assert(result >= 0);
+
+				pending.erase(pending.begin(), pending.begin() + consumed);
+
+				// when first vertex is known upfront, decoded vertices are final after every call
+				if (first)
+					assert(memcmp(&decoded[0], &data[0], decoder.vertex_offset * vertex_size) == 0);
+			}
+
+			assert(offset == buffer.size() && pending.empty());
+			assert(decoded == data);
+		}
+	}
+
+	// check that decoder rejects invalid header
+	meshopt_VertexDecoder decoder;
+	meshopt_decodeVertexStreamInit(&decoder, vertex_count, vertex_size, NULL);
+
+	std::vector<unsigned char> decoded(vertex_count * vertex_size);
+	std::vector<unsigned char> badbuffer(buffer);
+	badbuffer[0] = 0;
+
+	size_t consumed = 0;
+	assert(meshopt_decodeVertexStream(&decoder, &decoded[0], &badbuffer[0], badbuffer.size(), &consumed) < 0);
+}
+
 static void encodeVertexEmpty()
 {
 	std::vector<unsigned char> buffer(meshopt_encodeVertexBufferBound(0, 16));
@@ -582,6 +694,218 @@ static void decodeFilterExp()
 	assert(memcmp(data, expected, sizeof(data)) == 0);
 }
 
+static void decodeFilterFused()
+{
+	const size_t vertex_count = 1000;
+
+	// block boundaries depend on vertex size, so we test all filter strides
+	void (*filters[])(void*, size_t, size_t) = {meshopt_decodeFilterOct, meshopt_decodeFilterOct, meshopt_decodeFilterQuat, meshopt_decodeFilterExp};
+	const size_t sizes[] = {4, 8, 8, 16};
+
+	for (size_t f = 0; f < sizeof(sizes) / sizeof(sizes[0]); ++f)
+	{
+		size_t vertex_size = sizes[f];
+
+		std::vector<unsigned char> data(vertex_count * vertex_size);
+
+		for (size_t i = 0; i < data.size(); ++i)
+			data[i] = (unsigned char)((i / vertex_size) * 7 + (i % vertex_size) * 13);
+
+		std::vector<unsigned char> buffer(meshopt_encodeVertexBufferBound(vertex_count, vertex_size));
+		buffer.resize(meshopt_encodeVertexBuffer(&buffer[0], buffer.size(), &data[0], vertex_count, vertex_size));
+
+		std::vector<unsigned char> expected(data);
+		filters[f](&expected[0], vertex_count, vertex_size);
+
+		std::vector<unsigned char> decoded(vertex_count * vertex_size);
+		assert(meshopt_decodeVertexBufferFiltered(&decoded[0], vertex_count, vertex_size, &buffer[0], buffer.size(), filters[f]) == 0);
+		assert(decoded == expected);
+	}
+}
+
+static void encodeFilterOct()
+{
+	const size_t count = 75;
+
+	std::vector<float> data(count * 4);
+
+	for (size_t i = 0; i < count; ++i)
+	{
+		// cover both hemispheres and a few axis-aligned vectors
+		float x = (i % 5 == 0) ? 0.f : float(int(i * 37 % 23) - 11);
+		float y = (i % 7 == 0) ? 0.f : float(int(i * 53 % 19) - 9);
+		float z = float(int(i * 17 % 13) - 6);
+		float l = sqrtf(x * x + y * y + z * z);
+		float s = l == 0.f ? 0.f : 1.f / l;
+
+		data[i * 4 + 0] = x * s;
+		data[i * 4 + 1] = y * s;
+		data[i * 4 + 2] = z * s;
+		data[i * 4 + 3] = (i & 1) ? 1.f : -1.f;
+	}
+
+	const size_t strides[] = {4, 8};
+	const int bits[] = {8, 12};
+
+	for (size_t k = 0; k < 2; ++k)
+	{
+		size_t stride = strides[k];
+		size_t component_size = stride / 4;
+
+		// the extra vertex checks that the encoder doesn't write past the end and makes the decoded count aligned by 4
+		std::vector<unsigned char> encoded((count + 1) * stride, 0xcd);
+		meshopt_encodeFilterOct(&encoded[0], count, stride, bits[k], &data[0]);
+
+		assert(encoded[count * stride] == 0xcd);
+
+		for (size_t i = 0; i < count; ++i)
+		{
+			const float* n = &data[i * 4];
+
+			// reference scalar octahedral encoding
+			float nl = fabsf(n[0]) + fabsf(n[1]) + fabsf(n[2]);
+			float ns = nl == 0.f ? 0.f : 1.f / nl;
+			float nx = n[0] * ns, ny = n[1] * ns;
+			float u = (n[2] >= 0.f) ? nx : (1 - fabsf(ny)) * (nx >= 0.f ? 1.f : -1.f);
+			float v = (n[2] >= 0.f) ? ny : (1 - fabsf(nx)) * (ny >= 0.f ? 1.f : -1.f);
+
+			int expected[4] = {meshopt_quantizeSnorm(u, bits[k]), meshopt_quantizeSnorm(v, bits[k]), meshopt_quantizeSnorm(1.f, bits[k]), meshopt_quantizeSnorm(n[3], int(component_size * 8))};
+
+			for (int c = 0; c < 4; ++c)
+			{
+				int actual = (component_size == 1) ? int((signed char)encoded[i * stride + c]) : int((short)(encoded[i * stride + c * 2] | (encoded[i * stride + c * 2 + 1] << 8)));
+				assert(actual == expected[c]);
+			}
+		}
+
+		std::vector<unsigned char> decoded(encoded);
+		meshopt_decodeFilterOct(&decoded[0], (count + 1) & ~3, stride);
+
+		float scale = float((1 << (component_size * 8 - 1)) - 1);
+		float tolerance = (component_size == 1) ? 0.98f : 0.9999f;
+
+		for (size_t i = 0; i < count; ++i)
+		{
+			const float* n = &data[i * 4];
+
+			if (n[0] == 0.f && n[1] == 0.f && n[2] == 0.f)
+				continue;
+
+			float r[3];
+			for (int c = 0; c < 3; ++c)
+				r[c] = float((component_size == 1) ? int((signed char)decoded[i * stride + c]) : int((short)(decoded[i * stride + c * 2] | (decoded[i * stride + c * 2 + 1] << 8)))) / scale;
+
+			assert(r[0] * n[0] + r[1] * n[1] + r[2] * n[2] > tolerance);
+		}
+	}
+}
+
+static void encodeFilterQuat()
+{
+	const size_t count = 75;
+
+	std::vector<float> data(count * 4);
+
+	for (size_t i = 0; i < count; ++i)
+	{
+		float q[4] = {float(int(i * 37 % 23) - 11), float(int(i * 53 % 19) - 9), float(int(i * 17 % 13) - 6), float(int(i * 29 % 11) - 5)};
+
+		// make sure each component gets to be the largest one, including ties
+		q[i % 4] = (i & 1) ? 20.f : -20.f;
+		q[(i + 1) % 4] = (i % 3 == 0) ? q[i % 4] : q[(i + 1) % 4];
+
+		float l = sqrtf(q[0] * q[0] + q[1] * q[1] + q[2] * q[2] + q[3] * q[3]);
+
+		for (int c = 0; c < 4; ++c)
+			data[i * 4 + c] = q[c] / l;
+	}
+
+	std::vector<unsigned short> encoded((count + 1) * 4, 0xcdcd);
+	meshopt_encodeFilterQuat(&encoded[0], count, 8, 12, &data[0]);
+
+	assert(encoded[count * 4] == 0xcdcd);
+
+	for (size_t i = 0; i < count; ++i)
+	{
+		const float* q = &data[i * 4];
+
+		// reference scalar quaternion encoding
+		int qc = 0;
+		qc = fabsf(q[1]) > fabsf(q[qc]) ? 1 : qc;
+		qc = fabsf(q[2]) > fabsf(q[qc]) ? 2 : qc;
+		qc = fabsf(q[3]) > fabsf(q[qc]) ? 3 : qc;
+
+		float sign = q[qc] < 0.f ? -1.f : 1.f;
+
+		assert((short)encoded[i * 4 + 0] == meshopt_quantizeSnorm(q[(qc + 1) & 3] * sqrtf(2.f) * sign, 12));
+		assert((short)encoded[i * 4 + 1] == meshopt_quantizeSnorm(q[(qc + 2) & 3] * sqrtf(2.f) * sign, 12));
+		assert((short)encoded[i * 4 + 2] == meshopt_quantizeSnorm(q[(qc + 3) & 3] * sqrtf(2.f) * sign, 12));
+		assert((short)encoded[i * 4 + 3] == ((meshopt_quantizeSnorm(1.f, 12) & ~3) | qc));
+	}
+
+	std::vector<unsigned short> decoded(encoded);
+	meshopt_decodeFilterQuat(&decoded[0], (count + 1) & ~3, 8);
+
+	for (size_t i = 0; i < count; ++i)
+	{
+		const float* q = &data[i * 4];
+
+		float dot = 0;
+		for (int c = 0; c < 4; ++c)
+			dot += q[c] * float((short)decoded[i * 4 + c]) / 32767.f;
+
+		// quaternions are encoded up to the sign
+		assert(fabsf(dot) > 0.999f);
+	}
+}
+
+static void quantizeBuffers()
+{
+	const size_t count = 131;
+
+	// input stride has 5 floats; the last one must be ignored
+	std::vector<float> data(count * 5);
+
+	for (size_t i = 0; i < data.size(); ++i)
+		data[i] = float(int(i * 7919 % 601) - 300) / 250.f;
+
+	// a few special values to exercise clamping and half-precision edge cases
+	const float special[] = {0.f, -0.f, 1.f, -1.f, 0.5f, 1e-6f, 1e-4f, 65504.f, 65520.f, 1e10f, -1e10f};
+	for (size_t i = 0; i < sizeof(special) / sizeof(special[0]); ++i)
+		data[i * 3] = special[i];
+
+	for (size_t components = 1; components <= 4; ++components)
+	{
+		std::vector<unsigned char> unorm8(count * 5, 0xcd);
+		meshopt_quantizeUnormBuffer(&unorm8[0], count, 5, 1, &data[0], 5 * sizeof(float), components, 7);
+
+		std::vector<unsigned short> unorm16(count * 4, 0xcdcd);
+		meshopt_quantizeUnormBuffer(&unorm16[0], count, 8, 2, &data[0], 5 * sizeof(float), components, 16);
+
+		std::vector<unsigned char> snorm8(count * 4, 0xcd);
+		meshopt_quantizeSnormBuffer(&snorm8[0], count, 4, 1, &data[0], 5 * sizeof(float), components, 8);
+
+		std::vector<unsigned short> snorm16(count * 4, 0xcdcd);
+		meshopt_quantizeSnormBuffer(&snorm16[0], count, 8, 2, &data[0], 5 * sizeof(float), components, 12);
+
+		std::vector<unsigned short> half(count * 4, 0xcdcd);
+		meshopt_quantizeHalfBuffer(&half[0], count, 8, &data[0], 5 * sizeof(float), components);
+
+		for (size_t i = 0; i < count; ++i)
+			for (size_t k = 0; k < 4; ++k)
+			{
+				float v = data[i * 5 + k];
+				bool used = k < components;
+
+				assert(unorm8[i * 5 + k] == (used ? meshopt_quantizeUnorm(v, 7) : 0xcd));
+				assert(unorm16[i * 4 + k] == (used ? meshopt_quantizeUnorm(v, 16) : 0xcdcd));
+				assert(snorm8[i * 4 + k] == (used ? (unsigned char)meshopt_quantizeSnorm(v, 8) : 0xcd));
+				assert(snorm16[i * 4 + k] == (used ? (unsigned short)meshopt_quantizeSnorm(v, 12) : 0xcdcd));
+				assert(half[i * 4 + k] == (used ? meshopt_quantizeHalf(v) : 0xcdcd));
+			}
+	}
+}
+
 static void clusterBoundsDegenerate()
 {
 	const float vbd[] = {0, 0, 0, 0, 0, 0, 0, 0, 0};
@@ -691,88 +1015,2053 @@ static void simplifyStuck()
 	assert(meshopt_simplify(ib3, ib3, 9, vb2, 5, 12, 6, 1e-3f) == 9);
 }
 
-static void simplifySloppyStuck()
+static void runTasksReverse(void* context, void (*task)(void*, size_t), void* task_data, size_t task_count)
 {
-	const float vb[] = {0, 0, 0, 0, 0, 0, 0, 0, 0};
-	const unsigned int ib[] = {0, 1, 2, 0, 1, 2};
+	(void)context;
 
-	// simplifying down to 0 triangles results in 0 immediately
-	assert(meshopt_simplifySloppy(0, ib, 3, vb, 3, 12, 0) == 0);
+	for (size_t i = task_count; i > 0; --i)
+		task(task_data, i - 1);
+}
 
-	// simplifying down to 2 triangles given that all triangles are degenerate results in 0 as well
-	assert(meshopt_simplifySloppy(0, ib, 6, vb, 3, 12, 6) == 0);
+static void makeGrid(std::vector<float>& vb, std::vector<unsigned int>& ib, size_t grid)
+{
+	for (size_t y = 0; y <= grid; ++y)
+		for (size_t x = 0; x <= grid; ++x)
+		{
+			vb.push_back(float(x));
+			vb.push_back(float(y));
+			vb.push_back(0.f);
+		}
+
+	for (size_t y = 0; y < grid; ++y)
+		for (size_t x = 0; x < grid; ++x)
+		{
+			unsigned int v0 = unsigned(y * (grid + 1) + x);
+			unsigned int v1 = v0 + 1, v2 = v0 + unsigned(grid + 1), v3 = v2 + 1;
+
+			unsigned int quad[] = {v0, v1, v3, v0, v3, v2};
+			ib.insert(ib.end(), quad, quad + 6);
+		}
 }
 
-static void simplifyPointsStuck()
+struct ScratchArena
 {
-	const float vb[] = {0, 0, 0, 0, 0, 0, 0, 0, 0};
+	unsigned char* data;
+	size_t size;
+	size_t offset;
+	size_t peak;
+};
 
-	// simplifying down to 0 points results in 0 immediately
-	assert(meshopt_simplifyPoints(0, vb, 3, 12, 0) == 0);
+static void* arenaAlloc(void* context, size_t size)
+{
+	ScratchArena& arena = *static_cast<ScratchArena*>(context);
+
+	size_t offset = (arena.offset + 15) & ~size_t(15);
+	assert(offset + size <= arena.size);
+
+	arena.offset = offset + size;
+	arena.peak = arena.peak < arena.offset ? arena.offset : arena.peak;
+
+	return arena.data + offset;
 }
 
-static void runTestsOnce()
+static void arenaFree(void* context, void* ptr)
 {
-	decodeIndexV0();
-	decodeIndexV1();
-	decodeIndex16();
-	encodeIndexMemorySafe();
-	decodeIndexMemorySafe();
-	decodeIndexRejectExtraBytes();
-	decodeIndexRejectMalformedHeaders();
-	decodeIndexRejectInvalidVersion();
-	roundtripIndexTricky();
-	encodeIndexEmpty();
+	ScratchArena& arena = *static_cast<ScratchArena*>(context);
 
-	decodeIndexSequence();
-	decodeIndexSequence16();
-	encodeIndexSequenceMemorySafe();
-	decodeIndexSequenceMemorySafe();
-	decodeIndexSequenceRejectExtraBytes();
-	decodeIndexSequenceRejectMalformedHeaders();
-	decodeIndexSequenceRejectInvalidVersion();
-	encodeIndexSequenceEmpty();
+	// allocations are released in reverse order so the arena can rewind to the released block
+	unsigned char* block = static_cast<unsigned char*>(ptr);
+	assert(block >= arena.data && block < arena.data + arena.offset);
 
-	decodeVertexV0();
-	encodeVertexMemorySafe();
-	decodeVertexMemorySafe();
-	decodeVertexRejectExtraBytes();
-	decodeVertexRejectMalformedHeaders();
-	decodeVertexBitGroups();
-	decodeVertexBitGroupSentinels();
-	decodeVertexLarge();
-	encodeVertexEmpty();
+	arena.offset = block - arena.data;
+}
 
-	decodeFilterOct8();
-	decodeFilterOct12();
-	decodeFilterQuat12();
-	decodeFilterExp();
+static void runTasksWithoutContext(void* context, void (*task)(void*, size_t), void* task_data, size_t task_count)
+{
+	// simulates worker threads that have no context callbacks of their own; context is the arena of the calling thread
+	meshopt_setAllocatorContext(NULL, NULL, NULL);
 
-	clusterBoundsDegenerate();
+	for (size_t i = 0; i < task_count; ++i)
+		task(task_data, i);
 
-	customAllocator();
+	meshopt_setAllocatorContext(arenaAlloc, arenaFree, context);
+}
 
-	emptyMesh();
+static void customAllocatorContext()
+{
+	std::vector<float> vb;
+	std::vector<unsigned int> ib;
+	makeGrid(vb, ib, 16);
 
-	simplifyStuck();
-	simplifySloppyStuck();
-	simplifyPointsStuck();
+	std::vector<unsigned int> result(ib.size());
+
+	// measure peak scratch usage with a large arena first
+	std::vector<unsigned char> memory(1 << 20);
+	ScratchArena arena = {&memory[0], memory.size(), 0, 0};
+
+	meshopt_setAllocator(customAlloc, customFree);
+	meshopt_setAllocatorContext(arenaAlloc, arenaFree, &arena);
+
+	meshopt_optimizeVertexCache(&result[0], &ib[0], ib.size(), vb.size() / 3);
+	meshopt_simplify(&result[0], &ib[0], ib.size(), &vb[0], vb.size() / 3, 12, ib.size() / 2, 0.01f);
+
+	assert(arena.offset == 0 && arena.peak > 0);
+	assert(allocCount == 0 && freeCount == 0);
+
+	// the same calls must succeed with a scratch buffer that is exactly as large as the measured peak
+	std::vector<unsigned char> scratch(arena.peak);
+	ScratchArena fixed = {&scratch[0], scratch.size(), 0, 0};
+
+	meshopt_setAllocatorContext(arenaAlloc, arenaFree, &fixed);
+
+	meshopt_optimizeVertexCache(&result[0], &ib[0], ib.size(), vb.size() / 3);
+	meshopt_simplify(&result[0], &ib[0], ib.size(), &vb[0], vb.size() / 3, 12, ib.size() / 2, 0.01f);
+
+	assert(fixed.offset == 0 && fixed.peak == arena.peak);
+
+	// resetting the context callbacks reverts to meshopt_setAllocator callbacks
+	meshopt_setAllocatorContext(NULL, NULL, NULL);
+
+	meshopt_optimizeVertexCache(&result[0], &ib[0], ib.size(), vb.size() / 3);
+	assert(allocCount > 0 && allocCount == freeCount);
+
+	allocCount = freeCount = 0;
+
+	// persistent objects are allocated with meshopt_setAllocator callbacks and released through them even if the callbacks change later
+	meshopt_setAllocatorContext(arenaAlloc, arenaFree, &arena);
+
+	meshopt_Simplifier* simplifier = meshopt_createSimplifier(&ib[0], ib.size(), &vb[0], vb.size() / 3, 12);
+	assert(arena.offset == 0 && allocCount == 1 && freeCount == 0);
+
+	meshopt_setAllocator(operator new, operator delete);
+
+	meshopt_simplifyNext(simplifier, &result[0], ib.size() / 2, 0.01f);
+	assert(arena.offset == 0);
+
+	meshopt_destroySimplifier(simplifier);
+	assert(allocCount == 1 && freeCount == 1);
+
+	// tasks use the callbacks of the calling thread even if they run on threads with different callbacks
+	meshopt_setAllocator(customAlloc, customFree);
+
+	std::vector<unsigned int> strip(meshopt_stripifyParallelBound(ib.size(), 64));
+	meshopt_stripifyParallel(&strip[0], &ib[0], ib.size(), vb.size() / 3, ~0u, 64, runTasksWithoutContext, &arena);
+	meshopt_simplifyPartitioned(&result[0], &ib[0], ib.size(), &vb[0], vb.size() / 3, 12, ib.size() / 2, 0.01f, 4, runTasksWithoutContext, &arena);
+
+	assert(arena.offset == 0 && allocCount == 1 && freeCount == 1);
+
+	meshopt_setAllocatorContext(NULL, NULL, NULL);
+	meshopt_setAllocator(operator new, operator delete);
+
+	allocCount = freeCount = 0;
 }
 
-namespace meshopt
+static void simplifyPartitioned()
 {
-extern unsigned int cpuid;
+	std::vector<float> vb;
+	std::vector<unsigned int> ib;
+	makeGrid(vb, ib, 32);
+
+	size_t vertex_count = vb.size() / 3;
+	size_t target_index_count = ib.size() / 8;
+
+	std::vector<unsigned int> serial(ib.size());
+	serial.resize(meshopt_simplifyPartitioned(&serial[0], &ib[0], ib.size(), &vb[0], vertex_count, 12, target_index_count, 1e-2f, 4, NULL, NULL));
+
+	// flat grid can be simplified to the target; the result shouldn't depend on the task execution order
+	assert(serial.size() <= target_index_count);
+
+	std::vector<unsigned int> reverse(ib.size());
+	reverse.resize(meshopt_simplifyPartitioned(&reverse[0], &ib[0], ib.size(), &vb[0], vertex_count, 12, target_index_count, 1e-2f, 4, runTasksReverse, NULL));
+
+	assert(serial == reverse);
+
+	for (size_t i = 0; i < serial.size(); ++i)
+		assert(serial[i] < vertex_count);
 }
 
-void runTests()
+static void simplifyIncremental()
 {
-	runTestsOnce();
+	std::vector<float> vb;
+	std::vector<unsigned int> ib;
+	makeGrid(vb, ib, 32);
+
+	size_t vertex_count = vb.size() / 3;
+
+	meshopt_Simplifier* simplifier = meshopt_createSimplifier(&ib[0], ib.size(), &vb[0], vertex_count, 12);
+
+	// first call starts from the source mesh, so it should match meshopt_simplify exactly
+	std::vector<unsigned int> expected(ib.size());
+	expected.resize(meshopt_simplify(&expected[0], &ib[0], ib.size(), &vb[0], vertex_count, 12, ib.size() / 2, 1e-2f));
+
+	std::vector<unsigned int> lod1(ib.size());
+	lod1.resize(meshopt_simplifyNext(simplifier, &lod1[0], ib.size() / 2, 1e-2f));
+
+	assert(lod1 == expected);
+
+	// subsequent calls continue from the previous result
+	std::vector<unsigned int> lod2(lod1.size());
+	lod2.resize(meshopt_simplifyNext(simplifier, &lod2[0], ib.size() / 8, 1e-2f));
+
+	assert(lod2.size() <= ib.size() / 8);
+
+	// targets above the current index count keep the current result
+	std::vector<unsigned int> lod3(lod2.size());
+	lod3.resize(meshopt_simplifyNext(simplifier, &lod3[0], ib.size(), 1e-2f));
+
+	assert(lod3 == lod2);
+
+	meshopt_destroySimplifier(simplifier);
+}
+
+static void simplifyAttributes()
+{
+	std::vector<float> vb;
+	std::vector<unsigned int> ib;
+	makeGrid(vb, ib, 32);
+
+	size_t vertex_count = vb.size() / 3;
+
+	// attribute has a sharp ramp in the middle of the grid; the grid itself is flat
+	std::vector<float> attrs(vertex_count);
+
+	for (size_t i = 0; i < vertex_count; ++i)
+		attrs[i] = vb[i * 3 + 0] < 15 ? 0.f : (vb[i * 3 + 0] > 17 ? 1.f : (vb[i * 3 + 0] - 15) / 2);
+
+	std::vector<unsigned int> expected(ib.size());
+	expected.resize(meshopt_simplify(&expected[0], &ib[0], ib.size(), &vb[0], vertex_count, 12, 0, 1e-2f));
+
+	// zero weight should produce the same result as position-only simplification
+	float weight0 = 0.f;
+
+	std::vector<unsigned int> lod0(ib.size());
+	lod0.resize(meshopt_simplifyWithAttributes(&lod0[0], &ib[0], ib.size(), &vb[0], vertex_count, 12, &attrs[0], 4, &weight0, 1, 0, 1e-2f));
+
+	assert(lod0 == expected);
+
+	// with non-zero weight, the ramp should be preserved
+	float weight1 = 1.f;
+
+	std::vector<unsigned int> lod1(ib.size());
+	lod1.resize(meshopt_simplifyWithAttributes(&lod1[0], &ib[0], ib.size(), &vb[0], vertex_count, 12, &attrs[0], 4, &weight1, 1, 0, 1e-2f));
+
+	assert(lod1.size() > expected.size());
+
+	for (size_t i = 0; i < lod1.size(); ++i)
+		assert(lod1[i] < vertex_count);
+}
+
+static void meshletsSpatial()
+{
+	std::vector<float> vb;
+	std::vector<unsigned int> ib;
+	makeGrid(vb, ib, 32);
+
+	size_t vertex_count = vb.size() / 3;
+	size_t face_count = ib.size() / 3;
+
+	const size_t max_vertices = 64;
+	const size_t max_triangles = 126;
+
+	for (int k = 0; k < 2; ++k)
+	{
+		float cone_weight = k == 0 ? 0.f : 0.5f;
+
+		std::vector<meshopt_Meshlet> meshlets(meshopt_buildMeshletsBound(ib.size(), max_vertices, max_triangles));
+		meshlets.resize(meshopt_buildMeshletsSpatial(&meshlets[0], &ib[0], ib.size(), &vb[0], vertex_count, sizeof(float) * 3, max_vertices, max_triangles, cone_weight));
+
+		// every source triangle must be emitted exactly once
+		std::vector<int> emitted(face_count);
+
+		for (size_t i = 0; i < meshlets.size(); ++i)
+		{
+			const meshopt_Meshlet& m = meshlets[i];
+
+			assert(m.vertex_count <= max_vertices);
+			assert(m.triangle_count > 0 && m.triangle_count <= max_triangles);
+
+			for (size_t j = 0; j < m.triangle_count; ++j)
+			{
+				unsigned int a = m.vertices[m.indices[j][0]], b = m.vertices[m.indices[j][1]], c = m.vertices[m.indices[j][2]];
+
+				// meshlet triangles may be rotated but must preserve winding order
+				for (size_t t = 0; t < face_count; ++t)
+				{
+					unsigned int ta = ib[t * 3 + 0], tb = ib[t * 3 + 1], tc = ib[t * 3 + 2];
+
+					if ((a == ta && b == tb && c == tc) || (a == tb && b == tc && c == ta) || (a == tc && b == ta && c == tb))
+						emitted[t]++;
+				}
+			}
+		}
+
+		for (size_t t = 0; t < face_count; ++t)
+			assert(emitted[t] == 1);
+	}
+
+	// empty input produces no meshlets
+	assert(meshopt_buildMeshletsSpatial(0, &ib[0], 0, &vb[0], vertex_count, sizeof(float) * 3, max_vertices, max_triangles, 0.f) == 0);
+}
+
+static void meshletsPacked()
+{
+	std::vector<float> vb;
+	std::vector<unsigned int> ib;
+	makeGrid(vb, ib, 32);
+
+	size_t vertex_count = vb.size() / 3;
+
+	const size_t max_vertices = 64;
+	const size_t max_triangles = 126;
+
+	std::vector<meshopt_Meshlet> expected(meshopt_buildMeshletsBound(ib.size(), max_vertices, max_triangles));
+	expected.resize(meshopt_buildMeshletsSpatial(&expected[0], &ib[0], ib.size(), &vb[0], vertex_count, sizeof(float) * 3, max_vertices, max_triangles, 0.5f));
+
+	size_t max_meshlets = meshopt_buildMeshletsBound(ib.size(), max_vertices, max_triangles);
+	std::vector<meshopt_PackedMeshlet> meshlets(max_meshlets);
+	std::vector<unsigned int> meshlet_vertices(max_meshlets * max_vertices);
+	std::vector<unsigned char> meshlet_triangles(max_meshlets * ((max_triangles * 3 + 3) & ~3));
+
+	meshlets.resize(meshopt_buildMeshletsPacked(&meshlets[0], &meshlet_vertices[0], &meshlet_triangles[0], &ib[0], ib.size(), &vb[0], vertex_count, sizeof(float) * 3, max_vertices, max_triangles, 0.5f));
+
+	// packed output contains the same meshlets as the fixed-size output, stored back to back
+	assert(meshlets.size() == expected.size());
+
+	unsigned int vertex_offset = 0;
+	unsigned int triangle_offset = 0;
+
+	for (size_t i = 0; i < meshlets.size(); ++i)
+	{
+		const meshopt_PackedMeshlet& m = meshlets[i];
+
+		assert(m.vertex_offset == vertex_offset);
+		assert(m.triangle_offset == triangle_offset);
+		assert(m.triangle_offset % 4 == 0);
+
+		assert(m.vertex_count == expected[i].vertex_count);
+		assert(m.triangle_count == expected[i].triangle_count);
+		assert(memcmp(&meshlet_vertices[m.vertex_offset], expected[i].vertices, m.vertex_count * sizeof(unsigned int)) == 0);
+		assert(memcmp(&meshlet_triangles[m.triangle_offset], expected[i].indices, m.triangle_count * 3) == 0);
+
+		vertex_offset += m.vertex_count;
+		triangle_offset += (m.triangle_count * 3 + 3) & ~3;
+	}
+
+	assert(vertex_offset <= meshlet_vertices.size());
+	assert(triangle_offset <= meshlet_triangles.size());
+
+	// packed output supports larger meshlets than the fixed-size structure
+	size_t large_meshlets = meshopt_buildMeshletsBound(ib.size(), 255, 512);
+	meshlets.resize(large_meshlets);
+	meshlet_vertices.resize(large_meshlets * 255);
+	meshlet_triangles.resize(large_meshlets * 512 * 3);
+
+	size_t large_count = meshopt_buildMeshletsPacked(&meshlets[0], &meshlet_vertices[0], &meshlet_triangles[0], &ib[0], ib.size(), &vb[0], vertex_count, sizeof(float) * 3, 255, 512, 0.f);
+	assert(large_count > 0 && large_count < expected.size());
+
+	size_t triangle_count = 0;
+
+	for (size_t i = 0; i < large_count; ++i)
+	{
+		assert(meshlets[i].vertex_count <= 255 && meshlets[i].triangle_count <= 512);
+		triangle_count += meshlets[i].triangle_count;
+	}
+
+	assert(triangle_count == ib.size() / 3);
+}
+
+static void meshletBoundsPacked()
+{
+	std::vector<float> vb;
+	std::vector<unsigned int> ib;
+	makeGrid(vb, ib, 32);
+
+	size_t vertex_count = vb.size() / 3;
+
+	size_t max_meshlets = meshopt_buildMeshletsBound(ib.size(), 255, 512);
+	std::vector<meshopt_PackedMeshlet> meshlets(max_meshlets);
+	std::vector<unsigned int> meshlet_vertices(max_meshlets * 255);
+	std::vector<unsigned char> meshlet_triangles(max_meshlets * 512 * 3);
+
+	meshlets.resize(meshopt_buildMeshletsPacked(&meshlets[0], &meshlet_vertices[0], &meshlet_triangles[0], &ib[0], ib.size(), &vb[0], vertex_count, sizeof(float) * 3, 255, 512, 0.f));
+
+	// batched bounds must match per-cluster bounds, including clusters with more than 256 triangles
+	std::vector<meshopt_Bounds> expected(meshlets.size());
+
+	for (size_t i = 0; i < meshlets.size(); ++i)
+	{
+		const meshopt_PackedMeshlet& m = meshlets[i];
+
+		std::vector<unsigned int> indices(m.triangle_count * 3);
+		for (size_t j = 0; j < indices.size(); ++j)
+			indices[j] = meshlet_vertices[m.vertex_offset + meshlet_triangles[m.triangle_offset + j]];
+
+		expected[i] = meshopt_computeClusterBounds(&indices[0], indices.size(), &vb[0], vertex_count, sizeof(float) * 3);
+	}
+
+	std::vector<meshopt_Bounds> bounds(meshlets.size());
+
+	meshopt_computeMeshletBoundsPacked(&bounds[0], &meshlets[0], meshlets.size(), &meshlet_vertices[0], &meshlet_triangles[0], &vb[0], vertex_count, sizeof(float) * 3, NULL, NULL);
+	assert(memcmp(&bounds[0], &expected[0], bounds.size() * sizeof(meshopt_Bounds)) == 0);
+
+	memset(&bounds[0], 0, bounds.size() * sizeof(meshopt_Bounds));
+
+	meshopt_computeMeshletBoundsPacked(&bounds[0], &meshlets[0], meshlets.size(), &meshlet_vertices[0], &meshlet_triangles[0], &vb[0], vertex_count, sizeof(float) * 3, runTasksReverse, NULL);
+	assert(memcmp(&bounds[0], &expected[0], bounds.size() * sizeof(meshopt_Bounds)) == 0);
+
+	// the whole grid is flat, so its normal cone is a single direction
+	meshopt_Bounds grid = meshopt_computeClusterBounds(&ib[0], ib.size(), &vb[0], vertex_count, sizeof(float) * 3);
+	assert(grid.radius > 0 && grid.cone_cutoff == 0);
+}
+
+static void meshletsEncoded()
+{
+	std::vector<float> vb;
+	std::vector<unsigned int> ib;
+	makeGrid(vb, ib, 32);
+
+	size_t vertex_count = vb.size() / 3;
+
+	// offset and perturb the grid so that positions aren't aligned to the quantization grid
+	for (size_t i = 0; i < vertex_count; ++i)
+	{
+		vb[i * 3 + 0] = vb[i * 3 + 0] * 0.37f - 5.f;
+		vb[i * 3 + 1] = vb[i * 3 + 1] * 0.29f + 3.f;
+		vb[i * 3 + 2] = float(i * 7 % 11) * 0.13f;
+	}
+
+	const size_t max_vertices = 64;
+	const size_t max_triangles = 126;
+	const float grid_step = 1e-3f;
+
+	size_t max_meshlets = meshopt_buildMeshletsBound(ib.size(), max_vertices, max_triangles);
+	std::vector<meshopt_PackedMeshlet> meshlets(max_meshlets);
+	std::vector<unsigned int> meshlet_vertices(max_meshlets * max_vertices);
+	std::vector<unsigned char> meshlet_triangles(max_meshlets * ((max_triangles * 3 + 3) & ~3));
+
+	meshlets.resize(meshopt_buildMeshletsPacked(&meshlets[0], &meshlet_vertices[0], &meshlet_triangles[0], &ib[0], ib.size(), &vb[0], vertex_count, sizeof(float) * 3, max_vertices, max_triangles, 0.5f));
+
+	std::vector<meshopt_EncodedMeshlet> encoded(meshlets.size());
+	std::vector<unsigned int> data(meshopt_encodeMeshletsBound(meshlets.size(), max_vertices, max_triangles));
+
+	size_t data_size = meshopt_encodeMeshlets(&encoded[0], &data[0], data.size(), &meshlets[0], meshlets.size(), &meshlet_vertices[0], &meshlet_triangles[0], &vb[0], vertex_count, sizeof(float) * 3, grid_step);
+	assert(data_size > 0 && data_size <= data.size());
+
+	// compressed representation should be smaller than storing float3 positions and 8-bit indices per meshlet
+	size_t raw_size = 0;
+
+	for (size_t i = 0; i < meshlets.size(); ++i)
+		raw_size += meshlets[i].vertex_count * 12 + meshlets[i].triangle_count * 3;
+
+	assert(data_size * 4 < raw_size * 3 / 4);
+
+	// shared vertices must decode to the same position in every meshlet
+	std::vector<float> decoded_vb(vertex_count * 3);
+	std::vector<bool> decoded_seen(vertex_count);
+
+	for (size_t i = 0; i < meshlets.size(); ++i)
+	{
+		const meshopt_PackedMeshlet& m = meshlets[i];
+		const meshopt_EncodedMeshlet& e = encoded[i];
+
+		assert(e.vertex_count == m.vertex_count && e.triangle_count == m.triangle_count);
+		assert(e.bits[0] <= 24 && e.bits[1] <= 24 && e.bits[2] <= 24 && e.bits[3] == 0);
+
+		float positions[255 * 3];
+		unsigned char triangles[512 * 3];
+		meshopt_decodeMeshlet(positions, triangles, &e, &data[0]);
+
+		assert(memcmp(triangles, &meshlet_triangles[m.triangle_offset], m.triangle_count * 3) == 0);
+
+		for (size_t j = 0; j < m.vertex_count; ++j)
+		{
+			unsigned int v = meshlet_vertices[m.vertex_offset + j];
+
+			for (int k = 0; k < 3; ++k)
+			{
+				float error = positions[j * 3 + k] - vb[v * 3 + k];
+				assert(error <= grid_step * 0.51f && error >= -grid_step * 0.51f);
+			}
+
+			if (decoded_seen[v])
+				assert(memcmp(&decoded_vb[v * 3], &positions[j * 3], sizeof(float) * 3) == 0);
+
+			memcpy(&decoded_vb[v * 3], &positions[j * 3], sizeof(float) * 3);
+			decoded_seen[v] = true;
+		}
+	}
+
+	// insufficient data space is reported as an error
+	assert(meshopt_encodeMeshlets(&encoded[0], &data[0], data_size - 1, &meshlets[0], meshlets.size(), &meshlet_vertices[0], &meshlet_triangles[0], &vb[0], vertex_count, sizeof(float) * 3, grid_step) == 0);
+
+	// grid coordinates that can't be decoded exactly in floating point are reported as an error; x reaches ~5/1e-7 = 5e7 grid steps
+	assert(meshopt_encodeMeshlets(&encoded[0], &data[0], data.size(), &meshlets[0], meshlets.size(), &meshlet_vertices[0], &meshlet_triangles[0], &vb[0], vertex_count, sizeof(float) * 3, 1e-7f) == 0);
+
+	// the same applies when every grid coordinate is in range but a meshlet spans too many grid steps
+	std::vector<float> far_vb = vb;
+	far_vb[meshlet_vertices[0] * 3 + 0] = 1.5e5f;
+	far_vb[meshlet_vertices[1] * 3 + 0] = -1.5e5f;
+
+	assert(meshopt_encodeMeshlets(&encoded[0], &data[0], data.size(), &meshlets[0], meshlets.size(), &meshlet_vertices[0], &meshlet_triangles[0], &far_vb[0], vertex_count, sizeof(float) * 3, 1e-2f) == 0);
+}
+
+static void clusterLod()
+{
+	std::vector<float> vb;
+	std::vector<unsigned int> ib;
+	makeGrid(vb, ib, 64);
+
+	size_t vertex_count = vb.size() / 3;
+
+	// paraboloid height field, so that simplification has non-zero error while the projected area of any watertight cut stays the same
+	for (size_t i = 0; i < vertex_count; ++i)
+		vb[i * 3 + 2] = ((vb[i * 3 + 0] - 32) * (vb[i * 3 + 0] - 32) + (vb[i * 3 + 1] - 32) * (vb[i * 3 + 1] - 32)) * 0.01f;
+
+	const size_t max_vertices = 64;
+	const size_t max_triangles = 124;
+	const size_t group_size = 4;
+
+	size_t max_clusters = meshopt_buildClusterLodBound(ib.size(), max_vertices, max_triangles, group_size);
+	std::vector<meshopt_LodCluster> clusters(max_clusters);
+	std::vector<unsigned int> cluster_vertices(max_clusters * max_vertices);
+	std::vector<unsigned char> cluster_triangles(max_clusters * ((max_triangles * 3 + 3) & ~3));
+	std::vector<unsigned int> cluster_children(max_clusters);
+
+	clusters.resize(meshopt_buildClusterLod(&clusters[0], &cluster_vertices[0], &cluster_triangles[0], &cluster_children[0], &ib[0], ib.size(), &vb[0], vertex_count, sizeof(float) * 3, max_vertices, max_triangles, group_size));
+
+	size_t level0_triangles = 0;
+	unsigned int max_level = 0;
+	size_t roots = 0;
+
+	for (size_t i = 0; i < clusters.size(); ++i)
+	{
+		const meshopt_LodCluster& c = clusters[i];
+
+		assert(c.vertex_count <= max_vertices && c.triangle_count <= max_triangles);
+		assert(c.triangle_offset % 4 == 0);
+
+		level0_triangles += c.level == 0 ? c.triangle_count : 0;
+		max_level = c.level > max_level ? c.level : max_level;
+		roots += c.parent_count == 0;
+
+		assert((c.level == 0) == (c.child_count == 0));
+		assert(c.parent_count == 0 ? c.parent_error == FLT_MAX : c.parent_error < FLT_MAX);
+
+		// children link back to this cluster, and parent data of every child matches the cluster
+		for (size_t j = 0; j < c.child_count; ++j)
+		{
+			const meshopt_LodCluster& child = clusters[cluster_children[c.child_offset + j]];
+
+			assert(child.level < c.level);
+			assert(child.parent_offset <= i && i < child.parent_offset + child.parent_count);
+			assert(child.parent_error == c.error && child.parent_radius == c.radius);
+			assert(child.error <= c.error);
+
+			float dx = child.center[0] - c.center[0], dy = child.center[1] - c.center[1], dz = child.center[2] - c.center[2];
+			assert(sqrtf(dx * dx + dy * dy + dz * dz) + child.radius <= c.radius * 1.001f);
+		}
+	}
+
+	assert(level0_triangles == ib.size() / 3);
+	assert(max_level >= 3);
+	assert(roots > 0 && roots < 8);
+
+	float thresholds[] = {0.f, 1e-3f, 1e-2f, 1e-1f, 1.f, 1e9f};
+
+	for (size_t t = 0; t < sizeof(thresholds) / sizeof(thresholds[0]); ++t)
+	{
+		float threshold = thresholds[t];
+
+		// every cut must be watertight: each edge has a matching opposite edge unless it's on the grid border
+		std::vector<unsigned long long> edges;
+		size_t triangles = 0;
+
+		for (size_t i = 0; i < clusters.size(); ++i)
+		{
+			const meshopt_LodCluster& c = clusters[i];
+
+			if (!(c.error <= threshold && c.parent_error > threshold))
+				continue;
+
+			for (size_t j = 0; j < c.triangle_count * 3; ++j)
+			{
+				unsigned int a = cluster_vertices[c.vertex_offset + cluster_triangles[c.triangle_offset + j]];
+				unsigned int b = cluster_vertices[c.vertex_offset + cluster_triangles[c.triangle_offset + (j % 3 == 2 ? j - 2 : j + 1)]];
+
+				edges.push_back((unsigned long long)(a) << 32 | b);
+			}
+
+			triangles += c.triangle_count;
+		}
+
+		std::sort(edges.begin(), edges.end());
+
+		for (size_t i = 0; i < edges.size(); ++i)
+		{
+			unsigned int a = unsigned(edges[i] >> 32), b = unsigned(edges[i]);
+
+			bool border = (vb[a * 3 + 0] == 0 || vb[a * 3 + 0] == 64 || vb[a * 3 + 1] == 0 || vb[a * 3 + 1] == 64) && (vb[b * 3 + 0] == 0 || vb[b * 3 + 0] == 64 || vb[b * 3 + 1] == 0 || vb[b * 3 + 1] == 64);
+
+			assert(border || std::binary_search(edges.begin(), edges.end(), (unsigned long long)(b) << 32 | a));
+		}
+
+		assert(threshold > 0 || triangles == ib.size() / 3);
+		assert(threshold < 1e9f || triangles < ib.size() / 3 / 16);
+	}
+}
+
+static void simplifySloppyStuck()
+{
+	const float vb[] = {0, 0, 0, 0, 0, 0, 0, 0, 0};
+	const unsigned int ib[] = {0, 1, 2, 0, 1, 2};
+
+	// simplifying down to 0 triangles results in 0 immediately
+	assert(meshopt_simplifySloppy(0, ib, 3, vb, 3, 12, 0, FLT_MAX, NULL) == 0);
+
+	// simplifying down to 2 triangles given that all triangles are degenerate results in 0 as well
+	assert(meshopt_simplifySloppy(0, ib, 6, vb, 3, 12, 6, FLT_MAX, NULL) == 0);
+}
+
+static void simplifySloppyError()
+{
+	std::vector<float> vb;
+	std::vector<unsigned int> ib;
+	makeGrid(vb, ib, 64);
+
+	std::vector<unsigned int> lod(ib.size());
+	float error = -1.f;
+
+	// without an error bound, the result doesn't exceed target index count
+	size_t target = ib.size() / 4 / 3 * 3;
+	size_t count = meshopt_simplifySloppy(&lod[0], &ib[0], ib.size(), &vb[0], vb.size() / 3, 12, target, FLT_MAX, &error);
+	assert(count > 0 && count <= target);
+	assert(error > 0 && error < 1.f);
+
+	// error-driven simplification stops as soon as the error bound is reached
+	float target_errors[] = {0.2f, 0.05f, 0.01f};
+	size_t last_count = 0;
+
+	for (size_t i = 0; i < sizeof(target_errors) / sizeof(target_errors[0]); ++i)
+	{
+		count = meshopt_simplifySloppy(&lod[0], &ib[0], ib.size(), &vb[0], vb.size() / 3, 12, 0, target_errors[i], &error);
+		assert(count > last_count && count <= ib.size());
+		assert(error <= target_errors[i]);
+
+		for (size_t j = 0; j < count; ++j)
+			assert(lod[j] < vb.size() / 3);
+
+		last_count = count;
+	}
+
+	// when the error bound is tighter than the target index count, the result exceeds the target to maintain the error
+	count = meshopt_simplifySloppy(&lod[0], &ib[0], ib.size(), &vb[0], vb.size() / 3, 12, 30, 0.05f, &error);
+	assert(count > 30 && error <= 0.05f);
+
+	// when the target index count is tighter, the error bound doesn't change the result
+	size_t count_bounded = meshopt_simplifySloppy(&lod[0], &ib[0], ib.size(), &vb[0], vb.size() / 3, 12, target, 0.2f, NULL);
+	size_t count_unbounded = meshopt_simplifySloppy(&lod[0], &ib[0], ib.size(), &vb[0], vb.size() / 3, 12, target, FLT_MAX, NULL);
+	assert(count_bounded == count_unbounded);
+
+	// 16-bit indices go through the same code path
+	std::vector<unsigned short> ib16(ib.begin(), ib.end());
+
+	// without an error bound, destination only needs to fit the target index count
+	std::vector<unsigned short> target16(target);
+	size_t count_target16 = meshopt_simplifySloppy(&target16[0], &ib16[0], ib16.size(), &vb[0], vb.size() / 3, 12, target, FLT_MAX, NULL);
+	assert(count_target16 == count_unbounded);
+
+	for (size_t j = 0; j < count_target16; ++j)
+		assert(target16[j] < vb.size() / 3);
+
+	std::vector<unsigned short> lod16(ib.size());
+
+	size_t count16 = meshopt_simplifySloppy(&lod16[0], &ib16[0], ib16.size(), &vb[0], vb.size() / 3, 12, 0, 0.05f, &error);
+	assert(count16 == meshopt_simplifySloppy(&lod[0], &ib[0], ib.size(), &vb[0], vb.size() / 3, 12, 0, 0.05f, NULL));
+
+	for (size_t j = 0; j < count16; ++j)
+		assert(lod16[j] == lod[j]);
+}
+
+static void simplifyPointsStuck()
+{
+	const float vb[] = {0, 0, 0, 0, 0, 0, 0, 0, 0};
+
+	// simplifying down to 0 points results in 0 immediately
+	assert(meshopt_simplifyPoints(0, vb, 3, 12, 0) == 0);
+}
+
+static void remapParallel()
+{
+	// enough vertices to span several hash blocks, with many duplicates
+	const size_t vertex_count = 40002;
+
+	std::vector<float> vb(vertex_count * 3);
+
+	for (size_t i = 0; i < vertex_count; ++i)
+	{
+		vb[i * 3 + 0] = float(i % 1013);
+		vb[i * 3 + 1] = float(i % 7);
+		vb[i * 3 + 2] = 0.f;
+	}
+
+	std::vector<unsigned int> ib(vertex_count / 2 * 3);
+	unsigned int seed = 42;
+
+	for (size_t i = 0; i < ib.size(); ++i)
+	{
+		seed = seed * 1103515245 + 12345;
+		ib[i] = (seed >> 8) % vertex_count;
+	}
+
+	std::vector<unsigned int> expected(vertex_count), serial(vertex_count), reverse(vertex_count);
+
+	// unindexed
+	size_t unique = meshopt_generateVertexRemap(&expected[0], static_cast<unsigned int*>(NULL), vertex_count, &vb[0], vertex_count, sizeof(float) * 3);
+
+	assert(meshopt_generateVertexRemapParallel(&serial[0], static_cast<unsigned int*>(NULL), vertex_count, &vb[0], vertex_count, sizeof(float) * 3, NULL, NULL) == unique);
+	assert(meshopt_generateVertexRemapParallel(&reverse[0], static_cast<unsigned int*>(NULL), vertex_count, &vb[0], vertex_count, sizeof(float) * 3, runTasksReverse, NULL) == unique);
+	assert(serial == expected && reverse == expected);
+
+	// indexed; vertices that aren't referenced should be marked with ~0
+	unique = meshopt_generateVertexRemap(&expected[0], &ib[0], ib.size(), &vb[0], vertex_count, sizeof(float) * 3);
+
+	assert(meshopt_generateVertexRemapParallel(&serial[0], &ib[0], ib.size(), &vb[0], vertex_count, sizeof(float) * 3, NULL, NULL) == unique);
+	assert(meshopt_generateVertexRemapParallel(&reverse[0], &ib[0], ib.size(), &vb[0], vertex_count, sizeof(float) * 3, runTasksReverse, NULL) == unique);
+	assert(serial == expected && reverse == expected);
+
+	// empty input
+	assert(meshopt_generateVertexRemapParallel(&serial[0], static_cast<unsigned int*>(NULL), 0, &vb[0], 0, sizeof(float) * 3, runTasksReverse, NULL) == 0);
+}
+
+static void remapShadow()
+{
+	// 6 floats per vertex: position followed by an attribute; enough vertices to span several hash blocks
+	const size_t vertex_count = 40002;
+
+	std::vector<float> vb(vertex_count * 6);
+
+	for (size_t i = 0; i < vertex_count; ++i)
+	{
+		vb[i * 6 + 0] = float(i % 1013);
+		vb[i * 6 + 1] = float(i % 7);
+		vb[i * 6 + 2] = 0.f;
+		vb[i * 6 + 3] = float(i % 3);
+		vb[i * 6 + 4] = 1.f;
+		vb[i * 6 + 5] = 0.f;
+	}
+
+	std::vector<unsigned int> ib(vertex_count / 2 * 3);
+	unsigned int seed = 42;
+
+	for (size_t i = 0; i < ib.size(); ++i)
+	{
+		seed = seed * 1103515245 + 12345;
+		ib[i] = (seed >> 8) % vertex_count;
+	}
+
+	std::vector<unsigned int> expected(vertex_count), remap(vertex_count), reverse(vertex_count);
+	std::vector<unsigned int> expected_shadow(ib.size()), shadow(ib.size()), shadow_reverse(ib.size());
+
+	size_t unique = meshopt_generateVertexRemap(&expected[0], &ib[0], ib.size(), &vb[0], vertex_count, sizeof(float) * 6);
+	meshopt_generateShadowIndexBuffer(&expected_shadow[0], &ib[0], ib.size(), &vb[0], vertex_count, sizeof(float) * 3, sizeof(float) * 6);
+
+	// both outputs must match the separate calls exactly, regardless of task order
+	assert(meshopt_generateVertexRemapShadow(&remap[0], &shadow[0], &ib[0], ib.size(), &vb[0], vertex_count, sizeof(float) * 6, sizeof(float) * 3, NULL, NULL) == unique);
+	assert(meshopt_generateVertexRemapShadow(&reverse[0], &shadow_reverse[0], &ib[0], ib.size(), &vb[0], vertex_count, sizeof(float) * 6, sizeof(float) * 3, runTasksReverse, NULL) == unique);
+	assert(remap == expected && reverse == expected);
+	assert(shadow == expected_shadow && shadow_reverse == expected_shadow);
+
+	// shadow output can alias indices; 16-bit indices go through the adapter
+	std::vector<unsigned short> ib16(ib.begin(), ib.end());
+
+	assert(meshopt_generateVertexRemapShadow(&remap[0], &ib16[0], &ib16[0], ib16.size(), &vb[0], vertex_count, sizeof(float) * 6, sizeof(float) * 3, runTasksReverse, NULL) == unique);
+	assert(remap == expected);
+	assert(std::equal(ib16.begin(), ib16.end(), expected_shadow.begin()));
+
+	// unindexed; the shadow index buffer references the first vertex with the same position
+	unique = meshopt_generateVertexRemap(&expected[0], static_cast<unsigned int*>(NULL), vertex_count, &vb[0], vertex_count, sizeof(float) * 6);
+
+	std::vector<unsigned int> unindexed_shadow(vertex_count);
+	assert(meshopt_generateVertexRemapShadow(&remap[0], &unindexed_shadow[0], static_cast<unsigned int*>(NULL), vertex_count, &vb[0], vertex_count, sizeof(float) * 6, sizeof(float) * 3, runTasksReverse, NULL) == unique);
+	assert(remap == expected);
+
+	for (size_t i = 0; i < vertex_count; ++i)
+		assert(unindexed_shadow[i] == i % 7091);
+}
+
+static void remapFixedSize()
+{
+	// 4 vertices with 32 bytes each; vertices 0 and 2 are equal, vertex 3 only differs from vertex 1 in the last byte
+	unsigned char vb[4][32] = {};
+
+	for (int i = 0; i < 32; ++i)
+	{
+		vb[0][i] = vb[2][i] = (unsigned char)(i);
+		vb[1][i] = vb[3][i] = (unsigned char)(i * 3);
+	}
+
+	vb[3][31] ^= 1;
+
+	const unsigned int ib[] = {0, 1, 2, 2, 1, 3};
+
+	unsigned int expected[4] = {0, 1, 0, 2};
+	unsigned int remap[4];
+
+	// sizes 24 and 32 use specialized hashers; size 20 and split streams use generic ones
+	assert(meshopt_generateVertexRemap(remap, ib, 6, vb, 4, 32) == 3);
+	assert(memcmp(remap, expected, sizeof(expected)) == 0);
+
+	meshopt_Stream streams[] = {{&vb[0][0], 16, 32}, {&vb[0][16], 16, 32}};
+
+	assert(meshopt_generateVertexRemapMulti(remap, ib, 6, 4, streams, 2) == 3);
+	assert(memcmp(remap, expected, sizeof(expected)) == 0);
+
+	meshopt_Stream prefix[] = {{&vb[0][0], 20, 32}};
+	unsigned int expected_prefix[4] = {0, 1, 0, 1};
+
+	assert(meshopt_generateVertexRemapMulti(remap, ib, 6, 4, prefix, 1) == 2);
+	assert(memcmp(remap, expected_prefix, sizeof(expected_prefix)) == 0);
+
+	prefix[0].size = 24;
+
+	assert(meshopt_generateVertexRemapMulti(remap, ib, 6, 4, prefix, 1) == 2);
+	assert(memcmp(remap, expected_prefix, sizeof(expected_prefix)) == 0);
+
+	unsigned int shadow[6];
+	const unsigned int expected_shadow[] = {0, 1, 0, 0, 1, 3};
+
+	meshopt_generateShadowIndexBuffer(shadow, ib, 6, vb, 4, 32, 32);
+	assert(memcmp(shadow, expected_shadow, sizeof(expected_shadow)) == 0);
+
+	meshopt_generateShadowIndexBufferMulti(shadow, ib, 6, 4, streams, 2);
+	assert(memcmp(shadow, expected_shadow, sizeof(expected_shadow)) == 0);
+}
+
+static void vertexFetchMulti()
+{
+	std::vector<float> vb;
+	std::vector<unsigned int> ib;
+	makeGrid(vb, ib, 16);
+
+	const size_t vertex_count = vb.size() / 3;
+
+	// interleaved 32-byte vertices: 12-byte positions followed by 20 bytes of attributes; the last 2 vertices are unused
+	std::vector<unsigned char> vertices(vertex_count * 32);
+
+	for (size_t i = 0; i < vertices.size(); ++i)
+		vertices[i] = (unsigned char)((i / 32) * 7 + (i % 32) * 13);
+
+	for (size_t i = 0; i < vertex_count; ++i)
+		memcpy(&vertices[i * 32], &vb[i * 3], 12);
+
+	// reverse the triangle order so that the fetch order differs from the original vertex order
+	for (size_t i = 0; i < ib.size() / 2; ++i)
+	{
+		unsigned int t = ib[i];
+		ib[i] = ib[ib.size() - 1 - i];
+		ib[ib.size() - 1 - i] = t;
+	}
+
+	for (size_t i = 0; i < ib.size(); ++i)
+		ib[i] = ib[i] < vertex_count - 2 ? ib[i] : 0;
+
+	std::vector<unsigned int> expected_ib = ib;
+	std::vector<unsigned char> expected(vertex_count * 32);
+	size_t unique = meshopt_optimizeVertexFetch(&expected[0], &expected_ib[0], expected_ib.size(), &vertices[0], vertex_count, 32);
+	assert(unique == vertex_count - 2);
+
+	meshopt_Stream streams[] = {{&vertices[0], 12, 32}, {&vertices[12], 20, 32}};
+
+	std::vector<unsigned char> pos(vertex_count * 12), attr(vertex_count * 20);
+	void* destinations[] = {&pos[0], &attr[0]};
+
+	std::vector<unsigned int> multi_ib = ib;
+	assert(meshopt_optimizeVertexFetchMulti(destinations, &multi_ib[0], multi_ib.size(), vertex_count, streams, 2) == unique);
+	assert(multi_ib == expected_ib);
+
+	for (size_t i = 0; i < unique; ++i)
+	{
+		assert(memcmp(&pos[i * 12], &expected[i * 32], 12) == 0);
+		assert(memcmp(&attr[i * 20], &expected[i * 32 + 12], 20) == 0);
+	}
+
+	// in-place optimization of deinterleaved streams
+	std::vector<unsigned char> place_pos(vertex_count * 12), place_attr(vertex_count * 20);
+
+	for (size_t i = 0; i < vertex_count; ++i)
+	{
+		memcpy(&place_pos[i * 12], &vertices[i * 32], 12);
+		memcpy(&place_attr[i * 20], &vertices[i * 32 + 12], 20);
+	}
+
+	meshopt_Stream place_streams[] = {{&place_pos[0], 12, 12}, {&place_attr[0], 20, 20}};
+	void* place_destinations[] = {&place_pos[0], &place_attr[0]};
+
+	std::vector<unsigned int> place_ib = ib;
+	assert(meshopt_optimizeVertexFetchMulti(place_destinations, &place_ib[0], place_ib.size(), vertex_count, place_streams, 2) == unique);
+	assert(place_ib == expected_ib);
+	assert(memcmp(&place_pos[0], &pos[0], unique * 12) == 0);
+	assert(memcmp(&place_attr[0], &attr[0], unique * 20) == 0);
+
+	// remap with a fetch remap table must match per-stream remapping
+	std::vector<unsigned int> remap(vertex_count);
+	assert(meshopt_optimizeVertexFetchRemap(&remap[0], &ib[0], ib.size(), vertex_count) == unique);
+
+	meshopt_remapVertexBufferMulti(destinations, vertex_count, streams, 2, &remap[0]);
+
+	std::vector<unsigned char> remapped(vertex_count * 32);
+	meshopt_remapVertexBuffer(&remapped[0], &vertices[0], vertex_count, 32, &remap[0]);
+
+	for (size_t i = 0; i < unique; ++i)
+	{
+		assert(memcmp(&pos[i * 12], &remapped[i * 32], 12) == 0);
+		assert(memcmp(&attr[i * 20], &remapped[i * 32 + 12], 20) == 0);
+	}
+}
+
+static void encodeVertexMulti()
+{
+	const size_t vertex_count = 1000;
+
+	// interleaved 32-byte vertices are encoded as two 16-byte streams
+	std::vector<unsigned char> vertices(vertex_count * 32);
+
+	for (size_t i = 0; i < vertices.size(); ++i)
+		vertices[i] = (unsigned char)((i / 32) * (i % 32 + 1));
+
+	meshopt_Stream streams[] = {{&vertices[0], 16, 32}, {&vertices[16], 16, 32}};
+
+	std::vector<unsigned char> buffer(meshopt_encodeVertexBufferMultiBound(vertex_count, streams, 2));
+	assert(buffer.size() == 2 * meshopt_encodeVertexBufferBound(vertex_count, 16));
+
+	size_t sizes[2] = {};
+	size_t total = meshopt_encodeVertexBufferMulti(&buffer[0], buffer.size(), sizes, vertex_count, streams, 2);
+	assert(total > 0 && total == sizes[0] + sizes[1]);
+
+	size_t offset = 0;
+
+	for (size_t k = 0; k < 2; ++k)
+	{
+		// output must match encoding a deinterleaved copy of the stream
+		std::vector<unsigned char> stream(vertex_count * 16);
+
+		for (size_t i = 0; i < vertex_count; ++i)
+			memcpy(&stream[i * 16], &vertices[i * 32 + k * 16], 16);
+
+		std::vector<unsigned char> expected(meshopt_encodeVertexBufferBound(vertex_count, 16));
+		expected.resize(meshopt_encodeVertexBuffer(&expected[0], expected.size(), &stream[0], vertex_count, 16));
+
+		assert(sizes[k] == expected.size());
+		assert(memcmp(&buffer[offset], &expected[0], expected.size()) == 0);
+
+		std::vector<unsigned char> decoded(vertex_count * 16);
+		assert(meshopt_decodeVertexBuffer(&decoded[0], vertex_count, 16, &buffer[offset], sizes[k]) == 0);
+		assert(decoded == stream);
+
+		offset += sizes[k];
+	}
+
+	// the second stream doesn't fit
+	assert(meshopt_encodeVertexBufferMulti(&buffer[0], sizes[0] + sizes[1] - 1, sizes, vertex_count, streams, 2) == 0);
+}
+
+static void vertexCachePartitioned()
+{
+	std::vector<float> vb;
+	std::vector<unsigned int> ib;
+	makeGrid(vb, ib, 32);
+
+	size_t vertex_count = vb.size() / 3;
+
+	// a single partition is equivalent to the regular optimizer
+	std::vector<unsigned int> expected(ib.size()), result(ib.size());
+	meshopt_optimizeVertexCache(&expected[0], &ib[0], ib.size(), vertex_count);
+	meshopt_optimizeVertexCachePartitioned(&result[0], &ib[0], ib.size(), vertex_count, 1, NULL, NULL);
+	assert(result == expected);
+
+	// partitions are optimized independently, so the execution order doesn't affect the result; each partition keeps its own triangles
+	std::vector<unsigned int> reverse(ib.size());
+	meshopt_optimizeVertexCachePartitioned(&result[0], &ib[0], ib.size(), vertex_count, 7, NULL, NULL);
+	meshopt_optimizeVertexCachePartitioned(&reverse[0], &ib[0], ib.size(), vertex_count, 7, runTasksReverse, NULL);
+	assert(result == reverse);
+
+	size_t face_count = ib.size() / 3;
+
+	for (size_t p = 0; p < 7; ++p)
+	{
+		size_t begin = face_count * p / 7 * 3, end = face_count * (p + 1) / 7 * 3;
+
+		std::vector<unsigned int> source(ib.begin() + begin, ib.begin() + end);
+		std::vector<unsigned int> partition(result.begin() + begin, result.begin() + end);
+
+		meshopt_optimizeVertexCache(&source[0], &source[0], source.size(), vertex_count);
+		assert(partition == source);
+	}
+
+	// in-place optimization with more partitions than triangles puts every triangle in its own partition
+	std::vector<unsigned int> inplace(ib.begin(), ib.begin() + 6);
+	meshopt_optimizeVertexCachePartitioned(&inplace[0], &inplace[0], inplace.size(), vertex_count, 10, runTasksReverse, NULL);
+	assert(memcmp(&inplace[0], &ib[0], inplace.size() * sizeof(unsigned int)) == 0);
+}
+
+static unsigned int hashTriangles(const unsigned int* indices, size_t index_count)
+{
+	// order-independent hash of the triangle set
+	unsigned int result = 0;
+
+	for (size_t i = 0; i < index_count; i += 3)
+		result += (indices[i + 0] * 73856093u) ^ (indices[i + 1] * 19349663u) ^ (indices[i + 2] * 83492791u);
+
+	return result;
+}
+
+static void overdrawParallel()
+{
+	std::vector<float> vb;
+	std::vector<unsigned int> ib;
+	makeGrid(vb, ib, 32);
+
+	// add a second, disjoint copy of the grid above the first one so that the optimizer has several patches to sort
+	size_t grid_vertices = vb.size() / 3;
+	size_t grid_indices = ib.size();
+
+	for (size_t i = 0; i < grid_vertices; ++i)
+	{
+		vb.push_back(vb[i * 3 + 0]);
+		vb.push_back(vb[i * 3 + 1]);
+		vb.push_back(vb[i * 3 + 2] + 1.f);
+	}
+
+	for (size_t i = 0; i < grid_indices; ++i)
+		ib.push_back(ib[i] + unsigned(grid_vertices));
+
+	size_t vertex_count = vb.size() / 3;
+
+	meshopt_optimizeVertexCache(&ib[0], &ib[0], ib.size(), vertex_count);
+
+	// the result shouldn't depend on the task execution order
+	std::vector<unsigned int> serial(ib.size()), reverse(ib.size());
+	meshopt_optimizeOverdrawParallel(&serial[0], &ib[0], ib.size(), &vb[0], vertex_count, 12, 1.05f, NULL, NULL);
+	meshopt_optimizeOverdrawParallel(&reverse[0], &ib[0], ib.size(), &vb[0], vertex_count, 12, 1.05f, runTasksReverse, NULL);
+	assert(serial == reverse);
+
+	// triangles are reordered but otherwise preserved
+	assert(hashTriangles(&serial[0], serial.size()) == hashTriangles(&ib[0], ib.size()));
+
+	std::vector<unsigned int> inplace(ib);
+	meshopt_optimizeOverdrawParallel(&inplace[0], &inplace[0], inplace.size(), &vb[0], vertex_count, 12, 1.05f, runTasksReverse, NULL);
+	assert(inplace == serial);
+
+	std::vector<unsigned short> ib16(ib.begin(), ib.end()), result16(ib.size());
+	meshopt_optimizeOverdrawParallel(&result16[0], &ib16[0], ib16.size(), &vb[0], vertex_count, 12, 1.05f, runTasksReverse, NULL);
+
+	for (size_t i = 0; i < ib.size(); ++i)
+		assert(result16[i] == serial[i]);
+
+	// overdraw should be similar to the serial optimizer
+	std::vector<unsigned int> expected(ib.size());
+	meshopt_optimizeOverdraw(&expected[0], &ib[0], ib.size(), &vb[0], vertex_count, 12, 1.05f);
+
+	meshopt_OverdrawStatistics os = meshopt_analyzeOverdraw(&serial[0], serial.size(), &vb[0], vertex_count, 12);
+	meshopt_OverdrawStatistics oe = meshopt_analyzeOverdraw(&expected[0], expected.size(), &vb[0], vertex_count, 12);
+	assert(os.overdraw <= oe.overdraw * 1.01f);
+}
+
+static void optimizeRange()
+{
+	std::vector<float> vb;
+	std::vector<unsigned int> ib;
+	makeGrid(vb, ib, 32);
+
+	size_t vertex_count = vb.size() / 3;
+
+	meshopt_optimizeVertexCache(&ib[0], &ib[0], ib.size(), vertex_count);
+
+	// optimizing the entire buffer as a range is equivalent to the regular optimizers
+	std::vector<unsigned int> expected(ib.size()), result(ib);
+	meshopt_optimizeVertexCache(&expected[0], &ib[0], ib.size(), vertex_count);
+	meshopt_optimizeVertexCacheRange(&result[0], result.size(), vertex_count, 0, result.size());
+	assert(result == expected);
+
+	meshopt_optimizeOverdraw(&expected[0], &ib[0], ib.size(), &vb[0], vertex_count, 12, 1.05f);
+	result = ib;
+	meshopt_optimizeOverdrawRange(&result[0], result.size(), &vb[0], vertex_count, 12, 0, result.size(), 1.05f);
+	assert(result == expected);
+
+	ib = expected;
+	meshopt_optimizeVertexFetch(&vb[0], &ib[0], ib.size(), &vb[0], vertex_count, 12);
+
+	// simulate an edit: triangles in the range are shuffled and use new copies of their vertices that are appended to the vertex buffer
+	size_t range_offset = 300 * 3, range_count = 400 * 3;
+
+	std::vector<unsigned int> edited(ib);
+	unsigned int seed = 42;
+
+	for (size_t i = range_count / 3 - 1; i > 0; --i)
+	{
+		seed = seed * 1103515245 + 12345;
+		size_t j = (seed >> 16) % (i + 1);
+
+		for (size_t k = 0; k < 3; ++k)
+			std::swap(edited[range_offset + i * 3 + k], edited[range_offset + j * 3 + k]);
+	}
+
+	// when the range shares vertices with the preceding triangles, the optimizer continues from the cache state they leave behind
+	result = edited;
+	meshopt_optimizeVertexCacheRange(&result[0], result.size(), vertex_count, range_offset, range_count);
+
+	bool shared = false;
+
+	for (size_t i = range_offset - 3; i < range_offset; ++i)
+		for (size_t k = 0; k < 3; ++k)
+			shared |= result[i] == result[range_offset + k];
+
+	assert(shared);
+
+	std::vector<unsigned int> copies(vertex_count, ~0u), sources;
+
+	for (size_t i = range_offset; i < range_offset + range_count; ++i)
+		if (copies[edited[i]] == ~0u)
+		{
+			copies[edited[i]] = unsigned(sources.size());
+			sources.push_back(edited[i]);
+		}
+
+	// copies are added in the reverse order of first use so that the vertex order of the edit isn't optimal
+	for (size_t i = sources.size(); i > 0; --i)
+	{
+		float p[3] = {vb[sources[i - 1] * 3 + 0], vb[sources[i - 1] * 3 + 1], vb[sources[i - 1] * 3 + 2]};
+		vb.insert(vb.end(), p, p + 3);
+	}
+
+	for (size_t i = range_offset; i < range_offset + range_count; ++i)
+		edited[i] = unsigned(vertex_count + sources.size() - 1 - copies[edited[i]]);
+
+	// add a vertex that isn't referenced by the edit
+	vb.push_back(-1.f);
+	vb.push_back(-1.f);
+	vb.push_back(-1.f);
+
+	size_t edit_vertex_count = vb.size() / 3;
+
+	result = edited;
+	meshopt_optimizeVertexCacheRange(&result[0], result.size(), edit_vertex_count, range_offset, range_count);
+	meshopt_optimizeOverdrawRange(&result[0], result.size(), &vb[0], edit_vertex_count, 12, range_offset, range_count, 1.05f);
+
+	// triangles outside of the range are not affected, and triangles inside the range are reordered but otherwise preserved
+	assert(memcmp(&result[0], &edited[0], range_offset * sizeof(unsigned int)) == 0);
+	assert(memcmp(&result[range_offset + range_count], &edited[range_offset + range_count], (edited.size() - range_offset - range_count) * sizeof(unsigned int)) == 0);
+	assert(hashTriangles(&result[range_offset], range_count) == hashTriangles(&edited[range_offset], range_count));
+
+	// the efficiency of the range should be close to the efficiency of the entire mesh after full optimization
+	std::vector<unsigned int> full(edited.size());
+	meshopt_optimizeVertexCache(&full[0], &edited[0], edited.size(), edit_vertex_count);
+
+	meshopt_VertexCacheStatistics vse = meshopt_analyzeVertexCache(&edited[range_offset], range_count, edit_vertex_count, 16, 0, 0);
+	meshopt_VertexCacheStatistics vsr = meshopt_analyzeVertexCache(&result[range_offset], range_count, edit_vertex_count, 16, 0, 0);
+	meshopt_VertexCacheStatistics vsf = meshopt_analyzeVertexCache(&full[0], full.size(), edit_vertex_count, 16, 0, 0);
+	assert(vsr.acmr < vse.acmr * 0.75f);
+	assert(vsr.acmr < vsf.acmr * 1.1f);
+
+	std::vector<unsigned short> result16(edited.begin(), edited.end());
+	meshopt_optimizeVertexCacheRange(&result16[0], result16.size(), edit_vertex_count, range_offset, range_count);
+	meshopt_optimizeOverdrawRange(&result16[0], result16.size(), &vb[0], edit_vertex_count, 12, range_offset, range_count, 1.05f);
+
+	for (size_t i = 0; i < result.size(); ++i)
+		assert(result16[i] == result[i]);
+
+	std::vector<float> positions;
+
+	for (size_t i = 0; i < result.size(); ++i)
+		positions.insert(positions.end(), &vb[result[i] * 3], &vb[result[i] * 3] + 3);
+
+	// new vertices are reordered in the order of first use by the range; unused vertices are moved to the end and other vertices keep their place
+	size_t used = meshopt_optimizeVertexFetchRange(&vb[0], &result[range_offset], range_count, 12, vertex_count, edit_vertex_count - vertex_count);
+	assert(used == sources.size());
+	assert(vb[(edit_vertex_count - 1) * 3] == -1.f);
+
+	size_t next_vertex = vertex_count;
+
+	for (size_t i = range_offset; i < range_offset + range_count; ++i)
+	{
+		assert(result[i] <= next_vertex);
+		next_vertex += result[i] == next_vertex;
+	}
+
+	assert(next_vertex == vertex_count + used);
+
+	assert(memcmp(&result[0], &edited[0], range_offset * sizeof(unsigned int)) == 0);
+
+	for (size_t i = 0; i < result.size(); ++i)
+		assert(memcmp(&vb[result[i] * 3], &positions[i * 3], 3 * sizeof(float)) == 0);
+}
+
+static void vertexCacheProfiles()
+{
+	std::vector<float> vb;
+	std::vector<unsigned int> ib;
+	makeGrid(vb, ib, 16);
+
+	size_t vertex_count = vb.size() / 3;
+
+	// scramble the triangle order; grid order is close to optimal for large caches
+	std::vector<unsigned int> grid(ib);
+	size_t triangle_count = ib.size() / 3;
+
+	for (size_t i = 0; i < triangle_count; ++i)
+	{
+		size_t j = (i * 7919) % triangle_count;
+
+		ib[i * 3 + 0] = grid[j * 3 + 0];
+		ib[i * 3 + 1] = grid[j * 3 + 1];
+		ib[i * 3 + 2] = grid[j * 3 + 2];
+	}
+
+	std::vector<unsigned int> expected(ib.size()), result(ib.size());
+	meshopt_optimizeVertexCache(&expected[0], &ib[0], ib.size(), vertex_count);
+
+	// generic profile matches the default optimizer
+	meshopt_optimizeVertexCacheProfile(&result[0], &ib[0], ib.size(), vertex_count, meshopt_VertexCacheGeneric);
+	assert(result == expected);
+
+	meshopt_VertexScoreTable table = {};
+	meshopt_getVertexScoreTable(&table, meshopt_VertexCacheGeneric);
+
+	meshopt_optimizeVertexCacheTable(&result[0], &ib[0], ib.size(), vertex_count, &table);
+	assert(result == expected);
+
+	// analyzer profiles match the documented parameters
+	meshopt_VertexCacheStatistics vcs = meshopt_analyzeVertexCacheProfile(&expected[0], expected.size(), vertex_count, meshopt_VertexCacheAmd);
+	meshopt_VertexCacheStatistics vce = meshopt_analyzeVertexCache(&expected[0], expected.size(), vertex_count, 14, 64, 128);
+	assert(vcs.vertices_transformed == vce.vertices_transformed && vcs.warps_executed == vce.warps_executed);
+
+	const meshopt_VertexCacheProfile profiles[] = {meshopt_VertexCacheNvidia, meshopt_VertexCacheAmd, meshopt_VertexCacheIntel, meshopt_VertexCacheApple, meshopt_VertexCacheMobile};
+
+	for (size_t i = 0; i < sizeof(profiles) / sizeof(profiles[0]); ++i)
+	{
+		meshopt_optimizeVertexCacheProfile(&result[0], &ib[0], ib.size(), vertex_count, profiles[i]);
+		assert(hashTriangles(&result[0], result.size()) == hashTriangles(&ib[0], ib.size()));
+
+		// each profile should do better than the original order on its own cache model
+		meshopt_VertexCacheStatistics vco = meshopt_analyzeVertexCacheProfile(&ib[0], ib.size(), vertex_count, profiles[i]);
+		meshopt_VertexCacheStatistics vcr = meshopt_analyzeVertexCacheProfile(&result[0], result.size(), vertex_count, profiles[i]);
+		assert(vcr.vertices_transformed < vco.vertices_transformed);
+	}
+
+	// custom tables can be used as well
+	meshopt_VertexScoreTable custom = {};
+	for (size_t i = 0; i < 17; ++i)
+		custom.cache[i] = float(i);
+	for (size_t i = 1; i < 9; ++i)
+		custom.live[i] = 1.f / float(i);
+
+	std::vector<unsigned short> ib16(ib.begin(), ib.end()), result16(ib.size());
+	meshopt_optimizeVertexCacheTable(&result16[0], &ib16[0], ib16.size(), vertex_count, &custom);
+	meshopt_optimizeVertexCacheTable(&result[0], &ib[0], ib.size(), vertex_count, &custom);
+
+	for (size_t i = 0; i < ib.size(); ++i)
+		assert(result16[i] == result[i]);
+}
+
+static void analyzeVertexFetchMulti()
+{
+	std::vector<float> vb;
+	std::vector<unsigned int> ib;
+	makeGrid(vb, ib, 64);
+
+	size_t vertex_count = vb.size() / 3;
+
+	// shuffle triangles to get a meaningful amount of cache misses
+	unsigned int seed = 42;
+
+	for (size_t i = ib.size() / 3; i > 1; --i)
+	{
+		seed = seed * 1103515245 + 12345;
+		size_t j = (seed >> 8) % i;
+
+		for (int k = 0; k < 3; ++k)
+		{
+			unsigned int t = ib[(i - 1) * 3 + k];
+			ib[(i - 1) * 3 + k] = ib[j * 3 + k];
+			ib[j * 3 + k] = t;
+		}
+	}
+
+	// interleaved vertex with position, normal and uv, and the same data split into separate streams
+	std::vector<float> interleaved(vertex_count * 8);
+	std::vector<float> nrm(vertex_count * 3), uv(vertex_count * 2);
+
+	for (size_t i = 0; i < vertex_count; ++i)
+	{
+		memcpy(&interleaved[i * 8], &vb[i * 3], sizeof(float) * 3);
+		interleaved[i * 8 + 5] = nrm[i * 3 + 2] = 1.f;
+		interleaved[i * 8 + 6] = uv[i * 2 + 0] = vb[i * 3 + 0] / 64;
+		interleaved[i * 8 + 7] = uv[i * 2 + 1] = vb[i * 3 + 1] / 64;
+	}
+
+	// single stream with the default cache model matches meshopt_analyzeVertexFetch
+	meshopt_Stream pos_stream = {&vb[0], sizeof(float) * 3, sizeof(float) * 3};
+
+	meshopt_VertexFetchStatistics expected = meshopt_analyzeVertexFetch(&ib[0], ib.size(), vertex_count, sizeof(float) * 3);
+	meshopt_VertexFetchStatistics actual = meshopt_analyzeVertexFetchMulti(NULL, &ib[0], ib.size(), vertex_count, &pos_stream, 1, 64, 128 * 1024, 1);
+
+	assert(actual.bytes_fetched == expected.bytes_fetched && actual.overfetch == expected.overfetch);
+
+	// streams pointing into an interleaved buffer share cache lines, regardless of the stream order
+	meshopt_Stream interleaved_streams[] = {
+	    {&interleaved[3], sizeof(float) * 3, sizeof(float) * 8},
+	    {&interleaved[0], sizeof(float) * 3, sizeof(float) * 8},
+	    {&interleaved[6], sizeof(float) * 2, sizeof(float) * 8},
+	};
+
+	unsigned int interleaved_bytes[3] = {};
+
+	expected = meshopt_analyzeVertexFetch(&ib[0], ib.size(), vertex_count, sizeof(float) * 8);
+	actual = meshopt_analyzeVertexFetchMulti(interleaved_bytes, &ib[0], ib.size(), vertex_count, interleaved_streams, 3, 64, 128 * 1024, 1);
+
+	assert(actual.bytes_fetched == expected.bytes_fetched && actual.overfetch == expected.overfetch);
+	assert(interleaved_bytes[0] + interleaved_bytes[1] + interleaved_bytes[2] == actual.bytes_fetched);
+
+	// deinterleaved streams are fetched separately; with a small cache each stream misses independently
+	meshopt_Stream deinterleaved_streams[] = {
+	    {&vb[0], sizeof(float) * 3, sizeof(float) * 3},
+	    {&nrm[0], sizeof(float) * 3, sizeof(float) * 3},
+	    {&uv[0], sizeof(float) * 2, sizeof(float) * 2},
+	};
+
+	unsigned int deinterleaved_bytes[3] = {};
+
+	actual = meshopt_analyzeVertexFetchMulti(deinterleaved_bytes, &ib[0], ib.size(), vertex_count, deinterleaved_streams, 3, 32, 4096, 4);
+
+	assert(deinterleaved_bytes[0] + deinterleaved_bytes[1] + deinterleaved_bytes[2] == actual.bytes_fetched);
+	assert(deinterleaved_bytes[0] >= (vertex_count * 12 + 31) / 32 * 32);
+	assert(deinterleaved_bytes[1] >= (vertex_count * 12 + 31) / 32 * 32);
+	assert(deinterleaved_bytes[2] >= (vertex_count * 8 + 31) / 32 * 32);
+	assert(actual.overfetch >= 1);
+
+	// fully associative LRU caches never fetch more when they get larger
+	unsigned int last_bytes = ~0u;
+
+	for (unsigned int cache_size = 1024; cache_size <= 256 * 1024; cache_size *= 4)
+	{
+		actual = meshopt_analyzeVertexFetchMulti(NULL, &ib[0], ib.size(), vertex_count, deinterleaved_streams, 3, 64, cache_size, cache_size / 64);
+
+		assert(actual.bytes_fetched <= last_bytes);
+		last_bytes = actual.bytes_fetched;
+	}
+
+	// a cache that fits all streams fetches every line exactly once
+	assert(last_bytes == ((vertex_count * 12 + 63) / 64 * 2 + (vertex_count * 8 + 63) / 64) * 64);
+}
+
+static void analyzeOverdrawParallel()
+{
+	std::vector<float> vb;
+	std::vector<unsigned int> ib;
+	makeGrid(vb, ib, 16);
+
+	// add a tilted copy of the grid in front of the first one so that some pixels are shaded several times
+	size_t grid_vertices = vb.size() / 3;
+	size_t grid_indices = ib.size();
+
+	for (size_t i = 0; i < grid_vertices; ++i)
+	{
+		vb.push_back(vb[i * 3 + 0] + 0.5f);
+		vb.push_back(vb[i * 3 + 1]);
+		vb.push_back(vb[i * 3 + 2] + 1.f + vb[i * 3 + 0] * 0.1f);
+	}
+
+	for (size_t i = 0; i < grid_indices; ++i)
+		ib.push_back(ib[i] + unsigned(grid_vertices));
+
+	size_t vertex_count = vb.size() / 3;
+
+	meshopt_OverdrawStatistics expected = meshopt_analyzeOverdraw(&ib[0], ib.size(), &vb[0], vertex_count, 12);
+
+	// default settings cover the same pixels as meshopt_analyzeOverdraw
+	meshopt_OverdrawStatistics serial = meshopt_analyzeOverdrawParallel(&ib[0], ib.size(), &vb[0], vertex_count, 12, 256, 3, NULL, NULL);
+	assert(serial.pixels_covered == expected.pixels_covered);
+	assert(serial.pixels_shaded >= expected.pixels_shaded * 0.99f && serial.pixels_shaded <= expected.pixels_shaded * 1.01f);
+	assert(serial.overdraw > 1.f);
+
+	// the result shouldn't depend on the task execution order
+	meshopt_OverdrawStatistics reverse = meshopt_analyzeOverdrawParallel(&ib[0], ib.size(), &vb[0], vertex_count, 12, 256, 3, runTasksReverse, NULL);
+	assert(reverse.pixels_covered == serial.pixels_covered && reverse.pixels_shaded == serial.pixels_shaded);
+
+	std::vector<unsigned short> ib16(ib.begin(), ib.end());
+	meshopt_OverdrawStatistics result16 = meshopt_analyzeOverdrawParallel(&ib16[0], ib16.size(), &vb[0], vertex_count, 12, 256, 3, runTasksReverse, NULL);
+	assert(result16.pixels_covered == serial.pixels_covered && result16.pixels_shaded == serial.pixels_shaded);
+
+	// viewport sizes that aren't a multiple of the band count or SIMD width and extra views are supported as well
+	meshopt_OverdrawStatistics custom = meshopt_analyzeOverdrawParallel(&ib[0], ib.size(), &vb[0], vertex_count, 12, 101, 7, NULL, NULL);
+	meshopt_OverdrawStatistics customr = meshopt_analyzeOverdrawParallel(&ib[0], ib.size(), &vb[0], vertex_count, 12, 101, 7, runTasksReverse, NULL);
+	assert(custom.pixels_covered == customr.pixels_covered && custom.pixels_shaded == customr.pixels_shaded);
+	assert(custom.pixels_covered > 0 && custom.overdraw >= 1.f);
+
+	// a single view only covers a subset of the pixels
+	meshopt_OverdrawStatistics single = meshopt_analyzeOverdrawParallel(&ib[0], ib.size(), &vb[0], vertex_count, 12, 256, 1, NULL, NULL);
+	assert(single.pixels_covered < serial.pixels_covered);
+}
+
+static void spatialSortParallel()
+{
+	// a cluster of points near the origin that 30-bit keys don't distinguish, and a far away outlier
+	const size_t vertex_count = 100000;
+
+	std::vector<float> vb(vertex_count * 3);
+
+	for (size_t i = 0; i < vertex_count - 1; ++i)
+	{
+		vb[i * 3 + 0] = float(vertex_count - i) * 1e-8f;
+		vb[i * 3 + 1] = float(i % 3) * 1e-6f;
+		vb[i * 3 + 2] = 0.f;
+	}
+
+	vb[(vertex_count - 1) * 3 + 0] = 1.f;
+
+	std::vector<unsigned int> remap(vertex_count), reverse(vertex_count);
+	std::vector<unsigned int> chunks(meshopt_spatialSortChunkBound(vertex_count, 1000) + 1), chunks_reverse(chunks.size());
+
+	size_t chunk_count = meshopt_spatialSortRemapParallel(&remap[0], &chunks[0], 1000, &vb[0], vertex_count, sizeof(float) * 3, NULL, NULL);
+	assert(meshopt_spatialSortRemapParallel(&reverse[0], &chunks_reverse[0], 1000, &vb[0], vertex_count, sizeof(float) * 3, runTasksReverse, NULL) == chunk_count);
+	assert(remap == reverse && chunks == chunks_reverse);
+
+	// remap must be a permutation
+	std::vector<unsigned char> seen(vertex_count);
+
+	for (size_t i = 0; i < vertex_count; ++i)
+	{
+		assert(remap[i] < vertex_count && !seen[remap[i]]);
+		seen[remap[i]] = 1;
+	}
+
+	// points in the cluster are stored in decreasing x order, but 63-bit keys make the far corner of the cluster sort last
+	assert(remap[vertex_count - 1] == vertex_count - 1);
+	assert(remap[vertex_count - 2] < remap[0]);
+
+	// chunks cover the entire range and respect the size limit; adjacent chunks can't be merged
+	assert(chunk_count >= vertex_count / 1000 && chunk_count <= meshopt_spatialSortChunkBound(vertex_count, 1000));
+	assert(chunks[0] == 0 && chunks[chunk_count] == vertex_count);
+
+	for (size_t i = 0; i < chunk_count; ++i)
+	{
+		assert(chunks[i] < chunks[i + 1] && chunks[i + 1] - chunks[i] <= 1000);
+		assert(i + 1 == chunk_count || chunks[i + 2] - chunks[i] > 1000);
+	}
+
+	// without chunk output the remap is the same
+	assert(meshopt_spatialSortRemapParallel(&reverse[0], NULL, 0, &vb[0], vertex_count, sizeof(float) * 3, NULL, NULL) == 0);
+	assert(remap == reverse);
+}
+
+static void sortCanonicalTriangles(std::vector<unsigned long long>& result, const unsigned int* indices, size_t index_count)
+{
+	result.clear();
+
+	for (size_t i = 0; i < index_count; i += 3)
+	{
+		unsigned int a = indices[i + 0], b = indices[i + 1], c = indices[i + 2];
+
+		// rotate the triangle so that the smallest index comes first; this preserves winding
+		while (a > b || a > c)
+		{
+			unsigned int t = a;
+			a = b, b = c, c = t;
+		}
+
+		result.push_back((static_cast<unsigned long long>(a) << 42) | (static_cast<unsigned long long>(b) << 21) | c);
+	}
+
+	std::sort(result.begin(), result.end());
+}
+
+static void stripifyParallel()
+{
+	std::vector<float> vb;
+	std::vector<unsigned int> ib;
+	makeGrid(vb, ib, 64);
+
+	size_t vertex_count = vb.size() / 3;
+
+	std::vector<unsigned long long> expected, actual;
+	sortCanonicalTriangles(expected, &ib[0], ib.size());
+
+	const unsigned int restart_indices[] = {~0u, 0};
+	const size_t chunk_sizes[] = {1, 7, 1000, ib.size() / 3};
+
+	for (size_t r = 0; r < sizeof(restart_indices) / sizeof(restart_indices[0]); ++r)
+		for (size_t c = 0; c < sizeof(chunk_sizes) / sizeof(chunk_sizes[0]); ++c)
+		{
+			unsigned int restart_index = restart_indices[r];
+			size_t chunk_size = chunk_sizes[c];
+
+			std::vector<unsigned int> strip(meshopt_stripifyParallelBound(ib.size(), chunk_size));
+			std::vector<unsigned int> reverse(strip.size());
+
+			size_t strip_size = meshopt_stripifyParallel(&strip[0], &ib[0], ib.size(), vertex_count, restart_index, chunk_size, NULL, NULL);
+			assert(meshopt_stripifyParallel(&reverse[0], &ib[0], ib.size(), vertex_count, restart_index, chunk_size, runTasksReverse, NULL) == strip_size);
+			assert(strip_size <= strip.size());
+			assert(std::equal(strip.begin(), strip.begin() + strip_size, reverse.begin()));
+
+			// the strip must contain exactly the same triangles with the same winding
+			std::vector<unsigned int> list(meshopt_unstripifyBound(strip_size));
+			list.resize(meshopt_unstripify(&list[0], &strip[0], strip_size, restart_index));
+
+			sortCanonicalTriangles(actual, &list[0], list.size());
+			assert(actual == expected);
+
+			// without chunking, strips should be as efficient as the ones from the windowed stripifier
+			if (chunk_size == ib.size() / 3)
+			{
+				std::vector<unsigned int> serial(meshopt_stripifyBound(ib.size()));
+				size_t serial_size = meshopt_stripify(&serial[0], &ib[0], ib.size(), vertex_count, restart_index);
+
+				assert(strip_size <= serial_size);
+			}
+		}
+
+	// empty input
+	unsigned int dummy = 0;
+	assert(meshopt_stripifyParallel(&dummy, &ib[0], 0, vertex_count, ~0u, 100, runTasksReverse, NULL) == 0);
+}
+
+static void simplifySloppyStream()
+{
+	std::vector<float> vb;
+	std::vector<unsigned int> ib;
+	makeGrid(vb, ib, 32);
+
+	size_t vertex_count = vb.size() / 3;
+
+	const float box_min[3] = {0, 0, 0};
+	const float box_max[3] = {32, 32, 0};
+
+	meshopt_SloppyStream* stream = meshopt_createSloppyStream(box_min, box_max, 9, 1000, 1000);
+
+	// stream the mesh in two batches; the second half of the batch is also streamed twice to make sure duplicate triangles are removed
+	size_t half = ib.size() / 6 * 3;
+
+	assert(meshopt_sloppyStreamAddTriangles(stream, &ib[0], half, &vb[0], vertex_count, sizeof(float) * 3) == 0);
+	assert(meshopt_sloppyStreamAddTriangles(stream, &ib[half], ib.size() - half, &vb[0], vertex_count, sizeof(float) * 3) == 0);
+
+	size_t index_count = meshopt_sloppyStreamGetIndices(stream, NULL);
+
+	assert(meshopt_sloppyStreamAddTriangles(stream, &ib[half], ib.size() - half, &vb[0], vertex_count, sizeof(float) * 3) == 0);
+	assert(meshopt_sloppyStreamGetIndices(stream, NULL) == index_count);
+
+	// 9x9 cells produce 8x8 quads
+	size_t result_vertices = meshopt_sloppyStreamGetVertices(stream, NULL);
+	assert(result_vertices == 81);
+	assert(index_count == 8 * 8 * 6);
+
+	std::vector<float> rvb(result_vertices * 3);
+	std::vector<unsigned int> rib(index_count);
+
+	assert(meshopt_sloppyStreamGetVertices(stream, &rvb[0]) == result_vertices);
+	assert(meshopt_sloppyStreamGetIndices(stream, &rib[0]) == index_count);
+
+	// vertices stay on the plane and within the bounds
+	for (size_t i = 0; i < result_vertices; ++i)
+	{
+		assert(rvb[i * 3 + 0] >= 0 && rvb[i * 3 + 0] <= 32);
+		assert(rvb[i * 3 + 1] >= 0 && rvb[i * 3 + 1] <= 32);
+		assert(rvb[i * 3 + 2] > -1e-3f && rvb[i * 3 + 2] < 1e-3f);
+	}
+
+	for (size_t i = 0; i < index_count; ++i)
+		assert(rib[i] < result_vertices);
+
+	meshopt_destroySloppyStream(stream);
+
+	// points in the same cell are merged into their mean
+	const float pb[] = {0, 0, 0, 1, 0, 0, 0, 1, 0, 1, 1, 1, 10, 10, 10};
+	const float pmin[3] = {0, 0, 0};
+	const float pmax[3] = {10, 10, 10};
+
+	stream = meshopt_createSloppyStream(pmin, pmax, 2, 2, 0);
+
+	assert(meshopt_sloppyStreamAddPoints(stream, pb, 2, sizeof(float) * 3) == 0);
+	assert(meshopt_sloppyStreamAddPoints(stream, pb + 6, 3, sizeof(float) * 3) == 0);
+
+	float points[6];
+	assert(meshopt_sloppyStreamGetVertices(stream, points) == 2);
+	assert(meshopt_sloppyStreamGetIndices(stream, NULL) == 0);
+
+	assert(points[0] == 0.5f && points[1] == 0.5f && points[2] == 0.25f);
+	assert(points[3] == 10 && points[4] == 10 && points[5] == 10);
+
+	meshopt_destroySloppyStream(stream);
+
+	// exceeding capacity puts the stream into an error state
+	stream = meshopt_createSloppyStream(pmin, pmax, 2, 1, 0);
+
+	assert(meshopt_sloppyStreamAddPoints(stream, pb, 5, sizeof(float) * 3) == -1);
+	assert(meshopt_sloppyStreamAddPoints(stream, pb, 1, sizeof(float) * 3) == -1);
+	assert(meshopt_sloppyStreamGetVertices(stream, NULL) == 0);
+
+	meshopt_destroySloppyStream(stream);
+
+	// cell means stay precise for large point counts far away from the origin
+	std::vector<float> far(1024 * 3);
+
+	for (size_t i = 0; i < 1024; ++i)
+		far[i * 3 + 0] = far[i * 3 + 1] = far[i * 3 + 2] = (i & 1) ? 1000.7f : 1000.1f;
+
+	const float fmin[3] = {1000, 1000, 1000};
+	const float fmax[3] = {1001, 1001, 1001};
+
+	stream = meshopt_createSloppyStream(fmin, fmax, 1, 1, 0);
+
+	for (size_t i = 0; i < 4096; ++i)
+		assert(meshopt_sloppyStreamAddPoints(stream, &far[0], 1024, sizeof(float) * 3) == 0);
+
+	assert(meshopt_sloppyStreamGetVertices(stream, points) == 1);
+	assert(fabsf(points[0] - 1000.4f) < 1e-3f && fabsf(points[1] - 1000.4f) < 1e-3f && fabsf(points[2] - 1000.4f) < 1e-3f);
+
+	meshopt_destroySloppyStream(stream);
+
+	// cell quadrics stay precise for large triangle counts; along every axis, a large and a small plane pull the cell position in different directions
+	const float sizes[2] = {0.1f, 0.01f};
+	const float planes[2] = {1000.2f, 1000.45f};
+
+	std::vector<float> fvb;
+
+	for (int k = 0; k < 3; ++k)
+		for (int j = 0; j < 2; ++j)
+		{
+			// triangle in the plane orthogonal to axis k, centered on the other axes
+			const float offsets[3][2] = {{-1, -1}, {2, -1}, {-1, 2}};
+
+			for (int v = 0; v < 3; ++v)
+			{
+				float p[3] = {1000.3f, 1000.6f, 1000.7f};
+				p[k] = planes[j];
+				p[(k + 1) % 3] += offsets[v][0] * sizes[j];
+				p[(k + 2) % 3] += offsets[v][1] * sizes[j];
+
+				fvb.insert(fvb.end(), p, p + 3);
+			}
+		}
+
+	std::vector<unsigned int> fib(1026);
+
+	for (size_t i = 0; i < fib.size(); ++i)
+		fib[i] = unsigned(i % 18);
+
+	float expected[3];
+
+	stream = meshopt_createSloppyStream(fmin, fmax, 1, 1, 1);
+	assert(meshopt_sloppyStreamAddTriangles(stream, &fib[0], fib.size(), &fvb[0], 18, sizeof(float) * 3) == 0);
+	assert(meshopt_sloppyStreamGetVertices(stream, expected) == 1);
+	meshopt_destroySloppyStream(stream);
+
+	// streaming the same batch many times scales all quadrics uniformly, which shouldn't change the cell position
+	stream = meshopt_createSloppyStream(fmin, fmax, 1, 1, 1);
+
+	for (size_t i = 0; i < 4096; ++i)
+		assert(meshopt_sloppyStreamAddTriangles(stream, &fib[0], fib.size(), &fvb[0], 18, sizeof(float) * 3) == 0);
+
+	assert(meshopt_sloppyStreamGetVertices(stream, points) == 1);
+	assert(fabsf(points[0] - expected[0]) < 1e-4f && fabsf(points[1] - expected[1]) < 1e-4f && fabsf(points[2] - expected[2]) < 1e-4f);
+
+	meshopt_destroySloppyStream(stream);
+}
+
+static bool isTriangleRotation(const unsigned int* lhs, const unsigned int* rhs)
+{
+	return (lhs[0] == rhs[0] && lhs[1] == rhs[1] && lhs[2] == rhs[2]) ||
+	       (lhs[0] == rhs[1] && lhs[1] == rhs[2] && lhs[2] == rhs[0]) ||
+	       (lhs[0] == rhs[2] && lhs[1] == rhs[0] && lhs[2] == rhs[1]);
+}
+
+static void encodeIndexChunked()
+{
+	std::vector<float> vb;
+	std::vector<unsigned int> ib;
+	makeGrid(vb, ib, 48); // 4608 triangles = 5 chunks, the last one is partial
+
+	meshopt_encodeIndexVersion(2);
+
+	std::vector<unsigned char> buffer(meshopt_encodeIndexBufferBound(ib.size(), vb.size() / 3));
+	buffer.resize(meshopt_encodeIndexBuffer(&buffer[0], buffer.size(), &ib[0], ib.size()));
+
+	meshopt_encodeIndexVersion(1);
+
+	assert(buffer.size() > 0);
+
+	std::vector<unsigned int> decoded(ib.size());
+	assert(meshopt_decodeIndexBuffer(&decoded[0], ib.size(), &buffer[0], buffer.size()) == 0);
+
+	for (size_t i = 0; i < ib.size(); i += 3)
+		assert(isTriangleRotation(&decoded[i], &ib[i]));
+
+	// parallel decoding must match serial decoding exactly
+	std::vector<unsigned int> decodedp(ib.size());
+	assert(meshopt_decodeIndexBufferParallel(&decodedp[0], ib.size(), &buffer[0], buffer.size(), runTasksReverse, NULL) == 0);
+	assert(decodedp == decoded);
+
+	std::vector<unsigned short> decoded16(ib.size());
+	assert(meshopt_decodeIndexBufferParallel(&decoded16[0], ib.size(), &buffer[0], buffer.size(), runTasksReverse, NULL) == 0);
+
+	for (size_t i = 0; i < ib.size(); ++i)
+		assert(decoded16[i] == decoded[i]);
+
+	// decode chunks 1-2 and the partial last chunk separately
+	std::vector<unsigned int> range(3072 * 2);
+	assert(meshopt_decodeIndexBufferRange(&range[0], 3072, 3072 * 2, ib.size(), &buffer[0], buffer.size()) == 0);
+	assert(memcmp(&range[0], &decoded[3072], range.size() * sizeof(unsigned int)) == 0);
+
+	range.resize(ib.size() - 3072 * 4);
+	assert(meshopt_decodeIndexBufferRange(&range[0], 3072 * 4, range.size(), ib.size(), &buffer[0], buffer.size()) == 0);
+	assert(memcmp(&range[0], &decoded[3072 * 4], range.size() * sizeof(unsigned int)) == 0);
+
+	// decoder must reject truncated and extended data
+	for (size_t i = 0; i < buffer.size(); i += 7)
+	{
+		std::vector<unsigned char> shortbuffer(buffer.begin(), buffer.begin() + i);
+		assert(meshopt_decodeIndexBuffer(&decoded[0], ib.size(), i == 0 ? 0 : &shortbuffer[0], i) < 0);
+		assert(meshopt_decodeIndexBufferParallel(&decoded[0], ib.size(), i == 0 ? 0 : &shortbuffer[0], i, runTasksReverse, NULL) < 0);
+	}
+
+	std::vector<unsigned char> largebuffer(buffer);
+	largebuffer.push_back(0);
+
+	assert(meshopt_decodeIndexBuffer(&decoded[0], ib.size(), &largebuffer[0], largebuffer.size()) < 0);
+
+	// older versions can't be decoded partially
+	std::vector<unsigned char> buffer1(meshopt_encodeIndexBufferBound(ib.size(), vb.size() / 3));
+	buffer1.resize(meshopt_encodeIndexBuffer(&buffer1[0], buffer1.size(), &ib[0], ib.size()));
+
+	assert(meshopt_decodeIndexBufferRange(&range[0], 0, 3072, ib.size(), &buffer1[0], buffer1.size()) == -1);
+	assert(meshopt_decodeIndexBufferParallel(&decodedp[0], ib.size(), &buffer1[0], buffer1.size(), runTasksReverse, NULL) == 0);
+
+	for (size_t i = 0; i < ib.size(); i += 3)
+		assert(isTriangleRotation(&decodedp[i], &ib[i]));
+}
+
+static void encodeVertexLevels()
+{
+	// generate vertex data with a mix of small deltas and occasional outliers so that different bit widths are used
+	std::vector<unsigned int> data(4000);
+
+	for (size_t i = 0; i < data.size(); ++i)
+		data[i] = unsigned(i * 7) | ((i % 37 == 0) ? 0xff000000u : 0) | (unsigned(i % 5) << 16);
+
+	const size_t vertex_count = data.size() / 4;
+	const size_t vertex_size = 16;
+
+	std::vector<unsigned char> buffer(meshopt_encodeVertexBufferBound(vertex_count, vertex_size));
+	buffer.resize(meshopt_encodeVertexBuffer(&buffer[0], buffer.size(), &data[0], vertex_count, vertex_size));
+
+	// level 1 is the default encoding
+	std::vector<unsigned char> buffer1(meshopt_encodeVertexBufferBound(vertex_count, vertex_size));
+	buffer1.resize(meshopt_encodeVertexBufferLevel(&buffer1[0], buffer1.size(), &data[0], vertex_count, vertex_size, 1));
+	assert(buffer1 == buffer);
+
+	// level 0 is decodable with the same decoder but is never smaller
+	std::vector<unsigned char> buffer0(meshopt_encodeVertexBufferBound(vertex_count, vertex_size));
+	buffer0.resize(meshopt_encodeVertexBufferLevel(&buffer0[0], buffer0.size(), &data[0], vertex_count, vertex_size, 0));
+	assert(buffer0.size() >= buffer.size());
+
+	std::vector<unsigned int> decoded(data.size());
+	assert(meshopt_decodeVertexBuffer(&decoded[0], vertex_count, vertex_size, &buffer0[0], buffer0.size()) == 0);
+	assert(decoded == data);
+
+	// level 0 encoding must also handle running out of space
+	for (size_t i = 0; i < buffer0.size(); i += 13)
+	{
+		std::vector<unsigned char> shortbuffer(i);
+		assert(meshopt_encodeVertexBufferLevel(i == 0 ? 0 : &shortbuffer[0], i, &data[0], vertex_count, vertex_size, 0) == 0);
+	}
+}
+
+static void decodeIndexInPlace()
+{
+	std::vector<float> vb;
+	std::vector<unsigned int> ib;
+	makeGrid(vb, ib, 48);
+
+	for (int version = 1; version <= 2; ++version)
+	{
+		meshopt_encodeIndexVersion(version);
+
+		std::vector<unsigned char> buffer(meshopt_encodeIndexBufferBound(ib.size(), vb.size() / 3));
+		buffer.resize(meshopt_encodeIndexBuffer(&buffer[0], buffer.size(), &ib[0], ib.size()));
+
+		meshopt_encodeIndexVersion(1);
+
+		std::vector<unsigned int> expected(ib.size());
+		assert(meshopt_decodeIndexBuffer(&expected[0], ib.size(), &buffer[0], buffer.size()) == 0);
+
+		for (size_t index_size = 2; index_size <= 4; index_size += 2)
+		{
+			size_t margin = meshopt_decodeIndexBufferInPlaceMargin(ib.size(), index_size, &buffer[0], buffer.size());
+			assert(margin >= 16 && margin < buffer.size());
+
+			// place encoded data at the end of the allocation and decode over it
+			std::vector<unsigned char> memory(ib.size() * index_size + margin);
+			memcpy(&memory[memory.size() - buffer.size()], &buffer[0], buffer.size());
+
+			assert(meshopt_decodeIndexBuffer(&memory[0], ib.size(), index_size, &memory[memory.size() - buffer.size()], buffer.size()) == 0);
+
+			for (size_t i = 0; i < ib.size(); ++i)
+			{
+				unsigned int index = 0;
+
+				if (index_size == 2)
+				{
+					unsigned short index16 = 0;
+					memcpy(&index16, &memory[i * 2], 2);
+					index = index16;
+				}
+				else
+					memcpy(&index, &memory[i * 4], 4);
+
+				assert(index == expected[i]);
+			}
+		}
+
+		// malformed data returns the buffer size which is always sufficient
+		assert(meshopt_decodeIndexBufferInPlaceMargin(ib.size(), 4, &buffer[0], 17) == 17);
+	}
+
+	// since the chunk table may be overwritten during in-place decoding, the decoder must reject tables that don't match the data
+	meshopt_encodeIndexVersion(2);
+
+	std::vector<unsigned char> buffer(meshopt_encodeIndexBufferBound(ib.size(), vb.size() / 3));
+	buffer.resize(meshopt_encodeIndexBuffer(&buffer[0], buffer.size(), &ib[0], ib.size()));
+
+	meshopt_encodeIndexVersion(1);
+
+	std::vector<unsigned int> decoded(ib.size());
+
+	// next index of the second chunk
+	buffer[1 + 8 + 4]++;
+	assert(meshopt_decodeIndexBuffer(&decoded[0], ib.size(), &buffer[0], buffer.size()) < 0);
+	buffer[1 + 8 + 4]--;
+
+	// offset of the second chunk
+	buffer[1 + 8]++;
+	assert(meshopt_decodeIndexBuffer(&decoded[0], ib.size(), &buffer[0], buffer.size()) < 0);
+	buffer[1 + 8]--;
+
+	assert(meshopt_decodeIndexBuffer(&decoded[0], ib.size(), &buffer[0], buffer.size()) == 0);
+}
+
+static void decodeVertexInPlace()
+{
+	std::vector<float> vb;
+	std::vector<unsigned int> ib;
+	makeGrid(vb, ib, 48);
+
+	const size_t vertex_count = vb.size() / 3;
+	const size_t vertex_size = 12;
+
+	std::vector<unsigned char> buffer(meshopt_encodeVertexBufferBound(vertex_count, vertex_size));
+	buffer.resize(meshopt_encodeVertexBuffer(&buffer[0], buffer.size(), &vb[0], vertex_count, vertex_size));
+
+	size_t margin = meshopt_decodeVertexBufferInPlaceMargin(vertex_count, vertex_size, &buffer[0], buffer.size());
+	assert(margin < buffer.size());
+
+	// place encoded data at the end of the allocation and decode over it
+	std::vector<unsigned char> memory(vertex_count * vertex_size + margin);
+	memcpy(&memory[memory.size() - buffer.size()], &buffer[0], buffer.size());
+
+	assert(meshopt_decodeVertexBuffer(&memory[0], vertex_count, vertex_size, &memory[memory.size() - buffer.size()], buffer.size()) == 0);
+	assert(memcmp(&memory[0], &vb[0], vertex_count * vertex_size) == 0);
+
+	// small buffers may be larger than the decoded data, in which case the allocation must still fit the input
+	const unsigned char small[] = {1, 2, 3, 4};
+
+	std::vector<unsigned char> smallbuffer(meshopt_encodeVertexBufferBound(1, 4));
+	smallbuffer.resize(meshopt_encodeVertexBuffer(&smallbuffer[0], smallbuffer.size(), small, 1, 4));
+
+	assert(meshopt_decodeVertexBufferInPlaceMargin(1, 4, &smallbuffer[0], smallbuffer.size()) >= smallbuffer.size() - 4);
+
+	// malformed data returns the buffer size which is always sufficient
+	assert(meshopt_decodeVertexBufferInPlaceMargin(vertex_count, vertex_size, &buffer[0], buffer.size() / 2) == buffer.size() / 2);
+}
+
+struct ProfileState
+{
+	const char* stack[16];
+	size_t depth;
+	size_t zones;
+	size_t passes;
+	size_t allocated;
+	bool root;
+};
+
+static void profileBegin(void* context, const char* name)
+{
+	ProfileState& state = *static_cast<ProfileState*>(context);
+
+	assert(state.depth < sizeof(state.stack) / sizeof(state.stack[0]));
+	state.stack[state.depth++] = name;
+	state.zones++;
+
+	state.root |= state.depth == 1 && strcmp(name, "meshopt_simplify") == 0;
+}
+
+static void profileEnd(void* context, const char* name)
+{
+	ProfileState& state = *static_cast<ProfileState*>(context);
+
+	// zones must be properly nested
+	assert(state.depth > 0 && state.stack[state.depth - 1] == name);
+	state.depth--;
+}
+
+static void profileCounter(void* context, const char* name, size_t value)
+{
+	ProfileState& state = *static_cast<ProfileState*>(context);
+
+	// counters are reported from within zones
+	assert(state.depth > 0);
+
+	if (strcmp(name, "passes") == 0)
+		state.passes += value;
+	else if (strcmp(name, "allocated") == 0)
+		state.allocated += value;
+}
+
+static void profiler()
+{
+	std::vector<float> vb;
+	std::vector<unsigned int> ib;
+	makeGrid(vb, ib, 16);
+
+	std::vector<unsigned int> result(ib.size());
+
+	ProfileState state = {};
+	meshopt_setProfiler(profileBegin, profileEnd, profileCounter, &state);
+
+	meshopt_simplify(&result[0], &ib[0], ib.size(), &vb[0], vb.size() / 3, 12, ib.size() / 4, 1e-2f);
+
+	meshopt_setProfiler(NULL, NULL, NULL, NULL);
+
+	assert(state.depth == 0);
+
+#if MESHOPTIMIZER_PROFILE
+	assert(state.root && state.zones > 1);
+	assert(state.passes > 0 && state.allocated > 0);
+#else
+	assert(state.zones == 0 && state.passes == 0 && state.allocated == 0);
+#endif
+
+	// callbacks are not called after the profiler is reset
+	size_t zones = state.zones;
+	meshopt_optimizeVertexCache(&result[0], &ib[0], ib.size(), vb.size() / 3);
+
+	assert(state.zones == zones);
+}
+
+static void runTestsOnce()
+{
+	decodeIndexV0();
+	decodeIndexV1();
+	decodeIndex16();
+	encodeIndexMemorySafe();
+	decodeIndexMemorySafe();
+	decodeIndexRejectExtraBytes();
+	decodeIndexRejectMalformedHeaders();
+	decodeIndexRejectInvalidVersion();
+	roundtripIndexTricky();
+	encodeIndexEmpty();
+
+	decodeIndexSequence();
+	decodeIndexSequence16();
+	encodeIndexSequenceMemorySafe();
+	decodeIndexSequenceMemorySafe();
+	decodeIndexSequenceRejectExtraBytes();
+	decodeIndexSequenceRejectMalformedHeaders();
+	decodeIndexSequenceRejectInvalidVersion();
+	encodeIndexSequenceEmpty();
+
+	decodeVertexV0();
+	encodeVertexMemorySafe();
+	decodeVertexMemorySafe();
+	decodeVertexRejectExtraBytes();
+	decodeVertexRejectMalformedHeaders();
+	decodeVertexBitGroups();
+	decodeVertexBitGroupSentinels();
+	decodeVertexLarge();
+	decodeVertexRange();
+	decodeVertexStream();
+	encodeVertexEmpty();
+	encodeVertexMulti();
+
+	decodeFilterOct8();
+	decodeFilterOct12();
+	decodeFilterQuat12();
+	decodeFilterExp();
+	decodeFilterFused();
+	encodeFilterOct();
+	encodeFilterQuat();
+	quantizeBuffers();
+
+	remapParallel();
+	remapShadow();
+	remapFixedSize();
+	vertexFetchMulti();
+
+	vertexCachePartitioned();
+	overdrawParallel();
+	optimizeRange();
+	analyzeOverdrawParallel();
+	analyzeVertexFetchMulti();
+	vertexCacheProfiles();
+	spatialSortParallel();
+	stripifyParallel();
+
+	clusterBoundsDegenerate();
+	meshletsSpatial();
+	meshletsPacked();
+	meshletBoundsPacked();
+	meshletsEncoded();
+	clusterLod();
+
+	customAllocator();
+	customAllocatorContext();
+	profiler();
+
+	emptyMesh();
+
+	simplifyStuck();
+	simplifyPartitioned();
+	simplifyIncremental();
+	simplifyAttributes();
+	simplifySloppyStuck();
+	simplifySloppyError();
+	simplifyPointsStuck();
+	simplifySloppyStream();
+
+	encodeIndexChunked();
+	encodeVertexLevels();
+	decodeIndexInPlace();
+	decodeVertexInPlace();
+}
+
+namespace meshopt
+{
+extern unsigned int cpuid;
+}
+
+void runTests()
+{
+	runTestsOnce();
+
+#if !(defined(__AVX__) || defined(__SSSE3__)) && (defined(_M_IX86) || defined(_M_X64) || defined(__i386__) || defined(__x86_64__))
+	// When SSSE3/AVX support isn't enabled unconditionally, we use a cpuid-based fallback
+	// It's useful to be able to test scalar code in this case, so we temporarily fake the feature bits
+	// and restore them later
+	unsigned int cpuid = meshopt::cpuid;
+
+	// AVX2 code is only used when AVX bit is set, so masking it tests SSSE3 code
+	meshopt::cpuid = cpuid & ~(1u << 28);
+
+	runTestsOnce();
 
-#if !(defined(__AVX__) || defined(__SSSE3__)) && (defined(_M_IX86) || defined(_M_X64) || defined(__i386__) || defined(__x86_64__))
-	// When SSSE3/AVX support isn't enabled unconditionally, we use a cpuid-based fallback
-	// It's useful to be able to test scalar code in this case, so we temporarily fake the feature bits
-	// and restore them later
-	unsigned int cpuid = meshopt::cpuid;
 	meshopt::cpuid = 0;
 
 	runTestsOnce();
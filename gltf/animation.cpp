@@ -3,6 +3,7 @@
 
 #include <algorithm>
 
+#include <float.h>
 #include <math.h>
 #include <string.h>
 
@@ -226,6 +227,125 @@ static bool isTrackEqual(const std::vector<Attr>& data, cgltf_animation_path_typ
 	return true;
 }
 
+static float getSegmentError(const std::vector<Attr>& data, cgltf_animation_path_type type, size_t components, int first, int last)
+{
+	float result = 0;
+
+	for (int i = first + 1; i < last; ++i)
+	{
+		float t = float(i - first) / float(last - first);
+
+		for (size_t j = 0; j < components; ++j)
+		{
+			const Attr& v0 = data[first * components + j];
+			const Attr& v1 = data[last * components + j];
+
+			Attr value = interpolateLinear(v0, v1, t, type);
+
+			result = std::max(result, getDelta(value, data[i * components + j], type));
+		}
+	}
+
+	return result;
+}
+
+struct KeyframeError
+{
+	float error;
+	int frame;
+
+	// std::push_heap builds a max-heap, so the order is reversed to pop the smallest error first
+	bool operator<(const KeyframeError& other) const
+	{
+		return error > other.error || (error == other.error && frame > other.frame);
+	}
+};
+
+// bounds the cost of evaluating a removal; long linear runs keep a keyframe every kMaxKeyframeSpan frames
+static const int kMaxKeyframeSpan = 256;
+
+static void pushKeyframeError(std::vector<KeyframeError>& heap, std::vector<float>& errors, const std::vector<Attr>& data, cgltf_animation_path_type type, size_t components, int frame, int prev, int next)
+{
+	// keyframes that can't be removed don't go into the heap, but their outdated heap entries need to be invalidated
+	if (next - prev > kMaxKeyframeSpan)
+	{
+		errors[frame] = FLT_MAX;
+		return;
+	}
+
+	errors[frame] = getSegmentError(data, type, components, prev, next);
+
+	KeyframeError item = {errors[frame], frame};
+	heap.push_back(item);
+	std::push_heap(heap.begin(), heap.end());
+}
+
+static void reduceKeyframes(std::vector<float>& time, std::vector<Attr>& data, cgltf_animation_path_type type, size_t components, int frames, float mint, int freq)
+{
+	assert(data.size() == frames * components);
+
+	float tolerance = getDeltaTolerance(type);
+
+	// remaining keyframes form a linked list; the error of a keyframe is the largest deviation of the original frames between its neighbors when it is removed
+	std::vector<int> prev(frames), next(frames);
+	std::vector<float> errors(frames);
+	std::vector<KeyframeError> heap;
+
+	for (int i = 0; i < frames; ++i)
+	{
+		prev[i] = i - 1;
+		next[i] = i + 1;
+	}
+
+	for (int i = 1; i < frames - 1; ++i)
+		pushKeyframeError(heap, errors, data, type, components, i, i - 1, i + 1);
+
+	// greedily remove the keyframe with the smallest error; only its neighbors need their errors updated, and outdated heap entries are skipped
+	int removed = 0;
+
+	while (!heap.empty())
+	{
+		KeyframeError item = heap.front();
+		std::pop_heap(heap.begin(), heap.end());
+		heap.pop_back();
+
+		// removed keyframes are marked with prev = -1; the first keyframe is never in the heap
+		if (prev[item.frame] < 0 || errors[item.frame] != item.error)
+			continue;
+
+		if (item.error > tolerance)
+			break;
+
+		int p = prev[item.frame], n = next[item.frame];
+
+		next[p] = n;
+		prev[n] = p;
+		prev[item.frame] = -1;
+		removed++;
+
+		if (p > 0)
+			pushKeyframeError(heap, errors, data, type, components, p, prev[p], n);
+
+		if (n < frames - 1)
+			pushKeyframeError(heap, errors, data, type, components, n, p, next[n]);
+	}
+
+	// keep the track on the shared uniform timeline if we can't remove anything
+	if (removed == 0)
+		return;
+
+	std::vector<Attr> result;
+	result.reserve((frames - removed) * components);
+
+	for (int i = 0; i < frames; i = next[i])
+	{
+		time.push_back(mint + float(i) / freq);
+		result.insert(result.end(), data.begin() + i * components, data.begin() + (i + 1) * components);
+	}
+
+	data.swap(result);
+}
+
 static void getBaseTransform(Attr* result, size_t components, cgltf_animation_path_type type, cgltf_node* node)
 {
 	switch (type)
@@ -260,49 +380,81 @@ static void getBaseTransform(Attr* result, size_t components, cgltf_animation_pa
 	}
 }
 
-void processAnimation(Animation& animation, const Settings& settings)
+static void processTrack(Track& track, int frames, float mint, const Settings& settings)
 {
-	float mint = 0, maxt = 0;
+	std::vector<Attr> result;
+	resampleKeyframes(result, track.time, track.data, track.path, track.interpolation, track.components, frames, mint, settings.anim_freq);
 
-	for (size_t i = 0; i < animation.tracks.size(); ++i)
+	track.time.clear();
+	track.data.swap(result);
+
+	if (isTrackEqual(track.data, track.path, frames, &track.data[0], track.components))
 	{
-		const Track& track = animation.tracks[i];
-		assert(!track.time.empty());
+		// track is constant (equal to first keyframe), we only need the first keyframe
+		track.data.resize(track.components);
+
+		// track.dummy is true iff track redundantly sets up the value to be equal to default node transform
+		std::vector<Attr> base(track.components);
+		getBaseTransform(&base[0], track.components, track.path, track.node);
 
-		mint = std::min(mint, track.time.front());
-		maxt = std::max(maxt, track.time.back());
+		track.dummy = isTrackEqual(track.data, track.path, 1, &base[0], track.components);
 	}
+	else if (settings.anim_reduce)
+	{
+		// remove keyframes that can be reconstructed from their neighbors; such tracks carry their own time data
+		reduceKeyframes(track.time, track.data, track.path, track.components, frames, mint, settings.anim_freq);
+	}
+}
 
-	// round the number of frames to nearest but favor the "up" direction
-	// this means that at 10 Hz resampling, we will try to preserve the last frame <10ms
-	// but if the last frame is <2ms we favor just removing this data
-	int frames = 1 + int((maxt - mint) * settings.anim_freq + 0.8f);
+struct ProcessTrackContext
+{
+	std::vector<Animation>* animations;
+	std::vector<std::pair<size_t, size_t> >* tracks;
+	const Settings* settings;
+};
 
-	animation.start = mint;
-	animation.frames = frames;
+static void processTrackTask(void* context, size_t index)
+{
+	ProcessTrackContext& pc = *static_cast<ProcessTrackContext*>(context);
 
-	std::vector<Attr> base;
+	const std::pair<size_t, size_t>& item = (*pc.tracks)[index];
+	Animation& animation = (*pc.animations)[item.first];
 
-	for (size_t i = 0; i < animation.tracks.size(); ++i)
-	{
-		Track& track = animation.tracks[i];
+	processTrack(animation.tracks[item.second], animation.frames, animation.start, *pc.settings);
+}
 
-		std::vector<Attr> result;
-		resampleKeyframes(result, track.time, track.data, track.path, track.interpolation, track.components, frames, mint, settings.anim_freq);
+void processAnimations(std::vector<Animation>& animations, const Settings& settings)
+{
+	std::vector<std::pair<size_t, size_t> > tracks;
+
+	for (size_t i = 0; i < animations.size(); ++i)
+	{
+		Animation& animation = animations[i];
 
-		track.time.clear();
-		track.data.swap(result);
+		float mint = 0, maxt = 0;
 
-		if (isTrackEqual(track.data, track.path, frames, &track.data[0], track.components))
+		for (size_t j = 0; j < animation.tracks.size(); ++j)
 		{
-			// track is constant (equal to first keyframe), we only need the first keyframe
-			track.data.resize(track.components);
-
-			// track.dummy is true iff track redundantly sets up the value to be equal to default node transform
-			base.resize(track.components);
-			getBaseTransform(&base[0], track.components, track.path, track.node);
+			const Track& track = animation.tracks[j];
+			assert(!track.time.empty());
 
-			track.dummy = isTrackEqual(track.data, track.path, 1, &base[0], track.components);
+			mint = std::min(mint, track.time.front());
+			maxt = std::max(maxt, track.time.back());
 		}
+
+		// round the number of frames to nearest but favor the "up" direction
+		// this means that at 10 Hz resampling, we will try to preserve the last frame <10ms
+		// but if the last frame is <2ms we favor just removing this data
+		int frames = 1 + int((maxt - mint) * settings.anim_freq + 0.8f);
+
+		animation.start = mint;
+		animation.frames = frames;
+
+		for (size_t j = 0; j < animation.tracks.size(); ++j)
+			tracks.push_back(std::make_pair(i, j));
 	}
+
+	// tracks are independent once the timeline of each animation is known, so they can be resampled in parallel across all animations
+	ProcessTrackContext pc = {&animations, &tracks, &settings};
+	parallelFor(tracks.size(), settings.jobs, processTrackTask, &pc);
 }
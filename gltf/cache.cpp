@@ -0,0 +1,151 @@
+// This file is part of gltfpack; see gltfpack.h for version/license details
+#include "gltfpack.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "../src/meshoptimizer.h"
+
+#ifdef _WIN32
+#include <io.h>
+#include <windows.h>
+#else
+#include <unistd.h>
+#endif
+
+// Bump this when the layout or the semantics of cached data changes to invalidate existing cache entries
+static const char* kCacheVersion = "gltfpack-cache-1";
+
+static uint64_t rotl64(uint64_t v, int r)
+{
+	return (v << r) | (v >> (64 - r));
+}
+
+// MurmurHash3 finalizer
+static uint64_t fmix64(uint64_t k)
+{
+	k ^= k >> 33;
+	k *= 0xff51afd7ed558ccdull;
+	k ^= k >> 33;
+	k *= 0xc4ceb9fe1a85ec53ull;
+	k ^= k >> 33;
+
+	return k;
+}
+
+Hasher::Hasher()
+    : h1(0x9e3779b97f4a7c15ull)
+    , h2(0x243f6a8885a308d3ull)
+    , size(0)
+{
+	update(kCacheVersion, strlen(kCacheVersion));
+
+	// processing results depend on the library version as well
+	update(size_t(MESHOPTIMIZER_VERSION));
+}
+
+void Hasher::update(const void* data, size_t length)
+{
+	const unsigned char* bytes = static_cast<const unsigned char*>(data);
+
+	// two independent 64-bit lanes give us a 128-bit digest; this is not a cryptographic hash, but collisions are very unlikely for build artifacts
+	for (size_t i = 0; i < length; i += 8)
+	{
+		uint64_t k = 0;
+		memcpy(&k, bytes + i, length - i < 8 ? length - i : 8);
+
+		h1 = rotl64(h1 ^ (k * 0x87c37b91114253d5ull), 31) * 0x4cf5ad432745937full;
+		h2 = rotl64(h2 ^ (k * 0x52dce729ull), 33) * 0x38495ab5ull + h1;
+	}
+
+	size += length;
+}
+
+void Hasher::update(const std::string& data)
+{
+	update(data.size());
+	update(data.data(), data.size());
+}
+
+void Hasher::update(size_t value)
+{
+	uint64_t v = value;
+	update(&v, sizeof(v));
+}
+
+std::string Hasher::digest() const
+{
+	uint64_t a = fmix64(h1 ^ size);
+	uint64_t b = fmix64(h2 ^ rotl64(size, 17)) ^ a;
+
+	char result[33];
+	sprintf(result, "%08x%08x%08x%08x", unsigned(a >> 32), unsigned(a), unsigned(b >> 32), unsigned(b));
+
+	return result;
+}
+
+static std::string getCacheFile(const char* cache_path, const std::string& key)
+{
+	std::string result = cache_path;
+
+	if (!result.empty() && result[result.size() - 1] != '/' && result[result.size() - 1] != '\\')
+		result += '/';
+
+	result += key;
+
+	return result;
+}
+
+bool readCache(const Settings& settings, const std::string& key, std::string& data)
+{
+	if (!settings.cache_path)
+		return false;
+
+	std::string path = getCacheFile(settings.cache_path, key);
+
+	return readFile(path.c_str(), data);
+}
+
+bool writeCache(const Settings& settings, const std::string& key, const std::string& data)
+{
+	if (!settings.cache_path || data.empty())
+		return false;
+
+	std::string path = getCacheFile(settings.cache_path, key);
+
+	// write to a unique temporary file first and rename it so that concurrent readers never observe partial data
+#ifdef _WIN32
+	char suffix[32];
+	sprintf(suffix, ".%u.tmp", unsigned(GetCurrentThreadId()));
+
+	std::string temp = path + suffix;
+#else
+	std::string temp = path + ".XXXXXX";
+
+	int fd = mkstemp(&temp[0]);
+	if (fd < 0)
+		return false;
+
+	close(fd);
+#endif
+
+	if (!writeFile(temp.c_str(), data))
+	{
+		remove(temp.c_str());
+		return false;
+	}
+
+#ifdef _WIN32
+	// rename doesn't replace existing files on Windows; the existing entry has the same contents
+	remove(path.c_str());
+#endif
+
+	if (rename(temp.c_str(), path.c_str()) != 0)
+	{
+		remove(temp.c_str());
+		return false;
+	}
+
+	return true;
+}
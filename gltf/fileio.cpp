@@ -7,7 +7,11 @@
 
 #ifdef _WIN32
 #include <io.h>
+#include <windows.h>
 #else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
 #include <unistd.h>
 #endif
 
@@ -17,7 +21,14 @@ TempFile::TempFile(const char* suffix)
 #ifdef _WIN32
 	const char* temp_dir = getenv("TEMP");
 	path = temp_dir ? temp_dir : ".";
-	path += "\\gltfpack-XXXXXX";
+
+	// _mktemp isn't safe to call from multiple threads, so we make names unique per thread
+	char thread_id[16];
+	sprintf(thread_id, "%u", unsigned(GetCurrentThreadId()));
+
+	path += "\\gltfpack-";
+	path += thread_id;
+	path += "-XXXXXX";
 	(void)_mktemp(&path[0]);
 	path += suffix;
 #else
@@ -86,6 +97,110 @@ bool readFile(const char* path, std::string& data)
 	return result == data.size();
 }
 
+void writeStream(OutputStream& stream, const void* data, size_t size)
+{
+	if (stream.file && size)
+		fwrite(data, size, 1, stream.file);
+
+	stream.size += size;
+}
+
+void alignStream(OutputStream& stream, size_t alignment)
+{
+	static const char zero[16] = {};
+	assert(alignment <= sizeof(zero));
+
+	size_t padding = (alignment - stream.size % alignment) % alignment;
+
+	writeStream(stream, zero, padding);
+}
+
+bool copyFile(FILE* out, FILE* in, size_t size)
+{
+	char buffer[65536];
+
+	while (size)
+	{
+		size_t chunk = size < sizeof(buffer) ? size : sizeof(buffer);
+
+		if (fread(buffer, 1, chunk, in) != chunk)
+			return false;
+
+		if (fwrite(buffer, 1, chunk, out) != chunk)
+			return false;
+
+		size -= chunk;
+	}
+
+	return true;
+}
+
+void* mapFile(const char* path, size_t& size)
+{
+	// mappings are copy-on-write so that callers can treat the data as regular memory; untouched pages stay shared with the OS file cache
+#if defined(_WIN32)
+	HANDLE file = CreateFileA(path, GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+	if (file == INVALID_HANDLE_VALUE)
+		return NULL;
+
+	LARGE_INTEGER length;
+	if (!GetFileSizeEx(file, &length) || length.QuadPart <= 0 || uint64_t(length.QuadPart) > size_t(-1))
+	{
+		CloseHandle(file);
+		return NULL;
+	}
+
+	HANDLE mapping = CreateFileMappingA(file, NULL, PAGE_WRITECOPY, 0, 0, NULL);
+	CloseHandle(file);
+
+	if (!mapping)
+		return NULL;
+
+	void* result = MapViewOfFile(mapping, FILE_MAP_COPY, 0, 0, 0);
+	CloseHandle(mapping);
+
+	size = size_t(length.QuadPart);
+	return result;
+#elif !defined(__EMSCRIPTEN__)
+	int fd = open(path, O_RDONLY);
+	if (fd < 0)
+		return NULL;
+
+	struct stat st;
+	if (fstat(fd, &st) != 0 || !S_ISREG(st.st_mode) || st.st_size <= 0)
+	{
+		close(fd);
+		return NULL;
+	}
+
+	void* result = mmap(NULL, size_t(st.st_size), PROT_READ | PROT_WRITE, MAP_PRIVATE, fd, 0);
+	close(fd);
+
+	if (result == MAP_FAILED)
+		return NULL;
+
+	size = size_t(st.st_size);
+	return result;
+#else
+	(void)path;
+	(void)size;
+	return NULL;
+#endif
+}
+
+void unmapFile(void* data, size_t size)
+{
+#if defined(_WIN32)
+	(void)size;
+	UnmapViewOfFile(data);
+#elif !defined(__EMSCRIPTEN__)
+	munmap(data, size);
+#else
+	(void)data;
+	(void)size;
+#endif
+}
+
 bool writeFile(const char* path, const std::string& data)
 {
 	FILE* file = fopen(path, "wb");
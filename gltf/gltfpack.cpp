@@ -21,53 +21,117 @@ std::string getVersion()
 	return result;
 }
 
-static void finalizeBufferViews(std::string& json, std::vector<BufferView>& views, std::string& bin, std::string& fallback)
+struct CompressContext
 {
-	for (size_t i = 0; i < views.size(); ++i)
+	const std::vector<BufferView>* views;
+	size_t view_offset;
+	std::vector<std::string>* results;
+	const Settings* settings;
+};
+
+static void compressBufferView(void* context, size_t index)
+{
+	const CompressContext& cc = *static_cast<CompressContext*>(context);
+	const BufferView& view = (*cc.views)[cc.view_offset + index];
+	std::string& result = (*cc.results)[index];
+
+	if (view.compression == BufferView::Compression_None)
+		return;
+
+	std::string cache_key;
+
+	if (cc.settings->cache_path)
 	{
-		BufferView& view = views[i];
+		Hasher hasher;
+		hasher.update("view", 4);
+		hasher.update(size_t(view.compression));
+		hasher.update(view.stride);
+		hasher.update(view.data);
 
-		size_t bin_offset = bin.size();
-		size_t fallback_offset = fallback.size();
+		cache_key = hasher.digest();
 
-		size_t count = view.data.size() / view.stride;
+		if (readCache(*cc.settings, cache_key, result))
+			return;
+	}
+
+	size_t count = view.data.size() / view.stride;
+
+	switch (view.compression)
+	{
+	case BufferView::Compression_None:
+		break;
+
+	case BufferView::Compression_Attribute:
+		compressVertexStream(result, view.data, count, view.stride);
+		break;
+
+	case BufferView::Compression_Index:
+		compressIndexStream(result, view.data, count, view.stride);
+		break;
+
+	case BufferView::Compression_IndexSequence:
+		compressIndexSequence(result, view.data, count, view.stride);
+		break;
 
-		switch (view.compression)
+	default:
+		assert(!"Unknown compression type");
+	}
+
+	if (cc.settings->cache_path)
+		writeCache(*cc.settings, cache_key, result);
+}
+
+static void finalizeBufferViews(std::string& json, std::vector<BufferView>& views, OutputStream& bin, OutputStream& fallback, const Settings& settings)
+{
+	// buffer views are compressed independently; the results are concatenated in order to keep the output deterministic
+	// views are compressed in windows of one view per job, which keeps at most that many compressed views in memory at a time
+	size_t window = size_t(getJobCount(settings.jobs));
+
+	std::vector<std::string> compressed(window);
+
+	for (size_t i = 0; i < views.size(); ++i)
+	{
+		BufferView& view = views[i];
+
+		if (i % window == 0)
 		{
-		case BufferView::Compression_None:
-			bin += view.data;
-			break;
+			CompressContext cc = {&views, i, &compressed, &settings};
+			parallelFor(std::min(window, views.size() - i), settings.jobs, compressBufferView, &cc);
+		}
 
-		case BufferView::Compression_Attribute:
-			compressVertexStream(bin, view.data, count, view.stride);
-			fallback += view.data;
-			break;
+		std::string& result = compressed[i % window];
 
-		case BufferView::Compression_Index:
-			compressIndexStream(bin, view.data, count, view.stride);
-			fallback += view.data;
-			break;
+		size_t bin_offset = bin.size;
+		size_t fallback_offset = fallback.size;
 
-		case BufferView::Compression_IndexSequence:
-			compressIndexSequence(bin, view.data, count, view.stride);
-			fallback += view.data;
-			break;
+		size_t count = view.data.size() / view.stride;
 
-		default:
-			assert(!"Unknown compression type");
+		if (view.compression == BufferView::Compression_None)
+		{
+			writeStream(bin, view.data.data(), view.data.size());
+		}
+		else
+		{
+			writeStream(bin, result.data(), result.size());
+			writeStream(fallback, view.data.data(), view.data.size());
 		}
 
 		size_t raw_offset = (view.compression != BufferView::Compression_None) ? fallback_offset : bin_offset;
 
 		comma(json);
-		writeBufferView(json, view.kind, view.filter, count, view.stride, raw_offset, view.data.size(), view.compression, bin_offset, bin.size() - bin_offset);
+		writeBufferView(json, view.kind, view.filter, count, view.stride, raw_offset, view.data.size(), view.compression, bin_offset, bin.size - bin_offset);
 
 		// record written bytes for statistics
-		view.bytes = bin.size() - bin_offset;
+		view.bytes = bin.size - bin_offset;
+		view.raw_bytes = view.data.size();
+
+		// view contents have been written out, so we can release the memory to keep peak usage down
+		std::string().swap(view.data);
+		std::string().swap(result);
 
 		// align each bufferView by 4 bytes
-		bin.resize((bin.size() + 3) & ~3);
-		fallback.resize((fallback.size() + 3) & ~3);
+		alignStream(bin, 4);
+		alignStream(fallback, 4);
 	}
 }
 
@@ -145,16 +209,29 @@ static void printAttributeStats(const std::vector<BufferView>& views, BufferView
 		default:;
 		}
 
-		size_t count = view.data.size() / view.stride;
+		size_t count = view.raw_bytes / view.stride;
 
 		printf("stats: %s %s: compressed %d bytes (%.1f bits), raw %d bytes (%d bits)\n",
 		       name, variant,
 		       int(view.bytes), double(view.bytes) / double(count) * 8,
-		       int(view.data.size()), int(view.stride * 8));
+		       int(view.raw_bytes), int(view.stride * 8));
 	}
 }
 
-static void process(cgltf_data* data, const char* input_path, const char* output_path, std::vector<Mesh>& meshes, std::vector<Animation>& animations, const Settings& settings, std::string& json, std::string& bin, std::string& fallback)
+struct ProcessMeshContext
+{
+	std::vector<Mesh>* meshes;
+	const Settings* settings;
+};
+
+static void processMeshTask(void* context, size_t index)
+{
+	const ProcessMeshContext& pc = *static_cast<ProcessMeshContext*>(context);
+
+	processMesh((*pc.meshes)[index], *pc.settings);
+}
+
+static void process(cgltf_data* data, const char* input_path, const char* output_path, std::vector<Mesh>& meshes, std::vector<Animation>& animations, const Settings& settings, std::string& json, OutputStream& bin, OutputStream& fallback)
 {
 	if (settings.verbose)
 	{
@@ -163,10 +240,7 @@ static void process(cgltf_data* data, const char* input_path, const char* output
 		printMeshStats(meshes, "input");
 	}
 
-	for (size_t i = 0; i < animations.size(); ++i)
-	{
-		processAnimation(animations[i], settings);
-	}
+	processAnimations(animations, settings);
 
 	std::vector<NodeInfo> nodes(data->nodes_count);
 
@@ -267,10 +341,9 @@ static void process(cgltf_data* data, const char* input_path, const char* output
 	}
 #endif
 
-	for (size_t i = 0; i < meshes.size(); ++i)
-	{
-		processMesh(meshes[i], settings);
-	}
+	// meshes are independent at this point so they can be processed in parallel
+	ProcessMeshContext pc = {&meshes, &settings};
+	parallelFor(meshes.size(), settings.jobs, processMeshTask, &pc);
 
 #ifndef NDEBUG
 	meshes.insert(meshes.end(), debug_meshes.begin(), debug_meshes.end());
@@ -314,21 +387,31 @@ static void process(cgltf_data* data, const char* input_path, const char* output
 	size_t mesh_offset = 0;
 	size_t material_offset = 0;
 
-	for (size_t i = 0; i < data->images_count; ++i)
-	{
-		const cgltf_image& image = data->images[i];
+	std::vector<std::string> encoded_images;
 
-		if (settings.verbose && settings.texture_basis)
+	if (settings.texture_basis)
+	{
+		if (settings.verbose)
 		{
-			const char* uri = image.uri;
-			bool embedded = !uri || strncmp(uri, "data:", 5) == 0;
+			for (size_t i = 0; i < data->images_count; ++i)
+			{
+				const char* uri = data->images[i].uri;
+				bool embedded = !uri || strncmp(uri, "data:", 5) == 0;
 
-			printf("image %d (%s) is being encoded with Basis\n", int(i), embedded ? "embedded" : uri);
+				printf("image %d (%s) is being encoded with Basis\n", int(i), embedded ? "embedded" : uri);
+			}
 		}
 
+		encodeImages(encoded_images, data, images, input_path, settings);
+	}
+
+	for (size_t i = 0; i < data->images_count; ++i)
+	{
+		const cgltf_image& image = data->images[i];
+
 		comma(json_images);
 		append(json_images, "{");
-		writeImage(json_images, views, image, images[i], i, input_path, output_path, settings);
+		writeImage(json_images, views, image, settings.texture_basis ? encoded_images[i] : std::string(), i, input_path, output_path, settings);
 		append(json_images, "}");
 	}
 
@@ -578,7 +661,7 @@ static void process(cgltf_data* data, const char* input_path, const char* output
 	writeExtensions(json, extensions, sizeof(extensions) / sizeof(extensions[0]));
 
 	std::string json_views;
-	finalizeBufferViews(json_views, views, bin, fallback);
+	finalizeBufferViews(json_views, views, bin, fallback, settings);
 
 	writeArray(json, "bufferViews", json_views);
 	writeArray(json, "accessors", json_accessors);
@@ -614,7 +697,7 @@ static void process(cgltf_data* data, const char* input_path, const char* output
 	if (settings.verbose)
 	{
 		printMeshStats(meshes, "output");
-		printSceneStats(views, meshes, node_offset, mesh_offset, material_offset, json.size(), bin.size());
+		printSceneStats(views, meshes, node_offset, mesh_offset, material_offset, json.size(), bin.size);
 	}
 
 	if (settings.verbose > 1)
@@ -726,67 +809,78 @@ int gltfpack(const char* input, const char* output, const Settings& settings)
 		}
 	}
 
-	std::string json, bin, fallback;
-	process(data, input, output, meshes, animations, settings, json, bin, fallback);
-
-	cgltf_free(data);
-
 	if (!output)
 	{
+		// without an output file we still run the full pipeline to be able to print statistics
+		std::string json;
+		OutputStream bin = {}, fallback = {};
+		process(data, input, output, meshes, animations, settings, json, bin, fallback);
+
+		cgltf_free(data);
 		return 0;
 	}
 
 	const char* oext = strrchr(output, '.');
 
-	if (oext && (strcmp(oext, ".gltf") == 0 || strcmp(oext, ".GLTF") == 0))
-	{
-		std::string binpath = output;
-		binpath.replace(binpath.size() - 5, 5, ".bin");
-
-		std::string fbpath = output;
-		fbpath.replace(fbpath.size() - 5, 5, ".fallback.bin");
+	bool out_gltf = oext && (strcmp(oext, ".gltf") == 0 || strcmp(oext, ".GLTF") == 0);
+	bool out_glb = oext && (strcmp(oext, ".glb") == 0 || strcmp(oext, ".GLB") == 0);
 
-		FILE* outjson = fopen(output, "wb");
-		FILE* outbin = fopen(binpath.c_str(), "wb");
-		FILE* outfb = settings.fallback ? fopen(fbpath.c_str(), "wb") : NULL;
-		if (!outjson || !outbin || (!outfb && settings.fallback))
-		{
-			fprintf(stderr, "Error saving %s\n", output);
-			return 4;
-		}
+	if (!out_gltf && !out_glb)
+	{
+		fprintf(stderr, "Error saving %s: unknown extension (expected .gltf or .glb)\n", output);
+		cgltf_free(data);
+		return 4;
+	}
 
-		std::string bufferspec = getBufferSpec(getBaseName(binpath.c_str()), bin.size(), settings.fallback ? getBaseName(fbpath.c_str()) : NULL, fallback.size(), settings.compress);
+	std::string binpath = output;
+	binpath.replace(binpath.size() - (out_gltf ? 5 : 4), out_gltf ? 5 : 4, ".bin");
 
-		fprintf(outjson, "{");
-		fwrite(bufferspec.c_str(), bufferspec.size(), 1, outjson);
-		fprintf(outjson, ",");
-		fwrite(json.c_str(), json.size(), 1, outjson);
-		fprintf(outjson, "}");
+	std::string fbpath = output;
+	fbpath.replace(fbpath.size() - (out_gltf ? 5 : 4), out_gltf ? 5 : 4, ".fallback.bin");
 
-		fwrite(bin.c_str(), bin.size(), 1, outbin);
+	// buffer views are streamed to disk as they are finalized; since the GLB binary chunk must follow the JSON chunk, we stage it in a temporary file
+	TempFile tempbin(".bin");
 
-		if (settings.fallback)
-			fwrite(fallback.c_str(), fallback.size(), 1, outfb);
+	FILE* out = fopen(output, "wb");
+	FILE* outbin = fopen(out_gltf ? binpath.c_str() : tempbin.path.c_str(), out_gltf ? "wb" : "w+b");
+	FILE* outfb = settings.fallback ? fopen(fbpath.c_str(), "wb") : NULL;
+	if (!out || !outbin || (!outfb && settings.fallback))
+	{
+		fprintf(stderr, "Error saving %s\n", output);
 
-		fclose(outjson);
-		fclose(outbin);
+		if (out)
+			fclose(out);
+		if (outbin)
+			fclose(outbin);
 		if (outfb)
 			fclose(outfb);
+
+		cgltf_free(data);
+		return 4;
 	}
-	else if (oext && (strcmp(oext, ".glb") == 0 || strcmp(oext, ".GLB") == 0))
-	{
-		std::string fbpath = output;
-		fbpath.replace(fbpath.size() - 4, 4, ".fallback.bin");
 
-		FILE* out = fopen(output, "wb");
-		FILE* outfb = settings.fallback ? fopen(fbpath.c_str(), "wb") : NULL;
-		if (!out || (!outfb && settings.fallback))
-		{
-			fprintf(stderr, "Error saving %s\n", output);
-			return 4;
-		}
+	std::string json;
+	OutputStream bin = {outbin, 0};
+	OutputStream fallback = {outfb, 0};
+	process(data, input, output, meshes, animations, settings, json, bin, fallback);
 
-		std::string bufferspec = getBufferSpec(NULL, bin.size(), settings.fallback ? getBaseName(fbpath.c_str()) : NULL, fallback.size(), settings.compress);
+	cgltf_free(data);
+
+	bool ok = true;
+
+	if (out_gltf)
+	{
+		std::string bufferspec = getBufferSpec(getBaseName(binpath.c_str()), bin.size, settings.fallback ? getBaseName(fbpath.c_str()) : NULL, fallback.size, settings.compress);
+
+		fprintf(out, "{");
+		fwrite(bufferspec.c_str(), bufferspec.size(), 1, out);
+		fprintf(out, ",");
+		fwrite(json.c_str(), json.size(), 1, out);
+		fprintf(out, "}");
+	}
+	else
+	{
+		std::string bufferspec = getBufferSpec(NULL, bin.size, settings.fallback ? getBaseName(fbpath.c_str()) : NULL, fallback.size, settings.compress);
 
 		json.insert(0, "{" + bufferspec + ",");
 		json.push_back('}');
@@ -794,31 +888,33 @@ int gltfpack(const char* input, const char* output, const Settings& settings)
 		while (json.size() % 4)
 			json.push_back(' ');
 
-		while (bin.size() % 4)
-			bin.push_back('\0');
+		alignStream(bin, 4);
 
 		writeU32(out, 0x46546C67);
 		writeU32(out, 2);
-		writeU32(out, uint32_t(12 + 8 + json.size() + 8 + bin.size()));
+		writeU32(out, uint32_t(12 + 8 + json.size() + 8 + bin.size));
 
 		writeU32(out, uint32_t(json.size()));
 		writeU32(out, 0x4E4F534A);
 		fwrite(json.c_str(), json.size(), 1, out);
 
-		writeU32(out, uint32_t(bin.size()));
+		writeU32(out, uint32_t(bin.size));
 		writeU32(out, 0x004E4942);
-		fwrite(bin.c_str(), bin.size(), 1, out);
-
-		if (settings.fallback)
-			fwrite(fallback.c_str(), fallback.size(), 1, outfb);
 
-		fclose(out);
-		if (outfb)
-			fclose(outfb);
+		ok = fflush(outbin) == 0 && fseek(outbin, 0, SEEK_SET) == 0 && copyFile(out, outbin, bin.size);
 	}
-	else
+
+	ok = !ferror(out) && !ferror(outbin) && ok;
+	ok = (!outfb || !ferror(outfb)) && ok;
+
+	ok = fclose(out) == 0 && ok;
+	ok = fclose(outbin) == 0 && ok;
+	if (outfb)
+		ok = fclose(outfb) == 0 && ok;
+
+	if (!ok)
 	{
-		fprintf(stderr, "Error saving %s: unknown extension (expected .gltf or .glb)\n", output);
+		fprintf(stderr, "Error saving %s\n", output);
 		return 4;
 	}
 
@@ -840,6 +936,7 @@ int main(int argc, char** argv)
 	settings.anim_freq = 30;
 	settings.simplify_threshold = 1.f;
 	settings.texture_quality = 50;
+	settings.jobs = 1;
 
 	const char* input = 0;
 	const char* output = 0;
@@ -884,6 +981,10 @@ int main(int argc, char** argv)
 		{
 			settings.anim_const = true;
 		}
+		else if (strcmp(arg, "-ak") == 0)
+		{
+			settings.anim_reduce = true;
+		}
 		else if (strcmp(arg, "-kn") == 0)
 		{
 			settings.keep_named = true;
@@ -970,6 +1071,14 @@ int main(int argc, char** argv)
 			settings.compress = true;
 			settings.fallback = true;
 		}
+		else if (strcmp(arg, "-j") == 0 && i + 1 < argc && isdigit(argv[i + 1][0]))
+		{
+			settings.jobs = atoi(argv[++i]);
+		}
+		else if (strcmp(arg, "-cache") == 0 && i + 1 < argc)
+		{
+			settings.cache_path = argv[++i];
+		}
 		else if (strcmp(arg, "-v") == 0)
 		{
 			settings.verbose = 1;
@@ -1002,6 +1111,19 @@ int main(int argc, char** argv)
 		}
 	}
 
+	// quantization settings that are used by encoders need to be validated here since encoders assert on invalid bit counts
+	if (settings.nrm_bits < 1 || settings.nrm_bits > 16)
+	{
+		fprintf(stderr, "Normal quantization bits must be between 1 and 16, got %d\n", settings.nrm_bits);
+		return 1;
+	}
+
+	if (settings.rot_bits < 4 || settings.rot_bits > 16)
+	{
+		fprintf(stderr, "Rotation quantization bits must be between 4 and 16, got %d\n", settings.rot_bits);
+		return 1;
+	}
+
 	// shortcut for gltfpack -v
 	if (settings.verbose && argc == 2)
 	{
@@ -1052,6 +1174,7 @@ int main(int argc, char** argv)
 			fprintf(stderr, "\t-as N: use N-bit quantization for scale (default: 16; N should be between 1 and 24)\n");
 			fprintf(stderr, "\t-af N: resample animations at N Hz (default: 30)\n");
 			fprintf(stderr, "\t-ac: keep constant animation tracks even if they don't modify the node transform\n");
+			fprintf(stderr, "\t-ak: remove keyframes that can be reconstructed by linear interpolation within the quantization tolerance\n");
 			fprintf(stderr, "\nScene:\n");
 			fprintf(stderr, "\t-kn: keep named nodes and meshes attached to named nodes so that named nodes can be transformed externally\n");
 			fprintf(stderr, "\t-ke: keep extras data\n");
@@ -1061,6 +1184,8 @@ int main(int argc, char** argv)
 			fprintf(stderr, "\nMiscellaneous:\n");
 			fprintf(stderr, "\t-cf: produce compressed gltf/glb files with fallback for loaders that don't support compression\n");
 			fprintf(stderr, "\t-noq: disable quantization; produces much larger glTF files with no extensions\n");
+			fprintf(stderr, "\t-j N: process meshes, encode textures and compress buffers using N threads (default: 1; 0 uses all available cores)\n");
+			fprintf(stderr, "\t-cache path: reuse processed meshes, compressed buffers and encoded textures from the cache folder at path, and store new results there\n");
 			fprintf(stderr, "\t-v: verbose output (print version when used without other options)\n");
 			fprintf(stderr, "\t-h: display this help and exit\n");
 		}
@@ -14,6 +14,8 @@
 #include "../extern/cgltf.h"
 
 #include <assert.h>
+#include <stdint.h>
+#include <stdio.h>
 
 #include <string>
 #include <vector>
@@ -66,7 +68,7 @@ struct Track
 
 	cgltf_interpolation_type interpolation;
 
-	std::vector<float> time; // empty for resampled or constant animations
+	std::vector<float> time; // empty for resampled or constant animations; contains the remaining keyframe times for reduced animations
 	std::vector<Attr> data;
 };
 
@@ -92,6 +94,7 @@ struct Settings
 
 	int anim_freq;
 	bool anim_const;
+	bool anim_reduce;
 
 	bool keep_named;
 	bool keep_extras;
@@ -119,9 +122,26 @@ struct Settings
 	bool compressmore;
 	bool fallback;
 
+	int jobs;
+	const char* cache_path;
+
 	int verbose;
 };
 
+struct Hasher
+{
+	uint64_t h1, h2;
+	uint64_t size;
+
+	Hasher();
+
+	void update(const void* data, size_t length);
+	void update(const std::string& data);
+	void update(size_t value);
+
+	std::string digest() const;
+};
+
 struct QuantizationPosition
 {
 	float offset[3];
@@ -216,6 +236,13 @@ struct BufferView
 	std::string data;
 
 	size_t bytes;
+	size_t raw_bytes;
+};
+
+struct OutputStream
+{
+	FILE* file; // may be NULL, in which case we only track the size
+	size_t size;
 };
 
 struct TempFile
@@ -231,11 +258,22 @@ std::string getFullPath(const char* path, const char* base_path);
 std::string getFileName(const char* path);
 bool readFile(const char* path, std::string& data);
 bool writeFile(const char* path, const std::string& data);
+void* mapFile(const char* path, size_t& size);
+void unmapFile(void* data, size_t size);
+void writeStream(OutputStream& stream, const void* data, size_t size);
+void alignStream(OutputStream& stream, size_t alignment);
+bool copyFile(FILE* out, FILE* in, size_t size);
+
+int getJobCount(int jobs);
+void parallelFor(size_t count, int jobs, void (*task)(void* context, size_t index), void* context);
+
+bool readCache(const Settings& settings, const std::string& key, std::string& data);
+bool writeCache(const Settings& settings, const std::string& key, const std::string& data);
 
 cgltf_data* parseObj(const char* path, std::vector<Mesh>& meshes, const char** error);
 cgltf_data* parseGltf(const char* path, std::vector<Mesh>& meshes, std::vector<Animation>& animations, const char** error);
 
-void processAnimation(Animation& animation, const Settings& settings);
+void processAnimations(std::vector<Animation>& animations, const Settings& settings);
 void processMesh(Mesh& mesh, const Settings& settings);
 
 void debugSimplify(const Mesh& mesh, Mesh& kinds, Mesh& loops, float ratio);
@@ -289,7 +327,8 @@ const char* animationPath(cgltf_animation_path_type type);
 
 void writeMaterial(std::string& json, const cgltf_data* data, const cgltf_material& material, const QuantizationTexture* qt);
 void writeBufferView(std::string& json, BufferView::Kind kind, StreamFormat::Filter filter, size_t count, size_t stride, size_t bin_offset, size_t bin_size, BufferView::Compression compression, size_t compressed_offset, size_t compressed_size);
-void writeImage(std::string& json, std::vector<BufferView>& views, const cgltf_image& image, const ImageInfo& info, size_t index, const char* input_path, const char* output_path, const Settings& settings);
+void encodeImages(std::vector<std::string>& encoded, const cgltf_data* data, const std::vector<ImageInfo>& images, const char* input_path, const Settings& settings);
+void writeImage(std::string& json, std::vector<BufferView>& views, const cgltf_image& image, const std::string& encoded, size_t index, const char* input_path, const char* output_path, const Settings& settings);
 void writeTexture(std::string& json, const cgltf_texture& texture, cgltf_data* data, const Settings& settings);
 void writeMeshAttributes(std::string& json, std::vector<BufferView>& views, std::string& json_accessors, size_t& accr_offset, const Mesh& mesh, int target, const QuantizationPosition& qp, const QuantizationTexture& qt, const Settings& settings);
 size_t writeMeshIndices(std::vector<BufferView>& views, std::string& json_accessors, size_t& accr_offset, const Mesh& mesh, const Settings& settings);
@@ -3,6 +3,7 @@
 
 #include <algorithm>
 
+#include <float.h>
 #include <math.h>
 #include <string.h>
 
@@ -520,7 +521,7 @@ static void simplifyMesh(Mesh& mesh, float threshold, bool aggressive)
 	// if the mesh is complex enough and the precise simplifier got "stuck", we'll try to simplify using the sloppy simplifier which is guaranteed to reach the target count
 	if (aggressive && target_index_count > 50 * 3 && mesh.indices.size() > target_index_count)
 	{
-		indices.resize(meshopt_simplifySloppy(&indices[0], &mesh.indices[0], mesh.indices.size(), positions->data[0].f, vertex_count, sizeof(Attr), target_index_count));
+		indices.resize(meshopt_simplifySloppy(&indices[0], &mesh.indices[0], mesh.indices.size(), positions->data[0].f, vertex_count, sizeof(Attr), target_index_count, FLT_MAX, NULL));
 		mesh.indices.swap(indices);
 	}
 }
@@ -715,10 +716,125 @@ static void sortPointMesh(Mesh& mesh)
 	}
 }
 
+static std::string getMeshCacheKey(const Mesh& mesh, const Settings& settings)
+{
+	Hasher hasher;
+	hasher.update("mesh", 4);
+	hasher.update(size_t(mesh.type));
+
+	// the mesh is hashed after filterStreams, so material and skin only affect processing through the streams that were kept
+	hasher.update(size_t(mesh.skin != NULL));
+
+	hasher.update(mesh.streams.size());
+
+	for (size_t i = 0; i < mesh.streams.size(); ++i)
+	{
+		const Stream& stream = mesh.streams[i];
+
+		hasher.update(size_t(stream.type));
+		hasher.update(size_t(stream.index));
+		hasher.update(size_t(stream.target));
+		hasher.update(stream.data.size());
+		hasher.update(stream.data.empty() ? NULL : &stream.data[0], stream.data.size() * sizeof(Attr));
+	}
+
+	hasher.update(mesh.indices.size());
+	hasher.update(mesh.indices.empty() ? NULL : &mesh.indices[0], mesh.indices.size() * sizeof(unsigned int));
+
+	hasher.update(&settings.simplify_threshold, sizeof(settings.simplify_threshold));
+	hasher.update(size_t(settings.simplify_aggressive));
+	hasher.update(size_t(settings.compressmore));
+
+	return hasher.digest();
+}
+
+static void writeMeshData(std::string& data, const Mesh& mesh)
+{
+	unsigned int header[2] = {unsigned(mesh.streams.size()), unsigned(mesh.indices.size())};
+	data.append(reinterpret_cast<const char*>(header), sizeof(header));
+
+	for (size_t i = 0; i < mesh.streams.size(); ++i)
+	{
+		const Stream& stream = mesh.streams[i];
+
+		int info[4] = {int(stream.type), stream.index, stream.target, int(stream.data.size())};
+		data.append(reinterpret_cast<const char*>(info), sizeof(info));
+
+		if (!stream.data.empty())
+			data.append(reinterpret_cast<const char*>(&stream.data[0]), stream.data.size() * sizeof(Attr));
+	}
+
+	if (!mesh.indices.empty())
+		data.append(reinterpret_cast<const char*>(&mesh.indices[0]), mesh.indices.size() * sizeof(unsigned int));
+}
+
+static bool readMeshData(Mesh& mesh, const std::string& data)
+{
+	size_t offset = 0;
+
+	unsigned int header[2];
+	if (data.size() < sizeof(header))
+		return false;
+
+	memcpy(header, data.data(), sizeof(header));
+	offset += sizeof(header);
+
+	std::vector<Stream> streams(header[0]);
+
+	for (size_t i = 0; i < streams.size(); ++i)
+	{
+		Stream& stream = streams[i];
+
+		int info[4];
+		if (data.size() - offset < sizeof(info))
+			return false;
+
+		memcpy(info, data.data() + offset, sizeof(info));
+		offset += sizeof(info);
+
+		if (info[3] < 0 || (data.size() - offset) / sizeof(Attr) < size_t(info[3]))
+			return false;
+
+		stream.type = cgltf_attribute_type(info[0]);
+		stream.index = info[1];
+		stream.target = info[2];
+		stream.data.resize(info[3]);
+
+		if (!stream.data.empty())
+			memcpy(&stream.data[0], data.data() + offset, stream.data.size() * sizeof(Attr));
+
+		offset += stream.data.size() * sizeof(Attr);
+	}
+
+	if ((data.size() - offset) != header[1] * sizeof(unsigned int))
+		return false;
+
+	mesh.streams.swap(streams);
+	mesh.indices.resize(header[1]);
+
+	if (!mesh.indices.empty())
+		memcpy(&mesh.indices[0], data.data() + offset, mesh.indices.size() * sizeof(unsigned int));
+
+	return true;
+}
+
 void processMesh(Mesh& mesh, const Settings& settings)
 {
 	filterStreams(mesh);
 
+	// processing results only depend on the filtered mesh data and a few settings, so they can be reused across runs
+	std::string cache_key;
+
+	if (settings.cache_path)
+	{
+		std::string cache_data;
+
+		cache_key = getMeshCacheKey(mesh, settings);
+
+		if (readCache(settings, cache_key, cache_data) && readMeshData(mesh, cache_data))
+			return;
+	}
+
 	switch (mesh.type)
 	{
 	case cgltf_primitive_type_points:
@@ -742,6 +858,14 @@ void processMesh(Mesh& mesh, const Settings& settings)
 	default:
 		assert(!"Unknown primitive type");
 	}
+
+	if (settings.cache_path)
+	{
+		std::string cache_data;
+		writeMeshData(cache_data, mesh);
+
+		writeCache(settings, cache_key, cache_data);
+	}
 }
 
 #ifndef NDEBUG
@@ -2,6 +2,7 @@
 #include "gltfpack.h"
 
 #include <stdio.h>
+#include <stdlib.h>
 #include <string.h>
 
 static const char* getError(cgltf_result result, cgltf_data* data)
@@ -340,12 +341,132 @@ static bool needsDummyBuffers(cgltf_data* data)
 	return false;
 }
 
+// cgltf release callbacks don't get the data size, so we need to remember it for each mapping
+// note: parseGltf and cgltf_free are never called concurrently, so this doesn't need to be thread-safe
+static std::vector<std::pair<void*, size_t> > gFileMappings;
+
+static cgltf_result readFileMapped(const cgltf_memory_options* memory_options, const cgltf_file_options* file_options, const char* path, cgltf_size* size, void** data)
+{
+	(void)file_options;
+
+	size_t mapped_size = 0;
+	void* mapped = mapFile(path, mapped_size);
+
+	if (mapped)
+	{
+		// buffers may be smaller than the file that contains them
+		if (size && *size > mapped_size)
+		{
+			unmapFile(mapped, mapped_size);
+			return cgltf_result_io_error;
+		}
+
+		gFileMappings.push_back(std::make_pair(mapped, mapped_size));
+
+		if (size && *size == 0)
+			*size = mapped_size;
+
+		*data = mapped;
+		return cgltf_result_success;
+	}
+
+	// when the file can't be mapped we fall back to regular reads, using the same allocator that cgltf uses for everything else
+	FILE* file = fopen(path, "rb");
+	if (!file)
+		return cgltf_result_file_not_found;
+
+	size_t file_size = size ? *size : 0;
+
+	if (file_size == 0)
+	{
+		fseek(file, 0, SEEK_END);
+		long length = ftell(file);
+		fseek(file, 0, SEEK_SET);
+
+		if (length < 0)
+		{
+			fclose(file);
+			return cgltf_result_io_error;
+		}
+
+		file_size = size_t(length);
+	}
+
+	void* file_data = memory_options->alloc ? memory_options->alloc(memory_options->user_data, file_size) : malloc(file_size);
+	if (!file_data)
+	{
+		fclose(file);
+		return cgltf_result_out_of_memory;
+	}
+
+	size_t read_size = fread(file_data, 1, file_size, file);
+	fclose(file);
+
+	if (read_size != file_size)
+	{
+		memory_options->free ? memory_options->free(memory_options->user_data, file_data) : free(file_data);
+		return cgltf_result_io_error;
+	}
+
+	if (size)
+		*size = file_size;
+
+	*data = file_data;
+	return cgltf_result_success;
+}
+
+static void releaseFileMapped(const cgltf_memory_options* memory_options, const cgltf_file_options* file_options, void* data)
+{
+	(void)file_options;
+
+	for (size_t i = 0; i < gFileMappings.size(); ++i)
+	{
+		if (gFileMappings[i].first == data)
+		{
+			unmapFile(data, gFileMappings[i].second);
+
+			gFileMappings[i] = gFileMappings.back();
+			gFileMappings.pop_back();
+			return;
+		}
+	}
+
+	// data URIs and files that couldn't be mapped are allocated by cgltf
+	memory_options->free ? memory_options->free(memory_options->user_data, data) : free(data);
+}
+
+static cgltf_result parseFileMapped(const cgltf_options* options, const char* path, cgltf_data** out_data)
+{
+	void* file_data = NULL;
+	cgltf_size file_size = 0;
+
+	cgltf_result result = readFileMapped(&options->memory, &options->file, path, &file_size, &file_data);
+	if (result != cgltf_result_success)
+		return result;
+
+	// unlike cgltf_parse_file, we need to release the data using the file callbacks when parsing fails since it may be mapped
+	result = cgltf_parse(options, file_data, file_size, out_data);
+
+	if (result != cgltf_result_success)
+	{
+		releaseFileMapped(&options->memory, &options->file, file_data);
+		return result;
+	}
+
+	(*out_data)->file_data = file_data;
+
+	return cgltf_result_success;
+}
+
 cgltf_data* parseGltf(const char* path, std::vector<Mesh>& meshes, std::vector<Animation>& animations, const char** error)
 {
 	cgltf_data* data = 0;
 
+	// input files are memory-mapped so that buffers and the GLB binary chunk are used in place instead of being copied to the heap
 	cgltf_options options = {};
-	cgltf_result result = cgltf_parse_file(&options, path, &data);
+	options.file.read = readFileMapped;
+	options.file.release = releaseFileMapped;
+	cgltf_result result = parseFileMapped(&options, path, &data);
 	result = (result == cgltf_result_success) ? cgltf_load_buffers(&options, data, path) : result;
 	result = (result == cgltf_result_success) ? cgltf_validate(data) : result;
 
@@ -191,19 +191,18 @@ static void renormalizeWeights(uint8_t (&w)[4])
 	w[max] += uint8_t(255 - sum);
 }
 
-static void encodeOct(int& fu, int& fv, float nx, float ny, float nz, int bits)
+// appends size zero bytes to the binary and returns a pointer to them
+static char* appendData(std::string& bin, size_t size)
 {
-	float nl = fabsf(nx) + fabsf(ny) + fabsf(nz);
-	float ns = nl == 0.f ? 0.f : 1.f / nl;
+	size_t offset = bin.size();
+	bin.resize(offset + size);
 
-	nx *= ns;
-	ny *= ns;
-
-	float u = (nz >= 0.f) ? nx : (1 - fabsf(ny)) * (nx >= 0.f ? 1.f : -1.f);
-	float v = (nz >= 0.f) ? ny : (1 - fabsf(nx)) * (ny >= 0.f ? 1.f : -1.f);
+	return size ? &bin[offset] : NULL;
+}
 
-	fu = meshopt_quantizeSnorm(u, bits);
-	fv = meshopt_quantizeSnorm(v, bits);
+static const float* getAttrData(const std::vector<Attr>& data)
+{
+	return data.empty() ? NULL : data[0].f;
 }
 
 static StreamFormat writeVertexStreamRaw(std::string& bin, const Stream& stream, cgltf_type type, size_t components)
@@ -332,61 +331,14 @@ StreamFormat writeVertexStream(std::string& bin, const Stream& stream, const Qua
 
 		StreamFormat::Filter filter = oct ? StreamFormat::Filter_Oct : StreamFormat::Filter_None;
 
-		for (size_t i = 0; i < stream.data.size(); ++i)
-		{
-			const Attr& a = stream.data[i];
-
-			float nx = a.f[0], ny = a.f[1], nz = a.f[2];
-
-			if (bits > 8)
-			{
-				int16_t v[4];
-
-				if (oct)
-				{
-					int fu, fv;
-					encodeOct(fu, fv, nx, ny, nz, bits);
-
-					v[0] = int16_t(fu);
-					v[1] = int16_t(fv);
-					v[2] = int16_t(meshopt_quantizeSnorm(1.f, bits));
-					v[3] = 0;
-				}
-				else
-				{
-					v[0] = int16_t(meshopt_quantizeSnorm(nx, bits));
-					v[1] = int16_t(meshopt_quantizeSnorm(ny, bits));
-					v[2] = int16_t(meshopt_quantizeSnorm(nz, bits));
-					v[3] = 0;
-				}
-
-				bin.append(reinterpret_cast<const char*>(v), sizeof(v));
-			}
-			else
-			{
-				int8_t v[4];
-
-				if (oct)
-				{
-					int fu, fv;
-					encodeOct(fu, fv, nx, ny, nz, bits);
-
-					v[0] = int8_t(fu);
-					v[1] = int8_t(fv);
-					v[2] = int8_t(meshopt_quantizeSnorm(1.f, bits));
-					v[3] = 0;
-				}
-				else
-				{
-					v[0] = int8_t(meshopt_quantizeSnorm(nx, bits));
-					v[1] = int8_t(meshopt_quantizeSnorm(ny, bits));
-					v[2] = int8_t(meshopt_quantizeSnorm(nz, bits));
-					v[3] = 0;
-				}
+		size_t stride = (bits > 8) ? 8 : 4;
+		char* data = appendData(bin, stream.data.size() * stride);
 
-				bin.append(reinterpret_cast<const char*>(v), sizeof(v));
-			}
-		}
+		// note: the 4th component is padding; it stays zero for non-oct encoding and encodes .w (which is zero for normals) otherwise
+		if (oct)
+			meshopt_encodeFilterOct(data, stream.data.size(), stride, bits, getAttrData(stream.data));
+		else
+			meshopt_quantizeSnormBuffer(data, stream.data.size(), stride, stride / 4, getAttrData(stream.data), sizeof(Attr), 3, bits);
 
 		if (bits > 8)
 		{
@@ -409,34 +361,12 @@ StreamFormat writeVertexStream(std::string& bin, const Stream& stream, const Qua
 
 		StreamFormat::Filter filter = oct ? StreamFormat::Filter_Oct : StreamFormat::Filter_None;
 
-		for (size_t i = 0; i < stream.data.size(); ++i)
-		{
-			const Attr& a = stream.data[i];
-
-			float nx = a.f[0], ny = a.f[1], nz = a.f[2], nw = a.f[3];
+		char* data = appendData(bin, stream.data.size() * 4);
 
-			int8_t v[4];
-
-			if (oct)
-			{
-				int fu, fv;
-				encodeOct(fu, fv, nx, ny, nz, bits);
-
-				v[0] = int8_t(fu);
-				v[1] = int8_t(fv);
-				v[2] = int8_t(meshopt_quantizeSnorm(1.f, bits));
-				v[3] = int8_t(meshopt_quantizeSnorm(nw, bits));
-			}
-			else
-			{
-				v[0] = int8_t(meshopt_quantizeSnorm(nx, bits));
-				v[1] = int8_t(meshopt_quantizeSnorm(ny, bits));
-				v[2] = int8_t(meshopt_quantizeSnorm(nz, bits));
-				v[3] = int8_t(meshopt_quantizeSnorm(nw, bits));
-			}
-
-			bin.append(reinterpret_cast<const char*>(v), sizeof(v));
-		}
+		if (oct)
+			meshopt_encodeFilterOct(data, stream.data.size(), 4, bits, getAttrData(stream.data));
+		else
+			meshopt_quantizeSnormBuffer(data, stream.data.size(), 4, 1, getAttrData(stream.data), sizeof(Attr), 4, bits);
 
 		cgltf_type type = (stream.target == 0) ? cgltf_type_vec4 : cgltf_type_vec3;
 
@@ -445,17 +375,9 @@ StreamFormat writeVertexStream(std::string& bin, const Stream& stream, const Qua
 	}
 	else if (stream.type == cgltf_attribute_type_color)
 	{
-		for (size_t i = 0; i < stream.data.size(); ++i)
-		{
-			const Attr& a = stream.data[i];
+		char* data = appendData(bin, stream.data.size() * 4);
 
-			uint8_t v[4] = {
-			    uint8_t(meshopt_quantizeUnorm(a.f[0], 8)),
-			    uint8_t(meshopt_quantizeUnorm(a.f[1], 8)),
-			    uint8_t(meshopt_quantizeUnorm(a.f[2], 8)),
-			    uint8_t(meshopt_quantizeUnorm(a.f[3], 8))};
-			bin.append(reinterpret_cast<const char*>(v), sizeof(v));
-		}
+		meshopt_quantizeUnormBuffer(data, stream.data.size(), 4, 1, getAttrData(stream.data), sizeof(Attr), 4, 8);
 
 		StreamFormat format = {cgltf_type_vec4, cgltf_component_type_r_8u, true, 4};
 		return format;
@@ -577,26 +499,6 @@ StreamFormat writeTimeStream(std::string& bin, const std::vector<float>& data)
 	return format;
 }
 
-static void encodeQuat(int16_t v[4], const Attr& a, int bits)
-{
-	const float scaler = sqrtf(2.f);
-
-	// establish maximum quaternion component
-	int qc = 0;
-	qc = fabsf(a.f[1]) > fabsf(a.f[qc]) ? 1 : qc;
-	qc = fabsf(a.f[2]) > fabsf(a.f[qc]) ? 2 : qc;
-	qc = fabsf(a.f[3]) > fabsf(a.f[qc]) ? 3 : qc;
-
-	// we use double-cover properties to discard the sign
-	float sign = a.f[qc] < 0.f ? -1.f : 1.f;
-
-	// note: we always encode a cyclical swizzle to be able to recover the order via rotation
-	v[0] = int16_t(meshopt_quantizeSnorm(a.f[(qc + 1) & 3] * scaler * sign, bits));
-	v[1] = int16_t(meshopt_quantizeSnorm(a.f[(qc + 2) & 3] * scaler * sign, bits));
-	v[2] = int16_t(meshopt_quantizeSnorm(a.f[(qc + 3) & 3] * scaler * sign, bits));
-	v[3] = int16_t((meshopt_quantizeSnorm(1.f, bits) & ~3) | qc);
-}
-
 static void encodeExpShared(uint32_t v[3], const Attr& a, int bits)
 {
 	// get exponents from all components
@@ -628,26 +530,12 @@ StreamFormat writeKeyframeStream(std::string& bin, cgltf_animation_path_type typ
 	{
 		StreamFormat::Filter filter = settings.compressmore ? StreamFormat::Filter_Quat : StreamFormat::Filter_None;
 
-		for (size_t i = 0; i < data.size(); ++i)
-		{
-			const Attr& a = data[i];
-
-			int16_t v[4];
-
-			if (filter == StreamFormat::Filter_Quat)
-			{
-				encodeQuat(v, a, settings.rot_bits);
-			}
-			else
-			{
-				v[0] = int16_t(meshopt_quantizeSnorm(a.f[0], 16));
-				v[1] = int16_t(meshopt_quantizeSnorm(a.f[1], 16));
-				v[2] = int16_t(meshopt_quantizeSnorm(a.f[2], 16));
-				v[3] = int16_t(meshopt_quantizeSnorm(a.f[3], 16));
-			}
+		char* output = appendData(bin, data.size() * 8);
 
-			bin.append(reinterpret_cast<const char*>(v), sizeof(v));
-		}
+		if (filter == StreamFormat::Filter_Quat)
+			meshopt_encodeFilterQuat(output, data.size(), 8, settings.rot_bits, getAttrData(data));
+		else
+			meshopt_quantizeSnormBuffer(output, data.size(), 8, 2, getAttrData(data), sizeof(Attr), 4, 16);
 
 		StreamFormat format = {cgltf_type_vec4, cgltf_component_type_r_16, true, 8, filter};
 		return format;
@@ -0,0 +1,146 @@
+// This file is part of gltfpack; see gltfpack.h for version/license details
+#include "gltfpack.h"
+
+#if defined(_WIN32)
+#include <windows.h>
+#elif !defined(__EMSCRIPTEN__)
+#include <pthread.h>
+#include <unistd.h>
+#define GLTFPACK_PTHREADS
+#endif
+
+// tasks are handed out one at a time from a shared counter; task granularity in gltfpack (a mesh, a buffer view) is coarse enough that a lock is cheap
+struct ParallelContext
+{
+	void (*task)(void* context, size_t index);
+	void* task_context;
+	size_t count;
+	size_t next;
+
+#if defined(_WIN32)
+	CRITICAL_SECTION lock;
+#elif defined(GLTFPACK_PTHREADS)
+	pthread_mutex_t lock;
+#endif
+};
+
+static bool getNextTask(ParallelContext& context, size_t& index)
+{
+#if defined(_WIN32)
+	EnterCriticalSection(&context.lock);
+#elif defined(GLTFPACK_PTHREADS)
+	pthread_mutex_lock(&context.lock);
+#endif
+
+	index = context.next;
+	bool result = index < context.count;
+	context.next += result;
+
+#if defined(_WIN32)
+	LeaveCriticalSection(&context.lock);
+#elif defined(GLTFPACK_PTHREADS)
+	pthread_mutex_unlock(&context.lock);
+#endif
+
+	return result;
+}
+
+static void runTasks(ParallelContext& context)
+{
+	size_t index = 0;
+
+	while (getNextTask(context, index))
+		context.task(context.task_context, index);
+}
+
+#if defined(_WIN32)
+static DWORD WINAPI workerThread(LPVOID data)
+{
+	runTasks(*static_cast<ParallelContext*>(data));
+	return 0;
+}
+#elif defined(GLTFPACK_PTHREADS)
+static void* workerThread(void* data)
+{
+	runTasks(*static_cast<ParallelContext*>(data));
+	return NULL;
+}
+#endif
+
+int getJobCount(int jobs)
+{
+	if (jobs > 0)
+		return jobs;
+
+#if defined(_WIN32)
+	SYSTEM_INFO info;
+	GetSystemInfo(&info);
+	return info.dwNumberOfProcessors > 0 ? int(info.dwNumberOfProcessors) : 1;
+#elif defined(GLTFPACK_PTHREADS)
+	long count = sysconf(_SC_NPROCESSORS_ONLN);
+	return count > 0 ? int(count) : 1;
+#else
+	return 1;
+#endif
+}
+
+void parallelFor(size_t count, int jobs, void (*task)(void* context, size_t index), void* task_context)
+{
+	ParallelContext context;
+	context.task = task;
+	context.task_context = task_context;
+	context.count = count;
+	context.next = 0;
+
+	size_t workers = size_t(getJobCount(jobs));
+	workers = workers < count ? workers : count;
+
+#if defined(_WIN32)
+	InitializeCriticalSection(&context.lock);
+
+	// the calling thread participates in the work, so we only need to spawn workers - 1 threads
+	std::vector<HANDLE> threads;
+
+	for (size_t i = 1; i < workers; ++i)
+	{
+		HANDLE thread = CreateThread(NULL, 0, workerThread, &context, 0, NULL);
+
+		// if we fail to create a thread, remaining tasks will be processed by threads that did start
+		if (thread)
+			threads.push_back(thread);
+	}
+
+	runTasks(context);
+
+	for (size_t i = 0; i < threads.size(); ++i)
+	{
+		WaitForSingleObject(threads[i], INFINITE);
+		CloseHandle(threads[i]);
+	}
+
+	DeleteCriticalSection(&context.lock);
+#elif defined(GLTFPACK_PTHREADS)
+	pthread_mutex_init(&context.lock, NULL);
+
+	// the calling thread participates in the work, so we only need to spawn workers - 1 threads
+	std::vector<pthread_t> threads;
+
+	for (size_t i = 1; i < workers; ++i)
+	{
+		pthread_t thread;
+
+		// if we fail to create a thread, remaining tasks will be processed by threads that did start
+		if (pthread_create(&thread, NULL, workerThread, &context) == 0)
+			threads.push_back(thread);
+	}
+
+	runTasks(context);
+
+	for (size_t i = 0; i < threads.size(); ++i)
+		pthread_join(threads[i], NULL);
+
+	pthread_mutex_destroy(&context.lock);
+#else
+	runTasks(context);
+#endif
+}
@@ -553,14 +553,11 @@ static std::string decodeUri(const char* uri)
 	return result;
 }
 
-void writeImage(std::string& json, std::vector<BufferView>& views, const cgltf_image& image, const ImageInfo& info, size_t index, const char* input_path, const char* output_path, const Settings& settings)
+static bool readImage(const cgltf_image& image, const char* input_path, bool read_uri, std::string& img_data, std::string& mime_type)
 {
-	std::string img_data;
-	std::string mime_type;
-
 	if (image.uri && parseDataUri(image.uri, mime_type, img_data))
 	{
-		// we will re-embed img_data below
+		// image data is embedded in the URI
 	}
 	else if (image.buffer_view && image.buffer_view->buffer->data)
 	{
@@ -570,7 +567,7 @@ void writeImage(std::string& json, std::vector<BufferView>& views, const cgltf_i
 	}
 	else if (image.uri)
 	{
-		if (settings.texture_embed)
+		if (read_uri)
 		{
 			std::string full_path = getFullPath(decodeUri(image.uri).c_str(), input_path);
 
@@ -586,23 +583,92 @@ void writeImage(std::string& json, std::vector<BufferView>& views, const cgltf_i
 	if (image.mime_type)
 		mime_type = image.mime_type;
 
-	if (!img_data.empty())
+	return !img_data.empty();
+}
+
+struct EncodeImageContext
+{
+	std::vector<std::string>* encoded;
+	const cgltf_data* data;
+	const std::vector<ImageInfo>* images;
+	const char* input_path;
+	const Settings* settings;
+};
+
+static void encodeImage(void* context, size_t index)
+{
+	const EncodeImageContext& ec = *static_cast<EncodeImageContext*>(context);
+	const cgltf_image& image = ec.data->images[index];
+	const ImageInfo& info = (*ec.images)[index];
+	const Settings& settings = *ec.settings;
+
+	std::string& result = (*ec.encoded)[index];
+
+	std::string img_data;
+	std::string mime_type;
+
+	if (!readImage(image, ec.input_path, /* read_uri= */ true, img_data, mime_type))
+		return;
+
+	// cache key covers everything that affects encoder output
+	Hasher hasher;
+	hasher.update("basis", 5);
+	hasher.update(img_data);
+	hasher.update(mime_type);
+	hasher.update(size_t(info.normal_map));
+	hasher.update(size_t(info.srgb));
+	hasher.update(size_t(settings.texture_quality));
+	hasher.update(size_t(settings.texture_uastc));
+	hasher.update(size_t(settings.texture_ktx2));
+
+	std::string key = hasher.digest();
+
+	if (readCache(settings, key, result))
+		return;
+
+	if (encodeBasis(img_data, mime_type.c_str(), result, info.normal_map, info.srgb, settings.texture_quality, settings.texture_uastc))
 	{
-		if (settings.texture_basis)
-		{
-			std::string encoded;
+		if (settings.texture_ktx2)
+			result = basisToKtx(result, info.srgb, settings.texture_uastc);
 
-			if (encodeBasis(img_data, mime_type.c_str(), encoded, info.normal_map, info.srgb, settings.texture_quality, settings.texture_uastc))
-			{
-				if (settings.texture_ktx2)
-					encoded = basisToKtx(encoded, info.srgb, settings.texture_uastc);
+		writeCache(settings, key, result);
+	}
+	else
+	{
+		result.clear();
 
+		if (image.uri && strncmp(image.uri, "data:", 5) != 0 && !settings.texture_embed)
+			fprintf(stderr, "Warning: unable to encode image %s with Basis, skipping\n", image.uri);
+		else
+			fprintf(stderr, "Warning: unable to encode image %d with Basis, skipping\n", int(index));
+	}
+}
+
+void encodeImages(std::vector<std::string>& encoded, const cgltf_data* data, const std::vector<ImageInfo>& images, const char* input_path, const Settings& settings)
+{
+	encoded.resize(data->images_count);
+
+	// each image is encoded by a separate basisu process, so images can be encoded concurrently
+	EncodeImageContext ec = {&encoded, data, &images, input_path, &settings};
+	parallelFor(data->images_count, settings.jobs, encodeImage, &ec);
+}
+
+void writeImage(std::string& json, std::vector<BufferView>& views, const cgltf_image& image, const std::string& encoded, size_t index, const char* input_path, const char* output_path, const Settings& settings)
+{
+	std::string img_data;
+	std::string mime_type;
+
+	// encodeImages has already read external images for Basis encoding and reported read errors, so we only need to know whether the output is embedded
+	bool read_uri = settings.texture_embed && !settings.texture_basis;
+	bool embedded = readImage(image, input_path, read_uri, img_data, mime_type) || (settings.texture_basis && settings.texture_embed && image.uri);
+
+	if (embedded)
+	{
+		if (settings.texture_basis)
+		{
+			// encodeImages reports errors for images that failed to encode
+			if (!encoded.empty())
 				writeEmbeddedImage(json, views, encoded.c_str(), encoded.size(), settings.texture_ktx2 ? "image/ktx2" : "image/basis");
-			}
-			else
-			{
-				fprintf(stderr, "Warning: unable to encode image %d with Basis, skipping\n", int(index));
-			}
 		}
 		else
 		{
@@ -613,39 +679,23 @@ void writeImage(std::string& json, std::vector<BufferView>& views, const cgltf_i
 	{
 		if (settings.texture_basis)
 		{
-			std::string full_path = getFullPath(decodeUri(image.uri).c_str(), input_path);
 			std::string basis_uri = getFileName(image.uri) + (settings.texture_ktx2 ? ".ktx2" : ".basis");
 			std::string basis_full_path = getFullPath(decodeUri(basis_uri.c_str()).c_str(), output_path);
 
-			if (readFile(full_path.c_str(), img_data))
+			// encodeImages reports errors for images that failed to encode
+			if (!encoded.empty())
 			{
-				std::string encoded;
-
-				if (encodeBasis(img_data, mime_type.c_str(), encoded, info.normal_map, info.srgb, settings.texture_quality, settings.texture_uastc))
+				if (writeFile(basis_full_path.c_str(), encoded))
 				{
-					if (settings.texture_ktx2)
-						encoded = basisToKtx(encoded, info.srgb, settings.texture_uastc);
-
-					if (writeFile(basis_full_path.c_str(), encoded))
-					{
-						append(json, "\"uri\":\"");
-						append(json, basis_uri);
-						append(json, "\"");
-					}
-					else
-					{
-						fprintf(stderr, "Warning: unable to save Basis image %s, skipping\n", image.uri);
-					}
+					append(json, "\"uri\":\"");
+					append(json, basis_uri);
+					append(json, "\"");
 				}
 				else
 				{
-					fprintf(stderr, "Warning: unable to encode image %s with Basis, skipping\n", image.uri);
+					fprintf(stderr, "Warning: unable to save Basis image %s, skipping\n", image.uri);
 				}
 			}
-			else
-			{
-				fprintf(stderr, "Warning: unable to read image %s, skipping\n", image.uri);
-			}
 		}
 		else
 		{
@@ -744,13 +794,8 @@ size_t writeMeshIndices(std::vector<BufferView>& views, std::string& json_access
 	return index_accr;
 }
 
-static size_t writeAnimationTime(std::vector<BufferView>& views, std::string& json_accessors, size_t& accr_offset, float mint, int frames, const Settings& settings)
+static size_t writeAnimationTime(std::vector<BufferView>& views, std::string& json_accessors, size_t& accr_offset, const std::vector<float>& time, const Settings& settings)
 {
-	std::vector<float> time(frames);
-
-	for (int j = 0; j < frames; ++j)
-		time[j] = mint + float(j) / settings.anim_freq;
-
 	std::string scratch;
 	StreamFormat format = writeTimeStream(scratch, time);
 	BufferView::Compression compression = settings.compress ? BufferView::Compression_Attribute : BufferView::Compression_None;
@@ -760,7 +805,7 @@ static size_t writeAnimationTime(std::vector<BufferView>& views, std::string& js
 	views[view].data += scratch;
 
 	comma(json_accessors);
-	writeAccessor(json_accessors, view, offset, cgltf_type_scalar, format.component_type, format.normalized, frames, &time.front(), &time.back(), 1);
+	writeAccessor(json_accessors, view, offset, cgltf_type_scalar, format.component_type, format.normalized, time.size(), &time.front(), &time.back(), 1);
 
 	size_t time_accr = accr_offset++;
 
@@ -1081,12 +1126,19 @@ void writeAnimation(std::string& json, std::vector<BufferView>& views, std::stri
 
 		bool tc = track.data.size() == track.components;
 
-		needs_time = needs_time || !tc;
+		needs_time = needs_time || (!tc && track.time.empty());
 		needs_pose = needs_pose || tc;
 	}
 
-	size_t time_accr = needs_time ? writeAnimationTime(views, json_accessors, accr_offset, animation.start, animation.frames, settings) : 0;
-	size_t pose_accr = needs_pose ? writeAnimationTime(views, json_accessors, accr_offset, animation.start, 1, settings) : 0;
+	std::vector<float> time(animation.frames);
+
+	for (int j = 0; j < animation.frames; ++j)
+		time[j] = animation.start + float(j) / settings.anim_freq;
+
+	std::vector<float> pose(1, animation.start);
+
+	size_t time_accr = needs_time ? writeAnimationTime(views, json_accessors, accr_offset, time, settings) : 0;
+	size_t pose_accr = needs_pose ? writeAnimationTime(views, json_accessors, accr_offset, pose, settings) : 0;
 
 	std::string json_samplers;
 	std::string json_channels;
@@ -1099,6 +1151,9 @@ void writeAnimation(std::string& json, std::vector<BufferView>& views, std::stri
 
 		bool tc = track.data.size() == track.components;
 
+		// reduced tracks have their own set of keyframe times
+		size_t input_accr = tc ? pose_accr : track.time.empty() ? time_accr : writeAnimationTime(views, json_accessors, accr_offset, track.time, settings);
+
 		std::string scratch;
 		StreamFormat format = writeKeyframeStream(scratch, track.path, track.data, settings);
 		BufferView::Compression compression = settings.compress && track.path != cgltf_animation_path_type_weights ? BufferView::Compression_Attribute : BufferView::Compression_None;
@@ -1114,7 +1169,7 @@ void writeAnimation(std::string& json, std::vector<BufferView>& views, std::stri
 
 		comma(json_samplers);
 		append(json_samplers, "{\"input\":");
-		append(json_samplers, tc ? pose_accr : time_accr);
+		append(json_samplers, input_accr);
 		append(json_samplers, ",\"output\":");
 		append(json_samplers, data_accr);
 		append(json_samplers, "}");
@@ -21,7 +21,7 @@ var MeshoptDecoder = (function() {
 		console.log("Warning: meshopt_decoder is using experimental SIMD support");
 	}
 
-	var instance, heap;
+	var instance, heap, wasm_module;
 
 	var env = {
 		emscripten_notify_memory_growth: function(index) {
@@ -33,6 +33,7 @@ var MeshoptDecoder = (function() {
 		WebAssembly.instantiate(unpack(wasm), { env })
 		.then(function(result) {
 			instance = result.instance;
+			wasm_module = result.module;
 			instance.exports._start();
 			env.emscripten_notify_memory_growth(0);
 		});
@@ -50,26 +51,157 @@ var MeshoptDecoder = (function() {
 		return result.buffer.slice(0, write);
 	}
 
-	function decode(fun, target, count, size, source, filter) {
+	var scratch = 0, scratch_size = 0;
+
+	// scratch memory is kept between calls to avoid heap churn; it's always at the top of the heap, so it can grow in place
+	function reserve(size) {
 		var sbrk = instance.exports.sbrk;
+		if (scratch_size == 0) {
+			scratch = sbrk(0);
+		}
+		if (size > scratch_size) {
+			sbrk(size - scratch_size);
+			scratch_size = size;
+		}
+		return scratch;
+	}
+
+	function decodeScratch(fun, count, size, source, filter) {
 		var count4 = (count + 3) & ~3; // pad for SIMD filter
-		var tp = sbrk(count4 * size);
-		var sp = sbrk(source.length);
+		var tp = reserve(count4 * size + source.length);
+		var sp = tp + count4 * size;
 		heap.set(source, sp);
 		var res = fun(tp, count, size, sp, source.length);
 		if (res == 0 && filter) {
 			filter(tp, count4, size);
 		}
-		target.set(heap.subarray(tp, tp + count * size));
-		sbrk(tp - sbrk(0));
 		if (res != 0) {
 			throw new Error("Malformed buffer data: " + res);
 		}
+		return tp;
+	}
+
+	function decode(fun, target, count, size, source, filter) {
+		var tp = decodeScratch(fun, count, size, source, filter);
+		target.set(heap.subarray(tp, tp + count * size));
 	};
 
 	var filters = ["", "meshopt_decodeFilterOct", "meshopt_decodeFilterQuat", "meshopt_decodeFilterExp"];
 	var decoders = ["meshopt_decodeVertexBuffer", "meshopt_decodeIndexBuffer", "meshopt_decodeIndexSequence"];
 
+	var workers = [];
+	var requestId = 0;
+
+	// worker code is assembled from the functions below and a copy of decode; workers instantiate the module compiled by the main thread
+	function workerInit(event) {
+		var data = event.data;
+
+		if (data.module) {
+			ready = WebAssembly.instantiate(data.module, { env })
+				.then(function(result) {
+					instance = result;
+					instance.exports._start();
+					env.emscripten_notify_memory_growth(0);
+				});
+			return;
+		}
+
+		ready.then(function() {
+			try {
+				var target = new Uint8Array(data.count * data.size);
+				decode(instance.exports[data.mode], target, data.count, data.size, data.source, instance.exports[data.filter]);
+				self.postMessage({ id: data.id, count: data.count, action: "resolve", value: target }, [ target.buffer ]);
+			} catch (error) {
+				self.postMessage({ id: data.id, count: data.count, action: "reject", value: error.message });
+			}
+		});
+	}
+
+	function createWorker(url) {
+		var worker = {
+			object: new Worker(url),
+			pending: 0,
+			requests: {}
+		};
+
+		worker.object.onmessage = function(event) {
+			var data = event.data;
+			var request = worker.requests[data.id];
+
+			worker.pending -= data.count;
+			delete worker.requests[data.id];
+
+			if (data.action == "resolve") {
+				request.resolve(data.value);
+			} else {
+				request.reject(new Error(data.value));
+			}
+		};
+
+		return worker;
+	}
+
+	function initWorkers(count) {
+		var source =
+			"var instance, heap, ready;" +
+			"var env = { emscripten_notify_memory_growth: function(index) { heap = new Uint8Array(instance.exports.memory.buffer); } };" +
+			"var scratch = 0, scratch_size = 0;" +
+			"self.onmessage = workerInit;" +
+			reserve.toString() + decodeScratch.toString() + decode.toString() + workerInit.toString();
+
+		var blob = new Blob([source], { type: "text/javascript" });
+		var url = URL.createObjectURL(blob);
+
+		for (var i = 0; i < count; ++i) {
+			workers.push(createWorker(url));
+		}
+
+		URL.revokeObjectURL(url);
+
+		// messages are processed in order, so requests posted later will wait for the module to be instantiated
+		promise.then(function() {
+			for (var i = 0; i < workers.length; ++i) {
+				workers[i].object.postMessage({ module: wasm_module });
+			}
+		});
+	}
+
+	function terminateWorkers() {
+		for (var i = 0; i < workers.length; ++i) {
+			workers[i].object.terminate();
+
+			for (var id in workers[i].requests) {
+				workers[i].requests[id].reject(new Error("Worker was terminated"));
+			}
+		}
+
+		workers = [];
+	}
+
+	function decodeWorker(count, size, source, mode, filter) {
+		// pick the worker with the least amount of pending work
+		var worker = workers[0];
+
+		for (var i = 1; i < workers.length; ++i) {
+			if (workers[i].pending < worker.pending) {
+				worker = workers[i];
+			}
+		}
+
+		return new Promise(function(resolve, reject) {
+			// source is copied since it usually references a part of a larger buffer; the copy is transferred to the worker
+			var data = new Uint8Array(source);
+			var id = requestId++;
+
+			worker.pending += count;
+			worker.requests[id] = { resolve: resolve, reject: reject };
+
+			promise.then(function() {
+				worker.object.postMessage({ id: id, count: count, size: size, source: data, mode: mode, filter: filter }, [ data.buffer ]);
+			});
+		});
+	}
+
 	return {
 		ready: promise,
 		decodeVertexBuffer: function(target, count, size, source, filter) {
@@ -83,6 +215,25 @@ var MeshoptDecoder = (function() {
 		},
 		decodeGltfBuffer: function(target, count, size, source, mode, filter) {
 			decode(instance.exports[decoders[mode]], target, count, size, source, instance.exports[filters[filter]]);
+		},
+		decodeGltfBufferView: function(count, size, source, mode, filter) {
+			var tp = decodeScratch(instance.exports[decoders[mode]], count, size, source, instance.exports[filters[filter]]);
+			return heap.subarray(tp, tp + count * size);
+		},
+		useWorkers: function(count) {
+			terminateWorkers();
+			initWorkers(count);
+		},
+		decodeGltfBufferAsync: function(count, size, source, mode, filter) {
+			if (workers.length > 0) {
+				return decodeWorker(count, size, source, decoders[mode], filters[filter]);
+			}
+
+			return promise.then(function() {
+				var target = new Uint8Array(count * size);
+				decode(instance.exports[decoders[mode]], target, count, size, source, instance.exports[filters[filter]]);
+				return target;
+			});
 		}
 	};
 })();
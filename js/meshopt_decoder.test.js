@@ -6,6 +6,72 @@ process.on('unhandledRejection', error => {
 	process.exit(1);
 });
 
+// Web Worker emulation on top of worker_threads, used to test the worker pool in node.js
+if (typeof Worker === 'undefined') {
+	var worker_threads = require('worker_threads');
+	var blobs = require('buffer');
+
+	global.Worker = function(url) {
+		var worker = this;
+		var thread = null;
+		var queue = [];
+
+		var shim =
+			"var parentPort = require('worker_threads').parentPort;" +
+			"var self = { postMessage: function(message, transfer) { parentPort.postMessage(message, transfer); } };" +
+			"parentPort.on('message', function(message) { self.onmessage({ data: message }); });";
+
+		blobs.resolveObjectURL(url).text().then(function(source) {
+			thread = new worker_threads.Worker(shim + source, { eval: true });
+			thread.on('message', function(message) { worker.onmessage({ data: message }); });
+
+			for (var i = 0; i < queue.length; ++i) {
+				thread.postMessage(queue[i][0], queue[i][1]);
+			}
+		});
+
+		this.postMessage = function(message, transfer) {
+			if (thread) {
+				thread.postMessage(message, transfer);
+			} else {
+				queue.push([message, transfer]);
+			}
+		};
+
+		this.terminate = function() {
+			queue = [];
+			if (thread) {
+				thread.terminate();
+			}
+		};
+	};
+}
+
+var vertexEncoded = new Uint8Array([
+	0xa0, 0x01, 0x3f, 0x00, 0x00, 0x00, 0x58, 0x57, 0x58, 0x01, 0x26, 0x00, 0x00, 0x00, 0x01,
+	0x0c, 0x00, 0x00, 0x00, 0x58, 0x01, 0x08, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x01,
+	0x3f, 0x00, 0x00, 0x00, 0x17, 0x18, 0x17, 0x01, 0x26, 0x00, 0x00, 0x00, 0x01, 0x0c, 0x00,
+	0x00, 0x00, 0x17, 0x01, 0x08, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+	0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+	0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+]);
+
+var vertexExpected = new Uint8Array([
+	0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+	44, 1, 0, 0, 0, 0, 0, 0, 244, 1, 0, 0,
+	0, 0, 44, 1, 0, 0, 0, 0, 0, 0, 244, 1,
+	44, 1, 44, 1, 0, 0, 0, 0, 244, 1, 244, 1
+]);
+
+var indexEncoded = new Uint8Array([
+	0xe0, 0xf0, 0x10, 0xfe, 0xff, 0xf0, 0x0c, 0xff, 0x02, 0x02, 0x02, 0x00, 0x76, 0x87, 0x56, 0x67,
+	0x78, 0xa9, 0x86, 0x65, 0x89, 0x68, 0x98, 0x01, 0x69, 0x00, 0x00,
+]);
+
+var indexExpected = new Uint32Array([
+	0, 1, 2, 2, 1, 3, 4, 6, 5, 7, 8, 9
+]);
+
 var tests = {
 	decodeVertexBuffer: function() {
 		var encoded = new Uint8Array([
@@ -178,13 +244,79 @@ var tests = {
 
 		assert.deepStrictEqual(result, expected);
 	},
+
+	decodeGltfBufferView: function() {
+		var vertex = decoder.decodeGltfBufferView(4, 12, vertexEncoded, /* mode= */ 0);
+		assert.deepStrictEqual(new Uint8Array(vertex), vertexExpected);
+
+		// the view references scratch memory that is reused by the next call
+		var index = decoder.decodeGltfBufferView(12, 4, indexEncoded, /* mode= */ 1);
+		assert.deepStrictEqual(new Uint32Array(index.slice().buffer), indexExpected);
+		assert.equal(index.buffer, vertex.buffer);
+		assert.equal(index.byteOffset, vertex.byteOffset);
+
+		// regular decoding reuses the same scratch memory
+		var result = new Uint8Array(vertexExpected.length);
+		decoder.decodeGltfBuffer(result, 4, 12, vertexEncoded, /* mode= */ 0);
+		assert.deepStrictEqual(result, vertexExpected);
+		assert.deepStrictEqual(new Uint8Array(index), vertexExpected.subarray(0, index.length));
+
+		assert.throws(function() {
+			decoder.decodeGltfBufferView(4, 12, vertexEncoded.subarray(0, 10), /* mode= */ 0);
+		}, /Malformed buffer data/);
+	},
+
+	decodeGltfBufferAsync: function() {
+		// without workers, decoding happens on the calling thread after the module is ready
+		return Promise.all([
+			decoder.decodeGltfBufferAsync(4, 12, vertexEncoded, /* mode= */ 0),
+			decoder.decodeGltfBufferAsync(12, 4, indexEncoded, /* mode= */ 1),
+		]).then(function(results) {
+			assert.deepStrictEqual(results[0], vertexExpected);
+			assert.deepStrictEqual(new Uint32Array(results[1].buffer), indexExpected);
+		});
+	},
+
+	decodeGltfBufferWorkers: function() {
+		decoder.useWorkers(2);
+
+		// sources are copied before transferring them to the workers, so the caller's data stays intact
+		var source = new Uint8Array(vertexEncoded);
+
+		var requests = [];
+
+		for (var i = 0; i < 8; ++i) {
+			requests.push(decoder.decodeGltfBufferAsync(4, 12, source, /* mode= */ 0));
+			requests.push(decoder.decodeGltfBufferAsync(12, 4, indexEncoded, /* mode= */ 1));
+		}
+
+		assert.deepStrictEqual(source, vertexEncoded);
+
+		var malformed = decoder.decodeGltfBufferAsync(4, 12, vertexEncoded.subarray(0, 10), /* mode= */ 0)
+			.then(function() {
+				assert.fail('malformed data should be rejected');
+			}, function(error) {
+				assert(error.message.indexOf('Malformed buffer data') == 0);
+			});
+
+		return Promise.all(requests).then(function(results) {
+			for (var i = 0; i < results.length; i += 2) {
+				assert.deepStrictEqual(results[i], vertexExpected);
+				assert.deepStrictEqual(new Uint32Array(results[i + 1].buffer), indexExpected);
+			}
+
+			return malformed;
+		}).finally(function() {
+			decoder.useWorkers(0);
+		});
+	},
 };
 
-decoder.ready.then(() => {
+decoder.ready.then(async () => {
 	var count = 0;
 
 	for (var key in tests) {
-		tests[key]();
+		await tests[key]();
 		count++;
 	}
 
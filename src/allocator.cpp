@@ -6,3 +6,23 @@ void meshopt_setAllocator(void* (*allocate)(size_t), void (*deallocate)(void*))
 	meshopt_Allocator::Storage::allocate = allocate;
 	meshopt_Allocator::Storage::deallocate = deallocate;
 }
+
+void meshopt_setAllocatorContext(void* (*allocate)(void* context, size_t size), void (*deallocate)(void* context, void* ptr), void* context)
+{
+	// both callbacks have to be set together, otherwise memory would be released through a different allocator
+	assert((allocate == 0) == (deallocate == 0));
+
+	// context callbacks are thread-local, so this only changes the callbacks of the calling thread
+
+	meshopt_Allocator::Storage::allocate_context = allocate;
+	meshopt_Allocator::Storage::deallocate_context = deallocate;
+	meshopt_Allocator::Storage::context = context;
+}
+
+void meshopt_setProfiler(void (*begin)(void* context, const char* name), void (*end)(void* context, const char* name), void (*counter)(void* context, const char* name, size_t value), void* context)
+{
+	meshopt_ProfileZone::Storage::begin = begin;
+	meshopt_ProfileZone::Storage::end = end;
+	meshopt_ProfileZone::Storage::counter = counter;
+	meshopt_ProfileZone::Storage::context = context;
+}
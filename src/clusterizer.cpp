@@ -2,6 +2,8 @@
 #include "meshoptimizer.h"
 
 #include <assert.h>
+#include <float.h>
+#include <limits.h>
 #include <math.h>
 #include <string.h>
 
@@ -12,6 +14,64 @@
 namespace meshopt
 {
 
+struct TriangleAdjacency2
+{
+	unsigned int* counts;
+	unsigned int* offsets;
+	unsigned int* data;
+};
+
+static void buildTriangleAdjacency(TriangleAdjacency2& adjacency, const unsigned int* indices, size_t index_count, size_t vertex_count, meshopt_Allocator& allocator)
+{
+	MESHOPTIMIZER_ZONE("buildTriangleAdjacency");
+
+	size_t face_count = index_count / 3;
+
+	// allocate arrays
+	adjacency.counts = allocator.allocate<unsigned int>(vertex_count);
+	adjacency.offsets = allocator.allocate<unsigned int>(vertex_count);
+	adjacency.data = allocator.allocate<unsigned int>(index_count);
+
+	// fill triangle counts
+	memset(adjacency.counts, 0, vertex_count * sizeof(unsigned int));
+
+	for (size_t i = 0; i < index_count; ++i)
+	{
+		assert(indices[i] < vertex_count);
+
+		adjacency.counts[indices[i]]++;
+	}
+
+	// fill offset table
+	unsigned int offset = 0;
+
+	for (size_t i = 0; i < vertex_count; ++i)
+	{
+		adjacency.offsets[i] = offset;
+		offset += adjacency.counts[i];
+	}
+
+	assert(offset == index_count);
+
+	// fill triangle data
+	for (size_t i = 0; i < face_count; ++i)
+	{
+		unsigned int a = indices[i * 3 + 0], b = indices[i * 3 + 1], c = indices[i * 3 + 2];
+
+		adjacency.data[adjacency.offsets[a]++] = unsigned(i);
+		adjacency.data[adjacency.offsets[b]++] = unsigned(i);
+		adjacency.data[adjacency.offsets[c]++] = unsigned(i);
+	}
+
+	// fix offsets that have been disturbed by the previous pass
+	for (size_t i = 0; i < vertex_count; ++i)
+	{
+		assert(adjacency.offsets[i] >= adjacency.counts[i]);
+
+		adjacency.offsets[i] -= adjacency.counts[i];
+	}
+}
+
 static void computeBoundingSphere(float result[4], const float points[][3], size_t count)
 {
 	assert(count > 0);
@@ -82,6 +142,363 @@ static void computeBoundingSphere(float result[4], const float points[][3], size
 	result[3] = radius;
 }
 
+struct Cone
+{
+	float px, py, pz;
+	float nx, ny, nz;
+};
+
+static float getMeshletScore(float distance2, float spread, float cone_weight, float expected_radius)
+{
+	float cone = 1.f - spread * cone_weight;
+	float cone_clamped = cone < 1e-3f ? 1e-3f : cone;
+
+	return (1 + sqrtf(distance2) / expected_radius * (1 - cone_weight)) * cone_clamped;
+}
+
+static Cone getMeshletCone(const Cone& acc, unsigned int triangle_count)
+{
+	Cone result = acc;
+
+	float center_scale = triangle_count == 0 ? 0.f : 1.f / float(triangle_count);
+
+	result.px *= center_scale;
+	result.py *= center_scale;
+	result.pz *= center_scale;
+
+	float axis_length = result.nx * result.nx + result.ny * result.ny + result.nz * result.nz;
+	float axis_scale = axis_length == 0.f ? 0.f : 1.f / sqrtf(axis_length);
+
+	result.nx *= axis_scale;
+	result.ny *= axis_scale;
+	result.nz *= axis_scale;
+
+	return result;
+}
+
+static float computeTriangleCones(Cone* triangles, const unsigned int* indices, size_t index_count, const float* vertex_positions, size_t vertex_count, size_t vertex_positions_stride)
+{
+	MESHOPTIMIZER_ZONE("computeTriangleCones");
+
+	(void)vertex_count;
+
+	size_t vertex_stride_float = vertex_positions_stride / sizeof(float);
+	size_t face_count = index_count / 3;
+
+	float mesh_area = 0;
+
+	for (size_t i = 0; i < face_count; ++i)
+	{
+		unsigned int a = indices[i * 3 + 0], b = indices[i * 3 + 1], c = indices[i * 3 + 2];
+		assert(a < vertex_count && b < vertex_count && c < vertex_count);
+
+		const float* p0 = vertex_positions + vertex_stride_float * a;
+		const float* p1 = vertex_positions + vertex_stride_float * b;
+		const float* p2 = vertex_positions + vertex_stride_float * c;
+
+		float p10[3] = {p1[0] - p0[0], p1[1] - p0[1], p1[2] - p0[2]};
+		float p20[3] = {p2[0] - p0[0], p2[1] - p0[1], p2[2] - p0[2]};
+
+		float normalx = p10[1] * p20[2] - p10[2] * p20[1];
+		float normaly = p10[2] * p20[0] - p10[0] * p20[2];
+		float normalz = p10[0] * p20[1] - p10[1] * p20[0];
+
+		float area = sqrtf(normalx * normalx + normaly * normaly + normalz * normalz);
+		float invarea = (area == 0.f) ? 0.f : 1.f / area;
+
+		triangles[i].px = (p0[0] + p1[0] + p2[0]) / 3.f;
+		triangles[i].py = (p0[1] + p1[1] + p2[1]) / 3.f;
+		triangles[i].pz = (p0[2] + p1[2] + p2[2]) / 3.f;
+
+		triangles[i].nx = normalx * invarea;
+		triangles[i].ny = normaly * invarea;
+		triangles[i].nz = normalz * invarea;
+
+		mesh_area += area;
+	}
+
+	return mesh_area;
+}
+
+static bool appendMeshlet(meshopt_PackedMeshlet& meshlet, unsigned int a, unsigned int b, unsigned int c, unsigned char* used, meshopt_PackedMeshlet* meshlets, unsigned int* meshlet_vertices, unsigned char* meshlet_triangles, size_t meshlet_offset, size_t max_vertices, size_t max_triangles)
+{
+	unsigned char& av = used[a];
+	unsigned char& bv = used[b];
+	unsigned char& cv = used[c];
+
+	bool result = false;
+
+	unsigned int used_extra = (av == 0xff) + (bv == 0xff) + (cv == 0xff);
+
+	if (meshlet.vertex_count + used_extra > max_vertices || meshlet.triangle_count >= max_triangles)
+	{
+		meshlets[meshlet_offset] = meshlet;
+
+		for (size_t j = 0; j < meshlet.vertex_count; ++j)
+			used[meshlet_vertices[meshlet.vertex_offset + j]] = 0xff;
+
+		// triangle data of each meshlet is padded to 4 bytes to make it easier to address on the GPU
+		meshlet.vertex_offset += meshlet.vertex_count;
+		meshlet.triangle_offset += (meshlet.triangle_count * 3 + 3) & ~3;
+		meshlet.vertex_count = 0;
+		meshlet.triangle_count = 0;
+
+		result = true;
+	}
+
+	if (av == 0xff)
+	{
+		av = (unsigned char)meshlet.vertex_count;
+		meshlet_vertices[meshlet.vertex_offset + meshlet.vertex_count++] = a;
+	}
+
+	if (bv == 0xff)
+	{
+		bv = (unsigned char)meshlet.vertex_count;
+		meshlet_vertices[meshlet.vertex_offset + meshlet.vertex_count++] = b;
+	}
+
+	if (cv == 0xff)
+	{
+		cv = (unsigned char)meshlet.vertex_count;
+		meshlet_vertices[meshlet.vertex_offset + meshlet.vertex_count++] = c;
+	}
+
+	unsigned char* triangle = meshlet_triangles + meshlet.triangle_offset + meshlet.triangle_count * 3;
+
+	triangle[0] = av;
+	triangle[1] = bv;
+	triangle[2] = cv;
+	meshlet.triangle_count++;
+
+	return result;
+}
+
+static unsigned int getNeighborTriangle(const meshopt_PackedMeshlet& meshlet, const Cone* meshlet_cone, const unsigned int* meshlet_vertices, const unsigned int* indices, const TriangleAdjacency2& adjacency, const Cone* triangles, const unsigned int* live_triangles, const unsigned char* used, float meshlet_expected_radius, float cone_weight, unsigned int* out_extra)
+{
+	unsigned int best_triangle = ~0u;
+	unsigned int best_extra = 5;
+	float best_score = FLT_MAX;
+
+	for (size_t i = 0; i < meshlet.vertex_count; ++i)
+	{
+		unsigned int index = meshlet_vertices[meshlet.vertex_offset + i];
+
+		const unsigned int* neighbors = adjacency.data + adjacency.offsets[index];
+		size_t neighbors_size = adjacency.counts[index];
+
+		for (size_t j = 0; j < neighbors_size; ++j)
+		{
+			unsigned int triangle = neighbors[j];
+			unsigned int a = indices[triangle * 3 + 0], b = indices[triangle * 3 + 1], c = indices[triangle * 3 + 2];
+
+			unsigned int extra = (used[a] == 0xff) + (used[b] == 0xff) + (used[c] == 0xff);
+
+			// triangles that don't add new vertices to meshlets are max. priority
+			if (extra != 0)
+			{
+				// artificially increase the priority of dangling triangles as they're expensive to add to new meshlets
+				if (live_triangles[a] == 1 || live_triangles[b] == 1 || live_triangles[c] == 1)
+					extra = 0;
+
+				extra++;
+			}
+
+			// since topology-based priority is always more important than the score, we can skip scoring in some cases
+			if (extra > best_extra)
+				continue;
+
+			float score = 0;
+
+			// caller selects one of two scoring functions: geometrical (based on meshlet cone) or topological (based on remaining triangles)
+			if (meshlet_cone)
+			{
+				const Cone& tri_cone = triangles[triangle];
+
+				float distance2 =
+				    (tri_cone.px - meshlet_cone->px) * (tri_cone.px - meshlet_cone->px) +
+				    (tri_cone.py - meshlet_cone->py) * (tri_cone.py - meshlet_cone->py) +
+				    (tri_cone.pz - meshlet_cone->pz) * (tri_cone.pz - meshlet_cone->pz);
+
+				float spread = tri_cone.nx * meshlet_cone->nx + tri_cone.ny * meshlet_cone->ny + tri_cone.nz * meshlet_cone->nz;
+
+				score = getMeshletScore(distance2, spread, cone_weight, meshlet_expected_radius);
+			}
+			else
+			{
+				// each live_triangles entry is >= 1 since it includes the current triangle we're processing
+				score = float(live_triangles[a] + live_triangles[b] + live_triangles[c] - 3);
+			}
+
+			// note that topology-based priority is always more important than the score
+			// this helps maintain reasonable effectiveness of meshlet data and reduces scoring cost
+			if (extra < best_extra || score < best_score)
+			{
+				best_triangle = triangle;
+				best_extra = extra;
+				best_score = score;
+			}
+		}
+	}
+
+	if (out_extra)
+		*out_extra = best_extra;
+
+	return best_triangle;
+}
+
+struct KDNode
+{
+	union
+	{
+		float split;
+		unsigned int index;
+	};
+
+	// leaves: axis = 3, children = number of extra points after this one (0 if 'index' is the only point)
+	// branches: axis != 3, left subtree = skip 1, right subtree = skip 1+children
+	unsigned int axis : 2;
+	unsigned int children : 30;
+};
+
+static size_t kdtreePartition(unsigned int* indices, size_t count, const float* points, size_t stride, unsigned int axis, float pivot)
+{
+	size_t m = 0;
+
+	// invariant: elements in range [0, m) are < pivot, elements in range [m, i) are >= pivot
+	for (size_t i = 0; i < count; ++i)
+	{
+		float v = points[indices[i] * stride + axis];
+
+		// swap(m, i) unconditionally
+		unsigned int t = indices[m];
+		indices[m] = indices[i];
+		indices[i] = t;
+
+		// when v >= pivot, we swap i with m without advancing it, preserving invariants
+		m += v < pivot;
+	}
+
+	return m;
+}
+
+static size_t kdtreeBuildLeaf(size_t offset, KDNode* nodes, size_t node_count, unsigned int* indices, size_t count)
+{
+	assert(offset + count <= node_count);
+	(void)node_count;
+
+	KDNode& result = nodes[offset];
+
+	result.index = indices[0];
+	result.axis = 3;
+	result.children = unsigned(count - 1);
+
+	// all remaining points are stored in nodes immediately following the leaf
+	for (size_t i = 1; i < count; ++i)
+	{
+		KDNode& tail = nodes[offset + i];
+
+		tail.index = indices[i];
+		tail.axis = 3;
+		tail.children = ~0u >> 2; // bogus value to prevent misuse
+	}
+
+	return offset + count;
+}
+
+static size_t kdtreeBuild(size_t offset, KDNode* nodes, size_t node_count, const float* points, size_t stride, unsigned int* indices, size_t count, size_t leaf_size)
+{
+	assert(count > 0);
+	assert(offset < node_count);
+
+	if (count <= leaf_size)
+		return kdtreeBuildLeaf(offset, nodes, node_count, indices, count);
+
+	float mean[3] = {};
+	float vars[3] = {};
+	float runc = 1, runs = 1;
+
+	// gather statistics on the points in the subtree using Welford's algorithm
+	for (size_t i = 0; i < count; ++i, runc += 1.f, runs = 1.f / runc)
+	{
+		const float* point = points + indices[i] * stride;
+
+		for (int k = 0; k < 3; ++k)
+		{
+			float delta = point[k] - mean[k];
+			mean[k] += delta * runs;
+			vars[k] += delta * (point[k] - mean[k]);
+		}
+	}
+
+	// split axis is one where the variance is largest
+	unsigned int axis = vars[0] >= vars[1] && vars[0] >= vars[2] ? 0 : vars[1] >= vars[2] ? 1 : 2;
+
+	float split = mean[axis];
+	size_t middle = kdtreePartition(indices, count, points, stride, axis, split);
+
+	// when the partition is degenerate simply consolidate the points into a single node
+	if (middle <= leaf_size / 2 || middle >= count - leaf_size / 2)
+		return kdtreeBuildLeaf(offset, nodes, node_count, indices, count);
+
+	KDNode& result = nodes[offset];
+
+	result.split = split;
+	result.axis = axis;
+
+	// left subtree is right after our node
+	size_t next_offset = kdtreeBuild(offset + 1, nodes, node_count, points, stride, indices, middle, leaf_size);
+
+	// distance to the right subtree is represented explicitly
+	result.children = unsigned(next_offset - offset - 1);
+
+	return kdtreeBuild(next_offset, nodes, node_count, points, stride, indices + middle, count - middle, leaf_size);
+}
+
+static void kdtreeNearest(KDNode* nodes, unsigned int root, const float* points, size_t stride, const unsigned char* emitted_flags, const float* position, unsigned int& result, float& limit)
+{
+	const KDNode& node = nodes[root];
+
+	if (node.axis == 3)
+	{
+		// leaf
+		for (unsigned int i = 0; i <= node.children; ++i)
+		{
+			unsigned int index = nodes[root + i].index;
+
+			if (emitted_flags[index])
+				continue;
+
+			const float* point = points + index * stride;
+
+			float distance2 =
+			    (point[0] - position[0]) * (point[0] - position[0]) +
+			    (point[1] - position[1]) * (point[1] - position[1]) +
+			    (point[2] - position[2]) * (point[2] - position[2]);
+			float distance = sqrtf(distance2);
+
+			if (distance < limit)
+			{
+				result = index;
+				limit = distance;
+			}
+		}
+	}
+	else
+	{
+		// branch; we order recursion to process the node that search position is in first
+		float delta = position[node.axis] - node.split;
+		unsigned int first = (delta <= 0) ? 0 : node.children;
+		unsigned int second = first ^ node.children;
+
+		kdtreeNearest(nodes, root + 1 + first, points, stride, emitted_flags, position, result, limit);
+
+		// only process the other node if it can have a match based on closest distance so far
+		if (fabsf(delta) <= limit)
+			kdtreeNearest(nodes, root + 1 + second, points, stride, emitted_flags, position, result, limit);
+	}
+}
+
 } // namespace meshopt
 
 size_t meshopt_buildMeshletsBound(size_t index_count, size_t max_vertices, size_t max_triangles)
@@ -102,6 +519,8 @@ size_t meshopt_buildMeshletsBound(size_t index_count, size_t max_vertices, size_
 
 size_t meshopt_buildMeshlets(meshopt_Meshlet* destination, const unsigned int* indices, size_t index_count, size_t vertex_count, size_t max_vertices, size_t max_triangles)
 {
+	MESHOPTIMIZER_ZONE("meshopt_buildMeshlets");
+
 	assert(index_count % 3 == 0);
 	assert(max_vertices >= 3);
 	assert(max_triangles >= 1);
@@ -173,23 +592,182 @@ size_t meshopt_buildMeshlets(meshopt_Meshlet* destination, const unsigned int* i
 	return offset;
 }
 
-meshopt_Bounds meshopt_computeClusterBounds(const unsigned int* indices, size_t index_count, const float* vertex_positions, size_t vertex_count, size_t vertex_positions_stride)
+size_t meshopt_buildMeshletsPacked(meshopt_PackedMeshlet* meshlets, unsigned int* meshlet_vertices, unsigned char* meshlet_triangles, const unsigned int* indices, size_t index_count, const float* vertex_positions, size_t vertex_count, size_t vertex_positions_stride, size_t max_vertices, size_t max_triangles, float cone_weight)
 {
 	using namespace meshopt;
 
+	MESHOPTIMIZER_ZONE("meshopt_buildMeshletsPacked");
+
 	assert(index_count % 3 == 0);
 	assert(vertex_positions_stride > 0 && vertex_positions_stride <= 256);
 	assert(vertex_positions_stride % sizeof(float) == 0);
+	assert(max_vertices >= 3 && max_vertices <= 255);
+	assert(max_triangles >= 1 && max_triangles <= 512);
+	assert(cone_weight >= 0 && cone_weight <= 1);
 
-	assert(index_count / 3 <= 256);
+	meshopt_Allocator allocator;
 
-	(void)vertex_count;
+	meshopt_PackedMeshlet meshlet = {};
 
-	size_t vertex_stride_float = vertex_positions_stride / sizeof(float);
+	TriangleAdjacency2 adjacency = {};
+	buildTriangleAdjacency(adjacency, indices, index_count, vertex_count, allocator);
+
+	unsigned int* live_triangles = allocator.allocate<unsigned int>(vertex_count);
+	memcpy(live_triangles, adjacency.counts, vertex_count * sizeof(unsigned int));
+
+	size_t face_count = index_count / 3;
+
+	unsigned char* emitted_flags = allocator.allocate<unsigned char>(face_count);
+	memset(emitted_flags, 0, face_count);
+
+	// for each triangle, precompute centroid & normal to use for scoring
+	Cone* triangles = allocator.allocate<Cone>(face_count);
+	float mesh_area = computeTriangleCones(triangles, indices, index_count, vertex_positions, vertex_count, vertex_positions_stride);
+
+	// assuming each meshlet is a square patch, expected radius is sqrt(expected area)
+	float triangle_area_avg = face_count == 0 ? 0.f : mesh_area / float(face_count) * 0.5f;
+	float meshlet_expected_radius = sqrtf(triangle_area_avg * max_triangles) * 0.5f;
+
+	// build a kd-tree for nearest neighbor lookup
+	unsigned int* kdindices = allocator.allocate<unsigned int>(face_count);
+	for (size_t i = 0; i < face_count; ++i)
+		kdindices[i] = unsigned(i);
+
+	KDNode* nodes = allocator.allocate<KDNode>(face_count * 2);
+	if (face_count)
+		kdtreeBuild(0, nodes, face_count * 2, &triangles[0].px, sizeof(Cone) / sizeof(float), kdindices, face_count, /* leaf_size= */ 8);
+
+	// index of the vertex in the meshlet, 0xff if the vertex isn't used
+	unsigned char* used = allocator.allocate<unsigned char>(vertex_count);
+	memset(used, -1, vertex_count);
+
+	size_t meshlet_offset = 0;
+
+	Cone meshlet_cone_acc = {};
+
+	for (size_t emitted = 0; emitted < face_count; ++emitted)
+	{
+		Cone meshlet_cone = getMeshletCone(meshlet_cone_acc, meshlet.triangle_count);
+
+		unsigned int best_extra = 0;
+		unsigned int best_triangle = getNeighborTriangle(meshlet, &meshlet_cone, meshlet_vertices, indices, adjacency, triangles, live_triangles, used, meshlet_expected_radius, cone_weight, &best_extra);
+
+		// if the best triangle doesn't fit into current meshlet, the spatial scoring we've used is not very meaningful, so we re-select using topological scoring
+		if (best_triangle != ~0u && (meshlet.vertex_count + best_extra > max_vertices || meshlet.triangle_count >= max_triangles))
+			best_triangle = getNeighborTriangle(meshlet, NULL, meshlet_vertices, indices, adjacency, triangles, live_triangles, used, meshlet_expected_radius, 0.f, NULL);
+
+		// when we run out of neighboring triangles we need to switch to spatial search; we currently just pick the closest triangle irrespective of connectivity
+		if (best_triangle == ~0u)
+		{
+			float position[3] = {meshlet_cone.px, meshlet_cone.py, meshlet_cone.pz};
+			unsigned int index = ~0u;
+			float limit = FLT_MAX;
+
+			kdtreeNearest(nodes, 0, &triangles[0].px, sizeof(Cone) / sizeof(float), emitted_flags, position, index, limit);
+
+			best_triangle = index;
+		}
+
+		assert(best_triangle != ~0u);
+
+		unsigned int a = indices[best_triangle * 3 + 0], b = indices[best_triangle * 3 + 1], c = indices[best_triangle * 3 + 2];
+
+		// add meshlet to the output; when the current meshlet is full we reset the accumulated bounds
+		if (appendMeshlet(meshlet, a, b, c, used, meshlets, meshlet_vertices, meshlet_triangles, meshlet_offset, max_vertices, max_triangles))
+		{
+			meshlet_offset++;
+			memset(&meshlet_cone_acc, 0, sizeof(meshlet_cone_acc));
+		}
+
+		live_triangles[a]--;
+		live_triangles[b]--;
+		live_triangles[c]--;
+
+		// remove emitted triangle from adjacency data
+		// this makes sure that we spend less time traversing these lists on subsequent iterations
+		for (size_t k = 0; k < 3; ++k)
+		{
+			unsigned int index = indices[best_triangle * 3 + k];
+
+			unsigned int* neighbors = adjacency.data + adjacency.offsets[index];
+			size_t neighbors_size = adjacency.counts[index];
+
+			for (size_t i = 0; i < neighbors_size; ++i)
+			{
+				if (neighbors[i] == best_triangle)
+				{
+					neighbors[i] = neighbors[neighbors_size - 1];
+					adjacency.counts[index]--;
+					break;
+				}
+			}
+		}
+
+		// update aggregated meshlet cone data for scoring subsequent triangles
+		meshlet_cone_acc.px += triangles[best_triangle].px;
+		meshlet_cone_acc.py += triangles[best_triangle].py;
+		meshlet_cone_acc.pz += triangles[best_triangle].pz;
+		meshlet_cone_acc.nx += triangles[best_triangle].nx;
+		meshlet_cone_acc.ny += triangles[best_triangle].ny;
+		meshlet_cone_acc.nz += triangles[best_triangle].nz;
+
+		emitted_flags[best_triangle] = 1;
+	}
+
+	if (meshlet.triangle_count)
+		meshlets[meshlet_offset++] = meshlet;
+
+	assert(meshlet_offset <= meshopt_buildMeshletsBound(index_count, max_vertices, max_triangles));
+
+	return meshlet_offset;
+}
+
+size_t meshopt_buildMeshletsSpatial(meshopt_Meshlet* destination, const unsigned int* indices, size_t index_count, const float* vertex_positions, size_t vertex_count, size_t vertex_positions_stride, size_t max_vertices, size_t max_triangles, float cone_weight)
+{
+	MESHOPTIMIZER_ZONE("meshopt_buildMeshletsSpatial");
+
+	assert(max_vertices <= sizeof(destination->vertices) / sizeof(destination->vertices[0]));
+	assert(max_triangles <= sizeof(destination->indices) / 3);
+
+	meshopt_Allocator allocator;
+
+	size_t max_meshlets = meshopt_buildMeshletsBound(index_count, max_vertices, max_triangles);
+
+	meshopt_PackedMeshlet* meshlets = allocator.allocate<meshopt_PackedMeshlet>(max_meshlets);
+	unsigned int* meshlet_vertices = allocator.allocate<unsigned int>(max_meshlets * max_vertices);
+	unsigned char* meshlet_triangles = allocator.allocate<unsigned char>(max_meshlets * ((max_triangles * 3 + 3) & ~3));
+
+	size_t meshlet_count = meshopt_buildMeshletsPacked(meshlets, meshlet_vertices, meshlet_triangles, indices, index_count, vertex_positions, vertex_count, vertex_positions_stride, max_vertices, max_triangles, cone_weight);
+
+	// expand packed meshlets into fixed-size meshlet structures
+	for (size_t i = 0; i < meshlet_count; ++i)
+	{
+		const meshopt_PackedMeshlet& packed = meshlets[i];
+		meshopt_Meshlet& meshlet = destination[i];
+
+		memset(&meshlet, 0, sizeof(meshlet));
+
+		memcpy(meshlet.vertices, meshlet_vertices + packed.vertex_offset, packed.vertex_count * sizeof(unsigned int));
+		memcpy(meshlet.indices, meshlet_triangles + packed.triangle_offset, packed.triangle_count * 3);
+
+		meshlet.vertex_count = (unsigned char)packed.vertex_count;
+		meshlet.triangle_count = (unsigned char)packed.triangle_count;
+	}
+
+	return meshlet_count;
+}
+
+namespace meshopt
+{
+
+// clusters up to this size use stack storage for triangle data; larger clusters need a heap allocation
+const size_t kClusterBoundsStackTriangles = 256;
+
+static meshopt_Bounds computeClusterBounds(const unsigned int* indices, size_t index_count, const float* vertex_positions, size_t vertex_count, size_t vertex_stride_float, float (*normals)[3], float (*corners)[3][3])
+{
+	(void)vertex_count;
 
 	// compute triangle normals and gather triangle corners
-	float normals[256][3];
-	float corners[256][3][3];
 	size_t triangles = 0;
 
 	for (size_t i = 0; i < index_count; i += 3)
@@ -327,6 +905,93 @@ meshopt_Bounds meshopt_computeClusterBounds(const unsigned int* indices, size_t
 	return bounds;
 }
 
+struct MeshletBoundsContext
+{
+	meshopt_Bounds* destination;
+	const meshopt_PackedMeshlet* meshlets;
+	size_t meshlet_count;
+	const unsigned int* meshlet_vertices;
+	const unsigned char* meshlet_triangles;
+	const float* vertex_positions;
+	size_t vertex_count;
+	size_t vertex_stride_float;
+
+	// allocation callbacks of the calling thread, installed by the tasks that allocate memory
+	meshopt_Allocator::Callbacks callbacks;
+};
+
+// each task processes a fixed number of meshlets to amortize scheduling overhead
+const size_t kMeshletBoundsBatch = 64;
+
+static void computeMeshletBoundsBatch(void* task_data, size_t task_index)
+{
+	MESHOPTIMIZER_ZONE("computeMeshletBoundsBatch");
+
+	const MeshletBoundsContext& context = *static_cast<const MeshletBoundsContext*>(task_data);
+	meshopt_Allocator::Scope scope(context.callbacks);
+
+	size_t begin = task_index * kMeshletBoundsBatch;
+	size_t end = begin + kMeshletBoundsBatch < context.meshlet_count ? begin + kMeshletBoundsBatch : context.meshlet_count;
+
+	size_t max_triangles = kClusterBoundsStackTriangles;
+
+	for (size_t i = begin; i < end; ++i)
+		max_triangles = context.meshlets[i].triangle_count > max_triangles ? context.meshlets[i].triangle_count : max_triangles;
+
+	// scratch storage is shared between all meshlets in the batch
+	meshopt_Allocator allocator;
+
+	unsigned int* indices = allocator.allocate<unsigned int>(max_triangles * 3);
+	float(*normals)[3] = allocator.allocate<float[3]>(max_triangles);
+	float(*corners)[3][3] = allocator.allocate<float[3][3]>(max_triangles);
+
+	for (size_t i = begin; i < end; ++i)
+	{
+		const meshopt_PackedMeshlet& meshlet = context.meshlets[i];
+
+		const unsigned int* vertices = context.meshlet_vertices + meshlet.vertex_offset;
+		const unsigned char* triangles = context.meshlet_triangles + meshlet.triangle_offset;
+
+		for (size_t j = 0; j < meshlet.triangle_count * 3; ++j)
+		{
+			assert(triangles[j] < meshlet.vertex_count);
+			indices[j] = vertices[triangles[j]];
+		}
+
+		context.destination[i] = computeClusterBounds(indices, meshlet.triangle_count * 3, context.vertex_positions, context.vertex_count, context.vertex_stride_float, normals, corners);
+	}
+}
+
+} // namespace meshopt
+
+meshopt_Bounds meshopt_computeClusterBounds(const unsigned int* indices, size_t index_count, const float* vertex_positions, size_t vertex_count, size_t vertex_positions_stride)
+{
+	using namespace meshopt;
+
+	assert(index_count % 3 == 0);
+	assert(vertex_positions_stride > 0 && vertex_positions_stride <= 256);
+	assert(vertex_positions_stride % sizeof(float) == 0);
+
+	size_t vertex_stride_float = vertex_positions_stride / sizeof(float);
+
+	if (index_count / 3 <= kClusterBoundsStackTriangles)
+	{
+		float normals[kClusterBoundsStackTriangles][3];
+		float corners[kClusterBoundsStackTriangles][3][3];
+
+		return computeClusterBounds(indices, index_count, vertex_positions, vertex_count, vertex_stride_float, normals, corners);
+	}
+	else
+	{
+		meshopt_Allocator allocator;
+
+		float(*normals)[3] = allocator.allocate<float[3]>(index_count / 3);
+		float(*corners)[3][3] = allocator.allocate<float[3][3]>(index_count / 3);
+
+		return computeClusterBounds(indices, index_count, vertex_positions, vertex_count, vertex_stride_float, normals, corners);
+	}
+}
+
 meshopt_Bounds meshopt_computeMeshletBounds(const meshopt_Meshlet* meshlet, const float* vertex_positions, size_t vertex_count, size_t vertex_positions_stride)
 {
 	assert(vertex_positions_stride > 0 && vertex_positions_stride <= 256);
@@ -349,3 +1014,239 @@ meshopt_Bounds meshopt_computeMeshletBounds(const meshopt_Meshlet* meshlet, cons
 
 	return meshopt_computeClusterBounds(indices, meshlet->triangle_count * 3, vertex_positions, vertex_count, vertex_positions_stride);
 }
+
+void meshopt_computeMeshletBoundsPacked(meshopt_Bounds* destination, const meshopt_PackedMeshlet* meshlets, size_t meshlet_count, const unsigned int* meshlet_vertices, const unsigned char* meshlet_triangles, const float* vertex_positions, size_t vertex_count, size_t vertex_positions_stride, meshopt_Scheduler scheduler, void* scheduler_context)
+{
+	using namespace meshopt;
+
+	MESHOPTIMIZER_ZONE("meshopt_computeMeshletBoundsPacked");
+
+	assert(vertex_positions_stride > 0 && vertex_positions_stride <= 256);
+	assert(vertex_positions_stride % sizeof(float) == 0);
+
+	MeshletBoundsContext context = {};
+	context.callbacks = meshopt_Allocator::getCallbacks();
+	context.destination = destination;
+	context.meshlets = meshlets;
+	context.meshlet_count = meshlet_count;
+	context.meshlet_vertices = meshlet_vertices;
+	context.meshlet_triangles = meshlet_triangles;
+	context.vertex_positions = vertex_positions;
+	context.vertex_count = vertex_count;
+	context.vertex_stride_float = vertex_positions_stride / sizeof(float);
+
+	size_t task_count = (meshlet_count + kMeshletBoundsBatch - 1) / kMeshletBoundsBatch;
+
+	if (scheduler)
+		scheduler(scheduler_context, computeMeshletBoundsBatch, &context, task_count);
+	else
+		for (size_t i = 0; i < task_count; ++i)
+			computeMeshletBoundsBatch(&context, i);
+}
+
+namespace meshopt
+{
+
+// per-axis local coordinates are limited to 24 bits so that every value spans at most 2 words of the bit stream
+const int kMeshletPositionBits = 24;
+
+// decoders compute float(offset + local) * scale, so grid coordinates must be exactly representable as floats
+const float kMeshletGridLimit = float(1 << 24);
+
+static float quantizeGrid(float v, float inv_step)
+{
+	return floorf(v * inv_step + 0.5f);
+}
+
+static int getCoordinateBits(unsigned int range)
+{
+	int result = 0;
+
+	while (result < 32 && (range >> result) != 0)
+		result++;
+
+	return result;
+}
+
+static void writeBits(unsigned int* data, size_t offset, unsigned int value, int bits)
+{
+	if (bits == 0)
+		return;
+
+	size_t word = offset >> 5;
+	int shift = int(offset & 31);
+
+	data[word] |= value << shift;
+
+	if (shift + bits > 32)
+		data[word + 1] |= value >> (32 - shift);
+}
+
+static unsigned int readBits(const unsigned int* data, size_t offset, int bits)
+{
+	if (bits == 0)
+		return 0;
+
+	size_t word = offset >> 5;
+	int shift = int(offset & 31);
+
+	unsigned int result = data[word] >> shift;
+
+	if (shift + bits > 32)
+		result |= data[word + 1] << (32 - shift);
+
+	return result & ((1u << bits) - 1);
+}
+
+} // namespace meshopt
+
+size_t meshopt_encodeMeshletsBound(size_t meshlet_count, size_t max_vertices, size_t max_triangles)
+{
+	using namespace meshopt;
+
+	assert(max_vertices <= 255);
+	assert(max_triangles <= 512);
+
+	size_t position_words = (max_vertices * 3 * kMeshletPositionBits + 31) / 32;
+	size_t triangle_words = (max_triangles * 3 + 3) / 4;
+
+	return meshlet_count * (position_words + triangle_words);
+}
+
+size_t meshopt_encodeMeshlets(meshopt_EncodedMeshlet* destination, unsigned int* data, size_t data_size, const meshopt_PackedMeshlet* meshlets, size_t meshlet_count, const unsigned int* meshlet_vertices, const unsigned char* meshlet_triangles, const float* vertex_positions, size_t vertex_count, size_t vertex_positions_stride, float grid_step)
+{
+	using namespace meshopt;
+
+	MESHOPTIMIZER_ZONE("meshopt_encodeMeshlets");
+
+	assert(vertex_positions_stride > 0 && vertex_positions_stride <= 256);
+	assert(vertex_positions_stride % sizeof(float) == 0);
+	assert(grid_step > 0);
+
+	(void)vertex_count;
+
+	size_t vertex_stride_float = vertex_positions_stride / sizeof(float);
+	float inv_step = 1.f / grid_step;
+
+	size_t data_offset = 0;
+
+	for (size_t i = 0; i < meshlet_count; ++i)
+	{
+		const meshopt_PackedMeshlet& meshlet = meshlets[i];
+		const unsigned int* vertices = &meshlet_vertices[meshlet.vertex_offset];
+
+		assert(meshlet.vertex_count <= 255);
+		assert(meshlet.triangle_count <= 512);
+
+		// quantization happens on a grid shared by all meshlets, so vertices on meshlet boundaries decode to identical positions
+		int qmin[3] = {INT_MAX, INT_MAX, INT_MAX};
+		int qmax[3] = {INT_MIN, INT_MIN, INT_MIN};
+
+		for (size_t j = 0; j < meshlet.vertex_count; ++j)
+		{
+			assert(vertices[j] < vertex_count);
+			const float* position = vertex_positions + vertices[j] * vertex_stride_float;
+
+			for (int k = 0; k < 3; ++k)
+			{
+				float r = quantizeGrid(position[k], inv_step);
+
+				// grid_step is too small for the mesh extents; this also rejects NaN and infinite positions
+				if (!(fabsf(r) <= kMeshletGridLimit))
+					return 0;
+
+				int q = int(r);
+
+				qmin[k] = q < qmin[k] ? q : qmin[k];
+				qmax[k] = q > qmax[k] ? q : qmax[k];
+			}
+		}
+
+		meshopt_EncodedMeshlet& result = destination[i];
+		memset(&result, 0, sizeof(result));
+
+		int vertex_bits = 0;
+
+		for (int k = 0; k < 3; ++k)
+		{
+			int bits = meshlet.vertex_count ? getCoordinateBits(unsigned(qmax[k] - qmin[k])) : 0;
+
+			// grid_step is too small for the meshlet extents
+			if (bits > kMeshletPositionBits)
+				return 0;
+
+			result.offset[k] = meshlet.vertex_count ? qmin[k] : 0;
+			result.bits[k] = (unsigned char)bits;
+			vertex_bits += bits;
+		}
+
+		result.scale = grid_step;
+		result.data_offset = unsigned(data_offset);
+		result.vertex_count = meshlet.vertex_count;
+		result.triangle_count = meshlet.triangle_count;
+
+		size_t position_words = (meshlet.vertex_count * vertex_bits + 31) / 32;
+		size_t triangle_words = (meshlet.triangle_count * 3 + 3) / 4;
+
+		if (data_offset + position_words + triangle_words > data_size)
+			return 0;
+
+		unsigned int* meshlet_data = data + data_offset;
+		memset(meshlet_data, 0, (position_words + triangle_words) * sizeof(unsigned int));
+
+		size_t bit_offset = 0;
+
+		for (size_t j = 0; j < meshlet.vertex_count; ++j)
+		{
+			const float* position = vertex_positions + vertices[j] * vertex_stride_float;
+
+			for (int k = 0; k < 3; ++k)
+			{
+				unsigned int local = unsigned(int(quantizeGrid(position[k], inv_step)) - qmin[k]);
+
+				writeBits(meshlet_data, bit_offset, local, result.bits[k]);
+				bit_offset += result.bits[k];
+			}
+		}
+
+		// local indices are packed 4 per word in little-endian order regardless of host endianness
+		unsigned int* triangle_data = meshlet_data + position_words;
+		const unsigned char* triangles = &meshlet_triangles[meshlet.triangle_offset];
+
+		for (size_t j = 0; j < meshlet.triangle_count * 3; ++j)
+		{
+			assert(triangles[j] < meshlet.vertex_count);
+
+			triangle_data[j / 4] |= unsigned(triangles[j]) << (8 * (j % 4));
+		}
+
+		data_offset += position_words + triangle_words;
+	}
+
+	return data_offset;
+}
+
+void meshopt_decodeMeshlet(float* vertex_positions, unsigned char* triangles, const meshopt_EncodedMeshlet* meshlet, const unsigned int* data)
+{
+	using namespace meshopt;
+
+	const unsigned int* meshlet_data = data + meshlet->data_offset;
+
+	size_t bit_offset = 0;
+
+	for (size_t j = 0; j < meshlet->vertex_count; ++j)
+	{
+		for (int k = 0; k < 3; ++k)
+		{
+			unsigned int local = readBits(meshlet_data, bit_offset, meshlet->bits[k]);
+			bit_offset += meshlet->bits[k];
+
+			vertex_positions[j * 3 + k] = float(meshlet->offset[k] + int(local)) * meshlet->scale;
+		}
+	}
+
+	const unsigned int* triangle_data = meshlet_data + (bit_offset + 31) / 32;
+
+	for (size_t j = 0; j < meshlet->triangle_count * 3; ++j)
+		triangles[j] = (unsigned char)(triangle_data[j / 4] >> (8 * (j % 4)));
+}
@@ -23,6 +23,14 @@ const unsigned char kSequenceHeader = 0xd0;
 
 static int gEncodeIndexVersion = 0;
 
+// version 2 splits the triangle stream into independently decodable chunks of this many triangles
+const size_t kIndexChunkTriangles = 1024;
+
+#if TRACE
+static size_t gCodeStats[256];
+static size_t gCodeAuxStats[256];
+#endif
+
 typedef unsigned int VertexFifo[16];
 typedef unsigned int EdgeFifo[16][2];
 
@@ -142,6 +150,22 @@ static unsigned int decodeIndex(const unsigned char*& data, unsigned int last)
 	return last + d;
 }
 
+static void writeChunkEntry(unsigned char* entry, unsigned int offset, unsigned int next)
+{
+	// chunk table entries are stored as two little-endian 32-bit integers
+	for (int k = 0; k < 4; ++k)
+	{
+		entry[k] = (unsigned char)(offset >> (k * 8));
+		entry[4 + k] = (unsigned char)(next >> (k * 8));
+	}
+}
+
+static void readChunkEntry(const unsigned char* entry, unsigned int& offset, unsigned int& next)
+{
+	offset = entry[0] | (entry[1] << 8) | (entry[2] << 16) | (unsigned(entry[3]) << 24);
+	next = entry[4] | (entry[5] << 8) | (entry[6] << 16) | (unsigned(entry[7]) << 24);
+}
+
 static int getCodeAuxIndex(unsigned char v, const unsigned char* table)
 {
 	for (int i = 0; i < 16; ++i)
@@ -151,22 +175,6 @@ static int getCodeAuxIndex(unsigned char v, const unsigned char* table)
 	return -1;
 }
 
-static void writeTriangle(void* destination, size_t offset, size_t index_size, unsigned int a, unsigned int b, unsigned int c)
-{
-	if (index_size == 2)
-	{
-		static_cast<unsigned short*>(destination)[offset + 0] = (unsigned short)(a);
-		static_cast<unsigned short*>(destination)[offset + 1] = (unsigned short)(b);
-		static_cast<unsigned short*>(destination)[offset + 2] = (unsigned short)(c);
-	}
-	else
-	{
-		static_cast<unsigned int*>(destination)[offset + 0] = a;
-		static_cast<unsigned int*>(destination)[offset + 1] = b;
-		static_cast<unsigned int*>(destination)[offset + 2] = c;
-	}
-}
-
 #if TRACE
 static size_t sortTop16(unsigned char dest[16], size_t stats[256])
 {
@@ -199,27 +207,8 @@ static size_t sortTop16(unsigned char dest[16], size_t stats[256])
 }
 #endif
 
-} // namespace meshopt
-
-size_t meshopt_encodeIndexBuffer(unsigned char* buffer, size_t buffer_size, const unsigned int* indices, size_t index_count)
+static unsigned char* encodeIndexTriangles(unsigned char* code, unsigned char* data, unsigned char* data_safe_end, const unsigned char* codeaux_table, const unsigned int* indices, size_t index_count, int version, unsigned int& next)
 {
-	using namespace meshopt;
-
-	assert(index_count % 3 == 0);
-
-#if TRACE
-	size_t codestats[256] = {};
-	size_t codeauxstats[256] = {};
-#endif
-
-	// the minimum valid encoding is header, 1 byte per triangle and a 16-byte codeaux table
-	if (buffer_size < 1 + index_count / 3 + 16)
-		return 0;
-
-	int version = gEncodeIndexVersion;
-
-	buffer[0] = (unsigned char)(kIndexHeader | version);
-
 	EdgeFifo edgefifo;
 	memset(edgefifo, -1, sizeof(edgefifo));
 
@@ -229,26 +218,18 @@ size_t meshopt_encodeIndexBuffer(unsigned char* buffer, size_t buffer_size, cons
 	size_t edgefifooffset = 0;
 	size_t vertexfifooffset = 0;
 
-	unsigned int next = 0;
-	unsigned int last = 0;
-
-	unsigned char* code = buffer + 1;
-	unsigned char* data = code + index_count / 3;
-	unsigned char* data_safe_end = buffer + buffer_size - 16;
+	// free indices are delta-encoded relative to the start of the stream or chunk
+	unsigned int last = next;
 
 	int fecmax = version >= 1 ? 13 : 15;
 
-	// use static encoding table; it's possible to pack the result and then build an optimal table and repack
-	// for now we keep it simple and use the table that has been generated based on symbol frequency on a training mesh set
-	const unsigned char* codeaux_table = kCodeAuxEncodingTable;
-
 	for (size_t i = 0; i < index_count; i += 3)
 	{
 		// make sure we have enough space to write a triangle
 		// each triangle writes at most 16 bytes: 1b for codeaux and 5b for each free index
 		// after this we can be sure we can write without extra bounds checks
 		if (data > data_safe_end)
-			return 0;
+			return NULL;
 
 		int fer = getEdgeFifo(edgefifo, indices[i + 0], indices[i + 1], indices[i + 2], edgefifooffset);
 
@@ -276,7 +257,7 @@ size_t meshopt_encodeIndexBuffer(unsigned char* buffer, size_t buffer_size, cons
 			*code++ = (unsigned char)((fe << 4) | fec);
 
 #if TRACE
-			codestats[code[-1]]++;
+			gCodeStats[code[-1]]++;
 #endif
 
 			// note that we need to update the last index since free indices are delta-encoded
@@ -335,8 +316,8 @@ size_t meshopt_encodeIndexBuffer(unsigned char* buffer, size_t buffer_size, cons
 			}
 
 #if TRACE
-			codestats[code[-1]]++;
-			codeauxstats[codeaux]++;
+			gCodeStats[code[-1]]++;
+			gCodeAuxStats[codeaux]++;
 #endif
 
 			// note that we need to update the last index since free indices are delta-encoded
@@ -366,95 +347,20 @@ size_t meshopt_encodeIndexBuffer(unsigned char* buffer, size_t buffer_size, cons
 		}
 	}
 
-	// make sure we have enough space to write codeaux table
-	if (data > data_safe_end)
-		return 0;
-
-	// add codeaux encoding table to the end of the stream; this is used for decoding codeaux *and* as padding
-	// we need padding for decoding to be able to assume that each triangle is encoded as <= 16 bytes of extra data
-	// this is enough space for aux byte + 5 bytes per varint index which is the absolute worst case for any input
-	for (size_t i = 0; i < 16; ++i)
-	{
-		// decoder assumes that table entries never refer to separately encoded indices
-		assert((codeaux_table[i] & 0xf) != 0xf && (codeaux_table[i] >> 4) != 0xf);
-
-		*data++ = codeaux_table[i];
-	}
-
-	// since we encode restarts as codeaux without a table reference, we need to make sure 00 is encoded as a table reference
-	assert(codeaux_table[0] == 0);
-
-	assert(data >= buffer + index_count / 3 + 16);
-	assert(data <= buffer + buffer_size);
-
-#if TRACE
-	unsigned char codetop[16], codeauxtop[16];
-	size_t codetopsize = sortTop16(codetop, codestats);
-	size_t codeauxtopsize = sortTop16(codeauxtop, codeauxstats);
-
-	size_t sumcode = 0, sumcodeaux = 0;
-	for (size_t i = 0; i < 256; ++i)
-		sumcode += codestats[i], sumcodeaux += codeauxstats[i];
-
-	size_t acccode = 0, acccodeaux = 0;
-
-	printf("code\t\t\t\t\tcodeaux\n");
-
-	for (size_t i = 0; i < codetopsize && i < codeauxtopsize; ++i)
-	{
-		acccode += codestats[codetop[i]];
-		acccodeaux += codeauxstats[codeauxtop[i]];
-
-		printf("%2d: %02x = %d (%.1f%% ..%.1f%%)\t\t%2d: %02x = %d (%.1f%% ..%.1f%%)\n",
-		       int(i), codetop[i], int(codestats[codetop[i]]), double(codestats[codetop[i]]) / double(sumcode) * 100, double(acccode) / double(sumcode) * 100,
-		       int(i), codeauxtop[i], int(codeauxstats[codeauxtop[i]]), double(codeauxstats[codeauxtop[i]]) / double(sumcodeaux) * 100, double(acccodeaux) / double(sumcodeaux) * 100);
-	}
-#endif
-
-	return data - buffer;
+	return data;
 }
 
-size_t meshopt_encodeIndexBufferBound(size_t index_count, size_t vertex_count)
+template <typename T>
+static void writeTriangle(T* destination, unsigned int a, unsigned int b, unsigned int c)
 {
-	assert(index_count % 3 == 0);
-
-	// compute number of bits required for each index
-	unsigned int vertex_bits = 1;
-
-	while (vertex_bits < 32 && vertex_count > size_t(1) << vertex_bits)
-		vertex_bits++;
-
-	// worst-case encoding is 2 header bytes + 3 varint-7 encoded index deltas
-	unsigned int vertex_groups = (vertex_bits + 1 + 6) / 7;
-
-	return 1 + (index_count / 3) * (2 + 3 * vertex_groups) + 16;
+	destination[0] = T(a);
+	destination[1] = T(b);
+	destination[2] = T(c);
 }
 
-void meshopt_encodeIndexVersion(int version)
+template <typename T>
+static const unsigned char* decodeIndexBuffer(T* destination, size_t index_count, int version, const unsigned char* code, const unsigned char* data_safe_end, const unsigned char* codeaux_table, unsigned int next, unsigned int* next_result)
 {
-	assert(unsigned(version) <= 1);
-
-	meshopt::gEncodeIndexVersion = version;
-}
-
-int meshopt_decodeIndexBuffer(void* destination, size_t index_count, size_t index_size, const unsigned char* buffer, size_t buffer_size)
-{
-	using namespace meshopt;
-
-	assert(index_count % 3 == 0);
-	assert(index_size == 2 || index_size == 4);
-
-	// the minimum valid encoding is header, 1 byte per triangle and a 16-byte codeaux table
-	if (buffer_size < 1 + index_count / 3 + 16)
-		return -2;
-
-	if ((buffer[0] & 0xf0) != kIndexHeader)
-		return -1;
-
-	int version = buffer[0] & 0x0f;
-	if (version > 1)
-		return -1;
-
 	EdgeFifo edgefifo;
 	memset(edgefifo, -1, sizeof(edgefifo));
 
@@ -464,17 +370,13 @@ int meshopt_decodeIndexBuffer(void* destination, size_t index_count, size_t inde
 	size_t edgefifooffset = 0;
 	size_t vertexfifooffset = 0;
 
-	unsigned int next = 0;
-	unsigned int last = 0;
+	// free indices are delta-encoded relative to the start of the stream or chunk
+	unsigned int last = next;
 
 	int fecmax = version >= 1 ? 13 : 15;
 
-	// since we store 16-byte codeaux table at the end, triangle data has to begin before data_safe_end
-	const unsigned char* code = buffer + 1;
+	// triangle data follows code bytes and has to end before data_safe_end, which is followed by at least 16 more bytes
 	const unsigned char* data = code + index_count / 3;
-	const unsigned char* data_safe_end = buffer + buffer_size - 16;
-
-	const unsigned char* codeaux_table = data_safe_end;
 
 	for (size_t i = 0; i < index_count; i += 3)
 	{
@@ -482,7 +384,7 @@ int meshopt_decodeIndexBuffer(void* destination, size_t index_count, size_t inde
 		// each triangle reads at most 16 bytes of data: 1b for codeaux and 5b for each free index
 		// after this we can be sure we can read without extra bounds checks
 		if (data > data_safe_end)
-			return -2;
+			return NULL;
 
 		unsigned char codetri = *code++;
 
@@ -498,41 +400,30 @@ int meshopt_decodeIndexBuffer(void* destination, size_t index_count, size_t inde
 
 			// note: this is the most common path in the entire decoder
 			// inside this if we try to stay branchless (by using cmov/etc.) since these aren't predictable
-			if (fec < fecmax)
-			{
-				// fifo reads are wrapped around 16 entry buffer
-				unsigned int cf = vertexfifo[(vertexfifooffset - 1 - fec) & 15];
-				unsigned int c = (fec == 0) ? next : cf;
-
-				int fec0 = fec == 0;
-				next += fec0;
-
-				// output triangle
-				writeTriangle(destination, i, index_size, a, b, c);
+			// fifo reads are wrapped around 16 entry buffer
+			unsigned int cf = vertexfifo[(vertexfifooffset - 1 - fec) & 15];
+			unsigned int c = (fec == 0) ? next : cf;
 
-				// push vertex/edge fifo must match the encoding step *exactly* otherwise the data will not be decoded correctly
-				pushVertexFifo(vertexfifo, c, vertexfifooffset, fec0);
+			int fec0 = fec == 0;
+			next += fec0;
 
-				pushEdgeFifo(edgefifo, c, b, edgefifooffset);
-				pushEdgeFifo(edgefifo, a, c, edgefifooffset);
-			}
-			else
+			// free indices are rare, so this branch is well predicted
+			if (fec >= fecmax)
 			{
-				unsigned int c = 0;
-
 				// fec - (fec ^ 3) decodes 13, 14 into -1, 1
 				// note that we need to update the last index since free indices are delta-encoded
 				last = c = (fec != 15) ? last + (fec - (fec ^ 3)) : decodeIndex(data, last);
+				fec0 = 1;
+			}
 
-				// output triangle
-				writeTriangle(destination, i, index_size, a, b, c);
+			// output triangle
+			writeTriangle(destination + i, a, b, c);
 
-				// push vertex/edge fifo must match the encoding step *exactly* otherwise the data will not be decoded correctly
-				pushVertexFifo(vertexfifo, c, vertexfifooffset);
+			// push vertex/edge fifo must match the encoding step *exactly* otherwise the data will not be decoded correctly
+			pushVertexFifo(vertexfifo, c, vertexfifooffset, fec0);
 
-				pushEdgeFifo(edgefifo, c, b, edgefifooffset);
-				pushEdgeFifo(edgefifo, a, c, edgefifooffset);
-			}
+			pushEdgeFifo(edgefifo, c, b, edgefifooffset);
+			pushEdgeFifo(edgefifo, a, c, edgefifooffset);
 		}
 		else
 		{
@@ -562,7 +453,7 @@ int meshopt_decodeIndexBuffer(void* destination, size_t index_count, size_t inde
 				next += fec0;
 
 				// output triangle
-				writeTriangle(destination, i, index_size, a, b, c);
+				writeTriangle(destination + i, a, b, c);
 
 				// push vertex/edge fifo must match the encoding step *exactly* otherwise the data will not be decoded correctly
 				pushVertexFifo(vertexfifo, a, vertexfifooffset);
@@ -603,7 +494,7 @@ int meshopt_decodeIndexBuffer(void* destination, size_t index_count, size_t inde
 					last = c = decodeIndex(data, last);
 
 				// output triangle
-				writeTriangle(destination, i, index_size, a, b, c);
+				writeTriangle(destination + i, a, b, c);
 
 				// push vertex/edge fifo must match the encoding step *exactly* otherwise the data will not be decoded correctly
 				pushVertexFifo(vertexfifo, a, vertexfifooffset);
@@ -617,6 +508,343 @@ int meshopt_decodeIndexBuffer(void* destination, size_t index_count, size_t inde
 		}
 	}
 
+	// sequential chunk decoding continues from the state at the end of the previous chunk
+	if (next_result)
+		*next_result = next;
+
+	return data;
+}
+
+static size_t getIndexChunkCount(size_t index_count)
+{
+	return (index_count / 3 + kIndexChunkTriangles - 1) / kIndexChunkTriangles;
+}
+
+static int getIndexBufferVersion(const unsigned char* buffer, size_t buffer_size, size_t index_count)
+{
+	// the minimum valid encoding is header, 1 byte per triangle and a 16-byte codeaux table
+	if (buffer_size < 1 + index_count / 3 + 16)
+		return -2;
+
+	if ((buffer[0] & 0xf0) != kIndexHeader)
+		return -1;
+
+	int version = buffer[0] & 0x0f;
+	if (version > 2)
+		return -1;
+
+	// version 2 additionally stores 8 bytes per chunk in the chunk table after the header
+	if (version >= 2 && buffer_size < 1 + getIndexChunkCount(index_count) * 8 + index_count / 3 + 16)
+		return -2;
+
+	return version;
+}
+
+static int decodeIndexChunks(void* destination, size_t index_size, size_t index_count, const unsigned char* buffer, size_t buffer_size, size_t chunk_begin, size_t chunk_end)
+{
+	size_t chunk_count = getIndexChunkCount(index_count);
+	size_t header_size = 1 + chunk_count * 8;
+
+	const unsigned char* codeaux_table = buffer + buffer_size - 16;
+
+	for (size_t i = chunk_begin; i < chunk_end; ++i)
+	{
+		size_t chunk_offset = i * kIndexChunkTriangles * 3;
+		size_t chunk_size = index_count - chunk_offset < kIndexChunkTriangles * 3 ? index_count - chunk_offset : kIndexChunkTriangles * 3;
+
+		unsigned int offset = 0, next = 0;
+		readChunkEntry(buffer + 1 + i * 8, offset, next);
+
+		// each chunk ends where the next one begins; the last chunk ends at the codeaux table
+		size_t end = buffer_size - 16;
+
+		if (i + 1 < chunk_count)
+		{
+			unsigned int next_offset = 0, next_next = 0;
+			readChunkEntry(buffer + 1 + (i + 1) * 8, next_offset, next_next);
+
+			end = next_offset;
+		}
+
+		// validate the chunk table so that the decoder never reads outside of the buffer
+		if (offset < header_size || end > buffer_size - 16 || offset + chunk_size / 3 > end)
+			return -2;
+
+		void* chunk_destination = static_cast<char*>(destination) + (chunk_offset - chunk_begin * kIndexChunkTriangles * 3) * index_size;
+
+		const unsigned char* data = (index_size == 2)
+		    ? decodeIndexBuffer(static_cast<unsigned short*>(chunk_destination), chunk_size, 2, buffer + offset, buffer + end, codeaux_table, next, NULL)
+		    : decodeIndexBuffer(static_cast<unsigned int*>(chunk_destination), chunk_size, 2, buffer + offset, buffer + end, codeaux_table, next, NULL);
+
+		if (!data)
+			return -2;
+
+		// we should've read all data bytes and stopped at the beginning of the next chunk
+		if (data != buffer + end)
+			return -3;
+	}
+
+	return 0;
+}
+
+static unsigned int hashChunkEntry(unsigned int h, unsigned int offset, unsigned int next)
+{
+	// FNV-1a over both entry fields
+	h = (h ^ offset) * 16777619;
+	h = (h ^ next) * 16777619;
+
+	return h;
+}
+
+static int decodeIndexChunksSequential(void* destination, size_t index_size, size_t index_count, const unsigned char* buffer, size_t buffer_size)
+{
+	size_t chunk_count = getIndexChunkCount(index_count);
+	size_t header_size = 1 + chunk_count * 8;
+
+	const unsigned char* codeaux_table = buffer + buffer_size - 16;
+
+	// when decoding in place, decoded indices overwrite the chunk table, so it's validated and hashed before any output is written
+	// the decoder then reconstructs chunk offsets and next indices from the stream itself and compares the hash at the end
+	unsigned int table_hash = 2166136261u;
+	size_t table_end = header_size;
+
+	for (size_t i = 0; i < chunk_count; ++i)
+	{
+		size_t chunk_size = index_count - i * kIndexChunkTriangles * 3 < kIndexChunkTriangles * 3 ? index_count - i * kIndexChunkTriangles * 3 : kIndexChunkTriangles * 3;
+
+		unsigned int offset = 0, next = 0;
+		readChunkEntry(buffer + 1 + i * 8, offset, next);
+
+		if (offset < table_end || offset > buffer_size - 16 || buffer_size - 16 - offset < chunk_size / 3)
+			return -2;
+
+		table_hash = hashChunkEntry(table_hash, offset, next);
+		table_end = offset + chunk_size / 3;
+	}
+
+	unsigned int stream_hash = 2166136261u;
+
+	const unsigned char* data = buffer + header_size;
+	unsigned int next = 0;
+
+	for (size_t i = 0; i < chunk_count; ++i)
+	{
+		size_t chunk_offset = i * kIndexChunkTriangles * 3;
+		size_t chunk_size = index_count - chunk_offset < kIndexChunkTriangles * 3 ? index_count - chunk_offset : kIndexChunkTriangles * 3;
+
+		if (size_t(codeaux_table - data) < chunk_size / 3)
+			return -2;
+
+		stream_hash = hashChunkEntry(stream_hash, unsigned(data - buffer), next);
+
+		void* chunk_destination = static_cast<char*>(destination) + chunk_offset * index_size;
+
+		// chunk data can be followed by other chunks, so we can only bound the reads by the codeaux table
+		data = (index_size == 2)
+		    ? decodeIndexBuffer(static_cast<unsigned short*>(chunk_destination), chunk_size, 2, data, codeaux_table, codeaux_table, next, &next)
+		    : decodeIndexBuffer(static_cast<unsigned int*>(chunk_destination), chunk_size, 2, data, codeaux_table, codeaux_table, next, &next);
+
+		if (!data)
+			return -2;
+	}
+
+	// we should've read all data bytes and reconstructed the chunk table exactly
+	if (data != codeaux_table || stream_hash != table_hash)
+		return -3;
+
+	return 0;
+}
+
+struct IndexDecodeContext
+{
+	void* destination;
+	size_t index_size;
+	size_t index_count;
+
+	const unsigned char* buffer;
+	size_t buffer_size;
+
+	int* results;
+};
+
+static void decodeIndexChunkTask(void* context, size_t task_index)
+{
+	IndexDecodeContext& dc = *static_cast<IndexDecodeContext*>(context);
+
+	void* chunk_destination = static_cast<char*>(dc.destination) + task_index * kIndexChunkTriangles * 3 * dc.index_size;
+
+	dc.results[task_index] = decodeIndexChunks(chunk_destination, dc.index_size, dc.index_count, dc.buffer, dc.buffer_size, task_index, task_index + 1);
+}
+
+} // namespace meshopt
+
+size_t meshopt_encodeIndexBuffer(unsigned char* buffer, size_t buffer_size, const unsigned int* indices, size_t index_count)
+{
+	using namespace meshopt;
+
+	assert(index_count % 3 == 0);
+
+#if TRACE
+	size_t* codestats = gCodeStats;
+	size_t* codeauxstats = gCodeAuxStats;
+
+	memset(gCodeStats, 0, sizeof(gCodeStats));
+	memset(gCodeAuxStats, 0, sizeof(gCodeAuxStats));
+#endif
+
+	// the minimum valid encoding is header, 1 byte per triangle and a 16-byte codeaux table
+	if (buffer_size < 1 + index_count / 3 + 16)
+		return 0;
+
+	int version = gEncodeIndexVersion;
+
+	buffer[0] = (unsigned char)(kIndexHeader | version);
+
+	// use static encoding table; it's possible to pack the result and then build an optimal table and repack
+	// for now we keep it simple and use the table that has been generated based on symbol frequency on a training mesh set
+	const unsigned char* codeaux_table = kCodeAuxEncodingTable;
+
+	unsigned char* data_safe_end = buffer + buffer_size - 16;
+	unsigned char* data = NULL;
+
+	if (version >= 2)
+	{
+		size_t chunk_count = getIndexChunkCount(index_count);
+		size_t header_size = 1 + chunk_count * 8;
+
+		if (buffer_size < header_size + index_count / 3 + 16)
+			return 0;
+
+		// each chunk restarts the FIFO state so that chunks can be decoded independently; the chunk table stores the offset and the next vertex index for each chunk
+		unsigned int next = 0;
+		data = buffer + header_size;
+
+		for (size_t i = 0; i < chunk_count; ++i)
+		{
+			size_t chunk_offset = i * kIndexChunkTriangles * 3;
+			size_t chunk_size = index_count - chunk_offset < kIndexChunkTriangles * 3 ? index_count - chunk_offset : kIndexChunkTriangles * 3;
+
+			// data of all previous chunks plus code bytes of this chunk have to fit
+			if (data + chunk_size / 3 > data_safe_end)
+				return 0;
+
+			writeChunkEntry(buffer + 1 + i * 8, unsigned(data - buffer), next);
+
+			data = encodeIndexTriangles(data, data + chunk_size / 3, data_safe_end, codeaux_table, indices + chunk_offset, chunk_size, version, next);
+			if (!data)
+				return 0;
+		}
+	}
+	else
+	{
+		unsigned int next = 0;
+
+		data = encodeIndexTriangles(buffer + 1, buffer + 1 + index_count / 3, data_safe_end, codeaux_table, indices, index_count, version, next);
+		if (!data)
+			return 0;
+	}
+
+	// make sure we have enough space to write codeaux table
+	if (data > data_safe_end)
+		return 0;
+
+	// add codeaux encoding table to the end of the stream; this is used for decoding codeaux *and* as padding
+	// we need padding for decoding to be able to assume that each triangle is encoded as <= 16 bytes of extra data
+	// this is enough space for aux byte + 5 bytes per varint index which is the absolute worst case for any input
+	for (size_t i = 0; i < 16; ++i)
+	{
+		// decoder assumes that table entries never refer to separately encoded indices
+		assert((codeaux_table[i] & 0xf) != 0xf && (codeaux_table[i] >> 4) != 0xf);
+
+		*data++ = codeaux_table[i];
+	}
+
+	// since we encode restarts as codeaux without a table reference, we need to make sure 00 is encoded as a table reference
+	assert(codeaux_table[0] == 0);
+
+	assert(data >= buffer + 1 + index_count / 3 + 16);
+	assert(data <= buffer + buffer_size);
+
+#if TRACE
+	unsigned char codetop[16], codeauxtop[16];
+	size_t codetopsize = sortTop16(codetop, codestats);
+	size_t codeauxtopsize = sortTop16(codeauxtop, codeauxstats);
+
+	size_t sumcode = 0, sumcodeaux = 0;
+	for (size_t i = 0; i < 256; ++i)
+		sumcode += codestats[i], sumcodeaux += codeauxstats[i];
+
+	size_t acccode = 0, acccodeaux = 0;
+
+	printf("code\t\t\t\t\tcodeaux\n");
+
+	for (size_t i = 0; i < codetopsize && i < codeauxtopsize; ++i)
+	{
+		acccode += codestats[codetop[i]];
+		acccodeaux += codeauxstats[codeauxtop[i]];
+
+		printf("%2d: %02x = %d (%.1f%% ..%.1f%%)\t\t%2d: %02x = %d (%.1f%% ..%.1f%%)\n",
+		       int(i), codetop[i], int(codestats[codetop[i]]), double(codestats[codetop[i]]) / double(sumcode) * 100, double(acccode) / double(sumcode) * 100,
+		       int(i), codeauxtop[i], int(codeauxstats[codeauxtop[i]]), double(codeauxstats[codeauxtop[i]]) / double(sumcodeaux) * 100, double(acccodeaux) / double(sumcodeaux) * 100);
+	}
+#endif
+
+	return data - buffer;
+}
+
+size_t meshopt_encodeIndexBufferBound(size_t index_count, size_t vertex_count)
+{
+	using namespace meshopt;
+
+	assert(index_count % 3 == 0);
+
+	// compute number of bits required for each index
+	unsigned int vertex_bits = 1;
+
+	while (vertex_bits < 32 && vertex_count > size_t(1) << vertex_bits)
+		vertex_bits++;
+
+	// worst-case encoding is 2 header bytes + 3 varint-7 encoded index deltas
+	unsigned int vertex_groups = (vertex_bits + 1 + 6) / 7;
+
+	// version 2 additionally needs space for the chunk table
+	size_t chunk_table = getIndexChunkCount(index_count) * 8;
+
+	return 1 + chunk_table + (index_count / 3) * (2 + 3 * vertex_groups) + 16;
+}
+
+void meshopt_encodeIndexVersion(int version)
+{
+	assert(unsigned(version) <= 2);
+
+	meshopt::gEncodeIndexVersion = version;
+}
+
+int meshopt_decodeIndexBuffer(void* destination, size_t index_count, size_t index_size, const unsigned char* buffer, size_t buffer_size)
+{
+	using namespace meshopt;
+
+	assert(index_count % 3 == 0);
+	assert(index_size == 2 || index_size == 4);
+
+	int version = getIndexBufferVersion(buffer, buffer_size, index_count);
+	if (version < 0)
+		return version;
+
+	if (version >= 2)
+		return decodeIndexChunksSequential(destination, index_size, index_count, buffer, buffer_size);
+
+	// the decoder is specialized for each index size so that triangle writes don't need to branch on it
+	// since we store 16-byte codeaux table at the end, triangle data has to end before it
+	const unsigned char* data_safe_end = buffer + buffer_size - 16;
+
+	const unsigned char* data = (index_size == 2)
+	    ? decodeIndexBuffer(static_cast<unsigned short*>(destination), index_count, version, buffer + 1, data_safe_end, data_safe_end, 0, NULL)
+	    : decodeIndexBuffer(static_cast<unsigned int*>(destination), index_count, version, buffer + 1, data_safe_end, data_safe_end, 0, NULL);
+
+	if (!data)
+		return -2;
+
 	// we should've read all data bytes and stopped at the boundary between data and codeaux table
 	if (data != data_safe_end)
 		return -3;
@@ -624,6 +852,129 @@ int meshopt_decodeIndexBuffer(void* destination, size_t index_count, size_t inde
 	return 0;
 }
 
+int meshopt_decodeIndexBufferRange(void* destination, size_t index_offset, size_t index_range, size_t index_count, size_t index_size, const unsigned char* buffer, size_t buffer_size)
+{
+	using namespace meshopt;
+
+	const size_t chunk_indices = kIndexChunkTriangles * 3;
+
+	assert(index_count % 3 == 0);
+	assert(index_size == 2 || index_size == 4);
+	assert(index_offset + index_range <= index_count);
+	assert(index_offset % chunk_indices == 0);
+	assert((index_offset + index_range) % chunk_indices == 0 || index_offset + index_range == index_count);
+
+	int version = getIndexBufferVersion(buffer, buffer_size, index_count);
+	if (version < 0)
+		return version;
+
+	// older versions don't have a chunk table so the entire buffer has to be decoded at once
+	if (version < 2)
+		return -1;
+
+	size_t chunk_begin = index_offset / chunk_indices;
+	size_t chunk_end = (index_offset + index_range + chunk_indices - 1) / chunk_indices;
+
+	return decodeIndexChunks(destination, index_size, index_count, buffer, buffer_size, chunk_begin, chunk_end);
+}
+
+int meshopt_decodeIndexBufferParallel(void* destination, size_t index_count, size_t index_size, const unsigned char* buffer, size_t buffer_size, meshopt_Scheduler scheduler, void* scheduler_context)
+{
+	using namespace meshopt;
+
+	assert(index_count % 3 == 0);
+	assert(index_size == 2 || index_size == 4);
+
+	int version = getIndexBufferVersion(buffer, buffer_size, index_count);
+	if (version < 0)
+		return version;
+
+	size_t chunk_count = getIndexChunkCount(index_count);
+
+	if (version < 2 || !scheduler || chunk_count <= 1)
+		return meshopt_decodeIndexBuffer(destination, index_count, index_size, buffer, buffer_size);
+
+	meshopt_Allocator allocator;
+
+	int* results = allocator.allocate<int>(chunk_count);
+
+	IndexDecodeContext context = {destination, index_size, index_count, buffer, buffer_size, results};
+	scheduler(scheduler_context, decodeIndexChunkTask, &context, chunk_count);
+
+	// report the error for the first chunk that failed to match serial decoding
+	for (size_t i = 0; i < chunk_count; ++i)
+		if (results[i] != 0)
+			return results[i];
+
+	return 0;
+}
+
+size_t meshopt_decodeIndexBufferInPlaceMargin(size_t index_count, size_t index_size, const unsigned char* buffer, size_t buffer_size)
+{
+	using namespace meshopt;
+
+	assert(index_count % 3 == 0);
+	assert(index_size == 2 || index_size == 4);
+
+	// malformed buffers fail to decode; placing the input right after the output keeps that from touching the input
+	int version = getIndexBufferVersion(buffer, buffer_size, index_count);
+	if (version < 0)
+		return buffer_size;
+
+	size_t triangle_size = index_size * 3;
+	size_t decoded_size = index_count * index_size;
+
+	// the input has to fit into the allocation, and the codeaux table is read throughout decoding so it can't be overwritten
+	size_t margin = buffer_size > decoded_size ? buffer_size - decoded_size : 0;
+	margin = margin < 16 ? 16 : margin;
+
+	size_t chunk_count = version >= 2 ? getIndexChunkCount(index_count) : 1;
+	size_t header_size = version >= 2 ? 1 + chunk_count * 8 : 1;
+
+	for (size_t i = 0; i < chunk_count; ++i)
+	{
+		size_t chunk_triangles = version >= 2 ? i * kIndexChunkTriangles : 0;
+		size_t chunk_size = version >= 2 && index_count / 3 - chunk_triangles > kIndexChunkTriangles ? kIndexChunkTriangles : index_count / 3 - chunk_triangles;
+
+		unsigned int offset = unsigned(header_size), next = 0;
+		unsigned int end = unsigned(buffer_size - 16);
+
+		if (version >= 2)
+		{
+			readChunkEntry(buffer + 1 + i * 8, offset, next);
+
+			if (i + 1 < chunk_count)
+				readChunkEntry(buffer + 1 + (i + 1) * 8, end, next);
+
+			if (offset < header_size || end > buffer_size - 16 || offset > end || end - offset < chunk_size)
+				return buffer_size;
+		}
+
+		// each triangle is written before the code byte of the next triangle is read; indices are written faster than code bytes are read,
+		// so the write of the second to last triangle in the chunk is the closest to the read position
+		if (chunk_size >= 2)
+		{
+			size_t write = (chunk_triangles + chunk_size - 1) * triangle_size;
+			size_t read = offset + chunk_size - 1;
+
+			if (write + buffer_size > read + decoded_size && write + buffer_size - read - decoded_size > margin)
+				margin = write + buffer_size - read - decoded_size;
+		}
+
+		// the last triangle of the chunk is written before the next chunk is read
+		if (i + 1 < chunk_count)
+		{
+			size_t write = (chunk_triangles + chunk_size) * triangle_size;
+			size_t read = end;
+
+			if (write + buffer_size > read + decoded_size && write + buffer_size - read - decoded_size > margin)
+				margin = write + buffer_size - read - decoded_size;
+		}
+	}
+
+	return margin;
+}
+
 size_t meshopt_encodeIndexSequence(unsigned char* buffer, size_t buffer_size, const unsigned int* indices, size_t index_count)
 {
 	using namespace meshopt;
@@ -632,7 +983,8 @@ size_t meshopt_encodeIndexSequence(unsigned char* buffer, size_t buffer_size, co
 	if (buffer_size < 1 + index_count + 4)
 		return 0;
 
-	int version = gEncodeIndexVersion;
+	// version 2 only changes the triangle list encoding; sequences use version 1 in that case
+	int version = gEncodeIndexVersion > 1 ? 1 : gEncodeIndexVersion;
 
 	buffer[0] = (unsigned char)(kSequenceHeader | version);
 
@@ -48,6 +48,24 @@ struct VertexHasher
 	}
 };
 
+// fixed-size variant for common vertex sizes; constant size lets the compiler unroll hashing and inline the comparison into a few loads
+template <size_t Size>
+struct VertexHasherFixed
+{
+	const unsigned char* vertices;
+	size_t vertex_stride;
+
+	size_t hash(unsigned int index) const
+	{
+		return hashUpdate4(0, vertices + index * vertex_stride, Size);
+	}
+
+	bool equal(unsigned int lhs, unsigned int rhs) const
+	{
+		return memcmp(vertices + lhs * vertex_stride, vertices + rhs * vertex_stride, Size) == 0;
+	}
+};
+
 struct VertexStreamHasher
 {
 	const meshopt_Stream* streams;
@@ -119,22 +137,9 @@ static T* hashLookup(T* table, size_t buckets, const Hash& hash, const T& key, c
 	return 0;
 }
 
-} // namespace meshopt
-
-size_t meshopt_generateVertexRemap(unsigned int* destination, const unsigned int* indices, size_t index_count, const void* vertices, size_t vertex_count, size_t vertex_size)
+template <typename Hash>
+static size_t generateVertexRemap(meshopt_Allocator& allocator, unsigned int* destination, const unsigned int* indices, size_t index_count, size_t vertex_count, const Hash& hasher)
 {
-	using namespace meshopt;
-
-	assert(indices || index_count == vertex_count);
-	assert(index_count % 3 == 0);
-	assert(vertex_size > 0 && vertex_size <= 256);
-
-	meshopt_Allocator allocator;
-
-	memset(destination, -1, vertex_count * sizeof(unsigned int));
-
-	VertexHasher hasher = {static_cast<const unsigned char*>(vertices), vertex_size, vertex_size};
-
 	size_t table_size = hashBuckets(vertex_count);
 	unsigned int* table = allocator.allocate<unsigned int>(table_size);
 	memset(table, -1, table_size * sizeof(unsigned int));
@@ -170,6 +175,308 @@ size_t meshopt_generateVertexRemap(unsigned int* destination, const unsigned int
 	return next_vertex;
 }
 
+template <typename Hash>
+static void generateShadowIndexBuffer(meshopt_Allocator& allocator, unsigned int* destination, const unsigned int* indices, size_t index_count, size_t vertex_count, const Hash& hasher)
+{
+	unsigned int* remap = allocator.allocate<unsigned int>(vertex_count);
+	memset(remap, -1, vertex_count * sizeof(unsigned int));
+
+	size_t table_size = hashBuckets(vertex_count);
+	unsigned int* table = allocator.allocate<unsigned int>(table_size);
+	memset(table, -1, table_size * sizeof(unsigned int));
+
+	for (size_t i = 0; i < index_count; ++i)
+	{
+		unsigned int index = indices[i];
+		assert(index < vertex_count);
+
+		if (remap[index] == ~0u)
+		{
+			unsigned int* entry = hashLookup(table, table_size, hasher, index, ~0u);
+
+			if (*entry == ~0u)
+				*entry = index;
+
+			remap[index] = *entry;
+		}
+
+		destination[i] = remap[index];
+	}
+}
+
+static size_t generateVertexRemap(meshopt_Allocator& allocator, unsigned int* destination, const unsigned int* indices, size_t index_count, const unsigned char* vertices, size_t vertex_count, size_t vertex_size, size_t vertex_stride)
+{
+	switch (vertex_size)
+	{
+	case 12:
+	{
+		VertexHasherFixed<12> hasher = {vertices, vertex_stride};
+		return generateVertexRemap(allocator, destination, indices, index_count, vertex_count, hasher);
+	}
+	case 16:
+	{
+		VertexHasherFixed<16> hasher = {vertices, vertex_stride};
+		return generateVertexRemap(allocator, destination, indices, index_count, vertex_count, hasher);
+	}
+	case 24:
+	{
+		VertexHasherFixed<24> hasher = {vertices, vertex_stride};
+		return generateVertexRemap(allocator, destination, indices, index_count, vertex_count, hasher);
+	}
+	case 32:
+	{
+		VertexHasherFixed<32> hasher = {vertices, vertex_stride};
+		return generateVertexRemap(allocator, destination, indices, index_count, vertex_count, hasher);
+	}
+	default:
+	{
+		VertexHasher hasher = {vertices, vertex_size, vertex_stride};
+		return generateVertexRemap(allocator, destination, indices, index_count, vertex_count, hasher);
+	}
+	}
+}
+
+static void generateShadowIndexBuffer(meshopt_Allocator& allocator, unsigned int* destination, const unsigned int* indices, size_t index_count, const unsigned char* vertices, size_t vertex_count, size_t vertex_size, size_t vertex_stride)
+{
+	switch (vertex_size)
+	{
+	case 12:
+	{
+		VertexHasherFixed<12> hasher = {vertices, vertex_stride};
+		return generateShadowIndexBuffer(allocator, destination, indices, index_count, vertex_count, hasher);
+	}
+	case 16:
+	{
+		VertexHasherFixed<16> hasher = {vertices, vertex_stride};
+		return generateShadowIndexBuffer(allocator, destination, indices, index_count, vertex_count, hasher);
+	}
+	case 24:
+	{
+		VertexHasherFixed<24> hasher = {vertices, vertex_stride};
+		return generateShadowIndexBuffer(allocator, destination, indices, index_count, vertex_count, hasher);
+	}
+	case 32:
+	{
+		VertexHasherFixed<32> hasher = {vertices, vertex_stride};
+		return generateShadowIndexBuffer(allocator, destination, indices, index_count, vertex_count, hasher);
+	}
+	default:
+	{
+		VertexHasher hasher = {vertices, vertex_size, vertex_stride};
+		return generateShadowIndexBuffer(allocator, destination, indices, index_count, vertex_count, hasher);
+	}
+	}
+}
+
+template <typename Hash>
+static void computeHashes(unsigned int* hashes, size_t begin, size_t end, const Hash& hasher)
+{
+	for (size_t i = begin; i < end; ++i)
+		hashes[i] = unsigned(hasher.hash(unsigned(i)));
+}
+
+const size_t kRemapHashBlock = 16384;
+const size_t kRemapShards = 64;
+
+struct VertexHashCache
+{
+	const unsigned char* vertices;
+	size_t vertex_size;
+	size_t vertex_stride;
+	const unsigned int* hashes;
+
+	size_t hash(unsigned int index) const
+	{
+		return hashes[index];
+	}
+
+	bool equal(unsigned int lhs, unsigned int rhs) const
+	{
+		return hashes[lhs] == hashes[rhs] && memcmp(vertices + lhs * vertex_stride, vertices + rhs * vertex_stride, vertex_size) == 0;
+	}
+};
+
+struct RemapContext
+{
+	VertexHasher hasher;
+	size_t vertex_count;
+
+	unsigned int* hashes;
+
+	// referenced vertices in the order of first use, grouped by shard
+	const unsigned int* shard_vertices;
+	const size_t* shard_offsets;
+
+	unsigned int* tables;
+	const size_t* table_offsets;
+
+	unsigned int* destination;
+};
+
+static void computeRemapHashes(void* context, size_t task_index)
+{
+	const RemapContext& rc = *static_cast<RemapContext*>(context);
+
+	size_t begin = task_index * kRemapHashBlock;
+	size_t end = begin + kRemapHashBlock < rc.vertex_count ? begin + kRemapHashBlock : rc.vertex_count;
+
+	const unsigned char* vertices = rc.hasher.vertices;
+	size_t vertex_stride = rc.hasher.vertex_stride;
+
+	switch (rc.hasher.vertex_size)
+	{
+	case 12:
+	{
+		VertexHasherFixed<12> hasher = {vertices, vertex_stride};
+		return computeHashes(rc.hashes, begin, end, hasher);
+	}
+	case 16:
+	{
+		VertexHasherFixed<16> hasher = {vertices, vertex_stride};
+		return computeHashes(rc.hashes, begin, end, hasher);
+	}
+	case 24:
+	{
+		VertexHasherFixed<24> hasher = {vertices, vertex_stride};
+		return computeHashes(rc.hashes, begin, end, hasher);
+	}
+	case 32:
+	{
+		VertexHasherFixed<32> hasher = {vertices, vertex_stride};
+		return computeHashes(rc.hashes, begin, end, hasher);
+	}
+	default:
+		return computeHashes(rc.hashes, begin, end, rc.hasher);
+	}
+}
+
+static void remapShard(void* context, size_t task_index)
+{
+	const RemapContext& rc = *static_cast<RemapContext*>(context);
+
+	VertexHashCache hasher = {rc.hasher.vertices, rc.hasher.vertex_size, rc.hasher.vertex_stride, rc.hashes};
+
+	unsigned int* table = rc.tables + rc.table_offsets[task_index];
+	size_t table_size = rc.table_offsets[task_index + 1] - rc.table_offsets[task_index];
+
+	if (table_size == 0)
+		return;
+
+	memset(table, -1, table_size * sizeof(unsigned int));
+
+	// since shard vertices are in the order of first use, the first vertex in each equivalence class becomes its representative, which matches the serial version
+	for (size_t i = rc.shard_offsets[task_index]; i < rc.shard_offsets[task_index + 1]; ++i)
+	{
+		unsigned int index = rc.shard_vertices[i];
+		unsigned int* entry = hashLookup(table, table_size, hasher, index, ~0u);
+
+		if (*entry == ~0u)
+			*entry = index;
+
+		rc.destination[index] = *entry;
+	}
+}
+
+static unsigned int getRemapShard(unsigned int hash)
+{
+	// table lookups use low bits of the hash, so shards use high bits to keep the two independent; 6 bits give us kRemapShards shards
+	return (hash * 0x9e3779b1u) >> 26;
+}
+
+static void remapShards(const RemapContext& base, meshopt_Allocator& allocator, const unsigned int* order, size_t order_count, meshopt_Scheduler scheduler, void* scheduler_context)
+{
+	const unsigned int* hashes = base.hashes;
+
+	// partition vertices into shards by hash, preserving the order of first use within each shard
+	size_t shard_offsets[kRemapShards + 1] = {};
+
+	for (size_t i = 0; i < order_count; ++i)
+		shard_offsets[getRemapShard(hashes[order ? order[i] : i]) + 1]++;
+
+	size_t table_offsets[kRemapShards + 1] = {};
+
+	for (size_t i = 0; i < kRemapShards; ++i)
+	{
+		size_t shard_size = shard_offsets[i + 1];
+
+		table_offsets[i + 1] = table_offsets[i] + (shard_size ? hashBuckets(shard_size) : 0);
+		shard_offsets[i + 1] += shard_offsets[i];
+	}
+
+	unsigned int* shard_vertices = allocator.allocate<unsigned int>(order_count);
+
+	size_t shard_fill[kRemapShards];
+	memcpy(shard_fill, shard_offsets, sizeof(shard_fill));
+
+	for (size_t i = 0; i < order_count; ++i)
+	{
+		unsigned int index = order ? order[i] : unsigned(i);
+
+		shard_vertices[shard_fill[getRemapShard(hashes[index])]++] = index;
+	}
+
+	// shard layout lives on our stack, so tasks get a local copy of the context
+	RemapContext context = base;
+	context.shard_vertices = shard_vertices;
+	context.shard_offsets = shard_offsets;
+	context.tables = allocator.allocate<unsigned int>(table_offsets[kRemapShards]);
+	context.table_offsets = table_offsets;
+
+	// each shard deduplicates its vertices independently, writing the representative vertex for every vertex into destination
+	if (scheduler)
+		scheduler(scheduler_context, remapShard, &context, kRemapShards);
+	else
+		for (size_t i = 0; i < kRemapShards; ++i)
+			remapShard(&context, i);
+}
+
+struct RemapShadowContext
+{
+	const unsigned char* vertices;
+	size_t vertex_count;
+	size_t vertex_size;
+	size_t shadow_size;
+
+	unsigned int* hashes;
+	unsigned int* shadow_hashes;
+};
+
+static void computeRemapShadowHashes(void* context, size_t task_index)
+{
+	const RemapShadowContext& rc = *static_cast<RemapShadowContext*>(context);
+
+	size_t begin = task_index * kRemapHashBlock;
+	size_t end = begin + kRemapHashBlock < rc.vertex_count ? begin + kRemapHashBlock : rc.vertex_count;
+
+	// the full vertex hash continues from the shadow prefix hash, so every vertex is only read once
+	for (size_t i = begin; i < end; ++i)
+	{
+		const unsigned char* vertex = rc.vertices + i * rc.vertex_size;
+
+		unsigned int h = hashUpdate4(0, vertex, rc.shadow_size);
+
+		rc.shadow_hashes[i] = h;
+		rc.hashes[i] = hashUpdate4(h, vertex + rc.shadow_size, rc.vertex_size - rc.shadow_size);
+	}
+}
+
+} // namespace meshopt
+
+size_t meshopt_generateVertexRemap(unsigned int* destination, const unsigned int* indices, size_t index_count, const void* vertices, size_t vertex_count, size_t vertex_size)
+{
+	using namespace meshopt;
+
+	assert(indices || index_count == vertex_count);
+	assert(index_count % 3 == 0);
+	assert(vertex_size > 0 && vertex_size <= 256);
+
+	meshopt_Allocator allocator;
+
+	memset(destination, -1, vertex_count * sizeof(unsigned int));
+
+	return generateVertexRemap(allocator, destination, indices, index_count, static_cast<const unsigned char*>(vertices), vertex_count, vertex_size, vertex_size);
+}
+
 size_t meshopt_generateVertexRemapMulti(unsigned int* destination, const unsigned int* indices, size_t index_count, size_t vertex_count, const struct meshopt_Stream* streams, size_t stream_count)
 {
 	using namespace meshopt;
@@ -188,14 +495,122 @@ size_t meshopt_generateVertexRemapMulti(unsigned int* destination, const unsigne
 
 	memset(destination, -1, vertex_count * sizeof(unsigned int));
 
+	// single stream can use the fixed-size paths
+	if (stream_count == 1)
+		return generateVertexRemap(allocator, destination, indices, index_count, static_cast<const unsigned char*>(streams[0].data), vertex_count, streams[0].size, streams[0].stride);
+
 	VertexStreamHasher hasher = {streams, stream_count};
 
-	size_t table_size = hashBuckets(vertex_count);
-	unsigned int* table = allocator.allocate<unsigned int>(table_size);
-	memset(table, -1, table_size * sizeof(unsigned int));
+	return generateVertexRemap(allocator, destination, indices, index_count, vertex_count, hasher);
+}
+
+size_t meshopt_generateVertexRemapParallel(unsigned int* destination, const unsigned int* indices, size_t index_count, const void* vertices, size_t vertex_count, size_t vertex_size, meshopt_Scheduler scheduler, void* scheduler_context)
+{
+	using namespace meshopt;
+
+	assert(indices || index_count == vertex_count);
+	assert(index_count % 3 == 0);
+	assert(vertex_size > 0 && vertex_size <= 256);
+
+	meshopt_Allocator allocator;
+
+	memset(destination, -1, vertex_count * sizeof(unsigned int));
+
+	RemapContext context = {};
+	context.hasher.vertices = static_cast<const unsigned char*>(vertices);
+	context.hasher.vertex_size = vertex_size;
+	context.hasher.vertex_stride = vertex_size;
+	context.vertex_count = vertex_count;
+	context.destination = destination;
+
+	// hash all vertices up front; this is the bulk of the compute work and is trivially parallel
+	unsigned int* hashes = allocator.allocate<unsigned int>(vertex_count);
+	context.hashes = hashes;
+
+	size_t hash_tasks = (vertex_count + kRemapHashBlock - 1) / kRemapHashBlock;
+
+	if (scheduler)
+		scheduler(scheduler_context, computeRemapHashes, &context, hash_tasks);
+	else
+		for (size_t i = 0; i < hash_tasks; ++i)
+			computeRemapHashes(&context, i);
+
+	// collect referenced vertices in the order of first use; destination doubles as a visited marker
+	unsigned int* order = 0;
+	size_t order_count = vertex_count;
 
+	if (indices)
+	{
+		order = allocator.allocate<unsigned int>(vertex_count);
+		order_count = 0;
+
+		for (size_t i = 0; i < index_count; ++i)
+		{
+			unsigned int index = indices[i];
+			assert(index < vertex_count);
+
+			if (destination[index] == ~0u)
+			{
+				destination[index] = 0;
+				order[order_count++] = index;
+			}
+		}
+	}
+
+	remapShards(context, allocator, order, order_count, scheduler, scheduler_context);
+
+	// assign new indices in the order of first use; representatives always precede the vertices that refer to them
 	unsigned int next_vertex = 0;
 
+	for (size_t i = 0; i < order_count; ++i)
+	{
+		unsigned int index = order ? order[i] : unsigned(i);
+		unsigned int target = destination[index];
+
+		destination[index] = (target == index) ? next_vertex++ : destination[target];
+	}
+
+	assert(next_vertex <= vertex_count);
+
+	return next_vertex;
+}
+
+size_t meshopt_generateVertexRemapShadow(unsigned int* destination, unsigned int* shadow_destination, const unsigned int* indices, size_t index_count, const void* vertices, size_t vertex_count, size_t vertex_size, size_t shadow_size, meshopt_Scheduler scheduler, void* scheduler_context)
+{
+	using namespace meshopt;
+
+	assert(indices || index_count == vertex_count);
+	assert(index_count % 3 == 0);
+	assert(vertex_size > 0 && vertex_size <= 256);
+	assert(shadow_size > 0 && shadow_size <= vertex_size);
+
+	meshopt_Allocator allocator;
+
+	memset(destination, -1, vertex_count * sizeof(unsigned int));
+
+	const unsigned char* vertex_data = static_cast<const unsigned char*>(vertices);
+
+	// compute full and shadow hashes in one pass over the vertex data
+	RemapShadowContext hash_context = {};
+	hash_context.vertices = vertex_data;
+	hash_context.vertex_count = vertex_count;
+	hash_context.vertex_size = vertex_size;
+	hash_context.shadow_size = shadow_size;
+	hash_context.hashes = allocator.allocate<unsigned int>(vertex_count);
+	hash_context.shadow_hashes = allocator.allocate<unsigned int>(vertex_count);
+
+	size_t hash_tasks = (vertex_count + kRemapHashBlock - 1) / kRemapHashBlock;
+
+	if (scheduler)
+		scheduler(scheduler_context, computeRemapShadowHashes, &hash_context, hash_tasks);
+	else
+		for (size_t i = 0; i < hash_tasks; ++i)
+			computeRemapShadowHashes(&hash_context, i);
+
+	// collect referenced vertices in the order of first use; destination doubles as a visited marker
+	unsigned int* order = allocator.allocate<unsigned int>(vertex_count);
+	size_t order_count = 0;
+
 	for (size_t i = 0; i < index_count; ++i)
 	{
 		unsigned int index = indices ? indices[i] : unsigned(i);
@@ -203,21 +618,60 @@ size_t meshopt_generateVertexRemapMulti(unsigned int* destination, const unsigne
 
 		if (destination[index] == ~0u)
 		{
-			unsigned int* entry = hashLookup(table, table_size, hasher, index, ~0u);
+			destination[index] = 0;
+			order[order_count++] = index;
+		}
+	}
 
-			if (*entry == ~0u)
-			{
-				*entry = index;
+	// deduplicate full vertices; afterwards destination contains the representative vertex for every referenced vertex
+	RemapContext context = {};
+	context.hasher.vertices = vertex_data;
+	context.hasher.vertex_size = vertex_size;
+	context.hasher.vertex_stride = vertex_size;
+	context.vertex_count = vertex_count;
+	context.hashes = hash_context.hashes;
+	context.destination = destination;
 
-				destination[index] = next_vertex++;
-			}
-			else
-			{
-				assert(destination[*entry] != ~0u);
+	remapShards(context, allocator, order, order_count, scheduler, scheduler_context);
 
-				destination[index] = destination[*entry];
-			}
-		}
+	// vertices that are equal are also equal wrt the shadow prefix, so only representatives need to be deduplicated again;
+	// the first used vertex of each shadow class is always a representative, which matches meshopt_generateShadowIndexBuffer
+	unsigned int* representatives = allocator.allocate<unsigned int>(order_count);
+	size_t representative_count = 0;
+
+	for (size_t i = 0; i < order_count; ++i)
+		if (destination[order[i]] == order[i])
+			representatives[representative_count++] = order[i];
+
+	unsigned int* shadow_remap = allocator.allocate<unsigned int>(vertex_count);
+
+	RemapContext shadow_context = {};
+	shadow_context.hasher.vertices = vertex_data;
+	shadow_context.hasher.vertex_size = shadow_size;
+	shadow_context.hasher.vertex_stride = vertex_size;
+	shadow_context.vertex_count = vertex_count;
+	shadow_context.hashes = hash_context.shadow_hashes;
+	shadow_context.destination = shadow_remap;
+
+	remapShards(shadow_context, allocator, representatives, representative_count, scheduler, scheduler_context);
+
+	// shadow_destination may alias indices, so each index is read before it's overwritten
+	for (size_t i = 0; i < index_count; ++i)
+	{
+		unsigned int index = indices ? indices[i] : unsigned(i);
+
+		shadow_destination[i] = shadow_remap[destination[index]];
+	}
+
+	// assign new indices in the order of first use; representatives always precede the vertices that refer to them
+	unsigned int next_vertex = 0;
+
+	for (size_t i = 0; i < order_count; ++i)
+	{
+		unsigned int index = order[i];
+		unsigned int target = destination[index];
+
+		destination[index] = (target == index) ? next_vertex++ : destination[target];
 	}
 
 	assert(next_vertex <= vertex_count);
@@ -250,6 +704,56 @@ void meshopt_remapVertexBuffer(void* destination, const void* vertices, size_t v
 	}
 }
 
+void meshopt_remapVertexBufferMulti(void* const* destinations, size_t vertex_count, const struct meshopt_Stream* streams, size_t stream_count, const unsigned int* remap)
+{
+	assert(stream_count > 0 && stream_count <= 16);
+
+	size_t copy_size = 0;
+
+	for (size_t k = 0; k < stream_count; ++k)
+	{
+		assert(streams[k].size > 0 && streams[k].size <= 256);
+		assert(streams[k].size <= streams[k].stride);
+
+		if (destinations[k] == streams[k].data)
+			copy_size += vertex_count * streams[k].stride;
+	}
+
+	meshopt_Allocator allocator;
+
+	const unsigned char* sources[16];
+
+	// support in-place remap; all copies share one allocation to keep allocator usage independent of stream count
+	unsigned char* vertices_copy = copy_size ? allocator.allocate<unsigned char>(copy_size) : 0;
+
+	for (size_t k = 0; k < stream_count; ++k)
+	{
+		sources[k] = static_cast<const unsigned char*>(streams[k].data);
+
+		if (destinations[k] == streams[k].data)
+		{
+			memcpy(vertices_copy, sources[k], vertex_count * streams[k].stride);
+			sources[k] = vertices_copy;
+			vertices_copy += vertex_count * streams[k].stride;
+		}
+	}
+
+	for (size_t i = 0; i < vertex_count; ++i)
+	{
+		if (remap[i] != ~0u)
+		{
+			assert(remap[i] < vertex_count);
+
+			for (size_t k = 0; k < stream_count; ++k)
+			{
+				size_t size = streams[k].size;
+
+				memcpy(static_cast<unsigned char*>(destinations[k]) + remap[i] * size, sources[k] + i * streams[k].stride, size);
+			}
+		}
+	}
+}
+
 void meshopt_remapIndexBuffer(unsigned int* destination, const unsigned int* indices, size_t index_count, const unsigned int* remap)
 {
 	assert(index_count % 3 == 0);
@@ -274,32 +778,7 @@ void meshopt_generateShadowIndexBuffer(unsigned int* destination, const unsigned
 
 	meshopt_Allocator allocator;
 
-	unsigned int* remap = allocator.allocate<unsigned int>(vertex_count);
-	memset(remap, -1, vertex_count * sizeof(unsigned int));
-
-	VertexHasher hasher = {static_cast<const unsigned char*>(vertices), vertex_size, vertex_stride};
-
-	size_t table_size = hashBuckets(vertex_count);
-	unsigned int* table = allocator.allocate<unsigned int>(table_size);
-	memset(table, -1, table_size * sizeof(unsigned int));
-
-	for (size_t i = 0; i < index_count; ++i)
-	{
-		unsigned int index = indices[i];
-		assert(index < vertex_count);
-
-		if (remap[index] == ~0u)
-		{
-			unsigned int* entry = hashLookup(table, table_size, hasher, index, ~0u);
-
-			if (*entry == ~0u)
-				*entry = index;
-
-			remap[index] = *entry;
-		}
-
-		destination[i] = remap[index];
-	}
+	generateShadowIndexBuffer(allocator, destination, indices, index_count, static_cast<const unsigned char*>(vertices), vertex_count, vertex_size, vertex_stride);
 }
 
 void meshopt_generateShadowIndexBufferMulti(unsigned int* destination, const unsigned int* indices, size_t index_count, size_t vertex_count, const struct meshopt_Stream* streams, size_t stream_count)
@@ -318,30 +797,11 @@ void meshopt_generateShadowIndexBufferMulti(unsigned int* destination, const uns
 
 	meshopt_Allocator allocator;
 
-	unsigned int* remap = allocator.allocate<unsigned int>(vertex_count);
-	memset(remap, -1, vertex_count * sizeof(unsigned int));
+	// single stream can use the fixed-size paths
+	if (stream_count == 1)
+		return generateShadowIndexBuffer(allocator, destination, indices, index_count, static_cast<const unsigned char*>(streams[0].data), vertex_count, streams[0].size, streams[0].stride);
 
 	VertexStreamHasher hasher = {streams, stream_count};
 
-	size_t table_size = hashBuckets(vertex_count);
-	unsigned int* table = allocator.allocate<unsigned int>(table_size);
-	memset(table, -1, table_size * sizeof(unsigned int));
-
-	for (size_t i = 0; i < index_count; ++i)
-	{
-		unsigned int index = indices[i];
-		assert(index < vertex_count);
-
-		if (remap[index] == ~0u)
-		{
-			unsigned int* entry = hashLookup(table, table_size, hasher, index, ~0u);
-
-			if (*entry == ~0u)
-				*entry = index;
-
-			remap[index] = *entry;
-		}
-
-		destination[i] = remap[index];
-	}
+	generateShadowIndexBuffer(allocator, destination, indices, index_count, vertex_count, hasher);
 }
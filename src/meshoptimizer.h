@@ -52,7 +52,7 @@ MESHOPTIMIZER_API size_t meshopt_generateVertexRemap(unsigned int* destination,
  * Generates a vertex remap table from multiple vertex streams and an optional index buffer and returns number of unique vertices
  * As a result, all vertices that are binary equivalent map to the same (new) location, with no gaps in the resulting sequence.
  * Resulting remap table maps old vertices to new vertices and can be used in meshopt_remapVertexBuffer/meshopt_remapIndexBuffer.
- * To remap vertex buffers, you will need to call meshopt_remapVertexBuffer for each vertex stream.
+ * To remap vertex buffers, you will need to call meshopt_remapVertexBuffer for each vertex stream or use meshopt_remapVertexBufferMulti.
  *
  * destination must contain enough space for the resulting remap table (vertex_count elements)
  * indices can be NULL if the input is unindexed
@@ -67,6 +67,15 @@ MESHOPTIMIZER_API size_t meshopt_generateVertexRemapMulti(unsigned int* destinat
  */
 MESHOPTIMIZER_API void meshopt_remapVertexBuffer(void* destination, const void* vertices, size_t vertex_count, size_t vertex_size, const unsigned int* remap);
 
+/**
+ * Experimental: Generates vertex buffers for multiple vertex streams from the source streams and remap table generated by meshopt_generateVertexRemap*
+ * This is equivalent to calling meshopt_remapVertexBuffer for each stream, but reads the remap table once and supports strided source streams.
+ *
+ * destinations must contain stream_count pointers; each must have enough space for unique_vertex_count elements of streams[i].size bytes (tightly packed)
+ * vertex_count should be the initial vertex count and not the value returned by meshopt_generateVertexRemap*
+ */
+MESHOPTIMIZER_EXPERIMENTAL void meshopt_remapVertexBufferMulti(void* const* destinations, size_t vertex_count, const struct meshopt_Stream* streams, size_t stream_count, const unsigned int* remap);
+
 /**
  * Generate index buffer from the source index buffer and remap table generated by meshopt_generateVertexRemap
  *
@@ -138,13 +147,23 @@ MESHOPTIMIZER_API void meshopt_optimizeOverdraw(unsigned int* destination, const
  * Vertex fetch cache optimizer
  * Reorders vertices and changes indices to reduce the amount of GPU memory fetches during vertex processing
  * Returns the number of unique vertices, which is the same as input vertex count unless some vertices are unused
- * This functions works for a single vertex stream; for multiple vertex streams, use meshopt_optimizeVertexFetchRemap + meshopt_remapVertexBuffer for each stream.
+ * This functions works for a single vertex stream; for multiple vertex streams, use meshopt_optimizeVertexFetchMulti or meshopt_optimizeVertexFetchRemap + meshopt_remapVertexBuffer for each stream.
  *
  * destination must contain enough space for the resulting vertex buffer (vertex_count elements)
  * indices is used both as an input and as an output index buffer
  */
 MESHOPTIMIZER_API size_t meshopt_optimizeVertexFetch(void* destination, unsigned int* indices, size_t index_count, const void* vertices, size_t vertex_count, size_t vertex_size);
 
+/**
+ * Experimental: Vertex fetch cache optimizer for multiple vertex streams
+ * Reorders vertices of all streams and changes indices in a single pass over the index buffer, similarly to meshopt_optimizeVertexFetch
+ * Returns the number of unique vertices, which is the same as input vertex count unless some vertices are unused
+ *
+ * destinations must contain stream_count pointers; each must have enough space for vertex_count elements of streams[i].size bytes (tightly packed)
+ * indices is used both as an input and as an output index buffer
+ */
+MESHOPTIMIZER_EXPERIMENTAL size_t meshopt_optimizeVertexFetchMulti(void* const* destinations, unsigned int* indices, size_t index_count, size_t vertex_count, const struct meshopt_Stream* streams, size_t stream_count);
+
 /**
  * Vertex fetch cache optimizer
  * Generates vertex remap to reduce the amount of GPU memory fetches during vertex processing
@@ -169,7 +188,8 @@ MESHOPTIMIZER_API size_t meshopt_encodeIndexBufferBound(size_t index_count, size
 
 /**
  * Experimental: Set index encoder format version
- * version must specify the data format version to encode; valid values are 0 (decodable by all library versions) and 1 (decodable by 0.14+)
+ * version must specify the data format version to encode; valid values are 0 (decodable by all library versions), 1 (decodable by 0.14+) and 2 (decodable by 0.15+; index sequences are encoded using version 1)
+ * Version 2 restarts the encoding every 1024 triangles and stores a chunk table, which slightly reduces compression ratio but allows meshopt_decodeIndexBufferRange and meshopt_decodeIndexBufferParallel to decode chunks independently.
  */
 MESHOPTIMIZER_EXPERIMENTAL void meshopt_encodeIndexVersion(int version);
 
@@ -208,13 +228,34 @@ MESHOPTIMIZER_EXPERIMENTAL int meshopt_decodeIndexSequence(void* destination, si
  * Vertex buffer encoder
  * Encodes vertex data into an array of bytes that is generally smaller and compresses better compared to original.
  * Returns encoded data size on success, 0 on error; the only error condition is if buffer doesn't have enough space
- * This function works for a single vertex stream; for multiple vertex streams, call meshopt_encodeVertexBuffer for each stream.
+ * This function works for a single vertex stream; for multiple vertex streams, call meshopt_encodeVertexBuffer for each stream or use meshopt_encodeVertexBufferMulti.
  *
  * buffer must contain enough space for the encoded vertex buffer (use meshopt_encodeVertexBufferBound to compute worst case size)
  */
 MESHOPTIMIZER_API size_t meshopt_encodeVertexBuffer(unsigned char* buffer, size_t buffer_size, const void* vertices, size_t vertex_count, size_t vertex_size);
 MESHOPTIMIZER_API size_t meshopt_encodeVertexBufferBound(size_t vertex_count, size_t vertex_size);
 
+/**
+ * Experimental: Vertex buffer encoder with a speed/ratio tradeoff
+ * Encodes vertex data similarly to meshopt_encodeVertexBuffer; the output is decodable with meshopt_decodeVertexBuffer regardless of the level.
+ * level must be 0 (fast: bit widths are chosen to avoid escape bytes, which is slightly faster but results in a few percent larger output) or 1 (default: same as meshopt_encodeVertexBuffer, which selects the smallest encoding for every byte group)
+ *
+ * buffer must contain enough space for the encoded vertex buffer (use meshopt_encodeVertexBufferBound to compute worst case size)
+ */
+MESHOPTIMIZER_EXPERIMENTAL size_t meshopt_encodeVertexBufferLevel(unsigned char* buffer, size_t buffer_size, const void* vertices, size_t vertex_count, size_t vertex_size, int level);
+
+/**
+ * Experimental: Vertex buffer encoder for multiple vertex streams
+ * Encodes each stream as if by meshopt_encodeVertexBuffer and stores the results back to back; strided (interleaved) streams are read directly.
+ * Returns total encoded data size on success, 0 on error; the only error condition is if buffer doesn't have enough space
+ * Stream i can be decoded with meshopt_decodeVertexBuffer(..., vertex_count, streams[i].size, ...) from the offset that is the sum of stream_sizes[0..i)
+ *
+ * buffer must contain enough space for the encoded vertex buffers (use meshopt_encodeVertexBufferMultiBound to compute worst case size)
+ * stream_sizes must contain enough space for stream_count elements
+ */
+MESHOPTIMIZER_EXPERIMENTAL size_t meshopt_encodeVertexBufferMulti(unsigned char* buffer, size_t buffer_size, size_t* stream_sizes, size_t vertex_count, const struct meshopt_Stream* streams, size_t stream_count);
+MESHOPTIMIZER_EXPERIMENTAL size_t meshopt_encodeVertexBufferMultiBound(size_t vertex_count, const struct meshopt_Stream* streams, size_t stream_count);
+
 /**
  * Experimental: Set vertex encoder format version
  * version must specify the data format version to encode; valid values are 0 (decodable by all library versions)
@@ -231,6 +272,61 @@ MESHOPTIMIZER_EXPERIMENTAL void meshopt_encodeVertexVersion(int version);
  */
 MESHOPTIMIZER_API int meshopt_decodeVertexBuffer(void* destination, size_t vertex_count, size_t vertex_size, const unsigned char* buffer, size_t buffer_size);
 
+/**
+ * Experimental: Vertex buffer seek table generator
+ * Generates a table that makes it possible to decode arbitrary vertex ranges of the encoded vertex buffer independently, e.g. to decode a large buffer on multiple threads.
+ * For every internal block of vertices, the table records the offset of the block in the encoded buffer and the vertex that precedes the block in the source data.
+ * Returns table size on success, 0 on error; the error conditions are if table doesn't have enough space or if buffer doesn't contain a valid encoded stream.
+ *
+ * table must contain enough space for the resulting table (use meshopt_encodeVertexSeekTableBound to compute the size)
+ * buffer must contain the result of meshopt_encodeVertexBuffer for the same source vertex data
+ */
+MESHOPTIMIZER_EXPERIMENTAL size_t meshopt_encodeVertexSeekTable(unsigned char* table, size_t table_size, const unsigned char* buffer, size_t buffer_size, const void* vertices, size_t vertex_count, size_t vertex_size);
+MESHOPTIMIZER_EXPERIMENTAL size_t meshopt_encodeVertexSeekTableBound(size_t vertex_count, size_t vertex_size);
+
+/**
+ * Experimental: Vertex buffer range decoder
+ * Decodes vertices [range_offset..range_offset+range_count) from an array of bytes generated by meshopt_encodeVertexBuffer using the seek table generated by meshopt_encodeVertexSeekTable
+ * Multiple disjoint ranges of the same buffer can be decoded concurrently; the cost of decoding a range is proportional to the range size, rounded up to internal block size.
+ * Returns 0 if decoding was successful, and an error code otherwise
+ * The decoder is safe to use for untrusted input, but it may produce garbage data.
+ *
+ * destination must point to the entire vertex buffer (vertex_count * vertex_size bytes); only vertices in the requested range are written
+ */
+MESHOPTIMIZER_EXPERIMENTAL int meshopt_decodeVertexBufferRange(void* destination, size_t vertex_count, size_t vertex_size, size_t range_offset, size_t range_count, const unsigned char* buffer, size_t buffer_size, const unsigned char* table, size_t table_size);
+
+/**
+ * Experimental: Streaming vertex buffer decoder
+ * Decodes vertex data generated by meshopt_encodeVertexBuffer incrementally, as the encoded data arrives in chunks.
+ * The decoder state should be initialized with meshopt_decodeVertexStreamInit and can be placed on the stack or inside an object that owns the stream; no memory is allocated.
+ *
+ * The encoded stream stores the first vertex at the end, and all vertices are delta-encoded relative to it.
+ * If first_vertex is specified (e.g. from the first entry of the seek table or from the last vertex_size bytes of the stream), vertices [0..vertex_offset) are final after every call;
+ * if first_vertex is NULL, vertices are fixed up after the end of the stream is reached and are only final after decoding completes.
+ */
+struct meshopt_VertexDecoder
+{
+	size_t vertex_count;
+	size_t vertex_size;
+	size_t vertex_offset; /* number of vertices decoded so far */
+	int stage;
+	int delta; /* decoded vertices are relative to zero and need to be fixed up using the first vertex */
+	unsigned char last_vertex[256];
+};
+
+MESHOPTIMIZER_EXPERIMENTAL void meshopt_decodeVertexStreamInit(struct meshopt_VertexDecoder* decoder, size_t vertex_count, size_t vertex_size, const void* first_vertex);
+
+/**
+ * Decodes as many whole vertex blocks as possible from the next chunk of the encoded stream
+ * Returns 0 if decoding is complete, 1 if more data is needed, and an error code otherwise
+ * The number of bytes consumed is written to buffer_consumed; the remaining bytes must be passed again, followed by more data, in the next call.
+ * To make progress the decoder needs one whole block in the chunk, which is at most 10 KB for any vertex size.
+ * The decoder is safe to use for untrusted input, but it may produce garbage data.
+ *
+ * destination must point to the entire vertex buffer (vertex_count * vertex_size bytes) and must be the same for all calls
+ */
+MESHOPTIMIZER_EXPERIMENTAL int meshopt_decodeVertexStream(struct meshopt_VertexDecoder* decoder, void* destination, const unsigned char* buffer, size_t buffer_size, size_t* buffer_consumed);
+
 /**
  * Vertex buffer filters
  * These functions can be used to filter output of meshopt_decodeVertexBuffer in-place.
@@ -249,6 +345,46 @@ MESHOPTIMIZER_EXPERIMENTAL void meshopt_decodeFilterOct(void* buffer, size_t ver
 MESHOPTIMIZER_EXPERIMENTAL void meshopt_decodeFilterQuat(void* buffer, size_t vertex_count, size_t vertex_size);
 MESHOPTIMIZER_EXPERIMENTAL void meshopt_decodeFilterExp(void* buffer, size_t vertex_count, size_t vertex_size);
 
+/**
+ * Experimental: Vertex buffer decoder with filtering
+ * Decodes vertex data similarly to meshopt_decodeVertexBuffer and applies the filter to each decoded block while it's still in cache; this is faster than filtering the entire buffer after decoding.
+ * filter can be one of meshopt_decodeFilterOct/Quat/Exp, or any function with the same signature that modifies the data in-place; filter can be NULL.
+ * Returns 0 if decoding was successful, and an error code otherwise
+ *
+ * destination must contain enough space for the resulting vertex buffer (vertex_count * vertex_size bytes)
+ * vertex_count must be aligned by 4 when using meshopt_decodeFilter* functions
+ */
+MESHOPTIMIZER_EXPERIMENTAL int meshopt_decodeVertexBufferFiltered(void* destination, size_t vertex_count, size_t vertex_size, const unsigned char* buffer, size_t buffer_size, void (*filter)(void* buffer, size_t vertex_count, size_t vertex_size));
+
+/**
+ * Experimental: Vertex buffer filter encoders
+ * These functions can be used to encode data in a format that meshopt_decodeFilter can decode; unlike decoders, vertex_count doesn't need to be aligned by 4.
+ *
+ * meshopt_encodeFilterOct encodes unit vectors with K-bit (K <= 16) signed X/Y as an output; Z stores 1.0f at the same bit count.
+ * Each component is stored as an 8-bit or 16-bit normalized integer; stride must be equal to 4 or 8. W is quantized as a normalized integer of the full component width.
+ * Input data must contain 4 floats for every vector (count*4 total).
+ *
+ * meshopt_encodeFilterQuat encodes unit quaternions with K-bit (4 <= K <= 16) component encoding.
+ * Each component is stored as an 16-bit integer; stride must be equal to 8.
+ * Input data must contain 4 floats for every quaternion (count*4 total).
+ */
+MESHOPTIMIZER_EXPERIMENTAL void meshopt_encodeFilterOct(void* destination, size_t vertex_count, size_t vertex_size, int bits, const float* data);
+MESHOPTIMIZER_EXPERIMENTAL void meshopt_encodeFilterQuat(void* destination, size_t vertex_count, size_t vertex_size, int bits, const float* data);
+
+/**
+ * Experimental: Batched quantization
+ * Quantizes the first `components` floats of each input vertex (data_stride bytes apart) and stores them at the start of each output vertex (vertex_size bytes apart); other output bytes are left untouched.
+ * Results match meshopt_quantizeUnorm/meshopt_quantizeSnorm/meshopt_quantizeHalf for finite inputs; these functions are faster than calling them for every component.
+ *
+ * meshopt_quantizeUnormBuffer and meshopt_quantizeSnormBuffer store each component as an N-bit normalized integer in a component_size-byte value; component_size must be 1 or 2.
+ * meshopt_quantizeHalfBuffer stores each component as a 16-bit half-precision floating point value.
+ *
+ * components must be in [1..4] range
+ */
+MESHOPTIMIZER_EXPERIMENTAL void meshopt_quantizeUnormBuffer(void* destination, size_t vertex_count, size_t vertex_size, size_t component_size, const float* data, size_t data_stride, size_t components, int N);
+MESHOPTIMIZER_EXPERIMENTAL void meshopt_quantizeSnormBuffer(void* destination, size_t vertex_count, size_t vertex_size, size_t component_size, const float* data, size_t data_stride, size_t components, int N);
+MESHOPTIMIZER_EXPERIMENTAL void meshopt_quantizeHalfBuffer(void* destination, size_t vertex_count, size_t vertex_size, const float* data, size_t data_stride, size_t components);
+
 /**
  * Experimental: Mesh simplifier
  * Reduces the number of triangles in the mesh, attempting to preserve mesh appearance as much as possible
@@ -263,18 +399,68 @@ MESHOPTIMIZER_EXPERIMENTAL void meshopt_decodeFilterExp(void* buffer, size_t ver
  */
 MESHOPTIMIZER_EXPERIMENTAL size_t meshopt_simplify(unsigned int* destination, const unsigned int* indices, size_t index_count, const float* vertex_positions, size_t vertex_count, size_t vertex_positions_stride, size_t target_index_count, float target_error);
 
+/**
+ * Experimental: Mesh simplifier with attribute metric
+ * The algorithm enhances meshopt_simplify by incorporating attribute values into the error metric used to prioritize simplification order; see meshopt_simplify for details.
+ * Each attribute is interpolated linearly across every triangle, and the error measures the deviation of the attribute from that after the collapse; this preserves UV seams and shading better at the same triangle count.
+ * Note that the number of attributes affects memory requirements and running time; this algorithm requires ~(attribute_count * 20 + 44) extra bytes per vertex.
+ *
+ * vertex_attributes should have attribute_count floats for each vertex
+ * attribute_weights should have attribute_count floats in total; the weights determine relative priority of attributes between each other and wrt position. The recommended weight range is [1e-3..1e-1], assuming normalized attribute data.
+ * attribute_count must be <= 16
+ */
+MESHOPTIMIZER_EXPERIMENTAL size_t meshopt_simplifyWithAttributes(unsigned int* destination, const unsigned int* indices, size_t index_count, const float* vertex_positions, size_t vertex_count, size_t vertex_positions_stride, const float* vertex_attributes, size_t vertex_attributes_stride, const float* attribute_weights, size_t attribute_count, size_t target_index_count, float target_error);
+
+/**
+ * Experimental: Incremental mesh simplifier
+ * Keeps the simplifier state (adjacency-derived vertex classification and error quadrics) between calls, which makes it possible to generate a chain of LODs
+ * without repeating the setup for every level: each meshopt_simplifyNext call continues from the result of the previous call.
+ * The error is measured relative to the original mesh, similarly to meshopt_simplify; the simplifier allocates memory once using meshopt_setAllocator callbacks (never the meshopt_setAllocatorContext callbacks) and must be destroyed using meshopt_destroySimplifier, which releases it through the same callbacks.
+ * meshopt_simplifyNext returns the number of indices after simplification, with destination containing new index data; the result can't have more indices than the result of the previous call.
+ *
+ * destination must contain enough space for the current index buffer (the result of the previous call or index_count elements for the first call)
+ * vertex_positions should have float3 position in the first 12 bytes of each vertex - similar to glVertexPointer
+ */
+struct meshopt_Simplifier;
+
+MESHOPTIMIZER_EXPERIMENTAL struct meshopt_Simplifier* meshopt_createSimplifier(const unsigned int* indices, size_t index_count, const float* vertex_positions, size_t vertex_count, size_t vertex_positions_stride);
+MESHOPTIMIZER_EXPERIMENTAL size_t meshopt_simplifyNext(struct meshopt_Simplifier* simplifier, unsigned int* destination, size_t target_index_count, float target_error);
+MESHOPTIMIZER_EXPERIMENTAL void meshopt_destroySimplifier(struct meshopt_Simplifier* simplifier);
+
+/**
+ * Experimental: Task scheduler callback
+ * meshoptimizer never creates threads; functions that can split the work into independent tasks accept a scheduler instead.
+ * The scheduler must call task(task_data, i) for every i in [0..task_count) and return after all calls complete; the calls can run in any order and on any number of threads.
+ */
+typedef void (*meshopt_Scheduler)(void* context, void (*task)(void* task_data, size_t task_index), void* task_data, size_t task_count);
+
+/**
+ * Experimental: Partitioned mesh simplifier
+ * Reduces the number of triangles in the mesh similarly to meshopt_simplify, but splits the mesh into partition_count spatially coherent partitions first.
+ * Each partition is simplified independently with vertices shared between partitions locked, which allows partitions to be processed in parallel using the scheduler;
+ * after that, a final serial pass simplifies triangles that touch partition borders until the target is reached, keeping the remaining triangles intact.
+ * This is much faster for very large meshes on multiple threads, at the cost of slightly lower quality. scheduler can be NULL, in which case partitions are processed serially.
+ *
+ * destination must contain enough space for the *source* index buffer (index_count elements)
+ * vertex_positions should have float3 position in the first 12 bytes of each vertex - similar to glVertexPointer
+ */
+MESHOPTIMIZER_EXPERIMENTAL size_t meshopt_simplifyPartitioned(unsigned int* destination, const unsigned int* indices, size_t index_count, const float* vertex_positions, size_t vertex_count, size_t vertex_positions_stride, size_t target_index_count, float target_error, size_t partition_count, meshopt_Scheduler scheduler, void* scheduler_context);
+
 /**
  * Experimental: Mesh simplifier (sloppy)
  * Reduces the number of triangles in the mesh, sacrificing mesh apperance for simplification performance
- * The algorithm doesn't preserve mesh topology but is always able to reach target triangle count.
+ * The algorithm doesn't preserve mesh topology but can stop short of the target goal based on target error; it's always able to reach target triangle count otherwise.
+ * target_error is the maximum distance between a source vertex and the vertex that replaces it, relative to mesh extents (e.g. 1e-2 is 1% of the largest dimension); the resolution of the clustering grid limits it to ~2e-3.
+ * Pass FLT_MAX as target_error to always reach target_index_count, or 0 as target_index_count to simplify until target_error is reached.
  * Returns the number of indices after simplification, with destination containing new index data
  * The resulting index buffer references vertices from the original vertex buffer.
  * If the original vertex data isn't required, creating a compact vertex buffer using meshopt_optimizeVertexFetch is recommended.
  *
- * destination must contain enough space for the target index buffer
+ * destination must contain enough space for the target index buffer when target_error is FLT_MAX; otherwise the result can exceed the target when it's limited by target_error (worst case is index_count elements)
  * vertex_positions should have float3 position in the first 12 bytes of each vertex - similar to glVertexPointer
+ * result_error can be NULL; when it's not NULL, it will contain the achieved error using the same units as target_error
  */
-MESHOPTIMIZER_EXPERIMENTAL size_t meshopt_simplifySloppy(unsigned int* destination, const unsigned int* indices, size_t index_count, const float* vertex_positions, size_t vertex_count, size_t vertex_positions_stride, size_t target_index_count);
+MESHOPTIMIZER_EXPERIMENTAL size_t meshopt_simplifySloppy(unsigned int* destination, const unsigned int* indices, size_t index_count, const float* vertex_positions, size_t vertex_count, size_t vertex_positions_stride, size_t target_index_count, float target_error, float* result_error);
 
 /**
  * Experimental: Point cloud simplifier
@@ -288,6 +474,29 @@ MESHOPTIMIZER_EXPERIMENTAL size_t meshopt_simplifySloppy(unsigned int* destinati
  */
 MESHOPTIMIZER_EXPERIMENTAL size_t meshopt_simplifyPoints(unsigned int* destination, const float* vertex_positions, size_t vertex_count, size_t vertex_positions_stride, size_t target_vertex_count);
 
+/**
+ * Experimental: Streaming mesh and point cloud simplifier (sloppy)
+ * Simplifies meshes and point clouds that don't fit in memory using vertex clustering on a fixed grid, similarly to meshopt_simplifySloppy/meshopt_simplifyPoints.
+ * The grid covers the box [box_min..box_max] with grid_size cells (1..1024) along the largest box dimension; data can be added in batches of triangles or points,
+ * and the cell quadrics are accumulated incrementally so memory usage is proportional to max_cells and max_triangles; input batches don't need to stay alive.
+ * Each cell produces one output vertex at the position that minimizes the quadric error of triangles in the cell (or the mean position for point clouds), clamped to the cell.
+ * Adding data returns 0 on success or -1 if the number of cells or output triangles exceeds the capacity; after that the stream is in an error state and produces no results.
+ * meshopt_sloppyStreamGetVertices writes float3 positions for each output vertex and returns their count; meshopt_sloppyStreamGetIndices writes the index buffer.
+ * destination can be NULL to query the count. The stream allocates memory once using meshopt_setAllocator callbacks (never the meshopt_setAllocatorContext callbacks) and must be destroyed using meshopt_destroySloppyStream, which releases it through the same callbacks.
+ *
+ * box_min/box_max must contain 3 floats each; vertices outside of the box are clamped to it
+ * vertex_positions should have float3 position in the first 12 bytes of each vertex - similar to glVertexPointer
+ * indices in each triangle batch refer to the vertices of the same batch
+ */
+struct meshopt_SloppyStream;
+
+MESHOPTIMIZER_EXPERIMENTAL struct meshopt_SloppyStream* meshopt_createSloppyStream(const float* box_min, const float* box_max, size_t grid_size, size_t max_cells, size_t max_triangles);
+MESHOPTIMIZER_EXPERIMENTAL int meshopt_sloppyStreamAddTriangles(struct meshopt_SloppyStream* stream, const unsigned int* indices, size_t index_count, const float* vertex_positions, size_t vertex_count, size_t vertex_positions_stride);
+MESHOPTIMIZER_EXPERIMENTAL int meshopt_sloppyStreamAddPoints(struct meshopt_SloppyStream* stream, const float* vertex_positions, size_t vertex_count, size_t vertex_positions_stride);
+MESHOPTIMIZER_EXPERIMENTAL size_t meshopt_sloppyStreamGetVertices(const struct meshopt_SloppyStream* stream, float* destination);
+MESHOPTIMIZER_EXPERIMENTAL size_t meshopt_sloppyStreamGetIndices(const struct meshopt_SloppyStream* stream, unsigned int* destination);
+MESHOPTIMIZER_EXPERIMENTAL void meshopt_destroySloppyStream(struct meshopt_SloppyStream* stream);
+
 /**
  * Mesh stripifier
  * Converts a previously vertex cache optimized triangle list to triangle strip, stitching strips using restart index or degenerate triangles
@@ -375,6 +584,42 @@ struct meshopt_Meshlet
 MESHOPTIMIZER_EXPERIMENTAL size_t meshopt_buildMeshlets(struct meshopt_Meshlet* destination, const unsigned int* indices, size_t index_count, size_t vertex_count, size_t max_vertices, size_t max_triangles);
 MESHOPTIMIZER_EXPERIMENTAL size_t meshopt_buildMeshletsBound(size_t index_count, size_t max_vertices, size_t max_triangles);
 
+/**
+ * Experimental: Spatially coherent meshlet builder
+ * Splits the mesh into a set of meshlets like meshopt_buildMeshlets, but grows each meshlet through triangle adjacency and picks triangles based on proximity and orientation
+ * This produces meshlets with tighter bounds and better cone culling efficiency, and doesn't require the index buffer to be optimized for vertex cache first.
+ *
+ * destination must contain enough space for all meshlets, worst case size can be computed with meshopt_buildMeshletsBound
+ * max_vertices and max_triangles can't exceed limits statically declared in meshopt_Meshlet (max_vertices <= 64, max_triangles <= 126)
+ * cone_weight should be set to 0 when cone culling is not used, and a value between 0 and 1 otherwise to balance between cluster size and cone culling efficiency
+ */
+MESHOPTIMIZER_EXPERIMENTAL size_t meshopt_buildMeshletsSpatial(struct meshopt_Meshlet* destination, const unsigned int* indices, size_t index_count, const float* vertex_positions, size_t vertex_count, size_t vertex_positions_stride, size_t max_vertices, size_t max_triangles, float cone_weight);
+
+struct meshopt_PackedMeshlet
+{
+	/* offsets within meshlet_vertices and meshlet_triangles arrays with meshlet data */
+	unsigned int vertex_offset;
+	unsigned int triangle_offset;
+
+	/* number of vertices and triangles used in the meshlet; data is stored in consecutive range defined by offset and count */
+	unsigned int vertex_count;
+	unsigned int triangle_count;
+};
+
+/**
+ * Experimental: Spatially coherent meshlet builder with compact output
+ * Splits the mesh into a set of meshlets using the same algorithm as meshopt_buildMeshletsSpatial, but stores meshlet data in shared flat arrays instead of fixed-size structures.
+ * Each meshlet references meshlet_vertices (indices into the original vertex buffer) and meshlet_triangles (3 bytes per triangle, indexing into meshlet vertices) via offsets and counts.
+ * Triangle data of each meshlet starts at a 4-byte aligned offset; the arrays can be uploaded to the GPU as is.
+ *
+ * meshlets must contain enough space for all meshlets, worst case size can be computed with meshopt_buildMeshletsBound
+ * meshlet_vertices must contain enough space for all meshlets, worst case size is equal to max_meshlets * max_vertices
+ * meshlet_triangles must contain enough space for all meshlets, worst case size is equal to max_meshlets * ((max_triangles * 3 + 3) & ~3)
+ * max_vertices must not exceed 255, max_triangles must not exceed 512
+ * after the call, the used portion of the arrays ends at vertex_offset + vertex_count and triangle_offset + ((triangle_count * 3 + 3) & ~3) of the last meshlet
+ */
+MESHOPTIMIZER_EXPERIMENTAL size_t meshopt_buildMeshletsPacked(struct meshopt_PackedMeshlet* meshlets, unsigned int* meshlet_vertices, unsigned char* meshlet_triangles, const unsigned int* indices, size_t index_count, const float* vertex_positions, size_t vertex_count, size_t vertex_positions_stride, size_t max_vertices, size_t max_triangles, float cone_weight);
+
 struct meshopt_Bounds
 {
 	/* bounding sphere, useful for frustum and occlusion culling */
@@ -410,11 +655,116 @@ struct meshopt_Bounds
  * to do frustum/occlusion culling, the formula that doesn't use the apex may be preferable.
  *
  * vertex_positions should have float3 position in the first 12 bytes of each vertex - similar to glVertexPointer
- * index_count should be less than or equal to 256*3 (the function assumes clusters of limited size)
+ * clusters with up to 256 triangles are processed without heap allocations; larger clusters are supported but need temporary memory
  */
 MESHOPTIMIZER_EXPERIMENTAL struct meshopt_Bounds meshopt_computeClusterBounds(const unsigned int* indices, size_t index_count, const float* vertex_positions, size_t vertex_count, size_t vertex_positions_stride);
 MESHOPTIMIZER_EXPERIMENTAL struct meshopt_Bounds meshopt_computeMeshletBounds(const struct meshopt_Meshlet* meshlet, const float* vertex_positions, size_t vertex_count, size_t vertex_positions_stride);
 
+/**
+ * Experimental: Batched meshlet bounds generator
+ * Computes bounds for all meshlets produced by meshopt_buildMeshletsPacked in one call; the results are the same as calling meshopt_computeClusterBounds for every meshlet.
+ * Meshlets are split into independent batches that can be processed in parallel using the scheduler; scheduler can be NULL, in which case batches are processed serially.
+ *
+ * destination must contain enough space for meshlet_count bounds
+ * vertex_positions should have float3 position in the first 12 bytes of each vertex - similar to glVertexPointer
+ */
+MESHOPTIMIZER_EXPERIMENTAL void meshopt_computeMeshletBoundsPacked(struct meshopt_Bounds* destination, const struct meshopt_PackedMeshlet* meshlets, size_t meshlet_count, const unsigned int* meshlet_vertices, const unsigned char* meshlet_triangles, const float* vertex_positions, size_t vertex_count, size_t vertex_positions_stride, meshopt_Scheduler scheduler, void* scheduler_context);
+
+struct meshopt_EncodedMeshlet
+{
+	/* meshlet origin in quantization grid units; decoded position is (offset + local) * scale */
+	int offset[3];
+	float scale;
+
+	/* offset of meshlet data within the data array, in 32-bit words */
+	unsigned int data_offset;
+
+	/* number of vertices and triangles in the meshlet */
+	unsigned int vertex_count;
+	unsigned int triangle_count;
+
+	/* number of bits used for each local position component; bits[3] is reserved and is always 0 */
+	unsigned char bits[4];
+};
+
+/**
+ * Experimental: Meshlet vertex data encoder
+ * Encodes positions and triangles of meshlets produced by meshopt_buildMeshletsPacked into a compact format that can be decoded independently per meshlet, for example in a mesh shader.
+ * Positions are quantized to a grid with grid_step spacing that is shared by all meshlets, so vertices shared between meshlets decode to identical positions; the maximum error is grid_step/2 per component.
+ * Returns the number of 32-bit words written to data, or 0 if data doesn't have enough space or grid_step is too small for the positions
+ *
+ * Data of each meshlet starts at data_offset and stores vertex_count local positions as a bit stream with bits[0]+bits[1]+bits[2] bits per vertex,
+ * where value at bit offset b occupies bits starting from (b & 31) in word b >> 5 and may continue into the next word; it is followed by 8-bit local indices,
+ * starting at the next whole word and packed 4 per word from the least significant byte.
+ * Vertex attributes other than position can be fetched using meshlet_vertices which is unchanged by this function.
+ *
+ * destination must contain enough space for meshlet_count encoded meshlets
+ * data should have enough space for the encoded data, worst case size (in 32-bit words) can be computed with meshopt_encodeMeshletsBound
+ * grid_step must be large enough for every quantized position component (position / grid_step) to be at most 2^24 in magnitude, since decoders compute positions in floating point,
+ * and for every meshlet to span less than 2^24 grid steps per component; positions must be finite
+ */
+MESHOPTIMIZER_EXPERIMENTAL size_t meshopt_encodeMeshlets(struct meshopt_EncodedMeshlet* destination, unsigned int* data, size_t data_size, const struct meshopt_PackedMeshlet* meshlets, size_t meshlet_count, const unsigned int* meshlet_vertices, const unsigned char* meshlet_triangles, const float* vertex_positions, size_t vertex_count, size_t vertex_positions_stride, float grid_step);
+MESHOPTIMIZER_EXPERIMENTAL size_t meshopt_encodeMeshletsBound(size_t meshlet_count, size_t max_vertices, size_t max_triangles);
+
+/**
+ * Experimental: Meshlet vertex data decoder
+ * Decodes positions and triangles of a single meshlet encoded by meshopt_encodeMeshlets; this is a reference implementation of the decoding process for GPU decoders.
+ *
+ * vertex_positions must contain enough space for vertex_count float3 positions
+ * triangles must contain enough space for triangle_count * 3 local indices
+ */
+MESHOPTIMIZER_EXPERIMENTAL void meshopt_decodeMeshlet(float* vertex_positions, unsigned char* triangles, const struct meshopt_EncodedMeshlet* meshlet, const unsigned int* data);
+
+struct meshopt_LodCluster
+{
+	/* offsets within cluster_vertices and cluster_triangles arrays and counts, same as meshopt_PackedMeshlet */
+	unsigned int vertex_offset;
+	unsigned int triangle_offset;
+	unsigned int vertex_count;
+	unsigned int triangle_count;
+
+	/* depth in the hierarchy; 0 for clusters of the original mesh */
+	unsigned int level;
+
+	/* clusters that were merged and simplified to produce this cluster are cluster_children[child_offset..child_offset+child_count) */
+	unsigned int child_offset;
+	unsigned int child_count;
+
+	/* clusters that replace this cluster at a coarser level are clusters[parent_offset..parent_offset+parent_count); parent_count is 0 for root clusters */
+	unsigned int parent_offset;
+	unsigned int parent_count;
+
+	/* bounding sphere and simplification error (in position units) of this cluster; shared by all clusters produced from the same group */
+	float center[3];
+	float radius;
+	float error;
+
+	/* bounding sphere and simplification error of the parent clusters; parent_error is FLT_MAX for root clusters */
+	float parent_center[3];
+	float parent_radius;
+	float parent_error;
+};
+
+/**
+ * Experimental: Hierarchical cluster level of detail builder
+ * Splits the mesh into clusters like meshopt_buildMeshletsPacked, and then repeatedly merges groups of up to group_size adjacent clusters, simplifies each group
+ * to half of its triangles with vertices on the group border locked, and splits the result into new clusters, until no group can be simplified further.
+ * The result is a DAG of clusters: every cluster links to the clusters it was produced from (children) and to the clusters that replace it (parents).
+ * Returns the total number of clusters across all levels; clusters of each level are stored after the clusters of the previous level.
+ *
+ * To select the level of detail per cluster at runtime, project error to screen space using the respective bounding sphere, and render the cluster if
+ *   projected(center, radius, error) <= threshold && projected(parent_center, parent_radius, parent_error) > threshold
+ * Errors and spheres are monotonic (parents are never more precise or smaller than children), so the selected clusters form a watertight cut of the hierarchy.
+ *
+ * clusters must contain enough space for all clusters, worst case size can be computed with meshopt_buildClusterLodBound
+ * cluster_vertices must contain enough space for all clusters, worst case size is equal to max_clusters * max_vertices
+ * cluster_triangles must contain enough space for all clusters, worst case size is equal to max_clusters * ((max_triangles * 3 + 3) & ~3)
+ * cluster_children must contain enough space for max_clusters elements
+ * max_vertices must not exceed 255, max_triangles must not exceed 512, group_size must be at least 2
+ */
+MESHOPTIMIZER_EXPERIMENTAL size_t meshopt_buildClusterLod(struct meshopt_LodCluster* clusters, unsigned int* cluster_vertices, unsigned char* cluster_triangles, unsigned int* cluster_children, const unsigned int* indices, size_t index_count, const float* vertex_positions, size_t vertex_count, size_t vertex_positions_stride, size_t max_vertices, size_t max_triangles, size_t group_size);
+MESHOPTIMIZER_EXPERIMENTAL size_t meshopt_buildClusterLodBound(size_t index_count, size_t max_vertices, size_t max_triangles, size_t group_size);
+
 /**
  * Experimental: Spatial sorter
  * Generates a remap table that can be used to reorder points for spatial locality.
@@ -433,14 +783,228 @@ MESHOPTIMIZER_EXPERIMENTAL void meshopt_spatialSortRemap(unsigned int* destinati
  */
 MESHOPTIMIZER_EXPERIMENTAL void meshopt_spatialSortTriangles(unsigned int* destination, const unsigned int* indices, size_t index_count, const float* vertex_positions, size_t vertex_count, size_t vertex_positions_stride);
 
+/**
+ * Experimental: Parallel vertex remap generator
+ * Generates the same remap table as meshopt_generateVertexRemap, but splits the work into tasks that can run in parallel using the scheduler.
+ * Vertices are hashed in blocks and then partitioned by hash into shards that are deduplicated independently; this is faster for very large meshes on multiple threads.
+ * scheduler can be NULL, in which case tasks are processed serially.
+ *
+ * destination must contain enough space for the resulting remap table (vertex_count elements)
+ * indices can be NULL if the input is unindexed
+ */
+MESHOPTIMIZER_EXPERIMENTAL size_t meshopt_generateVertexRemapParallel(unsigned int* destination, const unsigned int* indices, size_t index_count, const void* vertices, size_t vertex_count, size_t vertex_size, meshopt_Scheduler scheduler, void* scheduler_context);
+
+/**
+ * Experimental: Combined vertex remap and shadow index buffer generator
+ * Generates the same remap table as meshopt_generateVertexRemap and the same index buffer as meshopt_generateShadowIndexBuffer (with vertex_stride = vertex_size) in one hashing pass.
+ * The shadow index buffer only considers the first shadow_size bytes of each vertex, e.g. the position for depth pre-pass rendering; the hash of that prefix is reused for the full vertex hash.
+ * Work is split into tasks similarly to meshopt_generateVertexRemapParallel; scheduler can be NULL, in which case tasks are processed serially.
+ * Returns the number of unique vertices, same as meshopt_generateVertexRemap.
+ *
+ * destination must contain enough space for the resulting remap table (vertex_count elements)
+ * shadow_destination must contain enough space for the resulting index buffer (index_count elements); it can alias indices
+ * indices can be NULL if the input is unindexed
+ */
+MESHOPTIMIZER_EXPERIMENTAL size_t meshopt_generateVertexRemapShadow(unsigned int* destination, unsigned int* shadow_destination, const unsigned int* indices, size_t index_count, const void* vertices, size_t vertex_count, size_t vertex_size, size_t shadow_size, meshopt_Scheduler scheduler, void* scheduler_context);
+
+/**
+ * Experimental: Parallel stripifier
+ * Converts a triangle list to triangle strip similarly to meshopt_stripify, but uses edge adjacency built for every chunk to find the next triangle, which scales linearly with the triangle count.
+ * Strips are not limited to a window of the input order, so they are usually longer than the ones produced by meshopt_stripify, at the cost of somewhat worse vertex cache efficiency.
+ * The index buffer is split into chunks of chunk_size triangles that are stripified independently and can be processed in parallel using the scheduler; scheduler can be NULL, in which case tasks are processed serially.
+ * Strips never cross chunk boundaries, and chunks are stitched using restart index or degenerate triangles; for best results, sort triangles spatially first, e.g. using meshopt_spatialSortTriangles, and optimize each chunk for vertex cache.
+ * Returns the number of indices in the resulting strip, with destination containing new index data
+ *
+ * destination must contain enough space for the target index buffer, worst case can be computed with meshopt_stripifyParallelBound
+ * restart_index should be 0xffff or 0xffffffff depending on index size, or 0 to use degenerate triangles
+ */
+MESHOPTIMIZER_EXPERIMENTAL size_t meshopt_stripifyParallel(unsigned int* destination, const unsigned int* indices, size_t index_count, size_t vertex_count, unsigned int restart_index, size_t chunk_size, meshopt_Scheduler scheduler, void* scheduler_context);
+MESHOPTIMIZER_EXPERIMENTAL size_t meshopt_stripifyParallelBound(size_t index_count, size_t chunk_size);
+
+/**
+ * Experimental: Parallel spatial sorter
+ * Generates a remap table that can be used to reorder points for spatial locality, similarly to meshopt_spatialSortRemap, but uses 63-bit Morton codes (21 bits per axis) for finer ordering on large extents.
+ * Keys are computed and sorted in blocks that can be processed in parallel using the scheduler; scheduler can be NULL, in which case tasks are processed serially.
+ * Optionally splits the sorted order into chunks of at most max_chunk_size points that correspond to runs of octree cells, which can be used as spatial pages;
+ * returns the number of chunks, with chunk_offsets[i]..chunk_offsets[i+1] containing the range of new indices for chunk i, or 0 if chunk_offsets is NULL.
+ *
+ * destination must contain enough space for the resulting remap table (vertex_count elements)
+ * chunk_offsets must contain enough space for meshopt_spatialSortChunkBound(vertex_count, max_chunk_size) + 1 elements, or be NULL
+ */
+MESHOPTIMIZER_EXPERIMENTAL size_t meshopt_spatialSortRemapParallel(unsigned int* destination, unsigned int* chunk_offsets, size_t max_chunk_size, const float* vertex_positions, size_t vertex_count, size_t vertex_positions_stride, meshopt_Scheduler scheduler, void* scheduler_context);
+MESHOPTIMIZER_EXPERIMENTAL size_t meshopt_spatialSortChunkBound(size_t vertex_count, size_t max_chunk_size);
+
+/**
+ * Experimental: Partitioned vertex transform cache optimizer
+ * Splits the index buffer into partition_count contiguous ranges with similar triangle counts and reorders triangles within each range similarly to meshopt_optimizeVertexCache.
+ * Partitions are optimized independently, which allows them to be processed in parallel using the scheduler; scheduler can be NULL, in which case partitions are processed serially.
+ * For best results the input should be spatially coherent, e.g. the output of meshopt_spatialSortTriangles; each partition then covers a compact region of the mesh and the efficiency loss at partition boundaries is small.
+ *
+ * destination must contain enough space for the resulting index buffer (index_count elements)
+ */
+MESHOPTIMIZER_EXPERIMENTAL void meshopt_optimizeVertexCachePartitioned(unsigned int* destination, const unsigned int* indices, size_t index_count, size_t vertex_count, size_t partition_count, meshopt_Scheduler scheduler, void* scheduler_context);
+
+/**
+ * Experimental: Vertex transform cache profiles
+ * Profiles approximate post-transform vertex reuse of different GPU families and select both the analyzer model and the optimizer scoring table.
+ * Analyzer parameters for each profile (cache_size, warp_size, primgroup_size) are:
+ * - Generic: 16, 0, 0 (FIFO cache)
+ * - Nvidia: 32, 32, 32
+ * - Amd: 14, 64, 128
+ * - Intel: 128, 0, 0
+ * - Apple: 32, 32, 0
+ * - Mobile: 16, 16, 0 (Mali and Adreno)
+ * The models are approximate; results may not match actual GPU performance.
+ */
+enum meshopt_VertexCacheProfile
+{
+	meshopt_VertexCacheGeneric,
+	meshopt_VertexCacheNvidia,
+	meshopt_VertexCacheAmd,
+	meshopt_VertexCacheIntel,
+	meshopt_VertexCacheApple,
+	meshopt_VertexCacheMobile
+};
+
+/**
+ * Experimental: Vertex transform cache optimizer scoring table
+ * The optimizer scores each vertex as cache[1 + position] + live[min(live_triangles, 8)], where position is the position in the emulated 16-entry cache or -1 if the vertex isn't in the cache,
+ * and live_triangles is the number of triangles that use the vertex and haven't been emitted yet; triangles with the highest total score of their vertices are emitted first.
+ * Scores must be non-negative, and scores of vertices with live triangles must be positive. tools/vcachetuner.cpp can be used to generate tables for custom cache models.
+ */
+struct meshopt_VertexScoreTable
+{
+	float cache[17];
+	float live[9];
+};
+
+/**
+ * Experimental: Vertex transform cache optimizer with a custom scoring table
+ * Reorders indices similarly to meshopt_optimizeVertexCache, using table to score vertices; see meshopt_VertexScoreTable.
+ *
+ * destination must contain enough space for the resulting index buffer (index_count elements)
+ */
+MESHOPTIMIZER_EXPERIMENTAL void meshopt_optimizeVertexCacheTable(unsigned int* destination, const unsigned int* indices, size_t index_count, size_t vertex_count, const struct meshopt_VertexScoreTable* table);
+
+/**
+ * Experimental: Vertex transform cache optimizer and analyzer for a specific GPU profile
+ * meshopt_optimizeVertexCacheProfile reorders indices similarly to meshopt_optimizeVertexCache using the scoring table tuned for the profile; Generic, Nvidia, Amd and Apple profiles use the same table as meshopt_optimizeVertexCache.
+ * meshopt_analyzeVertexCacheProfile returns cache statistics similarly to meshopt_analyzeVertexCache using the cache model of the profile.
+ * meshopt_getVertexScoreTable returns the scoring table for the profile, which can be used as a starting point for custom tuning.
+ *
+ * destination must contain enough space for the resulting index buffer (index_count elements)
+ */
+MESHOPTIMIZER_EXPERIMENTAL void meshopt_optimizeVertexCacheProfile(unsigned int* destination, const unsigned int* indices, size_t index_count, size_t vertex_count, enum meshopt_VertexCacheProfile profile);
+MESHOPTIMIZER_EXPERIMENTAL struct meshopt_VertexCacheStatistics meshopt_analyzeVertexCacheProfile(const unsigned int* indices, size_t index_count, size_t vertex_count, enum meshopt_VertexCacheProfile profile);
+MESHOPTIMIZER_EXPERIMENTAL void meshopt_getVertexScoreTable(struct meshopt_VertexScoreTable* destination, enum meshopt_VertexCacheProfile profile);
+
+/**
+ * Experimental: Parallel overdraw optimizer
+ * Reorders indices similarly to meshopt_optimizeOverdraw; clusters are built and measured in independent ranges using the scheduler, and scheduler can be NULL, in which case ranges are processed serially.
+ * Clusters are sorted using keys with twice the precision of meshopt_optimizeOverdraw, which orders clusters of large meshes more accurately, so the results may differ slightly; the results don't depend on the scheduler.
+ *
+ * destination must contain enough space for the resulting index buffer (index_count elements)
+ */
+MESHOPTIMIZER_EXPERIMENTAL void meshopt_optimizeOverdrawParallel(unsigned int* destination, const unsigned int* indices, size_t index_count, const float* vertex_positions, size_t vertex_count, size_t vertex_positions_stride, float threshold, meshopt_Scheduler scheduler, void* scheduler_context);
+
+/**
+ * Experimental: Parallel overdraw analyzer
+ * Returns overdraw statistics similarly to meshopt_analyzeOverdraw; each view is rasterized in independent bands of rows using the scheduler, and scheduler can be NULL, in which case bands are processed serially.
+ * With resolution 256 and 3 views, pixels_covered matches meshopt_analyzeOverdraw and pixels_shaded may differ slightly since depth is interpolated differently; the results don't depend on the scheduler.
+ * Depth and overdraw buffers are allocated by each band task and cover the rows of the band, so their memory usage grows with the number of concurrent tasks rather than with view_count.
+ *
+ * resolution is the size of the square viewport in pixels and must not exceed 1024
+ * view_count is the number of views; the first 3 views look along the coordinate axes, and the remaining views are distributed uniformly over a sphere
+ */
+MESHOPTIMIZER_EXPERIMENTAL struct meshopt_OverdrawStatistics meshopt_analyzeOverdrawParallel(const unsigned int* indices, size_t index_count, const float* vertex_positions, size_t vertex_count, size_t vertex_positions_stride, unsigned int resolution, unsigned int view_count, meshopt_Scheduler scheduler, void* scheduler_context);
+
+/**
+ * Experimental: Multi-stream vertex fetch analyzer
+ * Returns cache hit statistics similarly to meshopt_analyzeVertexFetch for a vertex layout described by streams, using a set associative LRU cache with a configurable geometry.
+ * Streams with the same stride that start within one vertex of each other are assumed to share an interleaved buffer; other streams are assumed to be stored in separate buffers.
+ * With a single stream, 64-byte lines, 128 KB cache and 1 way, the results match meshopt_analyzeVertexFetch.
+ *
+ * stream_bytes_fetched can be NULL; otherwise it must contain stream_count elements that receive the number of bytes fetched because of each stream
+ * cache_line_size must be a power of two; cache_size must be at least cache_line_size * cache_ways, and the number of sets, cache_size / (cache_line_size * cache_ways), must be a power of two
+ */
+MESHOPTIMIZER_EXPERIMENTAL struct meshopt_VertexFetchStatistics meshopt_analyzeVertexFetchMulti(unsigned int* stream_bytes_fetched, const unsigned int* indices, size_t index_count, size_t vertex_count, const struct meshopt_Stream* streams, size_t stream_count, unsigned int cache_line_size, unsigned int cache_size, unsigned int cache_ways);
+
+/**
+ * Experimental: Incremental vertex cache, overdraw and vertex fetch optimizers
+ * Re-optimize a part of a mesh that has been optimized with meshopt_optimizeVertexCache, meshopt_optimizeOverdraw and meshopt_optimizeVertexFetch after it was edited; the cost is proportional to the size of the edit, not the mesh.
+ * A typical edit replaces the triangles in [range_offset..range_offset+range_count) and appends new vertices to the end of the vertex buffer; to keep spatial edits contiguous, meshopt_spatialSortTriangles can be used to order the triangles before the initial optimization.
+ *
+ * meshopt_optimizeVertexCacheRange reorders triangles within the index range in place similarly to meshopt_optimizeVertexCache; the cache state is reconstructed from up to 16 triangles preceding the range, so the range continues the existing order.
+ * meshopt_optimizeOverdrawRange reorders triangles within the index range in place similarly to meshopt_optimizeOverdraw; the range must be optimized for vertex cache first (e.g. with meshopt_optimizeVertexCacheRange).
+ * meshopt_optimizeVertexFetchRange reorders vertices [vertex_offset..vertex_offset+vertex_range) in the order of their first use by indices, and returns the number of vertices in the range that are used; the remaining vertices are moved to the end of the range.
+ * indices must contain all triangles that reference vertices in the range (e.g. the edited index range); references to other vertices are left as is, so the order of other vertices is preserved.
+ *
+ * vertices must contain the entire vertex buffer; vertices in the range are reordered in place
+ */
+MESHOPTIMIZER_EXPERIMENTAL void meshopt_optimizeVertexCacheRange(unsigned int* indices, size_t index_count, size_t vertex_count, size_t range_offset, size_t range_count);
+MESHOPTIMIZER_EXPERIMENTAL void meshopt_optimizeOverdrawRange(unsigned int* indices, size_t index_count, const float* vertex_positions, size_t vertex_count, size_t vertex_positions_stride, size_t range_offset, size_t range_count, float threshold);
+MESHOPTIMIZER_EXPERIMENTAL size_t meshopt_optimizeVertexFetchRange(void* vertices, unsigned int* indices, size_t index_count, size_t vertex_size, size_t vertex_offset, size_t vertex_range);
+
+/**
+ * Experimental: Index buffer range decoder
+ * Decodes index_range indices starting from index_offset from an array of bytes generated by meshopt_encodeIndexBuffer with format version 2 (see meshopt_encodeIndexVersion)
+ * Returns 0 if decoding was successful, and an error code otherwise; -1 is returned when the data uses an older format version that can't be decoded partially.
+ * index_count must be equal to the number of indices in the entire encoded buffer; index_offset must be a multiple of 3072 (1024 triangles), and index_offset + index_range must be a multiple of 3072 or equal to index_count.
+ *
+ * destination must contain enough space for the resulting index range (index_range elements)
+ */
+MESHOPTIMIZER_EXPERIMENTAL int meshopt_decodeIndexBufferRange(void* destination, size_t index_offset, size_t index_range, size_t index_count, size_t index_size, const unsigned char* buffer, size_t buffer_size);
+
+/**
+ * Experimental: Parallel index buffer decoder
+ * Decodes index data similarly to meshopt_decodeIndexBuffer; data encoded with format version 2 (see meshopt_encodeIndexVersion) is decoded in independent chunks using the scheduler.
+ * Data that uses older format versions is decoded serially; scheduler can be NULL, in which case chunks are decoded serially as well.
+ *
+ * destination must contain enough space for the resulting index buffer (index_count elements)
+ */
+MESHOPTIMIZER_EXPERIMENTAL int meshopt_decodeIndexBufferParallel(void* destination, size_t index_count, size_t index_size, const unsigned char* buffer, size_t buffer_size, meshopt_Scheduler scheduler, void* scheduler_context);
+
+/**
+ * Experimental: In-place decoding margins
+ * meshopt_decodeVertexBuffer/meshopt_decodeVertexBufferFiltered and meshopt_decodeIndexBuffer can decode data in-place, without a separate allocation for the encoded data.
+ * To do that, allocate decoded size + margin bytes (vertex_count * vertex_size or index_count * index_size), copy the encoded buffer to the end of the allocation and call the decoder with the start of the allocation as a destination.
+ * Decoding runs front-to-back and the margin guarantees that the output never overwrites input that hasn't been read yet; the margin is never larger than buffer_size.
+ * The margin depends on the encoded data and is usually much smaller than buffer_size; if the data is malformed, buffer_size is returned and the decoder will report an error.
+ * Other decoding functions (range, stream and parallel decoders) don't support in-place decoding.
+ */
+MESHOPTIMIZER_EXPERIMENTAL size_t meshopt_decodeVertexBufferInPlaceMargin(size_t vertex_count, size_t vertex_size, const unsigned char* buffer, size_t buffer_size);
+MESHOPTIMIZER_EXPERIMENTAL size_t meshopt_decodeIndexBufferInPlaceMargin(size_t index_count, size_t index_size, const unsigned char* buffer, size_t buffer_size);
+
 /**
  * Set allocation callbacks
- * These callbacks will be used instead of the default operator new/operator delete for all temporary allocations in the library.
- * Note that all algorithms only allocate memory for temporary use.
- * allocate/deallocate are always called in a stack-like order - last pointer to be allocated is deallocated first.
+ * These callbacks will be used instead of the default operator new/operator delete for all allocations in the library.
+ * Note that most algorithms only allocate memory for temporary use; objects created by meshopt_createSimplifier/meshopt_createSloppyStream keep their memory until they are destroyed.
+ * Temporary allocations are always released in a stack-like order - last pointer to be allocated by each thread is deallocated first.
+ * Memory is always released through the callbacks that allocated it, even if the callbacks are changed in the meantime.
  */
 MESHOPTIMIZER_API void meshopt_setAllocator(void* (*allocate)(size_t), void (*deallocate)(void*));
 
+/**
+ * Experimental: Set allocation callbacks with a user context
+ * These callbacks will be used instead of the callbacks set by meshopt_setAllocator for temporary allocations in the library; context is passed to every call as is.
+ * The callbacks are set for the calling thread only (when the compiler supports thread-local storage), so every thread can use its own context; tasks that functions with a scheduler run on other threads use the callbacks of the thread that made the call.
+ * Only temporary allocations use these callbacks, and they are released in a stack-like order, so the callbacks can be implemented with a bump pointer arena that is reset on deallocation;
+ * objects created by meshopt_createSimplifier/meshopt_createSloppyStream outlive the call and always use meshopt_setAllocator callbacks instead.
+ * Scheduler tasks may allocate concurrently with the same context; to stay allocation-free, the callbacks can use the context to pick a per-thread arena. Memory is always released through the callbacks that allocated it.
+ * Passing NULL allocate/deallocate reverts to the callbacks set by meshopt_setAllocator. The peak scratch size for a given call can be measured by running it once with callbacks that record it.
+ */
+MESHOPTIMIZER_EXPERIMENTAL void meshopt_setAllocatorContext(void* (*allocate)(void* context, size_t size), void (*deallocate)(void* context, void* ptr), void* context);
+
+/**
+ * Experimental: Set profiling callbacks
+ * When the library is compiled with MESHOPTIMIZER_PROFILE=1, main phases of the expensive algorithms (simplifiers, vertex cache and overdraw optimizers, meshlet builders) are wrapped in zones:
+ * begin(context, name) and end(context, name) are called around every phase, and counter(context, name, value) reports statistics such as the number of simplification passes or bytes allocated by each call.
+ * Names are static strings; zones are nested correctly within each thread, and functions that accept a scheduler may call the callbacks from the threads that run the tasks.
+ * Passing NULL callbacks disables profiling. The library can also be compiled with MESHOPTIMIZER_ZONE(name) and MESHOPTIMIZER_COUNTER(name, value) defined to route zones to an external profiler directly, e.g. ZoneScopedN(name) for Tracy.
+ * When the library is compiled without MESHOPTIMIZER_PROFILE, the callbacks are never called and the instrumentation has no cost.
+ */
+MESHOPTIMIZER_EXPERIMENTAL void meshopt_setProfiler(void (*begin)(void* context, const char* name), void (*end)(void* context, const char* name), void (*counter)(void* context, const char* name, size_t value), void* context);
+
 #ifdef __cplusplus
 } /* extern "C" */
 #endif
@@ -509,6 +1073,8 @@ inline size_t meshopt_optimizeVertexFetchRemap(unsigned int* destination, const
 template <typename T>
 inline size_t meshopt_optimizeVertexFetch(void* destination, T* indices, size_t index_count, const void* vertices, size_t vertex_count, size_t vertex_size);
 template <typename T>
+inline size_t meshopt_optimizeVertexFetchMulti(void* const* destinations, T* indices, size_t index_count, size_t vertex_count, const meshopt_Stream* streams, size_t stream_count);
+template <typename T>
 inline size_t meshopt_encodeIndexBuffer(unsigned char* buffer, size_t buffer_size, const T* indices, size_t index_count);
 template <typename T>
 inline int meshopt_decodeIndexBuffer(T* destination, size_t index_count, const unsigned char* buffer, size_t buffer_size);
@@ -519,7 +1085,7 @@ inline int meshopt_decodeIndexSequence(T* destination, size_t index_count, const
 template <typename T>
 inline size_t meshopt_simplify(T* destination, const T* indices, size_t index_count, const float* vertex_positions, size_t vertex_count, size_t vertex_positions_stride, size_t target_index_count, float target_error);
 template <typename T>
-inline size_t meshopt_simplifySloppy(T* destination, const T* indices, size_t index_count, const float* vertex_positions, size_t vertex_count, size_t vertex_positions_stride, size_t target_index_count);
+inline size_t meshopt_simplifySloppy(T* destination, const T* indices, size_t index_count, const float* vertex_positions, size_t vertex_count, size_t vertex_positions_stride, size_t target_index_count, float target_error, float* result_error);
 template <typename T>
 inline size_t meshopt_stripify(T* destination, const T* indices, size_t index_count, size_t vertex_count, T restart_index);
 template <typename T>
@@ -533,9 +1099,45 @@ inline meshopt_VertexFetchStatistics meshopt_analyzeVertexFetch(const T* indices
 template <typename T>
 inline size_t meshopt_buildMeshlets(meshopt_Meshlet* destination, const T* indices, size_t index_count, size_t vertex_count, size_t max_vertices, size_t max_triangles);
 template <typename T>
+inline size_t meshopt_buildMeshletsSpatial(meshopt_Meshlet* destination, const T* indices, size_t index_count, const float* vertex_positions, size_t vertex_count, size_t vertex_positions_stride, size_t max_vertices, size_t max_triangles, float cone_weight);
+template <typename T>
+inline size_t meshopt_buildMeshletsPacked(meshopt_PackedMeshlet* meshlets, unsigned int* meshlet_vertices, unsigned char* meshlet_triangles, const T* indices, size_t index_count, const float* vertex_positions, size_t vertex_count, size_t vertex_positions_stride, size_t max_vertices, size_t max_triangles, float cone_weight);
+template <typename T>
 inline meshopt_Bounds meshopt_computeClusterBounds(const T* indices, size_t index_count, const float* vertex_positions, size_t vertex_count, size_t vertex_positions_stride);
 template <typename T>
+inline size_t meshopt_buildClusterLod(meshopt_LodCluster* clusters, unsigned int* cluster_vertices, unsigned char* cluster_triangles, unsigned int* cluster_children, const T* indices, size_t index_count, const float* vertex_positions, size_t vertex_count, size_t vertex_positions_stride, size_t max_vertices, size_t max_triangles, size_t group_size);
+template <typename T>
 inline void meshopt_spatialSortTriangles(T* destination, const T* indices, size_t index_count, const float* vertex_positions, size_t vertex_count, size_t vertex_positions_stride);
+template <typename T>
+inline size_t meshopt_generateVertexRemapParallel(unsigned int* destination, const T* indices, size_t index_count, const void* vertices, size_t vertex_count, size_t vertex_size, meshopt_Scheduler scheduler, void* scheduler_context);
+template <typename T>
+inline size_t meshopt_generateVertexRemapShadow(unsigned int* destination, T* shadow_destination, const T* indices, size_t index_count, const void* vertices, size_t vertex_count, size_t vertex_size, size_t shadow_size, meshopt_Scheduler scheduler, void* scheduler_context);
+template <typename T>
+inline size_t meshopt_stripifyParallel(T* destination, const T* indices, size_t index_count, size_t vertex_count, T restart_index, size_t chunk_size, meshopt_Scheduler scheduler, void* scheduler_context);
+template <typename T>
+inline void meshopt_optimizeVertexCachePartitioned(T* destination, const T* indices, size_t index_count, size_t vertex_count, size_t partition_count, meshopt_Scheduler scheduler, void* scheduler_context);
+template <typename T>
+inline void meshopt_optimizeVertexCacheTable(T* destination, const T* indices, size_t index_count, size_t vertex_count, const meshopt_VertexScoreTable* table);
+template <typename T>
+inline void meshopt_optimizeVertexCacheProfile(T* destination, const T* indices, size_t index_count, size_t vertex_count, meshopt_VertexCacheProfile profile);
+template <typename T>
+inline meshopt_VertexCacheStatistics meshopt_analyzeVertexCacheProfile(const T* indices, size_t index_count, size_t vertex_count, meshopt_VertexCacheProfile profile);
+template <typename T>
+inline void meshopt_optimizeOverdrawParallel(T* destination, const T* indices, size_t index_count, const float* vertex_positions, size_t vertex_count, size_t vertex_positions_stride, float threshold, meshopt_Scheduler scheduler, void* scheduler_context);
+template <typename T>
+inline meshopt_OverdrawStatistics meshopt_analyzeOverdrawParallel(const T* indices, size_t index_count, const float* vertex_positions, size_t vertex_count, size_t vertex_positions_stride, unsigned int resolution, unsigned int view_count, meshopt_Scheduler scheduler, void* scheduler_context);
+template <typename T>
+inline meshopt_VertexFetchStatistics meshopt_analyzeVertexFetchMulti(unsigned int* stream_bytes_fetched, const T* indices, size_t index_count, size_t vertex_count, const meshopt_Stream* streams, size_t stream_count, unsigned int cache_line_size, unsigned int cache_size, unsigned int cache_ways);
+template <typename T>
+inline void meshopt_optimizeVertexCacheRange(T* indices, size_t index_count, size_t vertex_count, size_t range_offset, size_t range_count);
+template <typename T>
+inline void meshopt_optimizeOverdrawRange(T* indices, size_t index_count, const float* vertex_positions, size_t vertex_count, size_t vertex_positions_stride, size_t range_offset, size_t range_count, float threshold);
+template <typename T>
+inline size_t meshopt_optimizeVertexFetchRange(void* vertices, T* indices, size_t index_count, size_t vertex_size, size_t vertex_offset, size_t vertex_range);
+template <typename T>
+inline int meshopt_decodeIndexBufferRange(T* destination, size_t index_offset, size_t index_range, size_t index_count, const unsigned char* buffer, size_t buffer_size);
+template <typename T>
+inline int meshopt_decodeIndexBufferParallel(T* destination, size_t index_count, const unsigned char* buffer, size_t buffer_size, meshopt_Scheduler scheduler, void* scheduler_context);
 #endif
 
 /* Inline implementation */
@@ -609,6 +1211,81 @@ inline float meshopt_quantizeFloat(float v, int N)
 
 /* Internal implementation helpers */
 #ifdef __cplusplus
+#ifndef MESHOPTIMIZER_PROFILE
+#define MESHOPTIMIZER_PROFILE 0
+#endif
+
+/* Zones last until the end of the enclosing scope and can be nested; zones and counters can be redirected to an external profiler by defining these macros */
+#ifndef MESHOPTIMIZER_ZONE
+#if MESHOPTIMIZER_PROFILE
+#define MESHOPTIMIZER_ZONE_CONCAT(a, b) a##b
+#define MESHOPTIMIZER_ZONE_NAME(line) MESHOPTIMIZER_ZONE_CONCAT(meshopt_profile_zone, line)
+#define MESHOPTIMIZER_ZONE(name) meshopt_ProfileZone MESHOPTIMIZER_ZONE_NAME(__LINE__)(name)
+#else
+#define MESHOPTIMIZER_ZONE(name) (void)0
+#endif
+#endif
+
+#ifndef MESHOPTIMIZER_COUNTER
+#if MESHOPTIMIZER_PROFILE
+#define MESHOPTIMIZER_COUNTER(name, value) meshopt_ProfileZone::count(name, value)
+#else
+#define MESHOPTIMIZER_COUNTER(name, value) (void)sizeof(value)
+#endif
+#endif
+
+class meshopt_ProfileZone
+{
+public:
+	template <typename T>
+	struct StorageT
+	{
+		static void (*begin)(void*, const char*);
+		static void (*end)(void*, const char*);
+		static void (*counter)(void*, const char*, size_t);
+		static void* context;
+	};
+
+	typedef StorageT<void> Storage;
+
+	// callbacks are captured on entry so that begin/end calls stay paired even if the profiler is changed while the zone is active
+	meshopt_ProfileZone(const char* name_)
+		: name(name_)
+		, end(Storage::end)
+		, context(Storage::context)
+	{
+		if (Storage::begin)
+			Storage::begin(context, name);
+	}
+
+	~meshopt_ProfileZone()
+	{
+		if (end)
+			end(context, name);
+	}
+
+	static void count(const char* name, size_t value)
+	{
+		if (Storage::counter)
+			Storage::counter(Storage::context, name, value);
+	}
+
+private:
+	const char* name;
+	void (*end)(void*, const char*);
+	void* context;
+};
+
+#ifndef MESHOPTIMIZER_THREAD_LOCAL
+#if defined(_MSC_VER)
+#define MESHOPTIMIZER_THREAD_LOCAL __declspec(thread)
+#elif defined(__GNUC__)
+#define MESHOPTIMIZER_THREAD_LOCAL __thread
+#else
+#define MESHOPTIMIZER_THREAD_LOCAL
+#endif
+#endif
+
 class meshopt_Allocator
 {
 public:
@@ -617,38 +1294,112 @@ public:
 	{
 		static void* (*allocate)(size_t);
 		static void (*deallocate)(void*);
+
+		// context callbacks are set for each thread separately
+		static MESHOPTIMIZER_THREAD_LOCAL void* (*allocate_context)(void*, size_t);
+		static MESHOPTIMIZER_THREAD_LOCAL void (*deallocate_context)(void*, void*);
+		static MESHOPTIMIZER_THREAD_LOCAL void* context;
 	};
 
 	typedef StorageT<void> Storage;
 
+	// callbacks are captured when the memory is allocated, so that it is released through the same callbacks even if they change in the meantime
+	struct Callbacks
+	{
+		void* (*allocate)(size_t);
+		void (*deallocate)(void*);
+
+		void* (*allocate_context)(void*, size_t);
+		void (*deallocate_context)(void*, void*);
+		void* context;
+	};
+
+	static Callbacks getCallbacks()
+	{
+		Callbacks result = {Storage::allocate, Storage::deallocate, Storage::allocate_context, Storage::deallocate_context, Storage::context};
+		return result;
+	}
+
+	static void* allocateStorage(const Callbacks& callbacks, size_t size)
+	{
+		return callbacks.allocate_context ? callbacks.allocate_context(callbacks.context, size) : callbacks.allocate(size);
+	}
+
+	static void deallocateStorage(const Callbacks& callbacks, void* ptr)
+	{
+		if (callbacks.deallocate_context)
+			callbacks.deallocate_context(callbacks.context, ptr);
+		else
+			callbacks.deallocate(ptr);
+	}
+
+	// scheduler tasks may run on other threads; tasks install the callbacks of the calling thread for their duration
+	class Scope
+	{
+	public:
+		Scope(const Callbacks& callbacks)
+			: saved(getCallbacks())
+		{
+			Storage::allocate_context = callbacks.allocate_context;
+			Storage::deallocate_context = callbacks.deallocate_context;
+			Storage::context = callbacks.context;
+		}
+
+		~Scope()
+		{
+			Storage::allocate_context = saved.allocate_context;
+			Storage::deallocate_context = saved.deallocate_context;
+			Storage::context = saved.context;
+		}
+
+	private:
+		Callbacks saved;
+	};
+
 	meshopt_Allocator()
-		: blocks()
+		: callbacks(getCallbacks())
+		, blocks()
 		, count(0)
+		, allocated(0)
 	{
 	}
 
 	~meshopt_Allocator()
 	{
+		MESHOPTIMIZER_COUNTER("allocated", allocated);
+
 		for (size_t i = count; i > 0; --i)
-			Storage::deallocate(blocks[i - 1]);
+			deallocateStorage(callbacks, blocks[i - 1]);
 	}
 
 	template <typename T> T* allocate(size_t size)
 	{
 		assert(count < sizeof(blocks) / sizeof(blocks[0]));
-		T* result = static_cast<T*>(Storage::allocate(size > size_t(-1) / sizeof(T) ? size_t(-1) : size * sizeof(T)));
+		size_t bytes = size > size_t(-1) / sizeof(T) ? size_t(-1) : size * sizeof(T);
+		T* result = static_cast<T*>(allocateStorage(callbacks, bytes));
 		blocks[count++] = result;
+		allocated += bytes;
 		return result;
 	}
 
 private:
+	Callbacks callbacks;
 	void* blocks[16];
 	size_t count;
+	size_t allocated;
 };
 
 // This makes sure that allocate/deallocate are lazily generated in translation units that need them and are deduplicated by the linker
 template <typename T> void* (*meshopt_Allocator::StorageT<T>::allocate)(size_t) = operator new;
 template <typename T> void (*meshopt_Allocator::StorageT<T>::deallocate)(void*) = operator delete;
+template <typename T> MESHOPTIMIZER_THREAD_LOCAL void* (*meshopt_Allocator::StorageT<T>::allocate_context)(void*, size_t) = 0;
+template <typename T> MESHOPTIMIZER_THREAD_LOCAL void (*meshopt_Allocator::StorageT<T>::deallocate_context)(void*, void*) = 0;
+template <typename T> MESHOPTIMIZER_THREAD_LOCAL void* meshopt_Allocator::StorageT<T>::context = 0;
+
+template <typename T> void (*meshopt_ProfileZone::StorageT<T>::begin)(void*, const char*) = 0;
+template <typename T> void (*meshopt_ProfileZone::StorageT<T>::end)(void*, const char*) = 0;
+template <typename T> void (*meshopt_ProfileZone::StorageT<T>::counter)(void*, const char*, size_t) = 0;
+template <typename T> void* meshopt_ProfileZone::StorageT<T>::context = 0;
 #endif
 
 /* Inline implementation for C++ templated wrappers */
@@ -662,15 +1413,17 @@ struct meshopt_IndexAdapter<T, false>
 	T* result;
 	unsigned int* data;
 	size_t count;
+	meshopt_Allocator::Callbacks callbacks;
 
 	meshopt_IndexAdapter(T* result_, const T* input, size_t count_)
 	    : result(result_)
 	    , data(0)
 	    , count(count_)
+	    , callbacks(meshopt_Allocator::getCallbacks())
 	{
 		size_t size = count > size_t(-1) / sizeof(unsigned int) ? size_t(-1) : count * sizeof(unsigned int);
 
-		data = static_cast<unsigned int*>(meshopt_Allocator::Storage::allocate(size));
+		data = static_cast<unsigned int*>(meshopt_Allocator::allocateStorage(callbacks, size));
 
 		if (input)
 		{
@@ -687,7 +1440,7 @@ struct meshopt_IndexAdapter<T, false>
 				result[i] = T(data[i]);
 		}
 
-		meshopt_Allocator::Storage::deallocate(data);
+		meshopt_Allocator::deallocateStorage(callbacks, data);
 	}
 };
 
@@ -797,6 +1550,14 @@ inline size_t meshopt_optimizeVertexFetch(void* destination, T* indices, size_t
 	return meshopt_optimizeVertexFetch(destination, inout.data, index_count, vertices, vertex_count, vertex_size);
 }
 
+template <typename T>
+inline size_t meshopt_optimizeVertexFetchMulti(void* const* destinations, T* indices, size_t index_count, size_t vertex_count, const meshopt_Stream* streams, size_t stream_count)
+{
+	meshopt_IndexAdapter<T> inout(indices, indices, index_count);
+
+	return meshopt_optimizeVertexFetchMulti(destinations, inout.data, index_count, vertex_count, streams, stream_count);
+}
+
 template <typename T>
 inline size_t meshopt_encodeIndexBuffer(unsigned char* buffer, size_t buffer_size, const T* indices, size_t index_count)
 {
@@ -841,12 +1602,20 @@ inline size_t meshopt_simplify(T* destination, const T* indices, size_t index_co
 }
 
 template <typename T>
-inline size_t meshopt_simplifySloppy(T* destination, const T* indices, size_t index_count, const float* vertex_positions, size_t vertex_count, size_t vertex_positions_stride, size_t target_index_count)
+inline size_t meshopt_simplifySloppy(T* destination, const T* indices, size_t index_count, const float* vertex_positions, size_t vertex_count, size_t vertex_positions_stride, size_t target_index_count, float target_error, float* result_error)
 {
 	meshopt_IndexAdapter<T> in(0, indices, index_count);
-	meshopt_IndexAdapter<T> out(destination, 0, target_index_count);
 
-	return meshopt_simplifySloppy(out.data, in.data, index_count, vertex_positions, vertex_count, vertex_positions_stride, target_index_count);
+	// the result can exceed target_index_count when limited by target_error, so we simplify into scratch memory and only copy the indices that were written
+	meshopt_Allocator allocator;
+	unsigned int* out = allocator.allocate<unsigned int>(index_count);
+
+	size_t result = meshopt_simplifySloppy(out, in.data, index_count, vertex_positions, vertex_count, vertex_positions_stride, target_index_count, target_error, result_error);
+
+	for (size_t i = 0; i < result; ++i)
+		destination[i] = T(out[i]);
+
+	return result;
 }
 
 template <typename T>
@@ -899,6 +1668,22 @@ inline size_t meshopt_buildMeshlets(meshopt_Meshlet* destination, const T* indic
 	return meshopt_buildMeshlets(destination, in.data, index_count, vertex_count, max_vertices, max_triangles);
 }
 
+template <typename T>
+inline size_t meshopt_buildMeshletsSpatial(meshopt_Meshlet* destination, const T* indices, size_t index_count, const float* vertex_positions, size_t vertex_count, size_t vertex_positions_stride, size_t max_vertices, size_t max_triangles, float cone_weight)
+{
+	meshopt_IndexAdapter<T> in(0, indices, index_count);
+
+	return meshopt_buildMeshletsSpatial(destination, in.data, index_count, vertex_positions, vertex_count, vertex_positions_stride, max_vertices, max_triangles, cone_weight);
+}
+
+template <typename T>
+inline size_t meshopt_buildMeshletsPacked(meshopt_PackedMeshlet* meshlets, unsigned int* meshlet_vertices, unsigned char* meshlet_triangles, const T* indices, size_t index_count, const float* vertex_positions, size_t vertex_count, size_t vertex_positions_stride, size_t max_vertices, size_t max_triangles, float cone_weight)
+{
+	meshopt_IndexAdapter<T> in(0, indices, index_count);
+
+	return meshopt_buildMeshletsPacked(meshlets, meshlet_vertices, meshlet_triangles, in.data, index_count, vertex_positions, vertex_count, vertex_positions_stride, max_vertices, max_triangles, cone_weight);
+}
+
 template <typename T>
 inline meshopt_Bounds meshopt_computeClusterBounds(const T* indices, size_t index_count, const float* vertex_positions, size_t vertex_count, size_t vertex_positions_stride)
 {
@@ -907,6 +1692,14 @@ inline meshopt_Bounds meshopt_computeClusterBounds(const T* indices, size_t inde
 	return meshopt_computeClusterBounds(in.data, index_count, vertex_positions, vertex_count, vertex_positions_stride);
 }
 
+template <typename T>
+inline size_t meshopt_buildClusterLod(meshopt_LodCluster* clusters, unsigned int* cluster_vertices, unsigned char* cluster_triangles, unsigned int* cluster_children, const T* indices, size_t index_count, const float* vertex_positions, size_t vertex_count, size_t vertex_positions_stride, size_t max_vertices, size_t max_triangles, size_t group_size)
+{
+	meshopt_IndexAdapter<T> in(0, indices, index_count);
+
+	return meshopt_buildClusterLod(clusters, cluster_vertices, cluster_triangles, cluster_children, in.data, index_count, vertex_positions, vertex_count, vertex_positions_stride, max_vertices, max_triangles, group_size);
+}
+
 template <typename T>
 inline void meshopt_spatialSortTriangles(T* destination, const T* indices, size_t index_count, const float* vertex_positions, size_t vertex_count, size_t vertex_positions_stride)
 {
@@ -915,6 +1708,141 @@ inline void meshopt_spatialSortTriangles(T* destination, const T* indices, size_
 
 	meshopt_spatialSortTriangles(out.data, in.data, index_count, vertex_positions, vertex_count, vertex_positions_stride);
 }
+
+template <typename T>
+inline size_t meshopt_generateVertexRemapParallel(unsigned int* destination, const T* indices, size_t index_count, const void* vertices, size_t vertex_count, size_t vertex_size, meshopt_Scheduler scheduler, void* scheduler_context)
+{
+	meshopt_IndexAdapter<T> in(0, indices, indices ? index_count : 0);
+
+	return meshopt_generateVertexRemapParallel(destination, indices ? in.data : 0, index_count, vertices, vertex_count, vertex_size, scheduler, scheduler_context);
+}
+
+template <typename T>
+inline size_t meshopt_generateVertexRemapShadow(unsigned int* destination, T* shadow_destination, const T* indices, size_t index_count, const void* vertices, size_t vertex_count, size_t vertex_size, size_t shadow_size, meshopt_Scheduler scheduler, void* scheduler_context)
+{
+	meshopt_IndexAdapter<T> in(0, indices, indices ? index_count : 0);
+	meshopt_IndexAdapter<T> out(shadow_destination, 0, index_count);
+
+	return meshopt_generateVertexRemapShadow(destination, out.data, indices ? in.data : 0, index_count, vertices, vertex_count, vertex_size, shadow_size, scheduler, scheduler_context);
+}
+
+template <typename T>
+inline size_t meshopt_stripifyParallel(T* destination, const T* indices, size_t index_count, size_t vertex_count, T restart_index, size_t chunk_size, meshopt_Scheduler scheduler, void* scheduler_context)
+{
+	meshopt_IndexAdapter<T> in(0, indices, index_count);
+	meshopt_IndexAdapter<T> out(destination, 0, meshopt_stripifyParallelBound(index_count, chunk_size));
+
+	return meshopt_stripifyParallel(out.data, in.data, index_count, vertex_count, unsigned(restart_index), chunk_size, scheduler, scheduler_context);
+}
+
+template <typename T>
+inline void meshopt_optimizeVertexCachePartitioned(T* destination, const T* indices, size_t index_count, size_t vertex_count, size_t partition_count, meshopt_Scheduler scheduler, void* scheduler_context)
+{
+	meshopt_IndexAdapter<T> in(0, indices, index_count);
+	meshopt_IndexAdapter<T> out(destination, 0, index_count);
+
+	meshopt_optimizeVertexCachePartitioned(out.data, in.data, index_count, vertex_count, partition_count, scheduler, scheduler_context);
+}
+
+template <typename T>
+inline void meshopt_optimizeVertexCacheTable(T* destination, const T* indices, size_t index_count, size_t vertex_count, const meshopt_VertexScoreTable* table)
+{
+	meshopt_IndexAdapter<T> in(0, indices, index_count);
+	meshopt_IndexAdapter<T> out(destination, 0, index_count);
+
+	meshopt_optimizeVertexCacheTable(out.data, in.data, index_count, vertex_count, table);
+}
+
+template <typename T>
+inline void meshopt_optimizeVertexCacheProfile(T* destination, const T* indices, size_t index_count, size_t vertex_count, meshopt_VertexCacheProfile profile)
+{
+	meshopt_IndexAdapter<T> in(0, indices, index_count);
+	meshopt_IndexAdapter<T> out(destination, 0, index_count);
+
+	meshopt_optimizeVertexCacheProfile(out.data, in.data, index_count, vertex_count, profile);
+}
+
+template <typename T>
+inline meshopt_VertexCacheStatistics meshopt_analyzeVertexCacheProfile(const T* indices, size_t index_count, size_t vertex_count, meshopt_VertexCacheProfile profile)
+{
+	meshopt_IndexAdapter<T> in(0, indices, index_count);
+
+	return meshopt_analyzeVertexCacheProfile(in.data, index_count, vertex_count, profile);
+}
+
+template <typename T>
+inline void meshopt_optimizeOverdrawParallel(T* destination, const T* indices, size_t index_count, const float* vertex_positions, size_t vertex_count, size_t vertex_positions_stride, float threshold, meshopt_Scheduler scheduler, void* scheduler_context)
+{
+	meshopt_IndexAdapter<T> in(0, indices, index_count);
+	meshopt_IndexAdapter<T> out(destination, 0, index_count);
+
+	meshopt_optimizeOverdrawParallel(out.data, in.data, index_count, vertex_positions, vertex_count, vertex_positions_stride, threshold, scheduler, scheduler_context);
+}
+
+template <typename T>
+inline meshopt_OverdrawStatistics meshopt_analyzeOverdrawParallel(const T* indices, size_t index_count, const float* vertex_positions, size_t vertex_count, size_t vertex_positions_stride, unsigned int resolution, unsigned int view_count, meshopt_Scheduler scheduler, void* scheduler_context)
+{
+	meshopt_IndexAdapter<T> in(0, indices, index_count);
+
+	return meshopt_analyzeOverdrawParallel(in.data, index_count, vertex_positions, vertex_count, vertex_positions_stride, resolution, view_count, scheduler, scheduler_context);
+}
+
+template <typename T>
+inline meshopt_VertexFetchStatistics meshopt_analyzeVertexFetchMulti(unsigned int* stream_bytes_fetched, const T* indices, size_t index_count, size_t vertex_count, const meshopt_Stream* streams, size_t stream_count, unsigned int cache_line_size, unsigned int cache_size, unsigned int cache_ways)
+{
+	meshopt_IndexAdapter<T> in(0, indices, index_count);
+
+	return meshopt_analyzeVertexFetchMulti(stream_bytes_fetched, in.data, index_count, vertex_count, streams, stream_count, cache_line_size, cache_size, cache_ways);
+}
+
+template <typename T>
+inline void meshopt_optimizeVertexCacheRange(T* indices, size_t index_count, size_t vertex_count, size_t range_offset, size_t range_count)
+{
+	(void)index_count;
+
+	// only the range and the triangles preceding it are accessed, so we only need to convert those
+	size_t lookback = range_offset < 16 * 3 ? range_offset : 16 * 3;
+
+	meshopt_IndexAdapter<T> inout(indices + range_offset - lookback, indices + range_offset - lookback, lookback + range_count);
+
+	meshopt_optimizeVertexCacheRange(inout.data, lookback + range_count, vertex_count, lookback, range_count);
+}
+
+template <typename T>
+inline void meshopt_optimizeOverdrawRange(T* indices, size_t index_count, const float* vertex_positions, size_t vertex_count, size_t vertex_positions_stride, size_t range_offset, size_t range_count, float threshold)
+{
+	(void)index_count;
+
+	meshopt_IndexAdapter<T> inout(indices + range_offset, indices + range_offset, range_count);
+
+	meshopt_optimizeOverdrawRange(inout.data, range_count, vertex_positions, vertex_count, vertex_positions_stride, 0, range_count, threshold);
+}
+
+template <typename T>
+inline size_t meshopt_optimizeVertexFetchRange(void* vertices, T* indices, size_t index_count, size_t vertex_size, size_t vertex_offset, size_t vertex_range)
+{
+	meshopt_IndexAdapter<T> inout(indices, indices, index_count);
+
+	return meshopt_optimizeVertexFetchRange(vertices, inout.data, index_count, vertex_size, vertex_offset, vertex_range);
+}
+
+template <typename T>
+inline int meshopt_decodeIndexBufferRange(T* destination, size_t index_offset, size_t index_range, size_t index_count, const unsigned char* buffer, size_t buffer_size)
+{
+	char index_size_valid[sizeof(T) == 2 || sizeof(T) == 4 ? 1 : -1];
+	(void)index_size_valid;
+
+	return meshopt_decodeIndexBufferRange(destination, index_offset, index_range, index_count, sizeof(T), buffer, buffer_size);
+}
+
+template <typename T>
+inline int meshopt_decodeIndexBufferParallel(T* destination, size_t index_count, const unsigned char* buffer, size_t buffer_size, meshopt_Scheduler scheduler, void* scheduler_context)
+{
+	char index_size_valid[sizeof(T) == 2 || sizeof(T) == 4 ? 1 : -1];
+	(void)index_size_valid;
+
+	return meshopt_decodeIndexBufferParallel(destination, index_count, sizeof(T), buffer, buffer_size, scheduler, scheduler_context);
+}
 #endif
 
 /**
@@ -3,8 +3,13 @@
 
 #include <assert.h>
 #include <float.h>
+#include <math.h>
 #include <string.h>
 
+#if defined(__SSE2__) || defined(_M_X64)
+#include <emmintrin.h>
+#endif
+
 // This work is based on:
 // Nicolas Capens. Advanced Rasterization. 2004
 namespace meshopt
@@ -140,6 +145,402 @@ static void rasterize(OverdrawBuffer* buffer, float v1x, float v1y, float v1z, f
 	}
 }
 
+// rows are processed in bands so that each band can be rasterized independently; each band processes its triangles in order, so the results don't depend on the task schedule
+const int kOverdrawBands = 8;
+
+// triangles are assigned to bands in fixed chunks for each view
+const size_t kOverdrawBinTasks = 16;
+
+struct OverdrawBandContext
+{
+	const unsigned int* indices;
+	size_t index_count;
+
+	// view space positions for each view, vertex_count * 3 floats per view
+	const float* positions;
+	size_t vertex_count;
+
+	int resolution;
+	size_t pitch;
+
+	// range of bands for each triangle of each view; triangles that don't cover any pixels have an empty range
+	unsigned char* bands;
+
+	// triangle counts for each band of each binning task, converted to offsets into band_triangles before scattering
+	size_t* bin_offsets;
+
+	// triangles of each band of each view, in the original order; band_offsets has view_count * kOverdrawBands + 1 elements
+	unsigned int* band_triangles;
+	size_t* band_offsets;
+
+	unsigned int* pixels_covered;
+	unsigned int* pixels_shaded;
+
+	// allocation callbacks of the calling thread, installed by the tasks that allocate memory
+	meshopt_Allocator::Callbacks callbacks;
+};
+
+static int getEdgeFunction(int DX, int DY, int X, int Y, int FX, int FY, int TL)
+{
+	// unsigned math makes wraparound well defined and matches incremental evaluation exactly
+	return int(unsigned(DX) * unsigned(FY - Y) - unsigned(DY) * unsigned(FX - X) + unsigned(TL - 1));
+}
+
+// half-space fixed point triangle rasterizer; unlike rasterize, this starts edge functions at the first row of the band and computes depth for each pixel directly,
+// which allows rasterizing any subset of rows; coverage matches rasterize exactly, and depth may differ by rounding
+// buffers only store the rows of the band, with front and back facing layers of layer_size elements each
+static void rasterizeBand(float* zbuffer, unsigned int* obuffer, size_t pitch, size_t layer_size, int resolution, int band_begin, int band_end, float v1x, float v1y, float v1z, float v2x, float v2y, float v2z, float v3x, float v3y, float v3z)
+{
+	// compute depth gradients
+	float DZx, DZy;
+	float det = computeDepthGradients(DZx, DZy, v1x, v1y, v1z, v2x, v2y, v2z, v3x, v3y, v3z);
+	int sign = det > 0;
+
+	// flip backfacing triangles to simplify rasterization logic
+	if (sign)
+	{
+		// flipping v2 & v3 preserves depth gradients since they're based on v1
+		float t;
+		t = v2x, v2x = v3x, v3x = t;
+		t = v2y, v2y = v3y, v3y = t;
+		t = v2z, v2z = v3z, v3z = t;
+
+		// flip depth since we rasterize backfacing triangles to second buffer with reverse Z; only v1z is used below
+		v1z = float(resolution) - v1z;
+		DZx = -DZx;
+		DZy = -DZy;
+	}
+
+	// coordinates, 28.4 fixed point
+	int X1 = int(16.0f * v1x + 0.5f);
+	int X2 = int(16.0f * v2x + 0.5f);
+	int X3 = int(16.0f * v3x + 0.5f);
+
+	int Y1 = int(16.0f * v1y + 0.5f);
+	int Y2 = int(16.0f * v2y + 0.5f);
+	int Y3 = int(16.0f * v3y + 0.5f);
+
+	// bounding rectangle, clipped against the band; see rasterize for rounding rules
+	int minx = max((min(X1, min(X2, X3)) + 7) >> 4, 0);
+	int maxx = min((max(X1, max(X2, X3)) + 7) >> 4, resolution);
+	int miny = max((min(Y1, min(Y2, Y3)) + 7) >> 4, band_begin);
+	int maxy = min((max(Y1, max(Y2, Y3)) + 7) >> 4, band_end);
+
+	if (minx >= maxx || miny >= maxy)
+		return;
+
+	// deltas, 28.4 fixed point
+	int DX12 = X1 - X2;
+	int DX23 = X2 - X3;
+	int DX31 = X3 - X1;
+
+	int DY12 = Y1 - Y2;
+	int DY23 = Y2 - Y3;
+	int DY31 = Y3 - Y1;
+
+	// fill convention correction
+	int TL1 = DY12 < 0 || (DY12 == 0 && DX12 > 0);
+	int TL2 = DY23 < 0 || (DY23 == 0 && DX23 > 0);
+	int TL3 = DY31 < 0 || (DY31 == 0 && DX31 > 0);
+
+	float* zlayer = zbuffer + sign * layer_size;
+	unsigned int* olayer = obuffer + sign * layer_size;
+
+#if defined(__SSE2__) || defined(_M_X64)
+	// process 4 pixels at a time for wide triangles; groups are aligned so that they never cross the padded row end
+	if (maxx - minx >= 8)
+	{
+		int startx = minx & ~3;
+
+		__m128i lane = _mm_setr_epi32(0, 1, 2, 3);
+		__m128i step1 = _mm_set1_epi32(int(unsigned(DY12) << 6));
+		__m128i step2 = _mm_set1_epi32(int(unsigned(DY23) << 6));
+		__m128i step3 = _mm_set1_epi32(int(unsigned(DY31) << 6));
+		__m128i rangemin = _mm_set1_epi32(minx - 1);
+		__m128i rangemax = _mm_set1_epi32(maxx);
+		__m128 dzx = _mm_set1_ps(DZx);
+
+		int FX = (startx << 4) + 8;
+		int FY = (miny << 4) + 8;
+
+		int CY1 = getEdgeFunction(DX12, DY12, X1, Y1, FX, FY, TL1);
+		int CY2 = getEdgeFunction(DX23, DY23, X2, Y2, FX, FY, TL2);
+		int CY3 = getEdgeFunction(DX31, DY31, X3, Y3, FX, FY, TL3);
+
+		unsigned int S1 = unsigned(DY12) << 4, S2 = unsigned(DY23) << 4, S3 = unsigned(DY31) << 4;
+
+		// edge functions for the first 4 pixels of the row; stepping them incrementally is exact since the math wraps around consistently
+		__m128i cy1 = _mm_setr_epi32(CY1, int(unsigned(CY1) - S1), int(unsigned(CY1) - 2 * S1), int(unsigned(CY1) - 3 * S1));
+		__m128i cy2 = _mm_setr_epi32(CY2, int(unsigned(CY2) - S2), int(unsigned(CY2) - 2 * S2), int(unsigned(CY2) - 3 * S2));
+		__m128i cy3 = _mm_setr_epi32(CY3, int(unsigned(CY3) - S3), int(unsigned(CY3) - 2 * S3), int(unsigned(CY3) - 3 * S3));
+
+		__m128i rowstep1 = _mm_set1_epi32(int(unsigned(DX12) << 4));
+		__m128i rowstep2 = _mm_set1_epi32(int(unsigned(DX23) << 4));
+		__m128i rowstep3 = _mm_set1_epi32(int(unsigned(DX31) << 4));
+
+		for (int y = miny; y < maxy; y++, FY += 16)
+		{
+			__m128i c1 = cy1, c2 = cy2, c3 = cy3;
+
+			cy1 = _mm_add_epi32(cy1, rowstep1);
+			cy2 = _mm_add_epi32(cy2, rowstep2);
+			cy3 = _mm_add_epi32(cy3, rowstep3);
+
+			// depth at pixel x is zrow + DZx * x
+			__m128 zrow = _mm_set1_ps(v1z + (DZx * float(8 - X1) + DZy * float(FY - Y1)) * (1 / 16.f));
+
+			float* zrowp = zlayer + (y - band_begin) * pitch;
+			unsigned int* orowp = olayer + (y - band_begin) * pitch;
+
+			for (int x = startx; x < maxx; x += 4)
+			{
+				__m128i xl = _mm_add_epi32(_mm_set1_epi32(x), lane);
+				__m128i inrange = _mm_and_si128(_mm_cmpgt_epi32(xl, rangemin), _mm_cmplt_epi32(xl, rangemax));
+
+				// check if all CXn are non-negative
+				__m128i inside = _mm_and_si128(_mm_cmpgt_epi32(_mm_or_si128(_mm_or_si128(c1, c2), c3), _mm_set1_epi32(-1)), inrange);
+
+				__m128 zx = _mm_add_ps(zrow, _mm_mul_ps(dzx, _mm_cvtepi32_ps(xl)));
+				__m128 zb = _mm_loadu_ps(zrowp + x);
+
+				__m128i pass = _mm_and_si128(inside, _mm_castps_si128(_mm_cmpge_ps(zx, zb)));
+				__m128 passf = _mm_castsi128_ps(pass);
+
+				_mm_storeu_ps(zrowp + x, _mm_or_ps(_mm_and_ps(passf, zx), _mm_andnot_ps(passf, zb)));
+
+				// pass is -1 for updated pixels
+				__m128i ob = _mm_loadu_si128(reinterpret_cast<const __m128i*>(orowp + x));
+				_mm_storeu_si128(reinterpret_cast<__m128i*>(orowp + x), _mm_sub_epi32(ob, pass));
+
+				c1 = _mm_sub_epi32(c1, step1);
+				c2 = _mm_sub_epi32(c2, step2);
+				c3 = _mm_sub_epi32(c3, step3);
+			}
+		}
+
+		return;
+	}
+#endif
+
+	// narrow triangles are processed one pixel at a time; depth is computed the same way as for wide triangles
+	unsigned int CY1 = unsigned(getEdgeFunction(DX12, DY12, X1, Y1, (minx << 4) + 8, (miny << 4) + 8, TL1));
+	unsigned int CY2 = unsigned(getEdgeFunction(DX23, DY23, X2, Y2, (minx << 4) + 8, (miny << 4) + 8, TL2));
+	unsigned int CY3 = unsigned(getEdgeFunction(DX31, DY31, X3, Y3, (minx << 4) + 8, (miny << 4) + 8, TL3));
+
+	for (int y = miny; y < maxy; y++)
+	{
+		unsigned int CX1 = CY1, CX2 = CY2, CX3 = CY3;
+
+		float* zrowp = zlayer + (y - band_begin) * pitch;
+		unsigned int* orowp = olayer + (y - band_begin) * pitch;
+
+		float zrow = v1z + (DZx * float(8 - X1) + DZy * float((y << 4) + 8 - Y1)) * (1 / 16.f);
+
+		for (int x = minx; x < maxx; x++)
+		{
+			// check if all CXn are non-negative
+			if (int(CX1 | CX2 | CX3) >= 0)
+			{
+				float ZX = zrow + DZx * float(x);
+
+				if (ZX >= zrowp[x])
+				{
+					zrowp[x] = ZX;
+					orowp[x]++;
+				}
+			}
+
+			CX1 -= unsigned(DY12) << 4;
+			CX2 -= unsigned(DY23) << 4;
+			CX3 -= unsigned(DY31) << 4;
+		}
+
+		CY1 += unsigned(DX12) << 4;
+		CY2 += unsigned(DX23) << 4;
+		CY3 += unsigned(DX31) << 4;
+	}
+}
+
+static int getBand(int row, int resolution)
+{
+	// inverse of the band boundary computation in rasterizeBandTask
+	return ((row + 1) * kOverdrawBands - 1) / resolution;
+}
+
+static void computeBandsTask(void* task_data, size_t task_index)
+{
+	const OverdrawBandContext& context = *static_cast<const OverdrawBandContext*>(task_data);
+
+	size_t view = task_index / kOverdrawBinTasks;
+	size_t chunk = task_index % kOverdrawBinTasks;
+
+	size_t triangle_count = context.index_count / 3;
+	size_t begin = triangle_count * chunk / kOverdrawBinTasks;
+	size_t end = triangle_count * (chunk + 1) / kOverdrawBinTasks;
+
+	int resolution = context.resolution;
+
+	const float* positions = context.positions + view * context.vertex_count * 3;
+	unsigned char* bands = context.bands + view * triangle_count * 2;
+	size_t* counts = context.bin_offsets + task_index * kOverdrawBands;
+
+	for (size_t i = begin; i < end; ++i)
+	{
+		const float* v0 = positions + context.indices[i * 3 + 0] * 3;
+		const float* v1 = positions + context.indices[i * 3 + 1] * 3;
+		const float* v2 = positions + context.indices[i * 3 + 2] * 3;
+
+		// this uses the same rounding as rasterizeBand so that the band range includes all rows the triangle can cover; triangles that don't cover any pixel centers are skipped
+		int X1 = int(16.0f * v0[0] + 0.5f), Y1 = int(16.0f * v0[1] + 0.5f);
+		int X2 = int(16.0f * v1[0] + 0.5f), Y2 = int(16.0f * v1[1] + 0.5f);
+		int X3 = int(16.0f * v2[0] + 0.5f), Y3 = int(16.0f * v2[1] + 0.5f);
+
+		int minx = max((min(X1, min(X2, X3)) + 7) >> 4, 0);
+		int maxx = min((max(X1, max(X2, X3)) + 7) >> 4, resolution);
+		int miny = max((min(Y1, min(Y2, Y3)) + 7) >> 4, 0);
+		int maxy = min((max(Y1, max(Y2, Y3)) + 7) >> 4, resolution);
+
+		if (minx < maxx && miny < maxy)
+		{
+			int band_first = getBand(miny, resolution);
+			int band_last = getBand(maxy - 1, resolution);
+
+			bands[i * 2 + 0] = (unsigned char)band_first;
+			bands[i * 2 + 1] = (unsigned char)band_last;
+
+			for (int b = band_first; b <= band_last; ++b)
+				counts[b]++;
+		}
+		else
+		{
+			bands[i * 2 + 0] = (unsigned char)kOverdrawBands;
+			bands[i * 2 + 1] = 0;
+		}
+	}
+}
+
+static void scatterBandsTask(void* task_data, size_t task_index)
+{
+	const OverdrawBandContext& context = *static_cast<const OverdrawBandContext*>(task_data);
+
+	size_t view = task_index / kOverdrawBinTasks;
+	size_t chunk = task_index % kOverdrawBinTasks;
+
+	size_t triangle_count = context.index_count / 3;
+	size_t begin = triangle_count * chunk / kOverdrawBinTasks;
+	size_t end = triangle_count * (chunk + 1) / kOverdrawBinTasks;
+
+	const unsigned char* bands = context.bands + view * triangle_count * 2;
+	size_t* offsets = context.bin_offsets + task_index * kOverdrawBands;
+
+	for (size_t i = begin; i < end; ++i)
+		for (int b = bands[i * 2 + 0]; b <= bands[i * 2 + 1]; ++b)
+			context.band_triangles[offsets[b]++] = unsigned(i);
+}
+
+static void rasterizeBandTask(void* task_data, size_t task_index)
+{
+	const OverdrawBandContext& context = *static_cast<const OverdrawBandContext*>(task_data);
+	meshopt_Allocator::Scope scope(context.callbacks);
+
+	size_t view = task_index / kOverdrawBands;
+	int band = int(task_index % kOverdrawBands);
+
+	int resolution = context.resolution;
+	size_t pitch = context.pitch;
+
+	int band_begin = resolution * band / kOverdrawBands;
+	int band_end = resolution * (band + 1) / kOverdrawBands;
+
+	const float* positions = context.positions + view * context.vertex_count * 3;
+
+	// buffers are allocated for each task and only cover the rows of the band, so memory usage depends on the number of concurrent tasks instead of the view count
+	size_t layer_size = (band_end - band_begin) * pitch;
+
+	meshopt_Allocator allocator;
+
+	float* zbuffer = allocator.allocate<float>(layer_size * 2);
+	unsigned int* obuffer = allocator.allocate<unsigned int>(layer_size * 2);
+
+	memset(zbuffer, 0, layer_size * 2 * sizeof(float));
+	memset(obuffer, 0, layer_size * 2 * sizeof(unsigned int));
+
+	for (size_t k = context.band_offsets[task_index]; k < context.band_offsets[task_index + 1]; ++k)
+	{
+		size_t i = context.band_triangles[k];
+
+		const float* v0 = positions + context.indices[i * 3 + 0] * 3;
+		const float* v1 = positions + context.indices[i * 3 + 1] * 3;
+		const float* v2 = positions + context.indices[i * 3 + 2] * 3;
+
+		rasterizeBand(zbuffer, obuffer, pitch, layer_size, resolution, band_begin, band_end, v0[0], v0[1], v0[2], v1[0], v1[1], v1[2], v2[0], v2[1], v2[2]);
+	}
+
+	unsigned int pixels_covered = 0;
+	unsigned int pixels_shaded = 0;
+
+	for (int s = 0; s < 2; ++s)
+		for (int y = band_begin; y < band_end; ++y)
+			for (int x = 0; x < resolution; ++x)
+			{
+				unsigned int overdraw = obuffer[s * layer_size + (y - band_begin) * pitch + x];
+
+				pixels_covered += overdraw > 0;
+				pixels_shaded += overdraw;
+			}
+
+	context.pixels_covered[task_index] = pixels_covered;
+	context.pixels_shaded[task_index] = pixels_shaded;
+}
+
+static void runBandTasks(meshopt_Scheduler scheduler, void* scheduler_context, void (*task)(void*, size_t), OverdrawBandContext& context, size_t task_count)
+{
+	if (scheduler)
+		scheduler(scheduler_context, task, &context, task_count);
+	else
+		for (size_t i = 0; i < task_count; ++i)
+			task(&context, i);
+}
+
+static void getViewTransform(float* transform, unsigned int view, unsigned int view_count)
+{
+	// the first three views look along the coordinate axes, matching meshopt_analyzeOverdraw; transform rows map positions to screen x, screen y and depth
+	static const float kAxisViews[3][9] = {
+	    {0, 0, 1, 0, 1, 0, 1, 0, 0},
+	    {1, 0, 0, 0, 0, 1, 0, 1, 0},
+	    {0, 1, 0, 1, 0, 0, 0, 0, 1},
+	};
+
+	if (view < 3)
+	{
+		memcpy(transform, kAxisViews[view], sizeof(kAxisViews[view]));
+		return;
+	}
+
+	// the remaining views are distributed over a sphere using a Fibonacci spiral
+	unsigned int index = view - 3;
+	unsigned int count = view_count - 3;
+
+	float dz = 1 - (2 * float(index) + 1) / float(count);
+	float dr = sqrtf(1 - dz * dz);
+	float phi = float(index) * 2.39996323f;
+
+	float d[3] = {dr * cosf(phi), dr * sinf(phi), dz};
+	float up[3] = {0, 0, 0};
+	up[fabsf(dz) < 0.9f ? 2 : 0] = 1;
+
+	// u = normalize(cross(up, d)), v = cross(d, u)
+	float u[3] = {up[1] * d[2] - up[2] * d[1], up[2] * d[0] - up[0] * d[2], up[0] * d[1] - up[1] * d[0]};
+	float ul = sqrtf(u[0] * u[0] + u[1] * u[1] + u[2] * u[2]);
+
+	u[0] /= ul, u[1] /= ul, u[2] /= ul;
+
+	float v[3] = {d[1] * u[2] - d[2] * u[1], d[2] * u[0] - d[0] * u[2], d[0] * u[1] - d[1] * u[0]};
+
+	float result[9] = {u[0], u[1], u[2], v[0], v[1], v[2], d[0], d[1], d[2]};
+	memcpy(transform, result, sizeof(result));
+}
+
 } // namespace meshopt
 
 meshopt_OverdrawStatistics meshopt_analyzeOverdraw(const unsigned int* indices, size_t index_count, const float* vertex_positions, size_t vertex_count, size_t vertex_positions_stride)
@@ -228,3 +629,149 @@ meshopt_OverdrawStatistics meshopt_analyzeOverdraw(const unsigned int* indices,
 
 	return result;
 }
+
+meshopt_OverdrawStatistics meshopt_analyzeOverdrawParallel(const unsigned int* indices, size_t index_count, const float* vertex_positions, size_t vertex_count, size_t vertex_positions_stride, unsigned int resolution, unsigned int view_count, meshopt_Scheduler scheduler, void* scheduler_context)
+{
+	using namespace meshopt;
+
+	assert(index_count % 3 == 0);
+	assert(vertex_positions_stride > 0 && vertex_positions_stride <= 256);
+	assert(vertex_positions_stride % sizeof(float) == 0);
+	assert(resolution > 0 && resolution <= 1024);
+	assert(view_count > 0);
+
+	meshopt_Allocator allocator;
+
+	size_t vertex_stride_float = vertex_positions_stride / sizeof(float);
+
+	meshopt_OverdrawStatistics result = {};
+
+	float minv[3] = {FLT_MAX, FLT_MAX, FLT_MAX};
+	float maxv[3] = {-FLT_MAX, -FLT_MAX, -FLT_MAX};
+
+	for (size_t i = 0; i < vertex_count; ++i)
+	{
+		const float* v = vertex_positions + i * vertex_stride_float;
+
+		for (int j = 0; j < 3; ++j)
+		{
+			minv[j] = min(minv[j], v[j]);
+			maxv[j] = max(maxv[j], v[j]);
+		}
+	}
+
+	float extent = max(maxv[0] - minv[0], max(maxv[1] - minv[1], maxv[2] - minv[2]));
+	float scale = float(resolution) / extent;
+
+	// rotated views need to fit the bounding sphere instead of the bounding box
+	float center[3] = {(minv[0] + maxv[0]) * 0.5f, (minv[1] + maxv[1]) * 0.5f, (minv[2] + maxv[2]) * 0.5f};
+	float radius = 0;
+
+	for (size_t i = 0; i < vertex_count && view_count > 3; ++i)
+	{
+		const float* v = vertex_positions + i * vertex_stride_float;
+
+		float d2 = (v[0] - center[0]) * (v[0] - center[0]) + (v[1] - center[1]) * (v[1] - center[1]) + (v[2] - center[2]) * (v[2] - center[2]);
+		radius = max(radius, d2);
+	}
+
+	radius = sqrtf(radius);
+
+	float half = float(resolution) * 0.5f;
+	float sphere_scale = radius == 0 ? 0 : half / radius;
+
+	// transform vertices into the view space of each view
+	float* positions = allocator.allocate<float>(vertex_count * 3 * view_count);
+
+	for (unsigned int view = 0; view < view_count; ++view)
+	{
+		float transform[9];
+		getViewTransform(transform, view, view_count);
+
+		float* dest = positions + view * vertex_count * 3;
+
+		for (size_t i = 0; i < vertex_count; ++i)
+		{
+			const float* v = vertex_positions + i * vertex_stride_float;
+
+			for (int k = 0; k < 3; ++k)
+			{
+				const float* t = &transform[k * 3];
+
+				if (view < 3)
+				{
+					// axis views only select one component, which keeps the results consistent with meshopt_analyzeOverdraw
+					int c = t[0] != 0 ? 0 : t[1] != 0 ? 1 : 2;
+					dest[i * 3 + k] = (v[c] - minv[c]) * scale;
+				}
+				else
+				{
+					float p = (v[0] - center[0]) * t[0] + (v[1] - center[1]) * t[1] + (v[2] - center[2]) * t[2];
+					dest[i * 3 + k] = p * sphere_scale + half;
+				}
+			}
+		}
+	}
+
+	// rows are padded to a multiple of 4 pixels for SIMD rasterization
+	size_t pitch = (resolution + 3) & ~3u;
+
+	size_t task_count = view_count * kOverdrawBands;
+
+	OverdrawBandContext context = {};
+	context.callbacks = meshopt_Allocator::getCallbacks();
+	context.indices = indices;
+	context.index_count = index_count;
+	context.positions = positions;
+	context.vertex_count = vertex_count;
+	context.resolution = int(resolution);
+	context.pitch = pitch;
+	context.pixels_covered = allocator.allocate<unsigned int>(task_count);
+	context.pixels_shaded = allocator.allocate<unsigned int>(task_count);
+
+	size_t bin_task_count = view_count * kOverdrawBinTasks;
+
+	context.bands = allocator.allocate<unsigned char>(index_count / 3 * 2 * view_count);
+	context.bin_offsets = allocator.allocate<size_t>(bin_task_count * kOverdrawBands);
+	memset(context.bin_offsets, 0, bin_task_count * kOverdrawBands * sizeof(size_t));
+
+	runBandTasks(scheduler, scheduler_context, computeBandsTask, context, bin_task_count);
+
+	// band lists are laid out by view and band; each band gets triangles from all binning tasks in order
+	context.band_offsets = allocator.allocate<size_t>(task_count + 1);
+
+	size_t offset = 0;
+
+	for (size_t i = 0; i < task_count; ++i)
+	{
+		size_t view = i / kOverdrawBands;
+		size_t band = i % kOverdrawBands;
+
+		context.band_offsets[i] = offset;
+
+		for (size_t chunk = 0; chunk < kOverdrawBinTasks; ++chunk)
+		{
+			size_t& count = context.bin_offsets[(view * kOverdrawBinTasks + chunk) * kOverdrawBands + band];
+
+			size_t start = offset;
+			offset += count;
+			count = start;
+		}
+	}
+
+	context.band_offsets[task_count] = offset;
+	context.band_triangles = allocator.allocate<unsigned int>(offset);
+
+	runBandTasks(scheduler, scheduler_context, scatterBandsTask, context, bin_task_count);
+	runBandTasks(scheduler, scheduler_context, rasterizeBandTask, context, task_count);
+
+	for (size_t i = 0; i < task_count; ++i)
+	{
+		result.pixels_covered += context.pixels_covered[i];
+		result.pixels_shaded += context.pixels_shaded[i];
+	}
+
+	result.overdraw = result.pixels_covered ? float(result.pixels_shaded) / float(result.pixels_covered) : 0.f;
+
+	return result;
+}
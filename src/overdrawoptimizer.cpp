@@ -5,12 +5,16 @@
 #include <math.h>
 #include <string.h>
 
+#if defined(__SSE2__) || defined(_M_X64)
+#include <emmintrin.h>
+#endif
+
 // This work is based on:
 // Pedro Sander, Diego Nehab and Joshua Barczak. Fast Triangle Reordering for Vertex Locality and Reduced Overdraw. 2007
 namespace meshopt
 {
 
-static void calculateSortData(float* sort_data, const unsigned int* indices, size_t index_count, const float* vertex_positions, size_t vertex_positions_stride, const unsigned int* clusters, size_t cluster_count)
+static void calculateMeshCentroid(float* result, const unsigned int* indices, size_t index_count, const float* vertex_positions, size_t vertex_positions_stride)
 {
 	size_t vertex_stride_float = vertex_positions_stride / sizeof(float);
 
@@ -25,66 +29,78 @@ static void calculateSortData(float* sort_data, const unsigned int* indices, siz
 		mesh_centroid[2] += p[2];
 	}
 
-	mesh_centroid[0] /= index_count;
-	mesh_centroid[1] /= index_count;
-	mesh_centroid[2] /= index_count;
+	result[0] = mesh_centroid[0];
+	result[1] = mesh_centroid[1];
+	result[2] = mesh_centroid[2];
+}
+
+static float calculateClusterSortData(const unsigned int* indices, size_t cluster_begin, size_t cluster_end, const float* vertex_positions, size_t vertex_positions_stride, const float* mesh_centroid)
+{
+	size_t vertex_stride_float = vertex_positions_stride / sizeof(float);
 
-	for (size_t cluster = 0; cluster < cluster_count; ++cluster)
+	float cluster_area = 0;
+	float cluster_centroid[3] = {};
+	float cluster_normal[3] = {};
+
+	for (size_t i = cluster_begin; i < cluster_end; i += 3)
 	{
-		size_t cluster_begin = clusters[cluster] * 3;
-		size_t cluster_end = (cluster + 1 < cluster_count) ? clusters[cluster + 1] * 3 : index_count;
-		assert(cluster_begin < cluster_end);
+		const float* p0 = vertex_positions + vertex_stride_float * indices[i + 0];
+		const float* p1 = vertex_positions + vertex_stride_float * indices[i + 1];
+		const float* p2 = vertex_positions + vertex_stride_float * indices[i + 2];
+
+		float p10[3] = {p1[0] - p0[0], p1[1] - p0[1], p1[2] - p0[2]};
+		float p20[3] = {p2[0] - p0[0], p2[1] - p0[1], p2[2] - p0[2]};
+
+		float normalx = p10[1] * p20[2] - p10[2] * p20[1];
+		float normaly = p10[2] * p20[0] - p10[0] * p20[2];
+		float normalz = p10[0] * p20[1] - p10[1] * p20[0];
+
+		float area = sqrtf(normalx * normalx + normaly * normaly + normalz * normalz);
+
+		cluster_centroid[0] += (p0[0] + p1[0] + p2[0]) * (area / 3);
+		cluster_centroid[1] += (p0[1] + p1[1] + p2[1]) * (area / 3);
+		cluster_centroid[2] += (p0[2] + p1[2] + p2[2]) * (area / 3);
+		cluster_normal[0] += normalx;
+		cluster_normal[1] += normaly;
+		cluster_normal[2] += normalz;
+		cluster_area += area;
+	}
 
-		float cluster_area = 0;
-		float cluster_centroid[3] = {};
-		float cluster_normal[3] = {};
+	float inv_cluster_area = cluster_area == 0 ? 0 : 1 / cluster_area;
 
-		for (size_t i = cluster_begin; i < cluster_end; i += 3)
-		{
-			const float* p0 = vertex_positions + vertex_stride_float * indices[i + 0];
-			const float* p1 = vertex_positions + vertex_stride_float * indices[i + 1];
-			const float* p2 = vertex_positions + vertex_stride_float * indices[i + 2];
-
-			float p10[3] = {p1[0] - p0[0], p1[1] - p0[1], p1[2] - p0[2]};
-			float p20[3] = {p2[0] - p0[0], p2[1] - p0[1], p2[2] - p0[2]};
-
-			float normalx = p10[1] * p20[2] - p10[2] * p20[1];
-			float normaly = p10[2] * p20[0] - p10[0] * p20[2];
-			float normalz = p10[0] * p20[1] - p10[1] * p20[0];
-
-			float area = sqrtf(normalx * normalx + normaly * normaly + normalz * normalz);
-
-			cluster_centroid[0] += (p0[0] + p1[0] + p2[0]) * (area / 3);
-			cluster_centroid[1] += (p0[1] + p1[1] + p2[1]) * (area / 3);
-			cluster_centroid[2] += (p0[2] + p1[2] + p2[2]) * (area / 3);
-			cluster_normal[0] += normalx;
-			cluster_normal[1] += normaly;
-			cluster_normal[2] += normalz;
-			cluster_area += area;
-		}
+	cluster_centroid[0] *= inv_cluster_area;
+	cluster_centroid[1] *= inv_cluster_area;
+	cluster_centroid[2] *= inv_cluster_area;
 
-		float inv_cluster_area = cluster_area == 0 ? 0 : 1 / cluster_area;
+	float cluster_normal_length = sqrtf(cluster_normal[0] * cluster_normal[0] + cluster_normal[1] * cluster_normal[1] + cluster_normal[2] * cluster_normal[2]);
+	float inv_cluster_normal_length = cluster_normal_length == 0 ? 0 : 1 / cluster_normal_length;
 
-		cluster_centroid[0] *= inv_cluster_area;
-		cluster_centroid[1] *= inv_cluster_area;
-		cluster_centroid[2] *= inv_cluster_area;
+	cluster_normal[0] *= inv_cluster_normal_length;
+	cluster_normal[1] *= inv_cluster_normal_length;
+	cluster_normal[2] *= inv_cluster_normal_length;
 
-		float cluster_normal_length = sqrtf(cluster_normal[0] * cluster_normal[0] + cluster_normal[1] * cluster_normal[1] + cluster_normal[2] * cluster_normal[2]);
-		float inv_cluster_normal_length = cluster_normal_length == 0 ? 0 : 1 / cluster_normal_length;
+	float centroid_vector[3] = {cluster_centroid[0] - mesh_centroid[0], cluster_centroid[1] - mesh_centroid[1], cluster_centroid[2] - mesh_centroid[2]};
 
-		cluster_normal[0] *= inv_cluster_normal_length;
-		cluster_normal[1] *= inv_cluster_normal_length;
-		cluster_normal[2] *= inv_cluster_normal_length;
+	return centroid_vector[0] * cluster_normal[0] + centroid_vector[1] * cluster_normal[1] + centroid_vector[2] * cluster_normal[2];
+}
+
+static void calculateSortData(float* sort_data, const unsigned int* indices, size_t index_count, const float* vertex_positions, size_t vertex_positions_stride, const unsigned int* clusters, size_t cluster_begin, size_t cluster_end, size_t cluster_count, const float* mesh_centroid)
+{
+	MESHOPTIMIZER_ZONE("calculateSortData");
 
-		float centroid_vector[3] = {cluster_centroid[0] - mesh_centroid[0], cluster_centroid[1] - mesh_centroid[1], cluster_centroid[2] - mesh_centroid[2]};
+	for (size_t cluster = cluster_begin; cluster < cluster_end; ++cluster)
+	{
+		size_t cluster_begin_index = clusters[cluster] * 3;
+		size_t cluster_end_index = (cluster + 1 < cluster_count) ? clusters[cluster + 1] * 3 : index_count;
+		assert(cluster_begin_index < cluster_end_index);
 
-		sort_data[cluster] = centroid_vector[0] * cluster_normal[0] + centroid_vector[1] * cluster_normal[1] + centroid_vector[2] * cluster_normal[2];
+		sort_data[cluster] = calculateClusterSortData(indices, cluster_begin_index, cluster_end_index, vertex_positions, vertex_positions_stride, mesh_centroid);
 	}
 }
 
-static void calculateSortOrderRadix(unsigned int* sort_order, const float* sort_data, unsigned short* sort_keys, size_t cluster_count)
+static float getSortDataMax(const float* sort_data, size_t cluster_count)
 {
-	// compute sort data bounds and renormalize, using fixed point snorm
+	// compute sort data bounds for renormalization
 	float sort_data_max = 1e-3f;
 
 	for (size_t i = 0; i < cluster_count; ++i)
@@ -94,6 +110,16 @@ static void calculateSortOrderRadix(unsigned int* sort_order, const float* sort_
 		sort_data_max = (sort_data_max < dpa) ? dpa : sort_data_max;
 	}
 
+	return sort_data_max;
+}
+
+static void calculateSortOrderRadix(unsigned int* sort_order, const float* sort_data, unsigned short* sort_keys, size_t cluster_count)
+{
+	MESHOPTIMIZER_ZONE("calculateSortOrderRadix");
+
+	// compute sort data bounds and renormalize, using fixed point snorm
+	float sort_data_max = getSortDataMax(sort_data, cluster_count);
+
 	const int sort_bits = 11;
 
 	for (size_t i = 0; i < cluster_count; ++i)
@@ -132,6 +158,59 @@ static void calculateSortOrderRadix(unsigned int* sort_order, const float* sort_
 	}
 }
 
+static void calculateSortOrderRadixWide(unsigned int* sort_order, const float* sort_data, unsigned int* sort_keys, unsigned int* sort_temp, size_t cluster_count)
+{
+	MESHOPTIMIZER_ZONE("calculateSortOrderRadixWide");
+
+	// compute sort data bounds and renormalize, using fixed point snorm with twice the precision of calculateSortOrderRadix
+	float sort_data_max = getSortDataMax(sort_data, cluster_count);
+
+	const int sort_bits = 11;
+
+	for (size_t i = 0; i < cluster_count; ++i)
+	{
+		// note that we flip distribution since high dot product should come first
+		float sort_key = 0.5f - 0.5f * (sort_data[i] / sort_data_max);
+
+		sort_keys[i] = meshopt_quantizeUnorm(sort_key, sort_bits * 2) & ((1 << (sort_bits * 2)) - 1);
+	}
+
+	// two passes of stable counting sort, low bits first
+	for (int pass = 0; pass < 2; ++pass)
+	{
+		const unsigned int* source = pass == 0 ? NULL : sort_temp;
+		unsigned int* target = pass == 0 ? sort_temp : sort_order;
+
+		int shift = pass * sort_bits;
+
+		unsigned int histogram[1 << sort_bits];
+		memset(histogram, 0, sizeof(histogram));
+
+		for (size_t i = 0; i < cluster_count; ++i)
+			histogram[(sort_keys[i] >> shift) & ((1 << sort_bits) - 1)]++;
+
+		size_t histogram_sum = 0;
+
+		for (size_t i = 0; i < 1 << sort_bits; ++i)
+		{
+			size_t count = histogram[i];
+			histogram[i] = unsigned(histogram_sum);
+			histogram_sum += count;
+		}
+
+		assert(histogram_sum == cluster_count);
+
+		for (size_t i = 0; i < cluster_count; ++i)
+		{
+			unsigned int cluster = source ? source[i] : unsigned(i);
+
+			target[histogram[(sort_keys[cluster] >> shift) & ((1 << sort_bits) - 1)]++] = cluster;
+		}
+	}
+}
+
+const unsigned int kCacheSize = 16;
+
 static unsigned int updateCache(unsigned int a, unsigned int b, unsigned int c, unsigned int cache_size, unsigned int* cache_timestamps, unsigned int& timestamp)
 {
 	unsigned int cache_misses = 0;
@@ -160,6 +239,8 @@ static unsigned int updateCache(unsigned int a, unsigned int b, unsigned int c,
 
 static size_t generateHardBoundaries(unsigned int* destination, const unsigned int* indices, size_t index_count, size_t vertex_count, unsigned int cache_size, unsigned int* cache_timestamps)
 {
+	MESHOPTIMIZER_ZONE("generateHardBoundaries");
+
 	memset(cache_timestamps, 0, vertex_count * sizeof(unsigned int));
 
 	unsigned int timestamp = cache_size + 1;
@@ -187,29 +268,91 @@ static size_t generateHardBoundaries(unsigned int* destination, const unsigned i
 	return result;
 }
 
-static size_t generateSoftBoundaries(unsigned int* destination, const unsigned int* indices, size_t index_count, size_t vertex_count, const unsigned int* clusters, size_t cluster_count, unsigned int cache_size, float threshold, unsigned int* cache_timestamps)
+// cache emulation that uses a timestamp per vertex; this is the fastest option when processing the entire mesh on one thread
+struct TimestampCache
 {
-	memset(cache_timestamps, 0, vertex_count * sizeof(unsigned int));
+	unsigned int* timestamps;
+	unsigned int timestamp;
 
-	unsigned int timestamp = 0;
+	void reset()
+	{
+		timestamp += kCacheSize + 1;
+	}
+
+	unsigned int update(unsigned int a, unsigned int b, unsigned int c)
+	{
+		return updateCache(a, b, c, kCacheSize, timestamps, timestamp);
+	}
+};
+
+// cache emulation that tracks the last kCacheSize vertices that missed the cache; this is equivalent to TimestampCache but doesn't need per-vertex state,
+// so parallel tasks can use it without allocating vertex_count elements each
+struct FifoCache
+{
+	unsigned int entries[kCacheSize];
+	size_t offset;
+
+	void reset()
+	{
+		memset(entries, -1, sizeof(entries));
+		offset = 0;
+	}
+
+	unsigned int update(unsigned int v)
+	{
+#if defined(__SSE2__) || defined(_M_X64)
+		__m128i vv = _mm_set1_epi32(int(v));
+		__m128i m0 = _mm_cmpeq_epi32(_mm_loadu_si128(reinterpret_cast<const __m128i*>(&entries[0])), vv);
+		__m128i m1 = _mm_cmpeq_epi32(_mm_loadu_si128(reinterpret_cast<const __m128i*>(&entries[4])), vv);
+		__m128i m2 = _mm_cmpeq_epi32(_mm_loadu_si128(reinterpret_cast<const __m128i*>(&entries[8])), vv);
+		__m128i m3 = _mm_cmpeq_epi32(_mm_loadu_si128(reinterpret_cast<const __m128i*>(&entries[12])), vv);
+
+		unsigned int miss = _mm_movemask_epi8(_mm_or_si128(_mm_or_si128(m0, m1), _mm_or_si128(m2, m3))) == 0;
+#else
+		unsigned int miss = 1;
+
+		for (size_t i = 0; i < kCacheSize; ++i)
+			miss &= entries[i] != v;
+#endif
+
+		// if vertex is not in cache, put it in cache
+		if (miss)
+		{
+			entries[offset] = v;
+			offset = (offset + 1) & (kCacheSize - 1);
+		}
+
+		return miss;
+	}
+
+	unsigned int update(unsigned int a, unsigned int b, unsigned int c)
+	{
+		return update(a) + update(b) + update(c);
+	}
+};
+
+template <typename Cache>
+static size_t generateSoftBoundaries(unsigned int* destination, const unsigned int* indices, size_t index_count, const unsigned int* clusters, size_t cluster_begin, size_t cluster_end, size_t cluster_count, float threshold, Cache& cache)
+{
+	MESHOPTIMIZER_ZONE("generateSoftBoundaries");
 
 	size_t result = 0;
 
-	for (size_t it = 0; it < cluster_count; ++it)
+	for (size_t it = cluster_begin; it < cluster_end; ++it)
 	{
 		size_t start = clusters[it];
 		size_t end = (it + 1 < cluster_count) ? clusters[it + 1] : index_count / 3;
 		assert(start < end);
 
 		// reset cache
-		timestamp += cache_size + 1;
+		cache.reset();
 
 		// measure cluster ACMR
 		unsigned int cluster_misses = 0;
 
 		for (size_t i = start; i < end; ++i)
 		{
-			unsigned int m = updateCache(indices[i * 3 + 0], indices[i * 3 + 1], indices[i * 3 + 2], cache_size, &cache_timestamps[0], timestamp);
+			unsigned int m = cache.update(indices[i * 3 + 0], indices[i * 3 + 1], indices[i * 3 + 2]);
 
 			cluster_misses += m;
 		}
@@ -220,14 +363,14 @@ static size_t generateSoftBoundaries(unsigned int* destination, const unsigned i
 		destination[result++] = unsigned(start);
 
 		// reset cache
-		timestamp += cache_size + 1;
+		cache.reset();
 
 		unsigned int running_misses = 0;
 		unsigned int running_faces = 0;
 
 		for (size_t i = start; i < end; ++i)
 		{
-			unsigned int m = updateCache(indices[i * 3 + 0], indices[i * 3 + 1], indices[i * 3 + 2], cache_size, &cache_timestamps[0], timestamp);
+			unsigned int m = cache.update(indices[i * 3 + 0], indices[i * 3 + 1], indices[i * 3 + 2]);
 
 			running_misses += m;
 			running_faces += 1;
@@ -240,7 +383,7 @@ static size_t generateSoftBoundaries(unsigned int* destination, const unsigned i
 				destination[result++] = unsigned(i + 1);
 
 				// reset cache
-				timestamp += cache_size + 1;
+				cache.reset();
 
 				running_misses = 0;
 				running_faces = 0;
@@ -259,18 +402,77 @@ static size_t generateSoftBoundaries(unsigned int* destination, const unsigned i
 		}
 	}
 
-	assert(result >= cluster_count);
-	assert(result <= index_count / 3);
+	assert(result >= cluster_end - cluster_begin);
 
 	return result;
 }
 
+// number of tasks for the parallel optimizer; this is independent of the scheduler to keep the results deterministic
+const size_t kOverdrawTasks = 64;
+
+struct OverdrawContext
+{
+	const unsigned int* indices;
+	size_t index_count;
+	const float* vertex_positions;
+	size_t vertex_positions_stride;
+	float threshold;
+
+	const unsigned int* hard_clusters;
+	size_t hard_cluster_count;
+	const unsigned int* hard_offsets;
+
+	unsigned int* soft_clusters;
+	unsigned int* soft_counts;
+	float* centroids;
+
+	const unsigned int* clusters;
+	size_t cluster_count;
+	float* sort_data;
+	const float* mesh_centroid;
+};
+
+static void generateSoftBoundariesTask(void* task_data, size_t task_index)
+{
+	const OverdrawContext& context = *static_cast<const OverdrawContext*>(task_data);
+
+	size_t face_count = context.index_count / 3;
+
+	// each task processes a range of hard clusters and writes soft boundaries to the triangle offset of the first one;
+	// since a range of N triangles produces at most N + 1 boundaries (one of which is removed), tasks need one extra element each
+	size_t cluster_begin = context.hard_offsets[task_index];
+	size_t cluster_end = context.hard_offsets[task_index + 1];
+
+	size_t offset = (cluster_begin < context.hard_cluster_count ? context.hard_clusters[cluster_begin] : face_count) + task_index;
+
+	FifoCache cache;
+	context.soft_counts[task_index] = unsigned(generateSoftBoundaries(context.soft_clusters + offset, context.indices, context.index_count, context.hard_clusters, cluster_begin, cluster_end, context.hard_cluster_count, context.threshold, cache));
+
+	// partial mesh centroid sums over a fixed triangle range are computed here to avoid another pass
+	size_t face_begin = face_count * task_index / kOverdrawTasks;
+	size_t face_end = face_count * (task_index + 1) / kOverdrawTasks;
+
+	calculateMeshCentroid(context.centroids + task_index * 3, context.indices + face_begin * 3, (face_end - face_begin) * 3, context.vertex_positions, context.vertex_positions_stride);
+}
+
+static void calculateSortDataTask(void* task_data, size_t task_index)
+{
+	const OverdrawContext& context = *static_cast<const OverdrawContext*>(task_data);
+
+	size_t cluster_begin = context.cluster_count * task_index / kOverdrawTasks;
+	size_t cluster_end = context.cluster_count * (task_index + 1) / kOverdrawTasks;
+
+	calculateSortData(context.sort_data, context.indices, context.index_count, context.vertex_positions, context.vertex_positions_stride, context.clusters, cluster_begin, cluster_end, context.cluster_count, context.mesh_centroid);
+}
+
 } // namespace meshopt
 
 void meshopt_optimizeOverdraw(unsigned int* destination, const unsigned int* indices, size_t index_count, const float* vertex_positions, size_t vertex_count, size_t vertex_positions_stride, float threshold)
 {
 	using namespace meshopt;
 
+	MESHOPTIMIZER_ZONE("meshopt_optimizeOverdraw");
+
 	assert(index_count % 3 == 0);
 	assert(vertex_positions_stride > 0 && vertex_positions_stride <= 256);
 	assert(vertex_positions_stride % sizeof(float) == 0);
@@ -289,24 +491,36 @@ void meshopt_optimizeOverdraw(unsigned int* destination, const unsigned int* ind
 		indices = indices_copy;
 	}
 
-	unsigned int cache_size = 16;
-
 	unsigned int* cache_timestamps = allocator.allocate<unsigned int>(vertex_count);
 
 	// generate hard boundaries from full-triangle cache misses
 	unsigned int* hard_clusters = allocator.allocate<unsigned int>(index_count / 3);
-	size_t hard_cluster_count = generateHardBoundaries(hard_clusters, indices, index_count, vertex_count, cache_size, cache_timestamps);
+	size_t hard_cluster_count = generateHardBoundaries(hard_clusters, indices, index_count, vertex_count, kCacheSize, cache_timestamps);
 
 	// generate soft boundaries
+	memset(cache_timestamps, 0, vertex_count * sizeof(unsigned int));
+	TimestampCache cache = {cache_timestamps, 0};
+
 	unsigned int* soft_clusters = allocator.allocate<unsigned int>(index_count / 3 + 1);
-	size_t soft_cluster_count = generateSoftBoundaries(soft_clusters, indices, index_count, vertex_count, hard_clusters, hard_cluster_count, cache_size, threshold, cache_timestamps);
+	size_t soft_cluster_count = generateSoftBoundaries(soft_clusters, indices, index_count, hard_clusters, 0, hard_cluster_count, hard_cluster_count, threshold, cache);
+	assert(soft_cluster_count <= index_count / 3);
+
+	MESHOPTIMIZER_COUNTER("hard_clusters", hard_cluster_count);
+	MESHOPTIMIZER_COUNTER("soft_clusters", soft_cluster_count);
 
 	const unsigned int* clusters = soft_clusters;
 	size_t cluster_count = soft_cluster_count;
 
 	// fill sort data
+	float mesh_centroid[3];
+	calculateMeshCentroid(mesh_centroid, indices, index_count, vertex_positions, vertex_positions_stride);
+
+	mesh_centroid[0] /= index_count;
+	mesh_centroid[1] /= index_count;
+	mesh_centroid[2] /= index_count;
+
 	float* sort_data = allocator.allocate<float>(cluster_count);
-	calculateSortData(sort_data, indices, index_count, vertex_positions, vertex_positions_stride, clusters, cluster_count);
+	calculateSortData(sort_data, indices, index_count, vertex_positions, vertex_positions_stride, clusters, 0, cluster_count, cluster_count, mesh_centroid);
 
 	// sort clusters using sort data
 	unsigned short* sort_keys = allocator.allocate<unsigned short>(cluster_count);
@@ -331,3 +545,231 @@ void meshopt_optimizeOverdraw(unsigned int* destination, const unsigned int* ind
 
 	assert(offset == index_count);
 }
+
+void meshopt_optimizeOverdrawParallel(unsigned int* destination, const unsigned int* indices, size_t index_count, const float* vertex_positions, size_t vertex_count, size_t vertex_positions_stride, float threshold, meshopt_Scheduler scheduler, void* scheduler_context)
+{
+	using namespace meshopt;
+
+	MESHOPTIMIZER_ZONE("meshopt_optimizeOverdrawParallel");
+
+	assert(index_count % 3 == 0);
+	assert(vertex_positions_stride > 0 && vertex_positions_stride <= 256);
+	assert(vertex_positions_stride % sizeof(float) == 0);
+
+	meshopt_Allocator allocator;
+
+	// guard for empty meshes
+	if (index_count == 0 || vertex_count == 0)
+		return;
+
+	// support in-place optimization
+	if (destination == indices)
+	{
+		unsigned int* indices_copy = allocator.allocate<unsigned int>(index_count);
+		memcpy(indices_copy, indices, index_count * sizeof(unsigned int));
+		indices = indices_copy;
+	}
+
+	size_t face_count = index_count / 3;
+
+	// generate hard boundaries from full-triangle cache misses; this depends on the cache state of the entire prefix so it runs serially
+	unsigned int* cache_timestamps = allocator.allocate<unsigned int>(vertex_count);
+
+	unsigned int* hard_clusters = allocator.allocate<unsigned int>(face_count);
+	size_t hard_cluster_count = generateHardBoundaries(hard_clusters, indices, index_count, vertex_count, kCacheSize, cache_timestamps);
+
+	// split hard clusters into task ranges with similar triangle counts
+	unsigned int* hard_offsets = allocator.allocate<unsigned int>(kOverdrawTasks + 1);
+
+	for (size_t i = 0, cluster = 0; i <= kOverdrawTasks; ++i)
+	{
+		size_t face_begin = face_count * i / kOverdrawTasks;
+
+		while (cluster < hard_cluster_count && hard_clusters[cluster] < face_begin)
+			cluster++;
+
+		hard_offsets[i] = unsigned(i == kOverdrawTasks ? hard_cluster_count : cluster);
+	}
+
+	// generate soft boundaries for each hard cluster range in parallel
+	unsigned int* soft_clusters = allocator.allocate<unsigned int>(face_count + kOverdrawTasks);
+	unsigned int* soft_counts = allocator.allocate<unsigned int>(kOverdrawTasks);
+	float* centroids = allocator.allocate<float>(kOverdrawTasks * 3);
+
+	OverdrawContext context = {};
+	context.indices = indices;
+	context.index_count = index_count;
+	context.vertex_positions = vertex_positions;
+	context.vertex_positions_stride = vertex_positions_stride;
+	context.threshold = threshold;
+	context.hard_clusters = hard_clusters;
+	context.hard_cluster_count = hard_cluster_count;
+	context.hard_offsets = hard_offsets;
+	context.soft_clusters = soft_clusters;
+	context.soft_counts = soft_counts;
+	context.centroids = centroids;
+
+	if (scheduler)
+		scheduler(scheduler_context, generateSoftBoundariesTask, &context, kOverdrawTasks);
+	else
+		for (size_t i = 0; i < kOverdrawTasks; ++i)
+			generateSoftBoundariesTask(&context, i);
+
+	// compact soft boundaries; each task range starts at or after the compacted position so we can move data in place
+	size_t cluster_count = 0;
+
+	for (size_t i = 0; i < kOverdrawTasks; ++i)
+	{
+		size_t offset = (hard_offsets[i] < hard_cluster_count ? hard_clusters[hard_offsets[i]] : face_count) + i;
+		assert(offset >= cluster_count);
+
+		memmove(soft_clusters + cluster_count, soft_clusters + offset, soft_counts[i] * sizeof(unsigned int));
+		cluster_count += soft_counts[i];
+	}
+
+	assert(cluster_count >= hard_cluster_count && cluster_count <= face_count);
+
+	MESHOPTIMIZER_COUNTER("hard_clusters", hard_cluster_count);
+	MESHOPTIMIZER_COUNTER("soft_clusters", cluster_count);
+
+	// partial centroid sums are added in a fixed order so that the result doesn't depend on the scheduler
+	float mesh_centroid[3] = {};
+
+	for (size_t i = 0; i < kOverdrawTasks; ++i)
+	{
+		mesh_centroid[0] += centroids[i * 3 + 0];
+		mesh_centroid[1] += centroids[i * 3 + 1];
+		mesh_centroid[2] += centroids[i * 3 + 2];
+	}
+
+	mesh_centroid[0] /= index_count;
+	mesh_centroid[1] /= index_count;
+	mesh_centroid[2] /= index_count;
+
+	// fill sort data in parallel
+	float* sort_data = allocator.allocate<float>(cluster_count);
+
+	context.clusters = soft_clusters;
+	context.cluster_count = cluster_count;
+	context.sort_data = sort_data;
+	context.mesh_centroid = mesh_centroid;
+
+	if (scheduler)
+		scheduler(scheduler_context, calculateSortDataTask, &context, kOverdrawTasks);
+	else
+		for (size_t i = 0; i < kOverdrawTasks; ++i)
+			calculateSortDataTask(&context, i);
+
+	// sort clusters using sort data; 22-bit keys keep the order precise for meshes with many clusters
+	unsigned int* sort_keys = allocator.allocate<unsigned int>(cluster_count);
+	unsigned int* sort_temp = allocator.allocate<unsigned int>(cluster_count);
+	unsigned int* sort_order = allocator.allocate<unsigned int>(cluster_count);
+	calculateSortOrderRadixWide(sort_order, sort_data, sort_keys, sort_temp, cluster_count);
+
+	// fill output buffer
+	size_t offset = 0;
+
+	for (size_t it = 0; it < cluster_count; ++it)
+	{
+		unsigned int cluster = sort_order[it];
+		assert(cluster < cluster_count);
+
+		size_t cluster_begin = soft_clusters[cluster] * 3;
+		size_t cluster_end = (cluster + 1 < cluster_count) ? soft_clusters[cluster + 1] * 3 : index_count;
+		assert(cluster_begin < cluster_end);
+
+		memcpy(destination + offset, indices + cluster_begin, (cluster_end - cluster_begin) * sizeof(unsigned int));
+		offset += cluster_end - cluster_begin;
+	}
+
+	assert(offset == index_count);
+}
+
+void meshopt_optimizeOverdrawRange(unsigned int* indices, size_t index_count, const float* vertex_positions, size_t vertex_count, size_t vertex_positions_stride, size_t range_offset, size_t range_count, float threshold)
+{
+	using namespace meshopt;
+
+	MESHOPTIMIZER_ZONE("meshopt_optimizeOverdrawRange");
+
+	assert(index_count % 3 == 0);
+	assert(range_offset % 3 == 0 && range_count % 3 == 0);
+	assert(range_offset + range_count <= index_count);
+	assert(vertex_positions_stride > 0 && vertex_positions_stride <= 256);
+	assert(vertex_positions_stride % sizeof(float) == 0);
+	(void)index_count;
+
+	meshopt_Allocator allocator;
+
+	// guard for empty ranges
+	if (range_count == 0 || vertex_count == 0)
+		return;
+
+	unsigned int* destination = indices + range_offset;
+
+	unsigned int* range = allocator.allocate<unsigned int>(range_count);
+	memcpy(range, destination, range_count * sizeof(unsigned int));
+
+	size_t face_count = range_count / 3;
+
+	// generate hard boundaries from full-triangle cache misses; FifoCache doesn't need per-vertex state so the cost only depends on the range size
+	FifoCache cache;
+	cache.reset();
+
+	unsigned int* hard_clusters = allocator.allocate<unsigned int>(face_count);
+	size_t hard_cluster_count = 0;
+
+	for (size_t i = 0; i < face_count; ++i)
+	{
+		assert(range[i * 3 + 0] < vertex_count && range[i * 3 + 1] < vertex_count && range[i * 3 + 2] < vertex_count);
+
+		unsigned int m = cache.update(range[i * 3 + 0], range[i * 3 + 1], range[i * 3 + 2]);
+
+		if (i == 0 || m == 3)
+			hard_clusters[hard_cluster_count++] = unsigned(i);
+	}
+
+	// generate soft boundaries
+	unsigned int* soft_clusters = allocator.allocate<unsigned int>(face_count + 1);
+	size_t soft_cluster_count = generateSoftBoundaries(soft_clusters, range, range_count, hard_clusters, 0, hard_cluster_count, hard_cluster_count, threshold, cache);
+	assert(soft_cluster_count <= face_count);
+
+	MESHOPTIMIZER_COUNTER("hard_clusters", hard_cluster_count);
+	MESHOPTIMIZER_COUNTER("soft_clusters", soft_cluster_count);
+
+	const unsigned int* clusters = soft_clusters;
+	size_t cluster_count = soft_cluster_count;
+
+	// fill sort data; clusters are sorted relative to the centroid of the range
+	float range_centroid[3];
+	calculateMeshCentroid(range_centroid, range, range_count, vertex_positions, vertex_positions_stride);
+
+	range_centroid[0] /= range_count;
+	range_centroid[1] /= range_count;
+	range_centroid[2] /= range_count;
+
+	float* sort_data = allocator.allocate<float>(cluster_count);
+	calculateSortData(sort_data, range, range_count, vertex_positions, vertex_positions_stride, clusters, 0, cluster_count, cluster_count, range_centroid);
+
+	// sort clusters using sort data
+	unsigned short* sort_keys = allocator.allocate<unsigned short>(cluster_count);
+	unsigned int* sort_order = allocator.allocate<unsigned int>(cluster_count);
+	calculateSortOrderRadix(sort_order, sort_data, sort_keys, cluster_count);
+
+	// fill output range
+	size_t offset = 0;
+
+	for (size_t it = 0; it < cluster_count; ++it)
+	{
+		unsigned int cluster = sort_order[it];
+		assert(cluster < cluster_count);
+
+		size_t cluster_begin = clusters[cluster] * 3;
+		size_t cluster_end = (cluster + 1 < cluster_count) ? clusters[cluster + 1] * 3 : range_count;
+		assert(cluster_begin < cluster_end);
+
+		memcpy(destination + offset, range + cluster_begin, (cluster_end - cluster_begin) * sizeof(unsigned int));
+		offset += cluster_end - cluster_begin;
+	}
+
+	assert(offset == range_count);
+}
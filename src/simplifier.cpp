@@ -32,6 +32,8 @@ struct EdgeAdjacency
 
 static void buildEdgeAdjacency(EdgeAdjacency& adjacency, const unsigned int* indices, size_t index_count, size_t vertex_count, meshopt_Allocator& allocator)
 {
+	MESHOPTIMIZER_ZONE("buildEdgeAdjacency");
+
 	size_t face_count = index_count / 3;
 
 	// allocate arrays
@@ -152,6 +154,8 @@ static T* hashLookup2(T* table, size_t buckets, const Hash& hash, const T& key,
 
 static void buildPositionRemap(unsigned int* remap, unsigned int* wedge, const float* vertex_positions_data, size_t vertex_count, size_t vertex_positions_stride, meshopt_Allocator& allocator)
 {
+	MESHOPTIMIZER_ZONE("buildPositionRemap");
+
 	PositionHasher hasher = {vertex_positions_data, vertex_positions_stride / sizeof(float)};
 
 	size_t table_size = hashBuckets2(vertex_count);
@@ -269,6 +273,8 @@ static size_t countOpenEdges(const EdgeAdjacency& adjacency, unsigned int vertex
 
 static void classifyVertices(unsigned char* result, unsigned int* loop, size_t vertex_count, const EdgeAdjacency& adjacency, const unsigned int* remap, const unsigned int* wedge)
 {
+	MESHOPTIMIZER_ZONE("classifyVertices");
+
 	for (size_t i = 0; i < vertex_count; ++i)
 		loop[i] = ~0u;
 
@@ -416,6 +422,8 @@ struct Quadric
 	float w;
 };
 
+const size_t kMaxAttributes = 16;
+
 struct Collapse
 {
 	unsigned int v0;
@@ -457,7 +465,7 @@ static void quadricAdd(Quadric& Q, const Quadric& R)
 	Q.w += R.w;
 }
 
-static float quadricError(const Quadric& Q, const Vector3& v)
+static float quadricEval(const Quadric& Q, const Vector3& v)
 {
 	float rx = Q.b0;
 	float ry = Q.b1;
@@ -480,6 +488,31 @@ static float quadricError(const Quadric& Q, const Vector3& v)
 	r += ry * v.y;
 	r += rz * v.z;
 
+	return r;
+}
+
+static float quadricError(const Quadric& Q, const Vector3& v)
+{
+	float r = quadricEval(Q, v);
+	float s = Q.w == 0.f ? 0.f : 1.f / Q.w;
+
+	return fabsf(r) * s;
+}
+
+static float quadricError(const Quadric& Q, const float* G, size_t attribute_count, const Vector3& v, const float* va)
+{
+	float r = quadricEval(Q, v);
+
+	// attribute error for each attribute is sum(w * (dot(g, v) + d - a)^2); the squared gradient terms are folded into Q
+	for (size_t k = 0; k < attribute_count; ++k)
+	{
+		const float* g = G + k * 4;
+		float a = va[k];
+
+		r += a * a * Q.w;
+		r -= 2 * a * (g[0] * v.x + g[1] * v.y + g[2] * v.z + g[3]);
+	}
+
 	float s = Q.w == 0.f ? 0.f : 1.f / Q.w;
 
 	return fabsf(r) * s;
@@ -555,8 +588,62 @@ static void quadricFromTriangleEdge(Quadric& Q, const Vector3& p0, const Vector3
 	quadricFromPlane(Q, normal.x, normal.y, normal.z, -distance, length * weight);
 }
 
+static void quadricFromAttributes(Quadric& Q, float* G, const Vector3& p0, const Vector3& p1, const Vector3& p2, const float* va0, const float* va1, const float* va2, size_t attribute_count)
+{
+	Vector3 p10 = {p1.x - p0.x, p1.y - p0.y, p1.z - p0.z};
+	Vector3 p20 = {p2.x - p0.x, p2.y - p0.y, p2.z - p0.z};
+
+	// normal = cross(p1 - p0, p2 - p0)
+	Vector3 normal = {p10.y * p20.z - p10.z * p20.y, p10.z * p20.x - p10.x * p20.z, p10.x * p20.y - p10.y * p20.x};
+	float normal2 = normal.x * normal.x + normal.y * normal.y + normal.z * normal.z;
+
+	memset(&Q, 0, sizeof(Quadric));
+	memset(G, 0, attribute_count * 4 * sizeof(float));
+
+	if (normal2 == 0.f)
+		return;
+
+	// attribute gradient is orthogonal to the normal: g = ((a1 - a0) * cross(p20, n) + (a2 - a0) * cross(n, p10)) / |n|^2
+	Vector3 c20 = {p20.y * normal.z - p20.z * normal.y, p20.z * normal.x - p20.x * normal.z, p20.x * normal.y - p20.y * normal.x};
+	Vector3 c10 = {normal.y * p10.z - normal.z * p10.y, normal.z * p10.x - normal.x * p10.z, normal.x * p10.y - normal.y * p10.x};
+
+	// weight matches the one used by quadricFromTriangle so that position and attribute errors are comparable
+	float w = sqrtf(sqrtf(normal2));
+	float inv = 1.f / normal2;
+
+	Q.w = w;
+
+	for (size_t k = 0; k < attribute_count; ++k)
+	{
+		float a0 = va0[k], a10 = va1[k] - a0, a20 = va2[k] - a0;
+
+		float gx = (a10 * c20.x + a20 * c10.x) * inv;
+		float gy = (a10 * c20.y + a20 * c10.y) * inv;
+		float gz = (a10 * c20.z + a20 * c10.z) * inv;
+		float gd = a0 - (gx * p0.x + gy * p0.y + gz * p0.z);
+
+		Q.a00 += w * gx * gx;
+		Q.a11 += w * gy * gy;
+		Q.a22 += w * gz * gz;
+		Q.a10 += w * gx * gy;
+		Q.a20 += w * gx * gz;
+		Q.a21 += w * gy * gz;
+		Q.b0 += w * gx * gd;
+		Q.b1 += w * gy * gd;
+		Q.b2 += w * gz * gd;
+		Q.c += w * gd * gd;
+
+		G[k * 4 + 0] = w * gx;
+		G[k * 4 + 1] = w * gy;
+		G[k * 4 + 2] = w * gz;
+		G[k * 4 + 3] = w * gd;
+	}
+}
+
 static void fillFaceQuadrics(Quadric* vertex_quadrics, const unsigned int* indices, size_t index_count, const Vector3* vertex_positions, const unsigned int* remap)
 {
+	MESHOPTIMIZER_ZONE("fillFaceQuadrics");
+
 	for (size_t i = 0; i < index_count; i += 3)
 	{
 		unsigned int i0 = indices[i + 0];
@@ -574,6 +661,8 @@ static void fillFaceQuadrics(Quadric* vertex_quadrics, const unsigned int* indic
 
 static void fillEdgeQuadrics(Quadric* vertex_quadrics, const unsigned int* indices, size_t index_count, const Vector3* vertex_positions, const unsigned int* remap, const unsigned char* vertex_kind, const unsigned int* loop)
 {
+	MESHOPTIMIZER_ZONE("fillEdgeQuadrics");
+
 	for (size_t i = 0; i < index_count; i += 3)
 	{
 		static const int next[3] = {1, 2, 0};
@@ -609,8 +698,39 @@ static void fillEdgeQuadrics(Quadric* vertex_quadrics, const unsigned int* indic
 	}
 }
 
+static void fillAttributeQuadrics(Quadric* attribute_quadrics, float* attribute_gradients, const unsigned int* indices, size_t index_count, const Vector3* vertex_positions, const float* vertex_attributes, size_t attribute_count)
+{
+	MESHOPTIMIZER_ZONE("fillAttributeQuadrics");
+
+	float G[kMaxAttributes * 4];
+
+	for (size_t i = 0; i < index_count; i += 3)
+	{
+		unsigned int i0 = indices[i + 0];
+		unsigned int i1 = indices[i + 1];
+		unsigned int i2 = indices[i + 2];
+
+		Quadric Q;
+		quadricFromAttributes(Q, G, vertex_positions[i0], vertex_positions[i1], vertex_positions[i2], &vertex_attributes[i0 * attribute_count], &vertex_attributes[i1 * attribute_count], &vertex_attributes[i2 * attribute_count], attribute_count);
+
+		// unlike position quadrics, attribute quadrics are accumulated per vertex since attribute values are discontinuous across seams
+		quadricAdd(attribute_quadrics[i0], Q);
+		quadricAdd(attribute_quadrics[i1], Q);
+		quadricAdd(attribute_quadrics[i2], Q);
+
+		for (size_t k = 0; k < attribute_count * 4; ++k)
+		{
+			attribute_gradients[i0 * attribute_count * 4 + k] += G[k];
+			attribute_gradients[i1 * attribute_count * 4 + k] += G[k];
+			attribute_gradients[i2 * attribute_count * 4 + k] += G[k];
+		}
+	}
+}
+
 static size_t pickEdgeCollapses(Collapse* collapses, const unsigned int* indices, size_t index_count, const unsigned int* remap, const unsigned char* vertex_kind, const unsigned int* loop)
 {
+	MESHOPTIMIZER_ZONE("pickEdgeCollapses");
+
 	size_t collapse_count = 0;
 
 	for (size_t i = 0; i < index_count; i += 3)
@@ -667,8 +787,10 @@ static size_t pickEdgeCollapses(Collapse* collapses, const unsigned int* indices
 	return collapse_count;
 }
 
-static void rankEdgeCollapses(Collapse* collapses, size_t collapse_count, const Vector3* vertex_positions, const Quadric* vertex_quadrics, const unsigned int* remap)
+static void rankEdgeCollapses(Collapse* collapses, size_t collapse_count, const Vector3* vertex_positions, const Quadric* vertex_quadrics, const Quadric* attribute_quadrics, const float* attribute_gradients, const float* vertex_attributes, size_t attribute_count, const unsigned int* remap)
 {
+	MESHOPTIMIZER_ZONE("rankEdgeCollapses");
+
 	for (size_t i = 0; i < collapse_count; ++i)
 	{
 		Collapse& c = collapses[i];
@@ -687,6 +809,13 @@ static void rankEdgeCollapses(Collapse* collapses, size_t collapse_count, const
 		float ei = quadricError(qi, vertex_positions[i1]);
 		float ej = quadricError(qj, vertex_positions[j1]);
 
+		// attribute error is evaluated for the collapsed vertex using attribute values of the target vertex
+		if (attribute_count)
+		{
+			ei += quadricError(attribute_quadrics[i0], &attribute_gradients[i0 * attribute_count * 4], attribute_count, vertex_positions[i1], &vertex_attributes[i1 * attribute_count]);
+			ej += quadricError(attribute_quadrics[j0], &attribute_gradients[j0 * attribute_count * 4], attribute_count, vertex_positions[j1], &vertex_attributes[j1 * attribute_count]);
+		}
+
 		// pick edge direction with minimal error
 		c.v0 = ei <= ej ? i0 : j0;
 		c.v1 = ei <= ej ? i1 : j1;
@@ -751,6 +880,8 @@ static void dumpLockedCollapses(const unsigned int* indices, size_t index_count,
 
 static void sortEdgeCollapses(unsigned int* sort_order, const Collapse* collapses, size_t collapse_count)
 {
+	MESHOPTIMIZER_ZONE("sortEdgeCollapses");
+
 	const int sort_bits = 11;
 
 	// fill histogram for counting sort
@@ -787,8 +918,10 @@ static void sortEdgeCollapses(unsigned int* sort_order, const Collapse* collapse
 	}
 }
 
-static size_t performEdgeCollapses(unsigned int* collapse_remap, unsigned char* collapse_locked, Quadric* vertex_quadrics, const Collapse* collapses, size_t collapse_count, const unsigned int* collapse_order, const unsigned int* remap, const unsigned int* wedge, const unsigned char* vertex_kind, size_t triangle_collapse_goal, float error_goal, float error_limit)
+static size_t performEdgeCollapses(unsigned int* collapse_remap, unsigned char* collapse_locked, Quadric* vertex_quadrics, const Collapse* collapses, size_t collapse_count, const unsigned int* collapse_order, const unsigned int* remap, const unsigned int* wedge, const unsigned char* vertex_kind, size_t triangle_collapse_goal, float error_goal, float error_limit, float& max_error)
 {
+	MESHOPTIMIZER_ZONE("performEdgeCollapses");
+
 	size_t edge_collapses = 0;
 	size_t triangle_collapses = 0;
 
@@ -854,6 +987,8 @@ static size_t performEdgeCollapses(unsigned int* collapse_remap, unsigned char*
 		collapse_locked[r0] = 1;
 		collapse_locked[r1] = 1;
 
+		max_error = max_error < c.error ? c.error : max_error;
+
 		// border edges collapse 1 triangle, other edges collapse 2 or more
 		triangle_collapses += (vertex_kind[i0] == Kind_Border) ? 1 : 2;
 		edge_collapses++;
@@ -862,8 +997,29 @@ static size_t performEdgeCollapses(unsigned int* collapse_remap, unsigned char*
 	return edge_collapses;
 }
 
+static void mergeAttributeQuadrics(Quadric* attribute_quadrics, float* attribute_gradients, size_t attribute_count, const unsigned int* collapse_remap, size_t vertex_count)
+{
+	MESHOPTIMIZER_ZONE("mergeAttributeQuadrics");
+
+	// every vertex moves at most once per pass and targets never move, so the merge order doesn't matter
+	for (size_t i = 0; i < vertex_count; ++i)
+	{
+		unsigned int t = collapse_remap[i];
+
+		if (t == i)
+			continue;
+
+		quadricAdd(attribute_quadrics[t], attribute_quadrics[i]);
+
+		for (size_t k = 0; k < attribute_count * 4; ++k)
+			attribute_gradients[t * attribute_count * 4 + k] += attribute_gradients[i * attribute_count * 4 + k];
+	}
+}
+
 static size_t remapIndexBuffer(unsigned int* indices, size_t index_count, const unsigned int* collapse_remap)
 {
+	MESHOPTIMIZER_ZONE("remapIndexBuffer");
+
 	size_t write = 0;
 
 	for (size_t i = 0; i < index_count; i += 3)
@@ -891,6 +1047,8 @@ static size_t remapIndexBuffer(unsigned int* indices, size_t index_count, const
 
 static void remapEdgeLoops(unsigned int* loop, size_t vertex_count, const unsigned int* collapse_remap)
 {
+	MESHOPTIMIZER_ZONE("remapEdgeLoops");
+
 	for (size_t i = 0; i < vertex_count; ++i)
 	{
 		if (loop[i] != ~0u)
@@ -967,6 +1125,8 @@ struct TriangleHasher
 
 static void computeVertexIds(unsigned int* vertex_ids, const Vector3* vertex_positions, size_t vertex_count, int grid_size)
 {
+	MESHOPTIMIZER_ZONE("computeVertexIds");
+
 	assert(grid_size >= 1 && grid_size <= 1024);
 	float cell_scale = float(grid_size - 1);
 
@@ -984,6 +1144,8 @@ static void computeVertexIds(unsigned int* vertex_ids, const Vector3* vertex_pos
 
 static size_t countTriangles(const unsigned int* vertex_ids, const unsigned int* indices, size_t index_count)
 {
+	MESHOPTIMIZER_ZONE("countTriangles");
+
 	size_t result = 0;
 
 	for (size_t i = 0; i < index_count; i += 3)
@@ -1000,6 +1162,8 @@ static size_t countTriangles(const unsigned int* vertex_ids, const unsigned int*
 
 static size_t fillVertexCells(unsigned int* table, size_t table_size, unsigned int* vertex_cells, const unsigned int* vertex_ids, size_t vertex_count)
 {
+	MESHOPTIMIZER_ZONE("fillVertexCells");
+
 	CellHasher hasher = {vertex_ids};
 
 	memset(table, -1, table_size * sizeof(unsigned int));
@@ -1026,6 +1190,8 @@ static size_t fillVertexCells(unsigned int* table, size_t table_size, unsigned i
 
 static size_t countVertexCells(unsigned int* table, size_t table_size, const unsigned int* vertex_ids, size_t vertex_count)
 {
+	MESHOPTIMIZER_ZONE("countVertexCells");
+
 	IdHasher hasher;
 
 	memset(table, -1, table_size * sizeof(unsigned int));
@@ -1046,6 +1212,8 @@ static size_t countVertexCells(unsigned int* table, size_t table_size, const uns
 
 static void fillCellQuadrics(Quadric* cell_quadrics, const unsigned int* indices, size_t index_count, const Vector3* vertex_positions, const unsigned int* vertex_cells)
 {
+	MESHOPTIMIZER_ZONE("fillCellQuadrics");
+
 	for (size_t i = 0; i < index_count; i += 3)
 	{
 		unsigned int i0 = indices[i + 0];
@@ -1076,6 +1244,8 @@ static void fillCellQuadrics(Quadric* cell_quadrics, const unsigned int* indices
 
 static void fillCellQuadrics(Quadric* cell_quadrics, const Vector3* vertex_positions, size_t vertex_count, const unsigned int* vertex_cells)
 {
+	MESHOPTIMIZER_ZONE("fillCellQuadrics");
+
 	for (size_t i = 0; i < vertex_count; ++i)
 	{
 		unsigned int c = vertex_cells[i];
@@ -1090,6 +1260,8 @@ static void fillCellQuadrics(Quadric* cell_quadrics, const Vector3* vertex_posit
 
 static void fillCellRemap(unsigned int* cell_remap, float* cell_errors, size_t cell_count, const unsigned int* vertex_cells, const Quadric* cell_quadrics, const Vector3* vertex_positions, size_t vertex_count)
 {
+	MESHOPTIMIZER_ZONE("fillCellRemap");
+
 	memset(cell_remap, -1, cell_count * sizeof(unsigned int));
 
 	for (size_t i = 0; i < vertex_count; ++i)
@@ -1107,6 +1279,8 @@ static void fillCellRemap(unsigned int* cell_remap, float* cell_errors, size_t c
 
 static size_t filterTriangles(unsigned int* destination, unsigned int* tritable, size_t tritable_size, const unsigned int* indices, size_t index_count, const unsigned int* vertex_cells, const unsigned int* cell_remap)
 {
+	MESHOPTIMIZER_ZONE("filterTriangles");
+
 	TriangleHasher hasher = {destination};
 
 	memset(tritable, -1, tritable_size * sizeof(unsigned int));
@@ -1158,6 +1332,61 @@ static float interpolate(float y, float x0, float y0, float x1, float y1, float
 	return x1 + num / den;
 }
 
+static int sloppyErrorGrid(float target_error)
+{
+	// grid_size cells span [0..1] with a cell size of 1/(grid_size-1); a single cell covers the entire unit cube
+	const float kDiagonal = 1.7320508f;
+
+	if (target_error >= kDiagonal)
+		return 1;
+
+	float grid = kDiagonal / target_error + 1.f;
+
+	return grid >= 1024.f ? 1024 : int(ceilf(grid));
+}
+
+static float sloppyPowerGuess(float y, float x0, float y0)
+{
+	// triangle count grows roughly as a square of grid size for surfaces
+	return x0 * sqrtf(y / y0);
+}
+
+static float sloppyPowerSecant(float y, float x0, float y0, float x1, float y1)
+{
+	assert(x0 > 0 && y0 > 0 && x1 > 0 && y1 > 0 && y0 != y1);
+
+	// a line in log-log space through both measurements assumes y = a * x^k locally
+	return x1 * powf(x1 / x0, logf(y / y1) / logf(y1 / y0));
+}
+
+static int sloppyRoundGrid(float x, bool over)
+{
+	// we round the prediction towards the side of the target that we haven't measured yet, which helps close the gap around the target
+	float r = over ? floorf(x) : ceilf(x);
+
+	return r >= 1024.f ? 1024 : r <= 1.f ? 1 : int(r);
+}
+
+static float computeCellError(const unsigned int* vertex_cells, const unsigned int* cell_remap, const Vector3* vertex_positions, size_t vertex_count)
+{
+	MESHOPTIMIZER_ZONE("computeCellError");
+
+	float result = 0;
+
+	for (size_t i = 0; i < vertex_count; ++i)
+	{
+		const Vector3& v = vertex_positions[i];
+		const Vector3& r = vertex_positions[cell_remap[vertex_cells[i]]];
+
+		float dx = v.x - r.x, dy = v.y - r.y, dz = v.z - r.z;
+		float d = dx * dx + dy * dy + dz * dz;
+
+		result = result < d ? d : result;
+	}
+
+	return sqrtf(result);
+}
+
 } // namespace meshopt
 
 #ifndef NDEBUG
@@ -1165,33 +1394,103 @@ unsigned char* meshopt_simplifyDebugKind = 0;
 unsigned int* meshopt_simplifyDebugLoop = 0;
 #endif
 
-size_t meshopt_simplify(unsigned int* destination, const unsigned int* indices, size_t index_count, const float* vertex_positions_data, size_t vertex_count, size_t vertex_positions_stride, size_t target_index_count, float target_error)
+namespace meshopt
 {
-	using namespace meshopt;
 
-	assert(index_count % 3 == 0);
-	assert(vertex_positions_stride > 0 && vertex_positions_stride <= 256);
-	assert(vertex_positions_stride % sizeof(float) == 0);
-	assert(target_index_count <= index_count);
+struct SimplifyState
+{
+	size_t vertex_count;
 
-	meshopt_Allocator allocator;
+	unsigned int* remap;
+	unsigned int* wedge;
+	unsigned char* vertex_kind;
+	unsigned int* loop;
+
+	Vector3* vertex_positions;
+	Quadric* vertex_quadrics;
+
+	size_t attribute_count;
+	float* vertex_attributes;
+	float* attribute_gradients;
+	Quadric* attribute_quadrics;
+
+	Collapse* edge_collapses;
+	unsigned int* collapse_order;
+	unsigned int* collapse_remap;
+	unsigned char* collapse_locked;
+};
+
+// bump allocator that carves arrays out of a single block; when data is NULL, it only computes the required size
+struct LinearAllocator
+{
+	unsigned char* data;
+	size_t size;
+
+	template <typename T>
+	T* allocate(size_t count)
+	{
+		T* result = data ? reinterpret_cast<T*>(data + size) : 0;
+		size += (count * sizeof(T) + 15) & ~size_t(15);
+		return result;
+	}
+};
+
+template <typename Allocator>
+static void allocateSimplifyState(SimplifyState& state, size_t index_count, size_t vertex_count, size_t attribute_count, Allocator& allocator)
+{
+	state.vertex_count = vertex_count;
+	state.attribute_count = attribute_count;
+
+	state.remap = allocator.template allocate<unsigned int>(vertex_count);
+	state.wedge = allocator.template allocate<unsigned int>(vertex_count);
+	state.vertex_kind = allocator.template allocate<unsigned char>(vertex_count);
+	state.loop = allocator.template allocate<unsigned int>(vertex_count);
 
-	unsigned int* result = destination;
+	state.vertex_positions = allocator.template allocate<Vector3>(vertex_count);
+	state.vertex_quadrics = allocator.template allocate<Quadric>(vertex_count);
+
+	// attribute values and gradients share the allocation to stay within the allocator block limit
+	if (attribute_count)
+	{
+		state.vertex_attributes = allocator.template allocate<float>(vertex_count * attribute_count * 5);
+		state.attribute_gradients = state.vertex_attributes + vertex_count * attribute_count;
+		state.attribute_quadrics = allocator.template allocate<Quadric>(vertex_count);
+	}
+
+	state.edge_collapses = allocator.template allocate<Collapse>(index_count);
+	state.collapse_order = allocator.template allocate<unsigned int>(index_count);
+	state.collapse_remap = allocator.template allocate<unsigned int>(vertex_count);
+	state.collapse_locked = allocator.template allocate<unsigned char>(vertex_count);
+}
+
+static void initSimplifyState(SimplifyState& state, const unsigned int* indices, size_t index_count, const float* vertex_positions_data, size_t vertex_count, size_t vertex_positions_stride, const float* vertex_attributes_data, size_t vertex_attributes_stride, const float* attribute_weights, const unsigned char* vertex_lock, meshopt_Allocator& allocator)
+{
+	unsigned int* remap = state.remap;
+	unsigned int* wedge = state.wedge;
+	unsigned char* vertex_kind = state.vertex_kind;
+	unsigned int* loop = state.loop;
 
 	// build adjacency information
 	EdgeAdjacency adjacency = {};
 	buildEdgeAdjacency(adjacency, indices, index_count, vertex_count, allocator);
 
 	// build position remap that maps each vertex to the one with identical position
-	unsigned int* remap = allocator.allocate<unsigned int>(vertex_count);
-	unsigned int* wedge = allocator.allocate<unsigned int>(vertex_count);
 	buildPositionRemap(remap, wedge, vertex_positions_data, vertex_count, vertex_positions_stride, allocator);
 
 	// classify vertices; vertex kind determines collapse rules, see kCanCollapse
-	unsigned char* vertex_kind = allocator.allocate<unsigned char>(vertex_count);
-	unsigned int* loop = allocator.allocate<unsigned int>(vertex_count);
 	classifyVertices(vertex_kind, loop, vertex_count, adjacency, remap, wedge);
 
+	// locked vertices can't move; all wedges of the locked vertex need to share the kind
+	if (vertex_lock)
+	{
+		for (size_t i = 0; i < vertex_count; ++i)
+			if (vertex_lock[i])
+				vertex_kind[remap[i]] = Kind_Locked;
+
+		for (size_t i = 0; i < vertex_count; ++i)
+			vertex_kind[i] = vertex_kind[remap[i]];
+	}
+
 #if TRACE
 	size_t unique_positions = 0;
 	for (size_t i = 0; i < vertex_count; ++i)
@@ -1207,28 +1506,60 @@ size_t meshopt_simplify(unsigned int* destination, const unsigned int* indices,
 	       int(kinds[Kind_Manifold]), int(kinds[Kind_Border]), int(kinds[Kind_Seam]), int(kinds[Kind_Complex]), int(kinds[Kind_Locked]));
 #endif
 
-	Vector3* vertex_positions = allocator.allocate<Vector3>(vertex_count);
-	rescalePositions(vertex_positions, vertex_positions_data, vertex_count, vertex_positions_stride);
+	rescalePositions(state.vertex_positions, vertex_positions_data, vertex_count, vertex_positions_stride);
 
-	Quadric* vertex_quadrics = allocator.allocate<Quadric>(vertex_count);
-	memset(vertex_quadrics, 0, vertex_count * sizeof(Quadric));
+	memset(state.vertex_quadrics, 0, vertex_count * sizeof(Quadric));
 
-	fillFaceQuadrics(vertex_quadrics, indices, index_count, vertex_positions, remap);
-	fillEdgeQuadrics(vertex_quadrics, indices, index_count, vertex_positions, remap, vertex_kind, loop);
+	fillFaceQuadrics(state.vertex_quadrics, indices, index_count, state.vertex_positions, remap);
+	fillEdgeQuadrics(state.vertex_quadrics, indices, index_count, state.vertex_positions, remap, vertex_kind, loop);
 
-	if (result != indices)
-		memcpy(result, indices, index_count * sizeof(unsigned int));
+	if (state.attribute_count)
+	{
+		size_t attribute_count = state.attribute_count;
+		size_t vertex_attributes_stride_float = vertex_attributes_stride / sizeof(float);
+
+		// attributes are premultiplied by weights so that the error is computed in weighted units
+		for (size_t i = 0; i < vertex_count; ++i)
+			for (size_t k = 0; k < attribute_count; ++k)
+				state.vertex_attributes[i * attribute_count + k] = vertex_attributes_data[i * vertex_attributes_stride_float + k] * attribute_weights[k];
+
+		memset(state.attribute_gradients, 0, vertex_count * attribute_count * 4 * sizeof(float));
+		memset(state.attribute_quadrics, 0, vertex_count * sizeof(Quadric));
+
+		fillAttributeQuadrics(state.attribute_quadrics, state.attribute_gradients, indices, index_count, state.vertex_positions, state.vertex_attributes, attribute_count);
+	}
+}
+
+static size_t simplifyPasses(const SimplifyState& state, unsigned int* result, size_t index_count, size_t target_index_count, float target_error, float* result_error)
+{
+	size_t vertex_count = state.vertex_count;
+
+	const unsigned int* remap = state.remap;
+	const unsigned int* wedge = state.wedge;
+	const unsigned char* vertex_kind = state.vertex_kind;
+	unsigned int* loop = state.loop;
+
+	const Vector3* vertex_positions = state.vertex_positions;
+	Quadric* vertex_quadrics = state.vertex_quadrics;
+
+	size_t attribute_count = state.attribute_count;
+	const float* vertex_attributes = state.vertex_attributes;
+	float* attribute_gradients = state.attribute_gradients;
+	Quadric* attribute_quadrics = state.attribute_quadrics;
+
+	Collapse* edge_collapses = state.edge_collapses;
+	unsigned int* collapse_order = state.collapse_order;
+	unsigned int* collapse_remap = state.collapse_remap;
+	unsigned char* collapse_locked = state.collapse_locked;
 
-#if TRACE
 	size_t pass_count = 0;
+	size_t collapse_total = 0;
+	float collapse_error = 0.f;
+
+#if TRACE
 	float worst_error = 0;
 #endif
 
-	Collapse* edge_collapses = allocator.allocate<Collapse>(index_count);
-	unsigned int* collapse_order = allocator.allocate<unsigned int>(index_count);
-	unsigned int* collapse_remap = allocator.allocate<unsigned int>(vertex_count);
-	unsigned char* collapse_locked = allocator.allocate<unsigned char>(vertex_count);
-
 	size_t result_count = index_count;
 
 	// target_error input is linear; we need to adjust it to match quadricError units
@@ -1242,7 +1573,7 @@ size_t meshopt_simplify(unsigned int* destination, const unsigned int* indices,
 		if (edge_collapse_count == 0)
 			break;
 
-		rankEdgeCollapses(edge_collapses, edge_collapse_count, vertex_positions, vertex_quadrics, remap);
+		rankEdgeCollapses(edge_collapses, edge_collapse_count, vertex_positions, vertex_quadrics, attribute_quadrics, attribute_gradients, vertex_attributes, attribute_count, remap);
 
 #if TRACE > 1
 		dumpEdgeCollapses(edge_collapses, edge_collapse_count, vertex_kind);
@@ -1266,17 +1597,23 @@ size_t meshopt_simplify(unsigned int* destination, const unsigned int* indices,
 
 		memset(collapse_locked, 0, vertex_count);
 
-		size_t collapses = performEdgeCollapses(collapse_remap, collapse_locked, vertex_quadrics, edge_collapses, edge_collapse_count, collapse_order, remap, wedge, vertex_kind, triangle_collapse_goal, error_goal, error_limit);
+		size_t collapses = performEdgeCollapses(collapse_remap, collapse_locked, vertex_quadrics, edge_collapses, edge_collapse_count, collapse_order, remap, wedge, vertex_kind, triangle_collapse_goal, error_goal, error_limit, collapse_error);
 
 		// no edges can be collapsed any more due to hitting the error limit or triangle collapse limit
 		if (collapses == 0)
 			break;
 
+		if (attribute_count)
+			mergeAttributeQuadrics(attribute_quadrics, attribute_gradients, attribute_count, collapse_remap, vertex_count);
+
 		remapEdgeLoops(loop, vertex_count, collapse_remap);
 
 		size_t new_count = remapIndexBuffer(result, result_count, collapse_remap);
 		assert(new_count < result_count);
 
+		pass_count++;
+		collapse_total += collapses;
+
 #if TRACE
 		float pass_error = 0.f;
 		for (size_t i = 0; i < edge_collapse_count; ++i)
@@ -1287,7 +1624,6 @@ size_t meshopt_simplify(unsigned int* destination, const unsigned int* indices,
 				pass_error = c.error;
 		}
 
-		pass_count++;
 		worst_error = (worst_error < pass_error) ? pass_error : worst_error;
 
 		printf("pass %d: triangles: %d -> %d, collapses: %d/%d (goal: %d), error: %e (limit %e goal %e)\n", int(pass_count), int(result_count / 3), int(new_count / 3), int(collapses), int(edge_collapse_count), int(edge_collapse_goal), pass_error, error_limit, error_goal);
@@ -1296,6 +1632,13 @@ size_t meshopt_simplify(unsigned int* destination, const unsigned int* indices,
 		result_count = new_count;
 	}
 
+	MESHOPTIMIZER_COUNTER("passes", pass_count);
+	MESHOPTIMIZER_COUNTER("collapses", collapse_total);
+
+	// collapse errors are squared and measured in normalized units, see rescalePositions
+	if (result_error)
+		*result_error = sqrtf(collapse_error);
+
 #if TRACE
 	printf("passes: %d, worst error: %e\n", int(pass_count), worst_error);
 #endif
@@ -1315,232 +1658,1543 @@ size_t meshopt_simplify(unsigned int* destination, const unsigned int* indices,
 	return result_count;
 }
 
-size_t meshopt_simplifySloppy(unsigned int* destination, const unsigned int* indices, size_t index_count, const float* vertex_positions_data, size_t vertex_count, size_t vertex_positions_stride, size_t target_index_count)
+static size_t simplifyEdge(unsigned int* destination, const unsigned int* indices, size_t index_count, const float* vertex_positions_data, size_t vertex_count, size_t vertex_positions_stride, const float* vertex_attributes_data, size_t vertex_attributes_stride, const float* attribute_weights, size_t attribute_count, size_t target_index_count, float target_error, const unsigned char* vertex_lock, float* result_error)
 {
-	using namespace meshopt;
-
 	assert(index_count % 3 == 0);
 	assert(vertex_positions_stride > 0 && vertex_positions_stride <= 256);
 	assert(vertex_positions_stride % sizeof(float) == 0);
 	assert(target_index_count <= index_count);
-
-	// we expect to get ~2 triangles/vertex in the output
-	size_t target_cell_count = target_index_count / 6;
-
-	if (target_cell_count == 0)
-		return 0;
+	assert(attribute_count <= kMaxAttributes);
 
 	meshopt_Allocator allocator;
 
-	Vector3* vertex_positions = allocator.allocate<Vector3>(vertex_count);
-	rescalePositions(vertex_positions, vertex_positions_data, vertex_count, vertex_positions_stride);
+	SimplifyState state = {};
+	allocateSimplifyState(state, index_count, vertex_count, attribute_count, allocator);
+	initSimplifyState(state, indices, index_count, vertex_positions_data, vertex_count, vertex_positions_stride, vertex_attributes_data, vertex_attributes_stride, attribute_weights, vertex_lock, allocator);
 
-	// find the optimal grid size using guided binary search
-#if TRACE
-	printf("source: %d vertices, %d triangles\n", int(vertex_count), int(index_count / 3));
-	printf("target: %d cells, %d triangles\n", int(target_cell_count), int(target_index_count / 3));
-#endif
+	if (destination != indices)
+		memcpy(destination, indices, index_count * sizeof(unsigned int));
 
-	unsigned int* vertex_ids = allocator.allocate<unsigned int>(vertex_count);
+	return simplifyPasses(state, destination, index_count, target_index_count, target_error, result_error);
+}
 
-	const int kInterpolationPasses = 5;
+struct SimplifyPartitionContext
+{
+	const float* vertex_positions_data;
+	size_t vertex_positions_stride;
 
-	// invariant: # of triangles in min_grid <= target_count
-	int min_grid = 0;
-	int max_grid = 1025;
-	size_t min_triangles = 0;
-	size_t max_triangles = index_count / 3;
+	unsigned int* indices;
+	const unsigned int* index_offsets;
 
-	// instead of starting in the middle, let's guess as to what the answer might be! triangle count usually grows as a square of grid size...
-	int next_grid_size = int(sqrtf(float(target_cell_count)) + 0.5f);
+	const unsigned int* vertices;
+	const unsigned int* vertex_offsets;
 
-	for (int pass = 0; pass < 10 + kInterpolationPasses; ++pass)
-	{
-		assert(min_triangles < target_index_count / 3);
-		assert(max_grid - min_grid > 1);
+	float* positions;
+	const unsigned char* vertex_lock;
 
-		// we clamp the prediction of the grid size to make sure that the search converges
-		int grid_size = next_grid_size;
-		grid_size = (grid_size <= min_grid) ? min_grid + 1 : (grid_size >= max_grid) ? max_grid - 1 : grid_size;
+	unsigned int* result_counts;
 
-		computeVertexIds(vertex_ids, vertex_positions, vertex_count, grid_size);
-		size_t triangles = countTriangles(vertex_ids, indices, index_count);
+	size_t index_count;
+	size_t target_index_count;
+	float target_error;
+	float extent;
 
-#if TRACE
-		printf("pass %d (%s): grid size %d, triangles %d, %s\n",
-		       pass, (pass == 0) ? "guess" : (pass <= kInterpolationPasses) ? "lerp" : "binary",
-		       grid_size, int(triangles),
-		       (triangles <= target_index_count / 3) ? "under" : "over");
-#endif
+	// allocation callbacks of the calling thread, installed by the tasks that allocate memory
+	meshopt_Allocator::Callbacks callbacks;
+};
 
-		float tip = interpolate(float(target_index_count / 3), float(min_grid), float(min_triangles), float(grid_size), float(triangles), float(max_grid), float(max_triangles));
+static float getPositionExtent(const float* positions, size_t vertex_count, size_t vertex_stride_float)
+{
+	float minv[3] = {FLT_MAX, FLT_MAX, FLT_MAX};
+	float maxv[3] = {-FLT_MAX, -FLT_MAX, -FLT_MAX};
 
-		if (triangles <= target_index_count / 3)
-		{
-			min_grid = grid_size;
-			min_triangles = triangles;
-		}
-		else
+	for (size_t i = 0; i < vertex_count; ++i)
+	{
+		const float* v = positions + i * vertex_stride_float;
+
+		for (int j = 0; j < 3; ++j)
 		{
-			max_grid = grid_size;
-			max_triangles = triangles;
+			minv[j] = minv[j] > v[j] ? v[j] : minv[j];
+			maxv[j] = maxv[j] < v[j] ? v[j] : maxv[j];
 		}
-
-		if (triangles == target_index_count / 3 || max_grid - min_grid <= 1)
-			break;
-
-		// we start by using interpolation search - it usually converges faster
-		// however, interpolation search has a worst case of O(N) so we switch to binary search after a few iterations which converges in O(logN)
-		next_grid_size = (pass < kInterpolationPasses) ? int(tip + 0.5f) : (min_grid + max_grid) / 2;
 	}
 
-	if (min_triangles == 0)
-		return 0;
+	float extent = 0.f;
 
-	// build vertex->cell association by mapping all vertices with the same quantized position to the same cell
-	size_t table_size = hashBuckets2(vertex_count);
-	unsigned int* table = allocator.allocate<unsigned int>(table_size);
+	extent = (maxv[0] - minv[0]) < extent ? extent : (maxv[0] - minv[0]);
+	extent = (maxv[1] - minv[1]) < extent ? extent : (maxv[1] - minv[1]);
+	extent = (maxv[2] - minv[2]) < extent ? extent : (maxv[2] - minv[2]);
 
-	unsigned int* vertex_cells = allocator.allocate<unsigned int>(vertex_count);
+	return extent;
+}
 
-	computeVertexIds(vertex_ids, vertex_positions, vertex_count, min_grid);
-	size_t cell_count = fillVertexCells(table, table_size, vertex_cells, vertex_ids, vertex_count);
+static void simplifyPartition(void* task_data, size_t task_index)
+{
+	MESHOPTIMIZER_ZONE("simplifyPartition");
 
-	// build a quadric for each target cell
-	Quadric* cell_quadrics = allocator.allocate<Quadric>(cell_count);
-	memset(cell_quadrics, 0, cell_count * sizeof(Quadric));
+	const SimplifyPartitionContext& context = *static_cast<const SimplifyPartitionContext*>(task_data);
+	meshopt_Allocator::Scope scope(context.callbacks);
 
-	fillCellQuadrics(cell_quadrics, indices, index_count, vertex_positions, vertex_cells);
+	unsigned int* indices = context.indices + context.index_offsets[task_index];
+	size_t index_count = context.index_offsets[task_index + 1] - context.index_offsets[task_index];
 
-	// for each target cell, find the vertex with the minimal error
-	unsigned int* cell_remap = allocator.allocate<unsigned int>(cell_count);
-	float* cell_errors = allocator.allocate<float>(cell_count);
+	const unsigned int* vertices = context.vertices + context.vertex_offsets[task_index];
+	size_t vertex_count = context.vertex_offsets[task_index + 1] - context.vertex_offsets[task_index];
 
-	fillCellRemap(cell_remap, cell_errors, cell_count, vertex_cells, cell_quadrics, vertex_positions, vertex_count);
+	float* positions = context.positions + context.vertex_offsets[task_index] * 3;
+	const unsigned char* vertex_lock = context.vertex_lock + context.vertex_offsets[task_index];
 
-	// collapse triangles!
-	// note that we need to filter out triangles that we've already output because we very frequently generate redundant triangles between cells :(
-	size_t tritable_size = hashBuckets2(min_triangles);
-	unsigned int* tritable = allocator.allocate<unsigned int>(tritable_size);
+	size_t vertex_stride_float = context.vertex_positions_stride / sizeof(float);
 
-	size_t write = filterTriangles(destination, tritable, tritable_size, indices, index_count, vertex_cells, cell_remap);
-	assert(write <= target_index_count);
+	for (size_t i = 0; i < vertex_count; ++i)
+	{
+		const float* v = context.vertex_positions_data + vertices[i] * vertex_stride_float;
+
+		positions[i * 3 + 0] = v[0];
+		positions[i * 3 + 1] = v[1];
+		positions[i * 3 + 2] = v[2];
+	}
+
+	// each partition gets a proportional share of the target; error is relative to mesh extents, so it needs to be rescaled to partition extents
+	size_t target_index_count = size_t(double(context.target_index_count) * double(index_count) / double(context.index_count)) / 3 * 3;
+
+	float extent = getPositionExtent(positions, vertex_count, 3);
+	float target_error = extent == 0 ? context.target_error : context.target_error * (context.extent / extent);
+
+	size_t result_count = simplifyEdge(indices, indices, index_count, positions, vertex_count, sizeof(float) * 3, NULL, 0, NULL, 0, target_index_count, target_error, vertex_lock, NULL);
+
+	for (size_t i = 0; i < result_count; ++i)
+		indices[i] = vertices[indices[i]];
+
+	context.result_counts[task_index] = unsigned(result_count);
+}
+
+// stream quadrics are accumulated over the entire input, so they use doubles to keep small contributions once the sums get large
+struct StreamQuadric
+{
+	double a00, a11, a22;
+	double a10, a20, a21;
+	double b0, b1, b2;
+};
+
+static void quadricAdd(StreamQuadric& Q, const Quadric& R)
+{
+	Q.a00 += R.a00;
+	Q.a11 += R.a11;
+	Q.a22 += R.a22;
+	Q.a10 += R.a10;
+	Q.a20 += R.a20;
+	Q.a21 += R.a21;
+	Q.b0 += R.b0;
+	Q.b1 += R.b1;
+	Q.b2 += R.b2;
+}
+
+struct SloppyStreamState
+{
+	float box_min[3];
+	float extent;
+	float scale;
+	int grid_size;
+
+	size_t max_cells;
+	size_t max_triangles;
+	bool overflow;
+
+	// cell_ids, cell_quadrics, cell_sums and triangles have one extra element that is used as a scratch slot for lookups
+	size_t cell_count;
+	unsigned int* cell_table;
+	size_t cell_table_size;
+	unsigned int* cell_ids;
+	StreamQuadric* cell_quadrics;
+	double (*cell_sums)[4]; // position sum and vertex count, used to regularize the cell position; doubles keep them exact for very large inputs
+
+	size_t triangle_count;
+	unsigned int* triangle_table;
+	size_t triangle_table_size;
+	unsigned int* triangles;
+};
+
+template <typename Allocator>
+static void allocateSloppyStreamState(SloppyStreamState& state, size_t max_cells, size_t max_triangles, Allocator& allocator)
+{
+	state.max_cells = max_cells;
+	state.max_triangles = max_triangles;
+
+	// tables always keep at least one empty slot so that lookups for new keys terminate when the stream is full
+	state.cell_table_size = hashBuckets2(max_cells + max_cells / 4 + 1);
+	state.cell_table = allocator.template allocate<unsigned int>(state.cell_table_size);
+	state.cell_ids = allocator.template allocate<unsigned int>(max_cells + 1);
+	state.cell_quadrics = allocator.template allocate<StreamQuadric>(max_cells + 1);
+	state.cell_sums = allocator.template allocate<double[4]>(max_cells + 1);
+
+	state.triangle_table_size = hashBuckets2(max_triangles + max_triangles / 4 + 1);
+	state.triangle_table = allocator.template allocate<unsigned int>(state.triangle_table_size);
+	state.triangles = allocator.template allocate<unsigned int>((max_triangles + 1) * 3);
+}
+
+static unsigned int addStreamCell(SloppyStreamState& state, unsigned int id)
+{
+	CellHasher hasher = {state.cell_ids};
+
+	// the id is placed in the next free slot so that the hasher can compare it with existing cells
+	unsigned int cell = unsigned(state.cell_count);
+	state.cell_ids[cell] = id;
+
+	unsigned int* entry = hashLookup2(state.cell_table, state.cell_table_size, hasher, cell, ~0u);
+
+	if (*entry != ~0u)
+		return *entry;
+
+	if (state.cell_count == state.max_cells)
+	{
+		state.overflow = true;
+		return ~0u;
+	}
+
+	*entry = cell;
+	state.cell_count++;
+
+	memset(&state.cell_quadrics[cell], 0, sizeof(StreamQuadric));
+	memset(state.cell_sums[cell], 0, sizeof(state.cell_sums[cell]));
+
+	return cell;
+}
+
+static void addStreamTriangle(SloppyStreamState& state, unsigned int a, unsigned int b, unsigned int c)
+{
+	// rotate the triangle so that the smallest index is first; this doesn't change the winding and makes duplicate detection robust
+	if (b < a && b < c)
+	{
+		unsigned int t = a;
+		a = b, b = c, c = t;
+	}
+	else if (c < a && c < b)
+	{
+		unsigned int t = c;
+		c = b, b = a, a = t;
+	}
+
+	TriangleHasher hasher = {state.triangles};
+
+	unsigned int triangle = unsigned(state.triangle_count);
+	state.triangles[triangle * 3 + 0] = a;
+	state.triangles[triangle * 3 + 1] = b;
+	state.triangles[triangle * 3 + 2] = c;
+
+	unsigned int* entry = hashLookup2(state.triangle_table, state.triangle_table_size, hasher, triangle, ~0u);
+
+	if (*entry != ~0u)
+		return;
+
+	if (state.triangle_count == state.max_triangles)
+	{
+		state.overflow = true;
+		return;
+	}
+
+	*entry = triangle;
+	state.triangle_count++;
+}
+
+static bool addStreamVertices(SloppyStreamState& state, unsigned int* vertex_cells, Vector3* positions, const float* vertex_positions_data, size_t vertex_count, size_t vertex_positions_stride)
+{
+	size_t vertex_stride_float = vertex_positions_stride / sizeof(float);
+
+	for (size_t i = 0; i < vertex_count; ++i)
+	{
+		const float* v = vertex_positions_data + i * vertex_stride_float;
+
+		// vertices are mapped to a unit cube using the stream bounds; vertices outside of the bounds are clamped
+		float p[3];
+
+		for (int k = 0; k < 3; ++k)
+		{
+			float pk = (v[k] - state.box_min[k]) * state.scale;
+			p[k] = pk < 0.f ? 0.f : (pk > 1.f ? 1.f : pk);
+		}
+
+		Vector3 pv = {p[0], p[1], p[2]};
+		positions[i] = pv;
+
+		unsigned int id;
+		computeVertexIds(&id, &pv, 1, state.grid_size);
+
+		unsigned int cell = addStreamCell(state, id);
+
+		if (cell == ~0u)
+			return false;
+
+		vertex_cells[i] = cell;
+
+		double* sum = state.cell_sums[cell];
+		sum[0] += p[0];
+		sum[1] += p[1];
+		sum[2] += p[2];
+		sum[3] += 1;
+	}
+
+	return true;
+}
+
+static Vector3 solveStreamCell(const SloppyStreamState& state, size_t cell)
+{
+	const StreamQuadric& Q = state.cell_quadrics[cell];
+	const double* sum = state.cell_sums[cell];
+
+	double mean[3] = {sum[0] / sum[3], sum[1] / sum[3], sum[2] / sum[3]};
+
+	// minimize the quadric error with a small regularization term that pulls the position towards the mean;
+	// this keeps the system well conditioned for flat or linear cells, and reduces to the mean for point clouds
+	double trace = Q.a00 + Q.a11 + Q.a22;
+	double lambda = trace * 1e-2;
+
+	double a00 = Q.a00 + lambda, a11 = Q.a11 + lambda, a22 = Q.a22 + lambda;
+	double a10 = Q.a10, a20 = Q.a20, a21 = Q.a21;
+
+	double r0 = -Q.b0 + lambda * mean[0], r1 = -Q.b1 + lambda * mean[1], r2 = -Q.b2 + lambda * mean[2];
+
+	// Cramer's rule for the symmetric 3x3 system
+	double c00 = a11 * a22 - a21 * a21;
+	double c01 = a21 * a20 - a10 * a22;
+	double c02 = a10 * a21 - a11 * a20;
+
+	double det = a00 * c00 + a10 * c01 + a20 * c02;
+
+	Vector3 result = {float(mean[0]), float(mean[1]), float(mean[2])};
+
+	if (trace > 0 && fabs(det) > 1e-6 * a00 * a11 * a22)
+	{
+		double c11 = a00 * a22 - a20 * a20;
+		double c12 = a20 * a10 - a00 * a21;
+		double c22 = a00 * a11 - a10 * a10;
+
+		result.x = float((c00 * r0 + c01 * r1 + c02 * r2) / det);
+		result.y = float((c01 * r0 + c11 * r1 + c12 * r2) / det);
+		result.z = float((c02 * r0 + c12 * r1 + c22 * r2) / det);
+	}
+
+	// the optimal position can be far away for nearly degenerate cells, so we restrict it to the cell bounds
+	unsigned int id = state.cell_ids[cell];
+	float cell_scale = float(state.grid_size - 1);
+	float cell_size = state.grid_size > 1 ? 1.f / cell_scale : 1.f;
+
+	float center[3] = {float(id >> 20), float((id >> 10) & 1023), float(id & 1023)};
+	float* rv[3] = {&result.x, &result.y, &result.z};
+
+	for (int k = 0; k < 3; ++k)
+	{
+		float lo = state.grid_size > 1 ? (center[k] - 0.5f) * cell_size : 0.f;
+		float hi = state.grid_size > 1 ? (center[k] + 0.5f) * cell_size : 1.f;
+
+		float vk = *rv[k];
+		*rv[k] = vk < lo ? lo : (vk > hi ? hi : vk);
+	}
+
+	return result;
+}
+
+static meshopt_Allocator::Callbacks getPersistentCallbacks()
+{
+	// persistent objects outlive the call that creates them, which would break the stack order of context allocations; they always use meshopt_setAllocator callbacks
+	meshopt_Allocator::Callbacks result = meshopt_Allocator::getCallbacks();
+	result.allocate_context = 0;
+	result.deallocate_context = 0;
+	result.context = 0;
+
+	return result;
+}
+
+} // namespace meshopt
+
+struct meshopt_Simplifier
+{
+	meshopt_Allocator::Callbacks callbacks;
+	meshopt::SimplifyState state;
+
+	unsigned int* indices;
+	size_t index_count;
+};
+
+struct meshopt_SloppyStream
+{
+	meshopt_Allocator::Callbacks callbacks;
+	meshopt::SloppyStreamState state;
+};
+
+size_t meshopt_simplify(unsigned int* destination, const unsigned int* indices, size_t index_count, const float* vertex_positions_data, size_t vertex_count, size_t vertex_positions_stride, size_t target_index_count, float target_error)
+{
+	MESHOPTIMIZER_ZONE("meshopt_simplify");
+
+	return meshopt::simplifyEdge(destination, indices, index_count, vertex_positions_data, vertex_count, vertex_positions_stride, NULL, 0, NULL, 0, target_index_count, target_error, NULL, NULL);
+}
+
+size_t meshopt_simplifyWithAttributes(unsigned int* destination, const unsigned int* indices, size_t index_count, const float* vertex_positions_data, size_t vertex_count, size_t vertex_positions_stride, const float* vertex_attributes_data, size_t vertex_attributes_stride, const float* attribute_weights, size_t attribute_count, size_t target_index_count, float target_error)
+{
+	using namespace meshopt;
+
+	MESHOPTIMIZER_ZONE("meshopt_simplifyWithAttributes");
+
+	assert(vertex_attributes_stride >= attribute_count * sizeof(float) && vertex_attributes_stride <= 256);
+	assert(vertex_attributes_stride % sizeof(float) == 0);
+	assert(attribute_count <= kMaxAttributes);
+
+	return simplifyEdge(destination, indices, index_count, vertex_positions_data, vertex_count, vertex_positions_stride, vertex_attributes_data, vertex_attributes_stride, attribute_weights, attribute_count, target_index_count, target_error, NULL, NULL);
+}
+
+meshopt_Simplifier* meshopt_createSimplifier(const unsigned int* indices, size_t index_count, const float* vertex_positions_data, size_t vertex_count, size_t vertex_positions_stride)
+{
+	using namespace meshopt;
+
+	MESHOPTIMIZER_ZONE("meshopt_createSimplifier");
+
+	assert(index_count % 3 == 0);
+	assert(vertex_positions_stride > 0 && vertex_positions_stride <= 256);
+	assert(vertex_positions_stride % sizeof(float) == 0);
+
+	// all persistent state is placed in a single allocation along with the simplifier itself
+	size_t header_size = (sizeof(meshopt_Simplifier) + 15) & ~size_t(15);
+
+	SimplifyState dummy = {};
+	LinearAllocator sizer = {0, header_size};
+	allocateSimplifyState(dummy, index_count, vertex_count, 0, sizer);
+	sizer.allocate<unsigned int>(index_count);
+
+	meshopt_Allocator::Callbacks callbacks = getPersistentCallbacks();
+	unsigned char* data = static_cast<unsigned char*>(meshopt_Allocator::allocateStorage(callbacks, sizer.size));
+
+	// persistent state is allocated directly so it's reported separately from temporary setup data
+	MESHOPTIMIZER_COUNTER("allocated", sizer.size);
+
+	meshopt_Simplifier* simplifier = reinterpret_cast<meshopt_Simplifier*>(data);
+	memset(simplifier, 0, sizeof(meshopt_Simplifier));
+
+	simplifier->callbacks = callbacks;
+
+	LinearAllocator linear = {data, header_size};
+	allocateSimplifyState(simplifier->state, index_count, vertex_count, 0, linear);
+	simplifier->indices = linear.allocate<unsigned int>(index_count);
+	simplifier->index_count = index_count;
+
+	assert(linear.size == sizer.size);
+
+	// adjacency and position hash table are only needed during setup
+	meshopt_Allocator allocator;
+	initSimplifyState(simplifier->state, indices, index_count, vertex_positions_data, vertex_count, vertex_positions_stride, NULL, 0, NULL, NULL, allocator);
+
+	memcpy(simplifier->indices, indices, index_count * sizeof(unsigned int));
+
+	return simplifier;
+}
+
+size_t meshopt_simplifyNext(meshopt_Simplifier* simplifier, unsigned int* destination, size_t target_index_count, float target_error)
+{
+	using namespace meshopt;
+
+	MESHOPTIMIZER_ZONE("meshopt_simplifyNext");
+
+	size_t index_count = simplifier->index_count;
+
+	if (target_index_count < index_count)
+		index_count = simplifyPasses(simplifier->state, simplifier->indices, index_count, target_index_count, target_error, NULL);
+
+	simplifier->index_count = index_count;
+
+	memcpy(destination, simplifier->indices, index_count * sizeof(unsigned int));
+
+	return index_count;
+}
+
+void meshopt_destroySimplifier(meshopt_Simplifier* simplifier)
+{
+	// callbacks are stored in the allocation that is being released
+	meshopt_Allocator::Callbacks callbacks = simplifier->callbacks;
+	meshopt_Allocator::deallocateStorage(callbacks, simplifier);
+}
+
+size_t meshopt_simplifyPartitioned(unsigned int* destination, const unsigned int* indices, size_t index_count, const float* vertex_positions_data, size_t vertex_count, size_t vertex_positions_stride, size_t target_index_count, float target_error, size_t partition_count, meshopt_Scheduler scheduler, void* scheduler_context)
+{
+	using namespace meshopt;
+
+	MESHOPTIMIZER_ZONE("meshopt_simplifyPartitioned");
+
+	assert(index_count % 3 == 0);
+	assert(vertex_positions_stride > 0 && vertex_positions_stride <= 256);
+	assert(vertex_positions_stride % sizeof(float) == 0);
+	assert(target_index_count <= index_count);
+	assert(partition_count > 0);
+
+	meshopt_Allocator allocator;
+
+	size_t face_count = index_count / 3;
+	size_t vertex_stride_float = vertex_positions_stride / sizeof(float);
+
+	partition_count = partition_count > face_count ? face_count : partition_count;
+
+	// order triangles spatially using centroids, and split the order into partitions with similar triangle counts
+	float* centroids = allocator.allocate<float>(face_count * 3);
+
+	for (size_t i = 0; i < face_count; ++i)
+	{
+		const float* p0 = vertex_positions_data + indices[i * 3 + 0] * vertex_stride_float;
+		const float* p1 = vertex_positions_data + indices[i * 3 + 1] * vertex_stride_float;
+		const float* p2 = vertex_positions_data + indices[i * 3 + 2] * vertex_stride_float;
+
+		centroids[i * 3 + 0] = (p0[0] + p1[0] + p2[0]) / 3.f;
+		centroids[i * 3 + 1] = (p0[1] + p1[1] + p2[1]) / 3.f;
+		centroids[i * 3 + 2] = (p0[2] + p1[2] + p2[2]) / 3.f;
+	}
+
+	unsigned int* face_order = allocator.allocate<unsigned int>(face_count);
+	meshopt_spatialSortRemap(face_order, centroids, face_count, sizeof(float) * 3);
+
+	unsigned int* partition_indices = allocator.allocate<unsigned int>(index_count);
+
+	for (size_t i = 0; i < face_count; ++i)
+	{
+		unsigned int r = face_order[i];
+
+		partition_indices[r * 3 + 0] = indices[i * 3 + 0];
+		partition_indices[r * 3 + 1] = indices[i * 3 + 1];
+		partition_indices[r * 3 + 2] = indices[i * 3 + 2];
+	}
+
+	unsigned int* index_offsets = allocator.allocate<unsigned int>(partition_count + 1);
+
+	for (size_t i = 0; i <= partition_count; ++i)
+		index_offsets[i] = unsigned(face_count * i / partition_count * 3);
+
+	// vertices that have the same position as a vertex in another partition are locked so that partitions stay connected
+	unsigned int* remap = allocator.allocate<unsigned int>(vertex_count);
+	unsigned int* wedge = allocator.allocate<unsigned int>(vertex_count);
+	buildPositionRemap(remap, wedge, vertex_positions_data, vertex_count, vertex_positions_stride, allocator);
+
+	unsigned int* position_partition = allocator.allocate<unsigned int>(vertex_count);
+	memset(position_partition, -1, vertex_count * sizeof(unsigned int));
+
+	unsigned char* position_shared = allocator.allocate<unsigned char>(vertex_count);
+	memset(position_shared, 0, vertex_count);
+
+	for (size_t p = 0; p < partition_count; ++p)
+		for (size_t i = index_offsets[p]; i < index_offsets[p + 1]; ++i)
+		{
+			unsigned int r = remap[partition_indices[i]];
+
+			if (position_partition[r] == ~0u)
+				position_partition[r] = unsigned(p);
+			else if (position_partition[r] != p)
+				position_shared[r] = 1;
+		}
+
+	// convert partition indices to local vertex indices; partitions have at most index_count vertices in total
+	unsigned int* vertex_local = allocator.allocate<unsigned int>(vertex_count);
+	unsigned int* vertex_stamp = position_partition; // no longer needed
+	memset(vertex_stamp, -1, vertex_count * sizeof(unsigned int));
+
+	unsigned int* partition_vertices = allocator.allocate<unsigned int>(index_count);
+	unsigned int* vertex_offsets = allocator.allocate<unsigned int>(partition_count + 1);
+
+	size_t partition_vertex_count = 0;
+
+	for (size_t p = 0; p < partition_count; ++p)
+	{
+		vertex_offsets[p] = unsigned(partition_vertex_count);
+
+		for (size_t i = index_offsets[p]; i < index_offsets[p + 1]; ++i)
+		{
+			unsigned int v = partition_indices[i];
+
+			if (vertex_stamp[v] != p)
+			{
+				vertex_stamp[v] = unsigned(p);
+				vertex_local[v] = unsigned(partition_vertex_count - vertex_offsets[p]);
+				partition_vertices[partition_vertex_count++] = v;
+			}
+
+			partition_indices[i] = vertex_local[v];
+		}
+	}
+
+	vertex_offsets[partition_count] = unsigned(partition_vertex_count);
+
+	unsigned char* vertex_lock = allocator.allocate<unsigned char>(partition_vertex_count);
+
+	for (size_t i = 0; i < partition_vertex_count; ++i)
+		vertex_lock[i] = position_shared[remap[partition_vertices[i]]];
+
+	float* positions = allocator.allocate<float>(partition_vertex_count * 3);
+	unsigned int* result_counts = allocator.allocate<unsigned int>(partition_count);
+
+	SimplifyPartitionContext context = {};
+	context.callbacks = meshopt_Allocator::getCallbacks();
+	context.vertex_positions_data = vertex_positions_data;
+	context.vertex_positions_stride = vertex_positions_stride;
+	context.indices = partition_indices;
+	context.index_offsets = index_offsets;
+	context.vertices = partition_vertices;
+	context.vertex_offsets = vertex_offsets;
+	context.positions = positions;
+	context.vertex_lock = vertex_lock;
+	context.result_counts = result_counts;
+	context.index_count = index_count;
+	context.target_index_count = target_index_count;
+	context.target_error = target_error;
+	context.extent = getPositionExtent(vertex_positions_data, vertex_count, vertex_stride_float);
+
+	if (scheduler)
+		scheduler(scheduler_context, simplifyPartition, &context, partition_count);
+	else
+		for (size_t p = 0; p < partition_count; ++p)
+			simplifyPartition(&context, p);
+
+	// stitch partitions together and run a final pass that can collapse partition borders
+	size_t result_count = 0;
+
+	for (size_t p = 0; p < partition_count; ++p)
+	{
+		memcpy(destination + result_count, partition_indices + index_offsets[p], result_counts[p] * sizeof(unsigned int));
+		result_count += result_counts[p];
+	}
+
+	if (result_count <= target_index_count)
+		return result_count;
+
+	// only triangles that touch partition borders can be simplified further, since the rest was simplified with unlocked vertices already
+	// the final pass only processes these triangles, which keeps the serial part of the work small; partition_indices is no longer needed and stores them temporarily
+	size_t interior_count = 0;
+	size_t seam_count = 0;
+
+	for (size_t i = 0; i < result_count; i += 3)
+	{
+		unsigned int a = destination[i + 0], b = destination[i + 1], c = destination[i + 2];
+
+		if (position_shared[remap[a]] | position_shared[remap[b]] | position_shared[remap[c]])
+		{
+			partition_indices[seam_count + 0] = a;
+			partition_indices[seam_count + 1] = b;
+			partition_indices[seam_count + 2] = c;
+			seam_count += 3;
+		}
+		else
+		{
+			destination[interior_count + 0] = a;
+			destination[interior_count + 1] = b;
+			destination[interior_count + 2] = c;
+			interior_count += 3;
+		}
+	}
+
+	// vertices that are also used by interior triangles need to stay in place to keep the result connected
+	for (size_t i = 0; i < interior_count; ++i)
+		position_shared[remap[destination[i]]] |= 2;
+
+	// convert border triangles to local vertex indices, reusing partition buffers; the result has at most partition_vertex_count unique vertices
+	unsigned int seam_vertex_count = 0;
+
+	for (size_t i = 0; i < seam_count; ++i)
+	{
+		unsigned int v = partition_indices[i];
+
+		if (vertex_stamp[v] != partition_count)
+		{
+			vertex_stamp[v] = unsigned(partition_count);
+			vertex_local[v] = seam_vertex_count;
+			partition_vertices[seam_vertex_count++] = v;
+		}
+
+		partition_indices[i] = vertex_local[v];
+	}
+
+	assert(seam_vertex_count <= partition_vertex_count);
+
+	for (size_t i = 0; i < seam_vertex_count; ++i)
+	{
+		const float* v = vertex_positions_data + partition_vertices[i] * vertex_stride_float;
+
+		positions[i * 3 + 0] = v[0];
+		positions[i * 3 + 1] = v[1];
+		positions[i * 3 + 2] = v[2];
+
+		vertex_lock[i] = (position_shared[remap[partition_vertices[i]]] & 2) != 0;
+	}
+
+	// error is relative to mesh extents, so it needs to be rescaled to the extents of the border triangles, similarly to simplifyPartition
+	size_t seam_target = target_index_count > interior_count ? target_index_count - interior_count : 0;
+
+	float seam_extent = getPositionExtent(positions, seam_vertex_count, 3);
+	float seam_error = seam_extent == 0 ? target_error : target_error * (context.extent / seam_extent);
+
+	size_t seam_result = simplifyEdge(partition_indices, partition_indices, seam_count, positions, seam_vertex_count, sizeof(float) * 3, NULL, 0, NULL, 0, seam_target, seam_error, vertex_lock, NULL);
+
+	for (size_t i = 0; i < seam_result; ++i)
+		destination[interior_count + i] = partition_vertices[partition_indices[i]];
+
+	return interior_count + seam_result;
+}
+
+size_t meshopt_simplifySloppy(unsigned int* destination, const unsigned int* indices, size_t index_count, const float* vertex_positions_data, size_t vertex_count, size_t vertex_positions_stride, size_t target_index_count, float target_error, float* result_error)
+{
+	using namespace meshopt;
+
+	MESHOPTIMIZER_ZONE("meshopt_simplifySloppy");
+
+	assert(index_count % 3 == 0);
+	assert(vertex_positions_stride > 0 && vertex_positions_stride <= 256);
+	assert(vertex_positions_stride % sizeof(float) == 0);
+	assert(target_index_count <= index_count);
+	assert(target_error >= 0);
+
+	// we expect to get ~2 triangles/vertex in the output
+	size_t target_cell_count = target_index_count / 6;
+
+	// every vertex is within a cell diagonal from the representative vertex of its cell, so the error bound gives us the coarsest grid we can use
+	int error_grid = sloppyErrorGrid(target_error);
+
+	if (result_error)
+		*result_error = 0;
+
+	if (target_cell_count == 0 && error_grid <= 1)
+		return 0;
+
+	meshopt_Allocator allocator;
+
+	Vector3* vertex_positions = allocator.allocate<Vector3>(vertex_count);
+	rescalePositions(vertex_positions, vertex_positions_data, vertex_count, vertex_positions_stride);
+
+	// find the optimal grid size using guided binary search
+#if TRACE
+	printf("source: %d vertices, %d triangles\n", int(vertex_count), int(index_count / 3));
+	printf("target: %d cells, %d triangles, grid size >= %d\n", int(target_cell_count), int(target_index_count / 3), error_grid);
+#endif
+
+	// we keep the vertex ids for min_grid around so that we don't need to recompute them after the search
+	unsigned int* vertex_ids = allocator.allocate<unsigned int>(vertex_count);
+	unsigned int* min_vertex_ids = allocator.allocate<unsigned int>(vertex_count);
+
+	const int kInterpolationPasses = 6;
+
+	// invariant: # of triangles in min_grid <= target_count, unless min_grid is limited by the error bound
+	int min_grid = 0;
+	int max_grid = 1025;
+	size_t min_triangles = 0;
+	size_t search_passes = 0;
+
+	// when we're error-limited, we start by counting triangles for the coarsest grid; if it's over the target already, we're done
+	if (error_grid > 1)
+	{
+		search_passes++;
+
+		computeVertexIds(min_vertex_ids, vertex_positions, vertex_count, error_grid);
+		min_grid = error_grid;
+		min_triangles = countTriangles(min_vertex_ids, indices, index_count);
+
+#if TRACE
+		printf("error bound: grid size %d, triangles %d, %s\n", error_grid, int(min_triangles), (min_triangles <= target_index_count / 3) ? "under" : "over");
+#endif
+	}
+
+	if (min_triangles < target_index_count / 3 && max_grid - min_grid > 1)
+	{
+		// instead of starting in the middle, let's guess as to what the answer might be! triangle count usually grows as a square of grid size...
+		int next_grid_size = (min_triangles == 0) ? int(sqrtf(float(target_cell_count)) + 0.5f) : sloppyRoundGrid(sloppyPowerGuess(float(target_index_count / 3), float(min_grid), float(min_triangles)), false);
+
+		int last_grid = min_grid;
+		size_t last_triangles = min_triangles;
+
+		for (int pass = 0; pass < 10 + kInterpolationPasses; ++pass)
+		{
+			assert(min_triangles < target_index_count / 3);
+			assert(max_grid - min_grid > 1);
+
+			search_passes++;
+
+			// we clamp the prediction of the grid size to make sure that the search converges
+			int grid_size = next_grid_size;
+			grid_size = (grid_size <= min_grid) ? min_grid + 1 : (grid_size >= max_grid) ? max_grid - 1 : grid_size;
+
+			computeVertexIds(vertex_ids, vertex_positions, vertex_count, grid_size);
+			size_t triangles = countTriangles(vertex_ids, indices, index_count);
+
+#if TRACE
+			printf("pass %d (%s): grid size %d, triangles %d, %s\n",
+			       pass, (pass == 0) ? "guess" : (pass <= kInterpolationPasses) ? "lerp" : "binary",
+			       grid_size, int(triangles),
+			       (triangles <= target_index_count / 3) ? "under" : "over");
+#endif
+
+			if (triangles <= target_index_count / 3)
+			{
+				min_grid = grid_size;
+				min_triangles = triangles;
+
+				unsigned int* temp = min_vertex_ids;
+				min_vertex_ids = vertex_ids;
+				vertex_ids = temp;
+			}
+			else
+			{
+				max_grid = grid_size;
+			}
+
+			if (triangles == target_index_count / 3 || max_grid - min_grid <= 1)
+				break;
+
+			// we start by using interpolation search - it usually converges faster
+			// triangle count grows as a power of grid size, so we use the secant method in log-log space on the last two measurements
+			// however, interpolation search has a worst case of O(N) so we switch to binary search after a few iterations which converges in O(logN)
+			if (pass >= kInterpolationPasses)
+				next_grid_size = (min_grid + max_grid) / 2;
+			else if (triangles == 0)
+				next_grid_size = grid_size * 2;
+			else if (last_triangles == 0 || last_triangles == triangles)
+				next_grid_size = sloppyRoundGrid(sloppyPowerGuess(float(target_index_count / 3), float(grid_size), float(triangles)), triangles > target_index_count / 3);
+			else
+				next_grid_size = sloppyRoundGrid(sloppyPowerSecant(float(target_index_count / 3), float(last_grid), float(last_triangles), float(grid_size), float(triangles)), triangles > target_index_count / 3);
+
+			last_grid = grid_size;
+			last_triangles = triangles;
+		}
+	}
+
+	MESHOPTIMIZER_COUNTER("passes", search_passes);
+	MESHOPTIMIZER_COUNTER("grid_size", size_t(min_grid));
+
+	if (min_triangles == 0)
+		return 0;
+
+	// build vertex->cell association by mapping all vertices with the same quantized position to the same cell
+	size_t table_size = hashBuckets2(vertex_count);
+	unsigned int* table = allocator.allocate<unsigned int>(table_size);
+
+	unsigned int* vertex_cells = allocator.allocate<unsigned int>(vertex_count);
+
+	size_t cell_count = fillVertexCells(table, table_size, vertex_cells, min_vertex_ids, vertex_count);
+
+	// build a quadric for each target cell
+	Quadric* cell_quadrics = allocator.allocate<Quadric>(cell_count);
+	memset(cell_quadrics, 0, cell_count * sizeof(Quadric));
+
+	fillCellQuadrics(cell_quadrics, indices, index_count, vertex_positions, vertex_cells);
+
+	// for each target cell, find the vertex with the minimal error
+	unsigned int* cell_remap = allocator.allocate<unsigned int>(cell_count);
+	float* cell_errors = allocator.allocate<float>(cell_count);
+
+	fillCellRemap(cell_remap, cell_errors, cell_count, vertex_cells, cell_quadrics, vertex_positions, vertex_count);
+
+	// collapse triangles!
+	// note that we need to filter out triangles that we've already output because we very frequently generate redundant triangles between cells :(
+	size_t tritable_size = hashBuckets2(min_triangles);
+	unsigned int* tritable = allocator.allocate<unsigned int>(tritable_size);
+
+	size_t write = filterTriangles(destination, tritable, tritable_size, indices, index_count, vertex_cells, cell_remap);
+	assert(write <= target_index_count || min_grid == error_grid);
+
+	if (result_error)
+		*result_error = computeCellError(vertex_cells, cell_remap, vertex_positions, vertex_count);
+
+#if TRACE
+	printf("result: %d cells, %d triangles (%d unfiltered)\n", int(cell_count), int(write / 3), int(min_triangles));
+#endif
+
+	return write;
+}
+
+size_t meshopt_simplifyPoints(unsigned int* destination, const float* vertex_positions_data, size_t vertex_count, size_t vertex_positions_stride, size_t target_vertex_count)
+{
+	using namespace meshopt;
+
+	MESHOPTIMIZER_ZONE("meshopt_simplifyPoints");
+
+	assert(vertex_positions_stride > 0 && vertex_positions_stride <= 256);
+	assert(vertex_positions_stride % sizeof(float) == 0);
+	assert(target_vertex_count <= vertex_count);
+
+	size_t target_cell_count = target_vertex_count;
+
+	if (target_cell_count == 0)
+		return 0;
+
+	meshopt_Allocator allocator;
+
+	Vector3* vertex_positions = allocator.allocate<Vector3>(vertex_count);
+	rescalePositions(vertex_positions, vertex_positions_data, vertex_count, vertex_positions_stride);
+
+	// find the optimal grid size using guided binary search
+#if TRACE
+	printf("source: %d vertices\n", int(vertex_count));
+	printf("target: %d cells\n", int(target_cell_count));
+#endif
+
+	unsigned int* vertex_ids = allocator.allocate<unsigned int>(vertex_count);
+
+	size_t table_size = hashBuckets2(vertex_count);
+	unsigned int* table = allocator.allocate<unsigned int>(table_size);
+
+	const int kInterpolationPasses = 5;
+
+	// invariant: # of vertices in min_grid <= target_count
+	int min_grid = 0;
+	int max_grid = 1025;
+	size_t min_vertices = 0;
+	size_t max_vertices = vertex_count;
+
+	// instead of starting in the middle, let's guess as to what the answer might be! triangle count usually grows as a square of grid size...
+	int next_grid_size = int(sqrtf(float(target_cell_count)) + 0.5f);
+
+	for (int pass = 0; pass < 10 + kInterpolationPasses; ++pass)
+	{
+		assert(min_vertices < target_vertex_count);
+		assert(max_grid - min_grid > 1);
+
+		// we clamp the prediction of the grid size to make sure that the search converges
+		int grid_size = next_grid_size;
+		grid_size = (grid_size <= min_grid) ? min_grid + 1 : (grid_size >= max_grid) ? max_grid - 1 : grid_size;
+
+		computeVertexIds(vertex_ids, vertex_positions, vertex_count, grid_size);
+		size_t vertices = countVertexCells(table, table_size, vertex_ids, vertex_count);
+
+#if TRACE
+		printf("pass %d (%s): grid size %d, vertices %d, %s\n",
+		       pass, (pass == 0) ? "guess" : (pass <= kInterpolationPasses) ? "lerp" : "binary",
+		       grid_size, int(vertices),
+		       (vertices <= target_vertex_count) ? "under" : "over");
+#endif
+
+		float tip = interpolate(float(target_vertex_count), float(min_grid), float(min_vertices), float(grid_size), float(vertices), float(max_grid), float(max_vertices));
+
+		if (vertices <= target_vertex_count)
+		{
+			min_grid = grid_size;
+			min_vertices = vertices;
+		}
+		else
+		{
+			max_grid = grid_size;
+			max_vertices = vertices;
+		}
+
+		if (vertices == target_vertex_count || max_grid - min_grid <= 1)
+			break;
+
+		// we start by using interpolation search - it usually converges faster
+		// however, interpolation search has a worst case of O(N) so we switch to binary search after a few iterations which converges in O(logN)
+		next_grid_size = (pass < kInterpolationPasses) ? int(tip + 0.5f) : (min_grid + max_grid) / 2;
+	}
+
+	if (min_vertices == 0)
+		return 0;
+
+	// build vertex->cell association by mapping all vertices with the same quantized position to the same cell
+	unsigned int* vertex_cells = allocator.allocate<unsigned int>(vertex_count);
+
+	computeVertexIds(vertex_ids, vertex_positions, vertex_count, min_grid);
+	size_t cell_count = fillVertexCells(table, table_size, vertex_cells, vertex_ids, vertex_count);
+
+	// build a quadric for each target cell
+	Quadric* cell_quadrics = allocator.allocate<Quadric>(cell_count);
+	memset(cell_quadrics, 0, cell_count * sizeof(Quadric));
+
+	fillCellQuadrics(cell_quadrics, vertex_positions, vertex_count, vertex_cells);
+
+	// for each target cell, find the vertex with the minimal error
+	unsigned int* cell_remap = allocator.allocate<unsigned int>(cell_count);
+	float* cell_errors = allocator.allocate<float>(cell_count);
+
+	fillCellRemap(cell_remap, cell_errors, cell_count, vertex_cells, cell_quadrics, vertex_positions, vertex_count);
+
+	// copy results to the output
+	assert(cell_count <= target_vertex_count);
+	memcpy(destination, cell_remap, sizeof(unsigned int) * cell_count);
+
+#if TRACE
+	printf("result: %d cells\n", int(cell_count));
+#endif
+
+	return cell_count;
+}
+
+meshopt_SloppyStream* meshopt_createSloppyStream(const float* box_min, const float* box_max, size_t grid_size, size_t max_cells, size_t max_triangles)
+{
+	using namespace meshopt;
+
+	MESHOPTIMIZER_ZONE("meshopt_createSloppyStream");
+
+	assert(grid_size >= 1 && grid_size <= 1024);
+	assert(max_cells > 0);
+
+	// all state is placed in a single allocation along with the stream itself; it's proportional to the output, not the input
+	size_t header_size = (sizeof(meshopt_SloppyStream) + 15) & ~size_t(15);
+
+	SloppyStreamState dummy = {};
+	LinearAllocator sizer = {0, header_size};
+	allocateSloppyStreamState(dummy, max_cells, max_triangles, sizer);
+
+	meshopt_Allocator::Callbacks callbacks = getPersistentCallbacks();
+	unsigned char* data = static_cast<unsigned char*>(meshopt_Allocator::allocateStorage(callbacks, sizer.size));
+
+	// persistent state is allocated directly so it's reported separately from temporary setup data
+	MESHOPTIMIZER_COUNTER("allocated", sizer.size);
+
+	meshopt_SloppyStream* stream = reinterpret_cast<meshopt_SloppyStream*>(data);
+	memset(stream, 0, sizeof(meshopt_SloppyStream));
+
+	stream->callbacks = callbacks;
+
+	SloppyStreamState& state = stream->state;
+
+	LinearAllocator linear = {data, header_size};
+	allocateSloppyStreamState(state, max_cells, max_triangles, linear);
+
+	assert(linear.size == sizer.size);
+
+	memset(state.cell_table, -1, state.cell_table_size * sizeof(unsigned int));
+	memset(state.triangle_table, -1, state.triangle_table_size * sizeof(unsigned int));
+
+	float extent = 0.f;
+
+	for (int k = 0; k < 3; ++k)
+	{
+		state.box_min[k] = box_min[k];
+		extent = (box_max[k] - box_min[k]) < extent ? extent : (box_max[k] - box_min[k]);
+	}
+
+	state.extent = extent;
+	state.scale = extent == 0 ? 0.f : 1.f / extent;
+	state.grid_size = int(grid_size);
+
+	return stream;
+}
+
+int meshopt_sloppyStreamAddTriangles(meshopt_SloppyStream* stream, const unsigned int* indices, size_t index_count, const float* vertex_positions_data, size_t vertex_count, size_t vertex_positions_stride)
+{
+	using namespace meshopt;
+
+	MESHOPTIMIZER_ZONE("meshopt_sloppyStreamAddTriangles");
+
+	assert(index_count % 3 == 0);
+	assert(vertex_positions_stride > 0 && vertex_positions_stride <= 256);
+	assert(vertex_positions_stride % sizeof(float) == 0);
+
+	SloppyStreamState& state = stream->state;
+
+	if (state.overflow)
+		return -1;
+
+	meshopt_Allocator allocator;
+
+	Vector3* positions = allocator.allocate<Vector3>(vertex_count);
+	unsigned int* vertex_cells = allocator.allocate<unsigned int>(vertex_count);
+
+	if (!addStreamVertices(state, vertex_cells, positions, vertex_positions_data, vertex_count, vertex_positions_stride))
+		return -1;
+
+	for (size_t i = 0; i < index_count; i += 3)
+	{
+		unsigned int i0 = indices[i + 0], i1 = indices[i + 1], i2 = indices[i + 2];
+		assert(i0 < vertex_count && i1 < vertex_count && i2 < vertex_count);
+
+		unsigned int c0 = vertex_cells[i0], c1 = vertex_cells[i1], c2 = vertex_cells[i2];
+
+		// same weighting as fillCellQuadrics
+		bool single_cell = (c0 == c1) & (c0 == c2);
+
+		Quadric Q;
+		quadricFromTriangle(Q, positions[i0], positions[i1], positions[i2], single_cell ? 3.f : 1.f);
+
+		quadricAdd(state.cell_quadrics[c0], Q);
 
-#if TRACE
-	printf("result: %d cells, %d triangles (%d unfiltered)\n", int(cell_count), int(write / 3), int(min_triangles));
-#endif
+		if (!single_cell)
+		{
+			quadricAdd(state.cell_quadrics[c1], Q);
+			quadricAdd(state.cell_quadrics[c2], Q);
+		}
 
-	return write;
+		if (c0 != c1 && c0 != c2 && c1 != c2)
+			addStreamTriangle(state, c0, c1, c2);
+	}
+
+	return state.overflow ? -1 : 0;
 }
 
-size_t meshopt_simplifyPoints(unsigned int* destination, const float* vertex_positions_data, size_t vertex_count, size_t vertex_positions_stride, size_t target_vertex_count)
+int meshopt_sloppyStreamAddPoints(meshopt_SloppyStream* stream, const float* vertex_positions_data, size_t vertex_count, size_t vertex_positions_stride)
 {
 	using namespace meshopt;
 
+	MESHOPTIMIZER_ZONE("meshopt_sloppyStreamAddPoints");
+
 	assert(vertex_positions_stride > 0 && vertex_positions_stride <= 256);
 	assert(vertex_positions_stride % sizeof(float) == 0);
-	assert(target_vertex_count <= vertex_count);
 
-	size_t target_cell_count = target_vertex_count;
+	SloppyStreamState& state = stream->state;
 
-	if (target_cell_count == 0)
+	if (state.overflow)
+		return -1;
+
+	meshopt_Allocator allocator;
+
+	Vector3* positions = allocator.allocate<Vector3>(vertex_count);
+	unsigned int* vertex_cells = allocator.allocate<unsigned int>(vertex_count);
+
+	// point clouds have no quadrics, so the cell position is the mean of cell points
+	return addStreamVertices(state, vertex_cells, positions, vertex_positions_data, vertex_count, vertex_positions_stride) ? 0 : -1;
+}
+
+size_t meshopt_sloppyStreamGetVertices(const meshopt_SloppyStream* stream, float* destination)
+{
+	using namespace meshopt;
+
+	MESHOPTIMIZER_ZONE("meshopt_sloppyStreamGetVertices");
+
+	const SloppyStreamState& state = stream->state;
+
+	if (state.overflow)
+		return 0;
+
+	if (destination)
+	{
+		for (size_t i = 0; i < state.cell_count; ++i)
+		{
+			Vector3 v = solveStreamCell(state, i);
+
+			destination[i * 3 + 0] = state.box_min[0] + v.x * state.extent;
+			destination[i * 3 + 1] = state.box_min[1] + v.y * state.extent;
+			destination[i * 3 + 2] = state.box_min[2] + v.z * state.extent;
+		}
+	}
+
+	return state.cell_count;
+}
+
+size_t meshopt_sloppyStreamGetIndices(const meshopt_SloppyStream* stream, unsigned int* destination)
+{
+	const meshopt::SloppyStreamState& state = stream->state;
+
+	if (state.overflow)
 		return 0;
 
+	if (destination)
+		memcpy(destination, state.triangles, state.triangle_count * 3 * sizeof(unsigned int));
+
+	return state.triangle_count * 3;
+}
+
+void meshopt_destroySloppyStream(meshopt_SloppyStream* stream)
+{
+	// callbacks are stored in the allocation that is being released
+	meshopt_Allocator::Callbacks callbacks = stream->callbacks;
+	meshopt_Allocator::deallocateStorage(callbacks, stream);
+}
+
+namespace meshopt
+{
+
+static void mergeSpheres(float* result, const float* sphere)
+{
+	float dx = sphere[0] - result[0], dy = sphere[1] - result[1], dz = sphere[2] - result[2];
+	float distance = sqrtf(dx * dx + dy * dy + dz * dz);
+
+	// sphere is already inside the result
+	if (distance + sphere[3] <= result[3])
+		return;
+
+	// result is inside the sphere
+	if (distance + result[3] <= sphere[3])
+	{
+		memcpy(result, sphere, 4 * sizeof(float));
+		return;
+	}
+
+	float radius = (distance + result[3] + sphere[3]) * 0.5f;
+	float k = (radius - result[3]) / distance;
+
+	result[0] += dx * k;
+	result[1] += dy * k;
+	result[2] += dz * k;
+	result[3] = radius;
+}
+
+static void initLodCluster(meshopt_LodCluster& cluster, const meshopt_PackedMeshlet& meshlet, unsigned int level)
+{
+	memset(&cluster, 0, sizeof(cluster));
+
+	cluster.vertex_offset = meshlet.vertex_offset;
+	cluster.triangle_offset = meshlet.triangle_offset;
+	cluster.vertex_count = meshlet.vertex_count;
+	cluster.triangle_count = meshlet.triangle_count;
+	cluster.level = level;
+
+	// clusters without parents are always rendered at coarse levels of detail
+	cluster.parent_error = FLT_MAX;
+}
+
+static size_t groupLodClusters(unsigned int* group_clusters, unsigned int* group_offsets, unsigned int* group_of, const meshopt_LodCluster* clusters, const unsigned int* pending, size_t pending_count, const unsigned int* cluster_vertices, const unsigned int* remap, const unsigned int* position_offsets, const unsigned int* position_clusters, size_t group_size, meshopt_Allocator& allocator)
+{
+	unsigned int* weights = allocator.allocate<unsigned int>(pending_count);
+	memset(weights, 0, pending_count * sizeof(unsigned int));
+
+	unsigned int* touched = allocator.allocate<unsigned int>(pending_count);
+
+	memset(group_of, -1, pending_count * sizeof(unsigned int));
+
+	size_t group_count = 0;
+	size_t group_cluster_count = 0;
+
+	// pending clusters are kept in spatially coherent order, so seeds are taken in order and groups grow through clusters sharing the most positions
+	for (size_t seed = 0; seed < pending_count; ++seed)
+	{
+		if (group_of[seed] != ~0u)
+			continue;
+
+		group_offsets[group_count] = unsigned(group_cluster_count);
+
+		size_t touched_count = 0;
+		unsigned int next = unsigned(seed);
+
+		for (size_t size = 0; size < group_size && next != ~0u; ++size)
+		{
+			group_of[next] = unsigned(group_count);
+			group_clusters[group_cluster_count++] = next;
+
+			const meshopt_LodCluster& cluster = clusters[pending[next]];
+
+			for (size_t j = 0; j < cluster.vertex_count; ++j)
+			{
+				unsigned int r = remap[cluster_vertices[cluster.vertex_offset + j]];
+
+				for (unsigned int k = position_offsets[r]; k < position_offsets[r + 1]; ++k)
+				{
+					unsigned int c = position_clusters[k];
+
+					if (group_of[c] != ~0u)
+						continue;
+
+					if (weights[c] == 0)
+						touched[touched_count++] = c;
+
+					weights[c]++;
+				}
+			}
+
+			// pick the ungrouped neighbor with the most shared positions; ties are resolved in favor of earlier clusters for determinism
+			next = ~0u;
+
+			for (size_t j = 0; j < touched_count; ++j)
+			{
+				unsigned int c = touched[j];
+
+				if (group_of[c] == ~0u && (next == ~0u || weights[c] > weights[next] || (weights[c] == weights[next] && c < next)))
+					next = c;
+			}
+		}
+
+		for (size_t j = 0; j < touched_count; ++j)
+			weights[touched[j]] = 0;
+
+		group_count++;
+	}
+
+	group_offsets[group_count] = unsigned(group_cluster_count);
+
+	return group_count;
+}
+
+} // namespace meshopt
+
+size_t meshopt_buildClusterLodBound(size_t index_count, size_t max_vertices, size_t max_triangles, size_t group_size)
+{
+	assert(group_size >= 2);
+
+	// every accepted group of g clusters produces at most g-1 clusters, so each level has at most (group_size-1)/group_size clusters of the previous one
+	return meshopt_buildMeshletsBound(index_count, max_vertices, max_triangles) * group_size;
+}
+
+size_t meshopt_buildClusterLod(meshopt_LodCluster* clusters, unsigned int* cluster_vertices, unsigned char* cluster_triangles, unsigned int* cluster_children, const unsigned int* indices, size_t index_count, const float* vertex_positions_data, size_t vertex_count, size_t vertex_positions_stride, size_t max_vertices, size_t max_triangles, size_t group_size)
+{
+	using namespace meshopt;
+
+	MESHOPTIMIZER_ZONE("meshopt_buildClusterLod");
+
+	assert(index_count % 3 == 0);
+	assert(vertex_positions_stride > 0 && vertex_positions_stride <= 256);
+	assert(vertex_positions_stride % sizeof(float) == 0);
+	assert(max_vertices >= 3 && max_vertices <= 255);
+	assert(max_triangles >= 1 && max_triangles <= 512);
+	assert(group_size >= 2);
+
 	meshopt_Allocator allocator;
 
-	Vector3* vertex_positions = allocator.allocate<Vector3>(vertex_count);
-	rescalePositions(vertex_positions, vertex_positions_data, vertex_count, vertex_positions_stride);
+	size_t vertex_stride_float = vertex_positions_stride / sizeof(float);
 
-	// find the optimal grid size using guided binary search
-#if TRACE
-	printf("source: %d vertices\n", int(vertex_count));
-	printf("target: %d cells\n", int(target_cell_count));
-#endif
+	// position remap is shared by all levels; clusters are adjacent if they reference the same position
+	unsigned int* remap = allocator.allocate<unsigned int>(vertex_count);
+	unsigned int* wedge = allocator.allocate<unsigned int>(vertex_count);
+	buildPositionRemap(remap, wedge, vertex_positions_data, vertex_count, vertex_positions_stride, allocator);
 
-	unsigned int* vertex_ids = allocator.allocate<unsigned int>(vertex_count);
+	size_t max_meshlets = meshopt_buildMeshletsBound(index_count, max_vertices, max_triangles);
 
-	size_t table_size = hashBuckets2(vertex_count);
-	unsigned int* table = allocator.allocate<unsigned int>(table_size);
+	// clusters that don't have parents yet; the number of pending clusters never increases so the lists fit max_meshlets
+	unsigned int* pending = allocator.allocate<unsigned int>(max_meshlets);
+	unsigned int* next_pending = allocator.allocate<unsigned int>(max_meshlets);
 
-	const int kInterpolationPasses = 5;
+	size_t cluster_count = 0;
+	size_t vertex_offset = 0;
+	size_t triangle_offset = 0;
+	size_t child_offset = 0;
 
-	// invariant: # of vertices in min_grid <= target_count
-	int min_grid = 0;
-	int max_grid = 1025;
-	size_t min_vertices = 0;
-	size_t max_vertices = vertex_count;
+	// level 0 clusters are regular meshlets of the original mesh
+	{
+		meshopt_PackedMeshlet* meshlets = allocator.allocate<meshopt_PackedMeshlet>(max_meshlets);
 
-	// instead of starting in the middle, let's guess as to what the answer might be! triangle count usually grows as a square of grid size...
-	int next_grid_size = int(sqrtf(float(target_cell_count)) + 0.5f);
+		cluster_count = meshopt_buildMeshletsPacked(meshlets, cluster_vertices, cluster_triangles, indices, index_count, vertex_positions_data, vertex_count, vertex_positions_stride, max_vertices, max_triangles, 0.f);
 
-	for (int pass = 0; pass < 10 + kInterpolationPasses; ++pass)
+		unsigned int cluster_indices[512 * 3];
+
+		for (size_t i = 0; i < cluster_count; ++i)
+		{
+			const meshopt_PackedMeshlet& meshlet = meshlets[i];
+			meshopt_LodCluster& cluster = clusters[i];
+
+			initLodCluster(cluster, meshlet, 0);
+
+			for (size_t j = 0; j < meshlet.triangle_count * 3; ++j)
+				cluster_indices[j] = cluster_vertices[meshlet.vertex_offset + cluster_triangles[meshlet.triangle_offset + j]];
+
+			meshopt_Bounds bounds = meshopt_computeClusterBounds(cluster_indices, meshlet.triangle_count * 3, vertex_positions_data, vertex_count, vertex_positions_stride);
+
+			memcpy(cluster.center, bounds.center, 3 * sizeof(float));
+			cluster.radius = bounds.radius;
+
+			pending[i] = unsigned(i);
+
+			vertex_offset = meshlet.vertex_offset + meshlet.vertex_count;
+			triangle_offset = meshlet.triangle_offset + ((meshlet.triangle_count * 3 + 3) & ~3);
+		}
+	}
+
+	size_t pending_count = cluster_count;
+	size_t accepted_count = 1;
+
+	// every round groups all pending clusters; clusters of groups that couldn't be simplified stay pending for the next round
+	while (pending_count > 1 && accepted_count > 0)
 	{
-		assert(min_vertices < target_vertex_count);
-		assert(max_grid - min_grid > 1);
+		MESHOPTIMIZER_ZONE("buildClusterLodRound");
 
-		// we clamp the prediction of the grid size to make sure that the search converges
-		int grid_size = next_grid_size;
-		grid_size = (grid_size <= min_grid) ? min_grid + 1 : (grid_size >= max_grid) ? max_grid - 1 : grid_size;
+		meshopt_Allocator round_allocator;
 
-		computeVertexIds(vertex_ids, vertex_positions, vertex_count, grid_size);
-		size_t vertices = countVertexCells(table, table_size, vertex_ids, vertex_count);
+		// build position -> pending cluster lists
+		unsigned int* position_offsets = round_allocator.allocate<unsigned int>(vertex_count + 1);
+		memset(position_offsets, 0, (vertex_count + 1) * sizeof(unsigned int));
 
-#if TRACE
-		printf("pass %d (%s): grid size %d, vertices %d, %s\n",
-		       pass, (pass == 0) ? "guess" : (pass <= kInterpolationPasses) ? "lerp" : "binary",
-		       grid_size, int(vertices),
-		       (vertices <= target_vertex_count) ? "under" : "over");
-#endif
+		for (size_t i = 0; i < pending_count; ++i)
+		{
+			const meshopt_LodCluster& cluster = clusters[pending[i]];
 
-		float tip = interpolate(float(target_vertex_count), float(min_grid), float(min_vertices), float(grid_size), float(vertices), float(max_grid), float(max_vertices));
+			for (size_t j = 0; j < cluster.vertex_count; ++j)
+				position_offsets[remap[cluster_vertices[cluster.vertex_offset + j]]]++;
+		}
 
-		if (vertices <= target_vertex_count)
+		unsigned int position_total = 0;
+
+		for (size_t i = 0; i <= vertex_count; ++i)
 		{
-			min_grid = grid_size;
-			min_vertices = vertices;
+			unsigned int count = position_offsets[i];
+			position_offsets[i] = position_total;
+			position_total += count;
 		}
-		else
+
+		unsigned int* position_clusters = round_allocator.allocate<unsigned int>(position_total);
+
+		for (size_t i = 0; i < pending_count; ++i)
 		{
-			max_grid = grid_size;
-			max_vertices = vertices;
+			const meshopt_LodCluster& cluster = clusters[pending[i]];
+
+			for (size_t j = 0; j < cluster.vertex_count; ++j)
+				position_clusters[position_offsets[remap[cluster_vertices[cluster.vertex_offset + j]]]++] = unsigned(i);
 		}
 
-		if (vertices == target_vertex_count || max_grid - min_grid <= 1)
-			break;
+		// offsets were advanced to the end of each list during the fill
+		for (size_t i = vertex_count; i > 0; --i)
+			position_offsets[i] = position_offsets[i - 1];
 
-		// we start by using interpolation search - it usually converges faster
-		// however, interpolation search has a worst case of O(N) so we switch to binary search after a few iterations which converges in O(logN)
-		next_grid_size = (pass < kInterpolationPasses) ? int(tip + 0.5f) : (min_grid + max_grid) / 2;
-	}
+		position_offsets[0] = 0;
 
-	if (min_vertices == 0)
-		return 0;
+		unsigned int* group_clusters = round_allocator.allocate<unsigned int>(pending_count);
+		unsigned int* group_offsets = round_allocator.allocate<unsigned int>(pending_count + 1);
+		unsigned int* group_of = round_allocator.allocate<unsigned int>(pending_count);
 
-	// build vertex->cell association by mapping all vertices with the same quantized position to the same cell
-	unsigned int* vertex_cells = allocator.allocate<unsigned int>(vertex_count);
+		size_t group_count = groupLodClusters(group_clusters, group_offsets, group_of, clusters, pending, pending_count, cluster_vertices, remap, position_offsets, position_clusters, group_size, round_allocator);
 
-	computeVertexIds(vertex_ids, vertex_positions, vertex_count, min_grid);
-	size_t cell_count = fillVertexCells(table, table_size, vertex_cells, vertex_ids, vertex_count);
+		unsigned int* vertex_local = round_allocator.allocate<unsigned int>(vertex_count);
+		unsigned int* vertex_stamp = round_allocator.allocate<unsigned int>(vertex_count);
+		memset(vertex_stamp, -1, vertex_count * sizeof(unsigned int));
 
-	// build a quadric for each target cell
-	Quadric* cell_quadrics = allocator.allocate<Quadric>(cell_count);
-	memset(cell_quadrics, 0, cell_count * sizeof(Quadric));
+		size_t next_pending_count = 0;
+		accepted_count = 0;
 
-	fillCellQuadrics(cell_quadrics, vertex_positions, vertex_count, vertex_cells);
+		for (size_t g = 0; g < group_count; ++g)
+		{
+			const unsigned int* group = group_clusters + group_offsets[g];
+			size_t group_cluster_count = group_offsets[g + 1] - group_offsets[g];
 
-	// for each target cell, find the vertex with the minimal error
-	unsigned int* cell_remap = allocator.allocate<unsigned int>(cell_count);
-	float* cell_errors = allocator.allocate<float>(cell_count);
+			bool accepted = false;
 
-	fillCellRemap(cell_remap, cell_errors, cell_count, vertex_cells, cell_quadrics, vertex_positions, vertex_count);
+			// single cluster groups can't be replaced by fewer clusters
+			if (group_cluster_count > 1)
+			{
+				meshopt_Allocator group_allocator;
 
-	// copy results to the output
-	assert(cell_count <= target_vertex_count);
-	memcpy(destination, cell_remap, sizeof(unsigned int) * cell_count);
+				size_t group_index_count = 0;
+				size_t group_vertex_limit = 0;
 
-#if TRACE
-	printf("result: %d cells\n", int(cell_count));
-#endif
+				for (size_t i = 0; i < group_cluster_count; ++i)
+				{
+					group_index_count += clusters[pending[group[i]]].triangle_count * 3;
+					group_vertex_limit += clusters[pending[group[i]]].vertex_count;
+				}
 
-	return cell_count;
+				// merge clusters into a single index buffer with group-local vertices
+				unsigned int* group_indices = group_allocator.allocate<unsigned int>(group_index_count);
+				unsigned int* group_vertices = group_allocator.allocate<unsigned int>(group_vertex_limit);
+				float* group_positions = group_allocator.allocate<float>(group_vertex_limit * 3);
+				unsigned char* group_lock = group_allocator.allocate<unsigned char>(group_vertex_limit);
+
+				size_t group_vertex_count = 0;
+				size_t offset = 0;
+
+				for (size_t i = 0; i < group_cluster_count; ++i)
+				{
+					const meshopt_LodCluster& cluster = clusters[pending[group[i]]];
+
+					for (size_t j = 0; j < cluster.triangle_count * 3; ++j)
+					{
+						unsigned int v = cluster_vertices[cluster.vertex_offset + cluster_triangles[cluster.triangle_offset + j]];
+
+						if (vertex_stamp[v] != g)
+						{
+							vertex_stamp[v] = unsigned(g);
+							vertex_local[v] = unsigned(group_vertex_count);
+
+							const float* p = vertex_positions_data + v * vertex_stride_float;
+							memcpy(&group_positions[group_vertex_count * 3], p, 3 * sizeof(float));
+
+							// positions shared with pending clusters outside of the group must stay in place to keep the group border watertight
+							unsigned int r = remap[v];
+							bool locked = false;
+
+							for (unsigned int k = position_offsets[r]; k < position_offsets[r + 1] && !locked; ++k)
+								locked = group_of[position_clusters[k]] != g;
+
+							group_lock[group_vertex_count] = locked;
+							group_vertices[group_vertex_count++] = v;
+						}
+
+						group_indices[offset++] = vertex_local[v];
+					}
+				}
+
+				size_t target_index_count = group_index_count / 6 * 3;
+				float group_error = 0.f;
+
+				size_t result_count = simplifyEdge(group_indices, group_indices, group_index_count, group_positions, group_vertex_count, sizeof(float) * 3, NULL, 0, NULL, 0, target_index_count, FLT_MAX, group_lock, &group_error);
+
+				// split the simplified group into new clusters
+				size_t group_max_meshlets = meshopt_buildMeshletsBound(result_count, max_vertices, max_triangles);
+				meshopt_PackedMeshlet* meshlets = group_allocator.allocate<meshopt_PackedMeshlet>(group_max_meshlets);
+				unsigned int* meshlet_vertices = group_allocator.allocate<unsigned int>(group_max_meshlets * max_vertices);
+				unsigned char* meshlet_triangles = group_allocator.allocate<unsigned char>(group_max_meshlets * ((max_triangles * 3 + 3) & ~3));
+
+				size_t meshlet_count = result_count ? meshopt_buildMeshletsPacked(meshlets, meshlet_vertices, meshlet_triangles, group_indices, result_count, group_positions, group_vertex_count, sizeof(float) * 3, max_vertices, max_triangles, 0.f) : 0;
+
+				// groups are only replaced if that reduces the cluster count, which bounds the total size of the hierarchy
+				if (meshlet_count > 0 && meshlet_count < group_cluster_count)
+				{
+					accepted = true;
+
+					// all clusters produced by the group share the group bounds and error, which keeps level of detail selection consistent between siblings
+					const meshopt_LodCluster& first = clusters[pending[group[0]]];
+					float sphere[4] = {first.center[0], first.center[1], first.center[2], first.radius};
+
+					float child_error = 0.f;
+					unsigned int child_level = 0;
+
+					for (size_t i = 0; i < group_cluster_count; ++i)
+					{
+						const meshopt_LodCluster& child = clusters[pending[group[i]]];
+
+						float child_sphere[4] = {child.center[0], child.center[1], child.center[2], child.radius};
+						mergeSpheres(sphere, child_sphere);
+
+						child_error = child_error < child.error ? child.error : child_error;
+						child_level = child_level < child.level ? child.level : child_level;
+
+						cluster_children[child_offset + i] = pending[group[i]];
+					}
+
+					// simplification error is relative to the group input, so accumulating child error keeps the error conservative and monotonic
+					float error = child_error + group_error * getPositionExtent(group_positions, group_vertex_count, 3);
+
+					for (size_t i = 0; i < group_cluster_count; ++i)
+					{
+						meshopt_LodCluster& child = clusters[pending[group[i]]];
+
+						child.parent_offset = unsigned(cluster_count);
+						child.parent_count = unsigned(meshlet_count);
+						memcpy(child.parent_center, sphere, 3 * sizeof(float));
+						child.parent_radius = sphere[3];
+						child.parent_error = error;
+					}
+
+					for (size_t i = 0; i < meshlet_count; ++i)
+					{
+						meshopt_PackedMeshlet meshlet = meshlets[i];
+
+						for (size_t j = 0; j < meshlet.vertex_count; ++j)
+							cluster_vertices[vertex_offset + j] = group_vertices[meshlet_vertices[meshlet.vertex_offset + j]];
+
+						size_t triangle_size = (meshlet.triangle_count * 3 + 3) & ~3;
+						memcpy(&cluster_triangles[triangle_offset], &meshlet_triangles[meshlet.triangle_offset], triangle_size);
+
+						meshlet.vertex_offset = unsigned(vertex_offset);
+						meshlet.triangle_offset = unsigned(triangle_offset);
+
+						next_pending[next_pending_count++] = unsigned(cluster_count);
+
+						meshopt_LodCluster& cluster = clusters[cluster_count++];
+						initLodCluster(cluster, meshlet, child_level + 1);
+
+						memcpy(cluster.center, sphere, 3 * sizeof(float));
+						cluster.radius = sphere[3];
+						cluster.error = error;
+						cluster.child_offset = unsigned(child_offset);
+						cluster.child_count = unsigned(group_cluster_count);
+
+						vertex_offset += meshlet.vertex_count;
+						triangle_offset += triangle_size;
+					}
+
+					child_offset += group_cluster_count;
+				}
+			}
+
+			if (accepted)
+				accepted_count++;
+			else
+				for (size_t i = 0; i < group_cluster_count; ++i)
+					next_pending[next_pending_count++] = pending[group[i]];
+		}
+
+		MESHOPTIMIZER_COUNTER("groups", group_count);
+		MESHOPTIMIZER_COUNTER("accepted", accepted_count);
+
+		assert(next_pending_count <= pending_count);
+
+		unsigned int* swap = pending;
+		pending = next_pending;
+		next_pending = swap;
+
+		pending_count = next_pending_count;
+	}
+
+	return cluster_count;
 }
@@ -107,6 +107,211 @@ static void radixPass(unsigned int* destination, const unsigned int* source, con
 	}
 }
 
+// "Insert" two 0 bits after each of the 21 low bits of x
+inline unsigned long long part1By2Wide(unsigned int v)
+{
+	unsigned long long x = v & 0x1fffff;
+	x = (x ^ (x << 32)) & 0x001f00000000ffffull;
+	x = (x ^ (x << 16)) & 0x001f0000ff0000ffull;
+	x = (x ^ (x << 8)) & 0x100f00f00f00f00full;
+	x = (x ^ (x << 4)) & 0x10c30c30c30c30c3ull;
+	x = (x ^ (x << 2)) & 0x1249249249249249ull;
+	return x;
+}
+
+const size_t kSortBlock = 65536;
+const int kSortBits = 11;
+const int kSortPasses = 6; // 63-bit keys
+const int kSortLevels = 21;
+
+struct SpatialSortContext
+{
+	const float* vertex_positions;
+	size_t vertex_stride_float;
+	size_t vertex_count;
+
+	float (*block_bounds)[6];
+	float minv[3];
+	float scale;
+
+	unsigned long long* keys[2];
+	unsigned int* order[2];
+
+	unsigned int* block_hist; // block_count x (1 << kSortBits)
+	int pass;
+	int current; // index of keys/order that contain the data sorted by previous passes
+};
+
+static void computeBlockBounds(void* task_data, size_t task_index)
+{
+	const SpatialSortContext& context = *static_cast<const SpatialSortContext*>(task_data);
+
+	size_t begin = task_index * kSortBlock;
+	size_t end = begin + kSortBlock < context.vertex_count ? begin + kSortBlock : context.vertex_count;
+
+	float minv[3] = {FLT_MAX, FLT_MAX, FLT_MAX};
+	float maxv[3] = {-FLT_MAX, -FLT_MAX, -FLT_MAX};
+
+	for (size_t i = begin; i < end; ++i)
+	{
+		const float* v = context.vertex_positions + i * context.vertex_stride_float;
+
+		for (int j = 0; j < 3; ++j)
+		{
+			float vj = v[j];
+
+			minv[j] = minv[j] > vj ? vj : minv[j];
+			maxv[j] = maxv[j] < vj ? vj : maxv[j];
+		}
+	}
+
+	float* result = context.block_bounds[task_index];
+
+	for (int j = 0; j < 3; ++j)
+	{
+		result[j] = minv[j];
+		result[3 + j] = maxv[j];
+	}
+}
+
+static void computeBlockKeys(void* task_data, size_t task_index)
+{
+	const SpatialSortContext& context = *static_cast<const SpatialSortContext*>(task_data);
+
+	size_t begin = task_index * kSortBlock;
+	size_t end = begin + kSortBlock < context.vertex_count ? begin + kSortBlock : context.vertex_count;
+
+	const float grid = float((1 << kSortLevels) - 1);
+
+	for (size_t i = begin; i < end; ++i)
+	{
+		const float* v = context.vertex_positions + i * context.vertex_stride_float;
+
+		unsigned int x = unsigned((v[0] - context.minv[0]) * context.scale * grid + 0.5f);
+		unsigned int y = unsigned((v[1] - context.minv[1]) * context.scale * grid + 0.5f);
+		unsigned int z = unsigned((v[2] - context.minv[2]) * context.scale * grid + 0.5f);
+
+		context.keys[0][i] = part1By2Wide(x) | (part1By2Wide(y) << 1) | (part1By2Wide(z) << 2);
+		context.order[0][i] = unsigned(i);
+	}
+}
+
+static void computeBlockHistogram(void* task_data, size_t task_index)
+{
+	const SpatialSortContext& context = *static_cast<const SpatialSortContext*>(task_data);
+
+	size_t begin = task_index * kSortBlock;
+	size_t end = begin + kSortBlock < context.vertex_count ? begin + kSortBlock : context.vertex_count;
+
+	const unsigned long long* keys = context.keys[context.current];
+	int bitoff = context.pass * kSortBits;
+
+	unsigned int* hist = context.block_hist + (task_index << kSortBits);
+	memset(hist, 0, sizeof(unsigned int) << kSortBits);
+
+	for (size_t i = begin; i < end; ++i)
+		hist[(keys[i] >> bitoff) & ((1 << kSortBits) - 1)]++;
+}
+
+static void scatterBlock(void* task_data, size_t task_index)
+{
+	const SpatialSortContext& context = *static_cast<const SpatialSortContext*>(task_data);
+
+	size_t begin = task_index * kSortBlock;
+	size_t end = begin + kSortBlock < context.vertex_count ? begin + kSortBlock : context.vertex_count;
+
+	const unsigned long long* keys = context.keys[context.current];
+	const unsigned int* order = context.order[context.current];
+	unsigned long long* keys_out = context.keys[context.current ^ 1];
+	unsigned int* order_out = context.order[context.current ^ 1];
+
+	int bitoff = context.pass * kSortBits;
+
+	// histogram has been converted to output offsets for this block, so blocks can scatter independently
+	unsigned int* offsets = context.block_hist + (task_index << kSortBits);
+
+	for (size_t i = begin; i < end; ++i)
+	{
+		unsigned long long key = keys[i];
+		unsigned int write = offsets[(key >> bitoff) & ((1 << kSortBits) - 1)]++;
+
+		keys_out[write] = key;
+		order_out[write] = order[i];
+	}
+}
+
+static void runSortTasks(meshopt_Scheduler scheduler, void* scheduler_context, void (*task)(void*, size_t), SpatialSortContext& context, size_t task_count)
+{
+	if (scheduler)
+		scheduler(scheduler_context, task, &context, task_count);
+	else
+		for (size_t i = 0; i < task_count; ++i)
+			task(&context, i);
+}
+
+static size_t findKeyBoundary(const unsigned long long* keys, size_t begin, size_t end, unsigned long long prefix, int shift)
+{
+	// first element in [begin, end) with key prefix greater than the given prefix
+	while (begin < end)
+	{
+		size_t mid = begin + (end - begin) / 2;
+
+		if ((keys[mid] >> shift) <= prefix)
+			begin = mid + 1;
+		else
+			end = mid;
+	}
+
+	return begin;
+}
+
+struct SpatialChunkBuilder
+{
+	unsigned int* offsets;
+	size_t count;
+	size_t max_size;
+	size_t last;
+};
+
+static void appendChunkCell(SpatialChunkBuilder& builder, size_t begin, size_t end)
+{
+	assert(builder.last <= begin);
+
+	// consecutive cells are merged while they fit, so every pair of adjacent chunks has more than max_size elements
+	if (end - builder.last > builder.max_size && builder.last < begin)
+	{
+		builder.offsets[++builder.count] = unsigned(begin);
+		builder.last = begin;
+	}
+
+	// cells with more than max_size identical keys can't be subdivided, so we split them into full chunks
+	while (end - builder.last > builder.max_size)
+	{
+		builder.last += builder.max_size;
+		builder.offsets[++builder.count] = unsigned(builder.last);
+	}
+}
+
+static void buildChunks(SpatialChunkBuilder& builder, const unsigned long long* keys, size_t begin, size_t end, int level)
+{
+	if (end - begin <= builder.max_size || level == kSortLevels)
+		return appendChunkCell(builder, begin, end);
+
+	// split the octree cell into 8 children; keys are sorted so children are contiguous ranges
+	int shift = 3 * (kSortLevels - level - 1);
+	unsigned long long prefix = (keys[begin] >> shift) & ~7ull;
+
+	for (size_t child = 0; child < 8 && begin < end; ++child)
+	{
+		size_t split = findKeyBoundary(keys, begin, end, prefix | child, shift);
+
+		if (split > begin)
+			buildChunks(builder, keys, begin, split, level + 1);
+
+		begin = split;
+	}
+}
+
 } // namespace meshopt
 
 void meshopt_spatialSortRemap(unsigned int* destination, const float* vertex_positions, size_t vertex_count, size_t vertex_positions_stride)
@@ -139,6 +344,127 @@ void meshopt_spatialSortRemap(unsigned int* destination, const float* vertex_pos
 		destination[scratch[i]] = unsigned(i);
 }
 
+size_t meshopt_spatialSortRemapParallel(unsigned int* destination, unsigned int* chunk_offsets, size_t max_chunk_size, const float* vertex_positions, size_t vertex_count, size_t vertex_positions_stride, meshopt_Scheduler scheduler, void* scheduler_context)
+{
+	using namespace meshopt;
+
+	assert(vertex_positions_stride > 0 && vertex_positions_stride <= 256);
+	assert(vertex_positions_stride % sizeof(float) == 0);
+	assert(!chunk_offsets || max_chunk_size > 0);
+
+	meshopt_Allocator allocator;
+
+	size_t block_count = (vertex_count + kSortBlock - 1) / kSortBlock;
+
+	SpatialSortContext context = {};
+	context.vertex_positions = vertex_positions;
+	context.vertex_stride_float = vertex_positions_stride / sizeof(float);
+	context.vertex_count = vertex_count;
+
+	// compute bounds per block and reduce them
+	context.block_bounds = allocator.allocate<float[6]>(block_count);
+	runSortTasks(scheduler, scheduler_context, computeBlockBounds, context, block_count);
+
+	float minv[3] = {FLT_MAX, FLT_MAX, FLT_MAX};
+	float maxv[3] = {-FLT_MAX, -FLT_MAX, -FLT_MAX};
+
+	for (size_t i = 0; i < block_count; ++i)
+		for (int j = 0; j < 3; ++j)
+		{
+			minv[j] = minv[j] > context.block_bounds[i][j] ? context.block_bounds[i][j] : minv[j];
+			maxv[j] = maxv[j] < context.block_bounds[i][3 + j] ? context.block_bounds[i][3 + j] : maxv[j];
+		}
+
+	float extent = 0.f;
+
+	extent = (maxv[0] - minv[0]) < extent ? extent : (maxv[0] - minv[0]);
+	extent = (maxv[1] - minv[1]) < extent ? extent : (maxv[1] - minv[1]);
+	extent = (maxv[2] - minv[2]) < extent ? extent : (maxv[2] - minv[2]);
+
+	memcpy(context.minv, minv, sizeof(minv));
+	context.scale = extent == 0 ? 0.f : 1.f / extent;
+
+	// generate 63-bit Morton keys based on the position inside a unit cube
+	for (int k = 0; k < 2; ++k)
+	{
+		context.keys[k] = allocator.allocate<unsigned long long>(vertex_count);
+		context.order[k] = allocator.allocate<unsigned int>(vertex_count);
+	}
+
+	runSortTasks(scheduler, scheduler_context, computeBlockKeys, context, block_count);
+
+	// LSD radix sort; each pass computes per-block histograms, converts them to per-block output offsets and scatters blocks independently, which keeps the sort stable
+	context.block_hist = allocator.allocate<unsigned int>(block_count << kSortBits);
+
+	for (int pass = 0; pass < kSortPasses; ++pass)
+	{
+		context.pass = pass;
+
+		runSortTasks(scheduler, scheduler_context, computeBlockHistogram, context, block_count);
+
+		unsigned int sum = 0;
+		unsigned int max_bucket = 0;
+
+		for (size_t bucket = 0; bucket < (1 << kSortBits); ++bucket)
+		{
+			unsigned int bucket_start = sum;
+
+			for (size_t block = 0; block < block_count; ++block)
+			{
+				unsigned int& h = context.block_hist[(block << kSortBits) + bucket];
+				unsigned int count = h;
+
+				h = sum;
+				sum += count;
+			}
+
+			max_bucket = max_bucket < sum - bucket_start ? sum - bucket_start : max_bucket;
+		}
+
+		assert(sum == vertex_count);
+
+		// when all keys share the same digit the pass doesn't change the order; this is common for high bits when the input is flat along some axis
+		if (max_bucket == vertex_count)
+			continue;
+
+		runSortTasks(scheduler, scheduler_context, scatterBlock, context, block_count);
+
+		context.current ^= 1;
+	}
+
+	const unsigned long long* keys = context.keys[context.current];
+	const unsigned int* order = context.order[context.current];
+
+	// since our remap table is mapping old=>new, we need to reverse it
+	for (size_t i = 0; i < vertex_count; ++i)
+		destination[order[i]] = unsigned(i);
+
+	if (!chunk_offsets)
+		return 0;
+
+	SpatialChunkBuilder builder = {chunk_offsets, 0, max_chunk_size, 0};
+	chunk_offsets[0] = 0;
+
+	if (vertex_count)
+	{
+		buildChunks(builder, keys, 0, vertex_count, 0);
+
+		builder.offsets[++builder.count] = unsigned(vertex_count);
+	}
+
+	assert(builder.count <= meshopt_spatialSortChunkBound(vertex_count, max_chunk_size));
+
+	return builder.count;
+}
+
+size_t meshopt_spatialSortChunkBound(size_t vertex_count, size_t max_chunk_size)
+{
+	assert(max_chunk_size > 0);
+
+	// greedy merging guarantees that every two adjacent chunks have more than max_chunk_size elements in total
+	return (vertex_count + max_chunk_size - 1) / max_chunk_size * 2;
+}
+
 void meshopt_spatialSortTriangles(unsigned int* destination, const unsigned int* indices, size_t index_count, const float* vertex_positions, size_t vertex_count, size_t vertex_positions_stride)
 {
 	using namespace meshopt;
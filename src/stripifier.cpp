@@ -47,6 +47,347 @@ static int findStripNext(const unsigned int buffer[][3], unsigned int buffer_siz
 	return -1;
 }
 
+static size_t hashBuckets4(size_t count)
+{
+	size_t buckets = 1;
+	while (buckets < count)
+		buckets *= 2;
+
+	return buckets;
+}
+
+static unsigned int* hashLookupEdge(unsigned int* table, size_t buckets, unsigned int a, unsigned int b)
+{
+	assert(buckets > 0);
+	assert((buckets & (buckets - 1)) == 0);
+
+	// edges are keyed by their vertices in either order, so both halves of the edge land in the same entry
+	unsigned int lo = a < b ? a : b, hi = a < b ? b : a;
+	unsigned int h = (lo * 0x9e3779b1u) ^ (hi * 0x85ebca77u);
+	h ^= h >> 15;
+
+	size_t hashmod = buckets - 1;
+	size_t bucket = h & hashmod;
+
+	for (size_t probe = 0; probe <= hashmod; ++probe)
+	{
+		// each entry stores the edge vertices in the order of the last edge that used the entry, followed by the index of that edge
+		unsigned int* item = &table[bucket * 3];
+
+		if (item[2] == ~0u || (item[0] == a && item[1] == b) || (item[0] == b && item[1] == a))
+			return item;
+
+		// hash collision, quadratic probing
+		bucket = (bucket + probe + 1) & hashmod;
+	}
+
+	assert(false && "Hash table is full"); // unreachable
+	return 0;
+}
+
+struct StripifyContext
+{
+	const unsigned int* indices;
+	size_t face_count;
+	size_t chunk_size;
+	unsigned int restart_index;
+
+	// per-triangle state; every chunk only touches the triangles in its range
+	unsigned int* neighbors;
+	unsigned char* degree;
+	unsigned char* emitted;
+	unsigned int* buckets;
+
+	unsigned int* destination;
+	size_t* chunk_sizes;
+
+	// allocation callbacks of the calling thread, installed by the tasks that allocate memory
+	meshopt_Allocator::Callbacks callbacks;
+};
+
+static unsigned int getStripVertex(const unsigned int* triangle, unsigned int e0, unsigned int e1)
+{
+	unsigned int a = triangle[0], b = triangle[1], c = triangle[2];
+
+	return (e0 == a && e1 == b) ? c : (e0 == b && e1 == c) ? a : b;
+}
+
+static void buildStripNeighbors(const StripifyContext& context, size_t begin, size_t end)
+{
+	const unsigned int* indices = context.indices;
+
+	// the edge table is allocated for each task, so memory usage depends on the number of concurrent tasks instead of the chunk count
+	// the table assumes every edge is unique, with 3 elements per entry and a load factor of at most 0.75
+	size_t table_size = hashBuckets4((end - begin) * 4);
+
+	meshopt_Allocator allocator;
+
+	unsigned int* table = allocator.allocate<unsigned int>(table_size * 3);
+	memset(table, -1, table_size * 3 * sizeof(unsigned int));
+
+	for (size_t i = begin * 3; i < end * 3; ++i)
+		context.neighbors[i] = ~0u;
+
+	// for every triangle edge [a b] find an earlier triangle in the same chunk with an unpaired opposite edge [b a], which is what findStripNext matches
+	// the table only holds edges of this chunk, so chunks don't need any global adjacency and are fully independent
+	for (size_t i = begin; i < end; ++i)
+	{
+		for (int k = 0; k < 3; ++k)
+		{
+			unsigned int a = indices[i * 3 + k], b = indices[i * 3 + (k == 2 ? 0 : k + 1)];
+
+			unsigned int* entry = hashLookupEdge(table, table_size, a, b);
+			unsigned int edge = entry[2];
+
+			// the entry holds the opposite edge if it starts with b; with non-manifold edges, it might be paired already
+			if (edge != ~0u && entry[0] == b && context.neighbors[edge] == ~0u)
+			{
+				context.neighbors[edge] = unsigned(i);
+				context.neighbors[i * 3 + k] = edge / 3;
+				continue;
+			}
+
+			// otherwise the current edge becomes the candidate for pairing with later triangles
+			entry[0] = a;
+			entry[1] = b;
+			entry[2] = unsigned(i * 3 + k);
+		}
+	}
+}
+
+static unsigned int getStripNext(const StripifyContext& context, unsigned int triangle, unsigned int e0, unsigned int e1)
+{
+	const unsigned int* indices = context.indices;
+
+	// the next triangle contains [e0 e1], so the current triangle contains [e1 e0]
+	for (int k = 0; k < 3; ++k)
+	{
+		unsigned int a = indices[triangle * 3 + k], b = indices[triangle * 3 + (k == 2 ? 0 : k + 1)];
+		unsigned int neighbor = context.neighbors[triangle * 3 + k];
+
+		if (a == e1 && b == e0 && neighbor != ~0u && !context.emitted[neighbor])
+			return neighbor;
+	}
+
+	return ~0u;
+}
+
+static void emitStripTriangle(const StripifyContext& context, unsigned int triangle, unsigned int** buckets, size_t* bucket_sizes)
+{
+	context.emitted[triangle] = 1;
+
+	// neighbors lose a live edge; they are re-inserted into the bucket for their new degree and stale entries are skipped on removal
+	for (int k = 0; k < 3; ++k)
+	{
+		unsigned int neighbor = context.neighbors[triangle * 3 + k];
+
+		if (neighbor == ~0u || context.emitted[neighbor])
+			continue;
+
+		assert(context.degree[neighbor] > 0);
+		unsigned int degree = --context.degree[neighbor];
+
+		buckets[degree][bucket_sizes[degree]++] = neighbor;
+	}
+}
+
+static unsigned int findStripStart(const StripifyContext& context, unsigned int** buckets, size_t* bucket_sizes, size_t& cursor, size_t end)
+{
+	// triangles next to emitted strips with fewer live neighbors are harder to reach later, so they are used to start new strips first
+	for (int degree = 0; degree < 3; ++degree)
+	{
+		while (bucket_sizes[degree])
+		{
+			unsigned int triangle = buckets[degree][--bucket_sizes[degree]];
+
+			if (!context.emitted[triangle] && context.degree[triangle] == degree)
+				return triangle;
+		}
+	}
+
+	// otherwise we continue in the input order, which is assumed to be optimized for locality
+	while (cursor < end && context.emitted[cursor])
+		cursor++;
+
+	return cursor < end ? unsigned(cursor) : ~0u;
+}
+
+static void stripifyChunk(void* context_, size_t task_index)
+{
+	const StripifyContext& context = *static_cast<StripifyContext*>(context_);
+	meshopt_Allocator::Scope scope(context.callbacks);
+
+	const unsigned int* indices = context.indices;
+	unsigned int restart_index = context.restart_index;
+
+	size_t begin = task_index * context.chunk_size;
+	size_t end = begin + context.chunk_size < context.face_count ? begin + context.chunk_size : context.face_count;
+	size_t count = end - begin;
+
+	buildStripNeighbors(context, begin, end);
+
+	// triangles enter the degree buckets once their degree drops; each bucket receives every triangle at most once, since degrees only decrease
+	unsigned int* buckets[3];
+	size_t bucket_sizes[3] = {};
+
+	for (int k = 0; k < 3; ++k)
+		buckets[k] = context.buckets + begin * 3 + count * k;
+
+	memset(context.emitted + begin, 0, count);
+
+	for (size_t i = begin; i < end; ++i)
+	{
+		unsigned int* neighbors = &context.neighbors[i * 3];
+
+		context.degree[i] = (unsigned char)((neighbors[0] != ~0u) + (neighbors[1] != ~0u) + (neighbors[2] != ~0u));
+	}
+
+	size_t cursor = begin;
+
+	// every chunk writes into its own slot of the output; see meshopt_stripifyParallelBound
+	unsigned int* destination = context.destination + begin * 5 + task_index;
+
+	unsigned int strip[2] = {};
+	unsigned int parity = 0;
+
+	size_t strip_size = 0;
+
+	unsigned int next = ~0u;
+	unsigned int next_vertex = 0;
+
+	for (;;)
+	{
+		if (next != ~0u)
+		{
+			unsigned int v = next_vertex;
+
+			emitStripTriangle(context, next, buckets, bucket_sizes);
+
+			// find next triangle (note that edge order flips on every iteration)
+			// in some cases we need to perform a swap to pick a different outgoing triangle edge
+			// for [a b c], the default strip edge is [b c], but we might want to use [a c]
+			unsigned int ce0 = parity ? strip[1] : v, ce1 = parity ? v : strip[1];
+			unsigned int se0 = parity ? v : strip[0], se1 = parity ? strip[0] : v;
+
+			unsigned int cont = getStripNext(context, next, ce0, ce1);
+			unsigned int swap = cont == ~0u ? getStripNext(context, next, se0, se1) : ~0u;
+
+			if (cont == ~0u && swap != ~0u)
+			{
+				// [a b c] => [a b a c]
+				destination[strip_size++] = strip[0];
+				destination[strip_size++] = v;
+
+				// next strip has same winding
+				// ? a b => b a v
+				strip[1] = v;
+
+				next = swap;
+				next_vertex = getStripVertex(&indices[swap * 3], se0, se1);
+			}
+			else
+			{
+				// emit the next vertex in the strip
+				destination[strip_size++] = v;
+
+				// next strip has flipped winding
+				strip[0] = strip[1];
+				strip[1] = v;
+				parity ^= 1;
+
+				next = cont;
+				next_vertex = cont == ~0u ? 0 : getStripVertex(&indices[cont * 3], ce0, ce1);
+			}
+		}
+		else
+		{
+			// if we didn't find anything, we need to find the next new triangle
+			unsigned int i = findStripStart(context, buckets, bucket_sizes, cursor, end);
+
+			if (i == ~0u)
+				break;
+
+			unsigned int a = indices[i * 3 + 0], b = indices[i * 3 + 1], c = indices[i * 3 + 2];
+
+			emitStripTriangle(context, i, buckets, bucket_sizes);
+
+			// we need to pre-rotate the triangle so that the strip continues through the outgoing edge "cb"
+			// when several edges have neighbors, we pick the neighbor with the fewest live neighbors to avoid leaving it isolated
+			unsigned int ea = getStripNext(context, i, c, b);
+			unsigned int eb = getStripNext(context, i, a, c);
+			unsigned int ec = getStripNext(context, i, b, a);
+
+			unsigned int mind = 4;
+			mind = (ea != ~0u && context.degree[ea] < mind) ? context.degree[ea] : mind;
+			mind = (eb != ~0u && context.degree[eb] < mind) ? context.degree[eb] : mind;
+			mind = (ec != ~0u && context.degree[ec] < mind) ? context.degree[ec] : mind;
+
+			if (ea != ~0u && context.degree[ea] == mind)
+			{
+				// keep abc
+				next = ea;
+			}
+			else if (eb != ~0u && context.degree[eb] == mind)
+			{
+				// abc -> bca
+				unsigned int t = a;
+				a = b, b = c, c = t;
+
+				next = eb;
+			}
+			else if (ec != ~0u && context.degree[ec] == mind)
+			{
+				// abc -> cab
+				unsigned int t = c;
+				c = b, b = a, a = t;
+
+				next = ec;
+			}
+
+			next_vertex = next == ~0u ? 0 : getStripVertex(&indices[next * 3], c, b);
+
+			if (restart_index)
+			{
+				if (strip_size)
+					destination[strip_size++] = restart_index;
+
+				destination[strip_size++] = a;
+				destination[strip_size++] = b;
+				destination[strip_size++] = c;
+
+				// new strip always starts with the same edge winding
+				strip[0] = b;
+				strip[1] = c;
+				parity = 1;
+			}
+			else
+			{
+				if (strip_size)
+				{
+					// connect last strip using degenerate triangles
+					destination[strip_size++] = strip[1];
+					destination[strip_size++] = a;
+				}
+
+				// note that we may need to flip the emitted triangle based on parity
+				// we always end up with outgoing edge "cb" in the end
+				unsigned int e0 = parity ? c : b;
+				unsigned int e1 = parity ? b : c;
+
+				destination[strip_size++] = a;
+				destination[strip_size++] = e0;
+				destination[strip_size++] = e1;
+
+				strip[0] = e0;
+				strip[1] = e1;
+				parity ^= 1;
+			}
+		}
+	}
+
+	context.chunk_sizes[task_index] = strip_size;
+}
+
 } // namespace meshopt
 
 size_t meshopt_stripify(unsigned int* destination, const unsigned int* indices, size_t index_count, size_t vertex_count, unsigned int restart_index)
@@ -293,3 +634,93 @@ size_t meshopt_unstripifyBound(size_t index_count)
 
 	return (index_count == 0) ? 0 : (index_count - 2) * 3;
 }
+
+size_t meshopt_stripifyParallel(unsigned int* destination, const unsigned int* indices, size_t index_count, size_t vertex_count, unsigned int restart_index, size_t chunk_size, meshopt_Scheduler scheduler, void* scheduler_context)
+{
+	assert(destination != indices);
+	assert(index_count % 3 == 0);
+	assert(chunk_size > 0);
+
+	using namespace meshopt;
+
+	// chunks only look at their own triangles, so no per-vertex data is needed
+	(void)vertex_count;
+
+	meshopt_Allocator allocator;
+
+	size_t face_count = index_count / 3;
+	size_t chunk_count = (face_count + chunk_size - 1) / chunk_size;
+
+	StripifyContext context = {};
+	context.callbacks = meshopt_Allocator::getCallbacks();
+	context.indices = indices;
+	context.face_count = face_count;
+	context.chunk_size = chunk_size;
+	context.restart_index = restart_index;
+
+	context.neighbors = allocator.allocate<unsigned int>(face_count * 3);
+	context.degree = allocator.allocate<unsigned char>(face_count);
+	context.emitted = allocator.allocate<unsigned char>(face_count);
+	context.buckets = allocator.allocate<unsigned int>(face_count * 3);
+	context.destination = destination;
+	context.chunk_sizes = allocator.allocate<size_t>(chunk_count);
+
+	if (scheduler)
+		scheduler(scheduler_context, stripifyChunk, &context, chunk_count);
+	else
+		for (size_t i = 0; i < chunk_count; ++i)
+			stripifyChunk(&context, i);
+
+	// compact chunk outputs; every chunk output starts at or after the end of the compacted data, so it's safe to move it down
+	size_t strip_size = 0;
+
+	for (size_t i = 0; i < chunk_count; ++i)
+	{
+		const unsigned int* chunk = destination + i * chunk_size * 5 + i;
+		size_t chunk_strip_size = context.chunk_sizes[i];
+
+		assert(chunk_strip_size >= 3);
+
+		if (strip_size)
+		{
+			unsigned int first = chunk[0];
+
+			if (restart_index)
+			{
+				destination[strip_size++] = restart_index;
+			}
+			else
+			{
+				// connect chunks using degenerate triangles; chunks are stripified assuming even parity, so we may need an extra index
+				unsigned int last = destination[strip_size - 1];
+
+				destination[strip_size++] = last;
+				destination[strip_size++] = first;
+
+				if (strip_size & 1)
+					destination[strip_size++] = first;
+			}
+		}
+
+		assert(destination + strip_size <= chunk);
+		memmove(destination + strip_size, chunk, chunk_strip_size * sizeof(unsigned int));
+
+		strip_size += chunk_strip_size;
+	}
+
+	assert(strip_size <= meshopt_stripifyParallelBound(index_count, chunk_size));
+
+	return strip_size;
+}
+
+size_t meshopt_stripifyParallelBound(size_t index_count, size_t chunk_size)
+{
+	assert(index_count % 3 == 0);
+	assert(chunk_size > 0);
+
+	size_t face_count = index_count / 3;
+	size_t chunk_count = (face_count + chunk_size - 1) / chunk_size;
+
+	// same per-triangle worst case as meshopt_stripifyBound; each chunk needs at most one extra index to stitch it with correct parity
+	return face_count * 5 + chunk_count;
+}
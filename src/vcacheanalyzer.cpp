@@ -71,3 +71,21 @@ meshopt_VertexCacheStatistics meshopt_analyzeVertexCache(const unsigned int* ind
 
 	return result;
 }
+
+meshopt_VertexCacheStatistics meshopt_analyzeVertexCacheProfile(const unsigned int* indices, size_t index_count, size_t vertex_count, meshopt_VertexCacheProfile profile)
+{
+	// cache_size, warp_size, primgroup_size for each profile; see meshopt_VertexCacheProfile
+	static const unsigned int kProfiles[][3] = {
+	    {16, 0, 0},    // Generic
+	    {32, 32, 32},  // Nvidia
+	    {14, 64, 128}, // Amd
+	    {128, 0, 0},   // Intel
+	    {32, 32, 0},   // Apple
+	    {16, 16, 0},   // Mobile
+	};
+
+	assert(unsigned(profile) < sizeof(kProfiles) / sizeof(kProfiles[0]));
+	const unsigned int* params = kProfiles[profile];
+
+	return meshopt_analyzeVertexCache(indices, index_count, vertex_count, params[0], params[1], params[2]);
+}
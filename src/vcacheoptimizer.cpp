@@ -13,11 +13,11 @@ namespace meshopt
 const size_t kCacheSizeMax = 16;
 const size_t kValenceMax = 8;
 
-struct VertexScoreTable
-{
-	float cache[1 + kCacheSizeMax];
-	float live[1 + kValenceMax];
-};
+typedef meshopt_VertexScoreTable VertexScoreTable;
+
+// the public table layout must match the optimizer limits
+typedef char VertexScoreTableCacheCheck[sizeof(((VertexScoreTable*)0)->cache) == sizeof(float) * (1 + kCacheSizeMax) ? 1 : -1];
+typedef char VertexScoreTableLiveCheck[sizeof(((VertexScoreTable*)0)->live) == sizeof(float) * (1 + kValenceMax) ? 1 : -1];
 
 // Tuned to minimize the ACMR of a GPU that has a cache profile similar to NVidia and AMD
 static const VertexScoreTable kVertexScoreTable = {
@@ -31,6 +31,39 @@ static const VertexScoreTable kVertexScoreTableStrip = {
     {0.f, 0.956f, 0.786f, 0.577f, 0.558f, 0.618f, 0.549f, 0.499f, 0.489f},
 };
 
+// Tuned to minimize the ATVR of the Intel profile (128-entry FIFO cache)
+static const VertexScoreTable kVertexScoreTableIntel = {
+    {0.f, 0.989f, 0.855f, 0.732f, 0.900f, 1.000f, 0.925f, 1.000f, 1.000f, 1.000f, 0.986f, 0.897f, 1.000f, 0.877f, 1.000f, 0.000f, 0.961f},
+    {0.f, 0.918f, 0.913f, 0.044f, 0.037f, 0.471f, 0.041f, 0.168f, 0.226f},
+};
+
+// Tuned to minimize the ATVR of the Mobile profile (16-entry cache, 16-vertex warps)
+static const VertexScoreTable kVertexScoreTableMobile = {
+    {0.f, 0.793f, 0.453f, 0.990f, 0.965f, 0.736f, 0.051f, 0.705f, 0.342f, 0.610f, 0.403f, 0.487f, 0.106f, 0.246f, 0.355f, 0.057f, 0.453f},
+    {0.f, 0.984f, 0.704f, 0.538f, 0.191f, 0.299f, 0.028f, 0.342f, 0.673f},
+};
+
+static const VertexScoreTable* getVertexScoreTable(meshopt_VertexCacheProfile profile)
+{
+	switch (profile)
+	{
+	case meshopt_VertexCacheGeneric:
+	case meshopt_VertexCacheNvidia:
+	case meshopt_VertexCacheAmd:
+	case meshopt_VertexCacheApple: // tuning for this profile doesn't improve on the default table
+		return &kVertexScoreTable;
+
+	case meshopt_VertexCacheIntel:
+		return &kVertexScoreTableIntel;
+
+	case meshopt_VertexCacheMobile:
+		return &kVertexScoreTableMobile;
+	}
+
+	assert(!"Unknown vertex cache profile");
+	return &kVertexScoreTable;
+}
+
 struct TriangleAdjacency
 {
 	unsigned int* counts;
@@ -40,6 +73,8 @@ struct TriangleAdjacency
 
 static void buildTriangleAdjacency(TriangleAdjacency& adjacency, const unsigned int* indices, size_t index_count, size_t vertex_count, meshopt_Allocator& allocator)
 {
+	MESHOPTIMIZER_ZONE("buildTriangleAdjacency");
+
 	size_t face_count = index_count / 3;
 
 	// allocate arrays
@@ -164,13 +199,81 @@ static unsigned int getNextTriangleDeadEnd(unsigned int& input_cursor, const uns
 	return ~0u;
 }
 
-} // namespace meshopt
+struct VertexCachePartitionContext
+{
+	unsigned int* destination;
+	const unsigned int* indices;
+	const unsigned int* index_offsets;
+	const unsigned int* vertices;
+	const unsigned int* vertex_offsets;
+
+	// allocation callbacks of the calling thread, installed by the tasks that allocate memory
+	meshopt_Allocator::Callbacks callbacks;
+};
 
-void meshopt_optimizeVertexCacheTable(unsigned int* destination, const unsigned int* indices, size_t index_count, size_t vertex_count, const meshopt::VertexScoreTable* table)
+static void optimizeVertexCachePartition(void* task_data, size_t task_index)
 {
-	using namespace meshopt;
+	MESHOPTIMIZER_ZONE("optimizeVertexCachePartition");
+
+	const VertexCachePartitionContext& context = *static_cast<const VertexCachePartitionContext*>(task_data);
+	meshopt_Allocator::Scope scope(context.callbacks);
 
+	unsigned int* destination = context.destination + context.index_offsets[task_index];
+	const unsigned int* indices = context.indices + context.index_offsets[task_index];
+	size_t index_count = context.index_offsets[task_index + 1] - context.index_offsets[task_index];
+
+	const unsigned int* vertices = context.vertices + context.vertex_offsets[task_index];
+	size_t vertex_count = context.vertex_offsets[task_index + 1] - context.vertex_offsets[task_index];
+
+	meshopt_optimizeVertexCache(destination, indices, index_count, vertex_count);
+
+	for (size_t i = 0; i < index_count; ++i)
+		destination[i] = vertices[destination[i]];
+}
+
+static size_t hashBuckets3(size_t count)
+{
+	size_t buckets = 1;
+	while (buckets < count)
+		buckets *= 2;
+
+	return buckets;
+}
+
+static unsigned int* hashLookupVertex(unsigned int* table, size_t buckets, unsigned int vertex)
+{
+	assert(buckets > 0);
+	assert((buckets & (buckets - 1)) == 0);
+
+	// MurmurHash2 finalizer
+	unsigned int h = vertex;
+	h ^= h >> 13;
+	h *= 0x5bd1e995;
+	h ^= h >> 15;
+
+	size_t hashmod = buckets - 1;
+	size_t bucket = h & hashmod;
+
+	for (size_t probe = 0; probe <= hashmod; ++probe)
+	{
+		// each entry stores the vertex index followed by the local vertex index
+		unsigned int* item = &table[bucket * 2];
+
+		if (item[0] == ~0u || item[0] == vertex)
+			return item;
+
+		// hash collision, quadratic probing
+		bucket = (bucket + probe + 1) & hashmod;
+	}
+
+	assert(false && "Hash table is full"); // unreachable
+	return 0;
+}
+
+static void optimizeVertexCacheTable(unsigned int* destination, const unsigned int* indices, size_t index_count, size_t vertex_count, const VertexScoreTable* table, const unsigned int* cache_seed, size_t cache_seed_count)
+{
 	assert(index_count % 3 == 0);
+	assert(table);
 
 	meshopt_Allocator allocator;
 
@@ -229,6 +332,56 @@ void meshopt_optimizeVertexCacheTable(unsigned int* destination, const unsigned
 	unsigned int current_triangle = 0;
 	unsigned int input_cursor = 1;
 
+	// seeded cache represents the state left by the preceding triangles; we start from the best triangle that continues it
+	if (cache_seed_count)
+	{
+		assert(cache_seed_count <= cache_size);
+
+		unsigned int best_triangle = ~0u;
+		float best_score = 0;
+
+		for (size_t i = 0; i < cache_seed_count; ++i)
+		{
+			unsigned int index = cache_seed[i];
+			assert(index < vertex_count);
+
+			cache[cache_count++] = index;
+
+			float score = vertexScore(table, int(i), live_triangles[index]);
+			float score_diff = score - vertex_scores[index];
+
+			vertex_scores[index] = score;
+
+			const unsigned int* neighbours_begin = &adjacency.data[0] + adjacency.offsets[index];
+			const unsigned int* neighbours_end = neighbours_begin + adjacency.counts[index];
+
+			for (const unsigned int* it = neighbours_begin; it != neighbours_end; ++it)
+				triangle_scores[*it] += score_diff;
+		}
+
+		// scores are only final after all seed vertices are processed since triangles may share several of them
+		for (size_t i = 0; i < cache_seed_count; ++i)
+		{
+			unsigned int index = cache_seed[i];
+
+			const unsigned int* neighbours_begin = &adjacency.data[0] + adjacency.offsets[index];
+			const unsigned int* neighbours_end = neighbours_begin + adjacency.counts[index];
+
+			for (const unsigned int* it = neighbours_begin; it != neighbours_end; ++it)
+				if (best_score < triangle_scores[*it])
+				{
+					best_triangle = *it;
+					best_score = triangle_scores[*it];
+				}
+		}
+
+		if (best_triangle != ~0u)
+		{
+			current_triangle = best_triangle;
+			input_cursor = 0;
+		}
+	}
+
 	unsigned int output_triangle = 0;
 
 	while (current_triangle != ~0u)
@@ -348,6 +501,17 @@ void meshopt_optimizeVertexCacheTable(unsigned int* destination, const unsigned
 	assert(output_triangle == face_count);
 }
 
+} // namespace meshopt
+
+void meshopt_optimizeVertexCacheTable(unsigned int* destination, const unsigned int* indices, size_t index_count, size_t vertex_count, const meshopt_VertexScoreTable* table)
+{
+	using namespace meshopt;
+
+	MESHOPTIMIZER_ZONE("meshopt_optimizeVertexCacheTable");
+
+	optimizeVertexCacheTable(destination, indices, index_count, vertex_count, table, 0, 0);
+}
+
 void meshopt_optimizeVertexCache(unsigned int* destination, const unsigned int* indices, size_t index_count, size_t vertex_count)
 {
 	meshopt_optimizeVertexCacheTable(destination, indices, index_count, vertex_count, &meshopt::kVertexScoreTable);
@@ -358,10 +522,181 @@ void meshopt_optimizeVertexCacheStrip(unsigned int* destination, const unsigned
 	meshopt_optimizeVertexCacheTable(destination, indices, index_count, vertex_count, &meshopt::kVertexScoreTableStrip);
 }
 
+void meshopt_optimizeVertexCacheProfile(unsigned int* destination, const unsigned int* indices, size_t index_count, size_t vertex_count, meshopt_VertexCacheProfile profile)
+{
+	meshopt_optimizeVertexCacheTable(destination, indices, index_count, vertex_count, meshopt::getVertexScoreTable(profile));
+}
+
+void meshopt_getVertexScoreTable(meshopt_VertexScoreTable* destination, meshopt_VertexCacheProfile profile)
+{
+	*destination = *meshopt::getVertexScoreTable(profile);
+}
+
+void meshopt_optimizeVertexCachePartitioned(unsigned int* destination, const unsigned int* indices, size_t index_count, size_t vertex_count, size_t partition_count, meshopt_Scheduler scheduler, void* scheduler_context)
+{
+	using namespace meshopt;
+
+	MESHOPTIMIZER_ZONE("meshopt_optimizeVertexCachePartitioned");
+
+	assert(index_count % 3 == 0);
+	assert(partition_count > 0);
+
+	meshopt_Allocator allocator;
+
+	size_t face_count = index_count / 3;
+
+	// guard for empty meshes
+	if (face_count == 0 || vertex_count == 0)
+		return;
+
+	partition_count = partition_count > face_count ? face_count : partition_count;
+
+	unsigned int* index_offsets = allocator.allocate<unsigned int>(partition_count + 1);
+
+	for (size_t i = 0; i <= partition_count; ++i)
+		index_offsets[i] = unsigned(face_count * i / partition_count * 3);
+
+	// convert partition indices to local vertex indices so that per-partition state stays small and cache resident; partitions have at most index_count vertices in total
+	unsigned int* partition_indices = allocator.allocate<unsigned int>(index_count);
+	unsigned int* partition_vertices = allocator.allocate<unsigned int>(index_count);
+	unsigned int* vertex_offsets = allocator.allocate<unsigned int>(partition_count + 1);
+
+	unsigned int* vertex_local = allocator.allocate<unsigned int>(vertex_count);
+	unsigned int* vertex_stamp = allocator.allocate<unsigned int>(vertex_count);
+	memset(vertex_stamp, -1, vertex_count * sizeof(unsigned int));
+
+	size_t partition_vertex_count = 0;
+
+	for (size_t p = 0; p < partition_count; ++p)
+	{
+		vertex_offsets[p] = unsigned(partition_vertex_count);
+
+		for (size_t i = index_offsets[p]; i < index_offsets[p + 1]; ++i)
+		{
+			unsigned int v = indices[i];
+			assert(v < vertex_count);
+
+			if (vertex_stamp[v] != p)
+			{
+				vertex_stamp[v] = unsigned(p);
+				vertex_local[v] = unsigned(partition_vertex_count - vertex_offsets[p]);
+				partition_vertices[partition_vertex_count++] = v;
+			}
+
+			partition_indices[i] = vertex_local[v];
+		}
+	}
+
+	vertex_offsets[partition_count] = unsigned(partition_vertex_count);
+
+	VertexCachePartitionContext context = {};
+	context.callbacks = meshopt_Allocator::getCallbacks();
+	context.destination = destination;
+	context.indices = partition_indices;
+	context.index_offsets = index_offsets;
+	context.vertices = partition_vertices;
+	context.vertex_offsets = vertex_offsets;
+
+	if (scheduler)
+		scheduler(scheduler_context, optimizeVertexCachePartition, &context, partition_count);
+	else
+		for (size_t p = 0; p < partition_count; ++p)
+			optimizeVertexCachePartition(&context, p);
+}
+
+void meshopt_optimizeVertexCacheRange(unsigned int* indices, size_t index_count, size_t vertex_count, size_t range_offset, size_t range_count)
+{
+	using namespace meshopt;
+
+	MESHOPTIMIZER_ZONE("meshopt_optimizeVertexCacheRange");
+
+	assert(index_count % 3 == 0);
+	assert(range_offset % 3 == 0 && range_count % 3 == 0);
+	assert(range_offset + range_count <= index_count);
+	(void)index_count;
+
+	meshopt_Allocator allocator;
+
+	// guard for empty ranges
+	if (range_count == 0 || vertex_count == 0)
+		return;
+
+	unsigned int cache_size = 16;
+	assert(cache_size <= kCacheSizeMax);
+
+	// reconstruct the cache state after the preceding triangles, most recently used vertices first; this is bounded to keep the cost independent of the mesh size
+	unsigned int cache_seed[kCacheSizeMax];
+	size_t cache_seed_count = 0;
+
+	size_t lookback_begin = range_offset > kCacheSizeMax * 3 ? range_offset - kCacheSizeMax * 3 : 0;
+
+	for (size_t i = range_offset; i > lookback_begin && cache_seed_count < cache_size; i -= 3)
+	{
+		for (size_t k = 0; k < 3 && cache_seed_count < cache_size; ++k)
+		{
+			unsigned int index = indices[i - 3 + k];
+			assert(index < vertex_count);
+
+			bool cached = false;
+
+			for (size_t j = 0; j < cache_seed_count; ++j)
+				cached |= cache_seed[j] == index;
+
+			if (!cached)
+				cache_seed[cache_seed_count++] = index;
+		}
+	}
+
+	// convert range indices to local vertex indices so that the optimizer state is proportional to the range size; seed vertices come first
+	size_t table_size = hashBuckets3(range_count + cache_seed_count);
+	unsigned int* table = allocator.allocate<unsigned int>(table_size * 2);
+	memset(table, -1, table_size * 2 * sizeof(unsigned int));
+
+	unsigned int* local_vertices = allocator.allocate<unsigned int>(range_count + cache_seed_count);
+	unsigned int* local_indices = allocator.allocate<unsigned int>(range_count);
+	size_t local_vertex_count = 0;
+
+	for (size_t i = 0; i < cache_seed_count; ++i)
+	{
+		unsigned int* entry = hashLookupVertex(table, table_size, cache_seed[i]);
+
+		entry[0] = cache_seed[i];
+		entry[1] = unsigned(local_vertex_count);
+		local_vertices[local_vertex_count] = cache_seed[i];
+		cache_seed[i] = unsigned(local_vertex_count++);
+	}
+
+	unsigned int* range = indices + range_offset;
+
+	for (size_t i = 0; i < range_count; ++i)
+	{
+		unsigned int index = range[i];
+		assert(index < vertex_count);
+
+		unsigned int* entry = hashLookupVertex(table, table_size, index);
+
+		if (entry[0] == ~0u)
+		{
+			entry[0] = index;
+			entry[1] = unsigned(local_vertex_count);
+			local_vertices[local_vertex_count++] = index;
+		}
+
+		local_indices[i] = entry[1];
+	}
+
+	optimizeVertexCacheTable(range, local_indices, range_count, local_vertex_count, &kVertexScoreTable, cache_seed, cache_seed_count);
+
+	for (size_t i = 0; i < range_count; ++i)
+		range[i] = local_vertices[range[i]];
+}
+
 void meshopt_optimizeVertexCacheFifo(unsigned int* destination, const unsigned int* indices, size_t index_count, size_t vertex_count, unsigned int cache_size)
 {
 	using namespace meshopt;
 
+	MESHOPTIMIZER_ZONE("meshopt_optimizeVertexCacheFifo");
+
 	assert(index_count % 3 == 0);
 	assert(cache_size >= 3);
 
@@ -52,6 +52,26 @@
 #define SIMD_TARGET
 #endif
 
+// AVX2 is used for wider delta decoding; when SSSE3 is selected via cpuid, AVX2 code is selected the same way
+#if defined(SIMD_SSE) && (defined(SIMD_FALLBACK) || defined(__AVX2__))
+#define SIMD_AVX2
+#endif
+
+#if defined(SIMD_AVX2) && defined(SIMD_FALLBACK) && (defined(__GNUC__) || defined(__clang__))
+#define SIMD_TARGET_AVX2 __attribute__((target("avx2")))
+#else
+#define SIMD_TARGET_AVX2
+#endif
+
+// Byte group decoding needs to be inlined into block decoding to avoid call overhead; this also makes sure AVX2 code doesn't call legacy SSE code
+#if defined(SIMD_SSE) && defined(_MSC_VER) && !defined(__clang__)
+#define SIMD_INLINE __forceinline
+#elif defined(SIMD_SSE)
+#define SIMD_INLINE inline __attribute__((always_inline))
+#else
+#define SIMD_INLINE
+#endif
+
 #endif // !MESHOPTIMIZER_NO_SIMD
 
 #ifdef SIMD_SSE
@@ -66,7 +86,7 @@
 #endif
 #endif
 
-#ifdef SIMD_AVX
+#if defined(SIMD_AVX) || defined(SIMD_AVX2)
 #include <immintrin.h>
 #endif
 
@@ -157,33 +177,90 @@ Stats* bytestats;
 Stats vertexstats[256];
 #endif
 
-static bool encodeBytesGroupZero(const unsigned char* buffer)
+#if defined(SIMD_SSE) && (defined(__SSE2__) || defined(_M_X64))
+// SSE2 is part of the x64 baseline, so the measure kernel doesn't need a cpuid check even when the decoder does
+static unsigned int popcount16(unsigned int v)
+{
+	v = v - ((v >> 1) & 0x5555);
+	v = (v & 0x3333) + ((v >> 2) & 0x3333);
+	v = (v + (v >> 4)) & 0x0f0f;
+
+	return (v + (v >> 8)) & 0x1f;
+}
+
+static void encodeBytesGroupCount(const unsigned char* buffer, bool& zero, size_t& count2, size_t& count4)
+{
+	__m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(buffer));
+
+	// v >= k for unsigned bytes is equivalent to max(v, k) == v
+	int mask0 = _mm_movemask_epi8(_mm_cmpeq_epi8(v, _mm_setzero_si128()));
+	int mask2 = _mm_movemask_epi8(_mm_cmpeq_epi8(_mm_max_epu8(v, _mm_set1_epi8(3)), v));
+	int mask4 = _mm_movemask_epi8(_mm_cmpeq_epi8(_mm_max_epu8(v, _mm_set1_epi8(15)), v));
+
+	zero = mask0 == 0xffff;
+	count2 = popcount16(mask2);
+	count4 = popcount16(mask4);
+}
+#else
+static void encodeBytesGroupCount(const unsigned char* buffer, bool& zero, size_t& count2, size_t& count4)
 {
+	unsigned char any = 0;
+
+	count2 = 0;
+	count4 = 0;
+
 	for (size_t i = 0; i < kByteGroupSize; ++i)
-		if (buffer[i])
-			return false;
+	{
+		any |= buffer[i];
+		count2 += buffer[i] >= 3;
+		count4 += buffer[i] >= 15;
+	}
 
-	return true;
+	zero = any == 0;
 }
+#endif
 
-static size_t encodeBytesGroupMeasure(const unsigned char* buffer, int bits)
+static int encodeBytesGroupSelect(const unsigned char* buffer, size_t& best_size)
 {
-	assert(bits >= 1 && bits <= 8);
+	// compute the sizes for all bit widths in one pass; 1-bit groups are only usable when all values are zero
+	bool zero = false;
+	size_t count2 = 0, count4 = 0;
+	encodeBytesGroupCount(buffer, zero, count2, count4);
 
-	if (bits == 1)
-		return encodeBytesGroupZero(buffer) ? 0 : size_t(-1);
+	if (zero)
+	{
+		best_size = 0;
+		return 1;
+	}
 
-	if (bits == 8)
-		return kByteGroupSize;
+	size_t size2 = kByteGroupSize * 2 / 8 + count2;
+	size_t size4 = kByteGroupSize * 4 / 8 + count4;
 
-	size_t result = kByteGroupSize * bits / 8;
+	// ties are resolved in favor of smaller bit widths
+	int best_bits = 8;
+	best_size = kByteGroupSize;
 
-	unsigned char sentinel = (1 << bits) - 1;
+	if (size2 < best_size)
+		best_bits = 2, best_size = size2;
+
+	if (size4 < best_size)
+		best_bits = 4, best_size = size4;
+
+	return best_bits;
+}
+
+static int encodeBytesGroupSelectFast(const unsigned char* buffer, size_t& best_size)
+{
+	// pick the smallest bit width that fits all values without escapes; this is cheaper than counting escapes but groups with a few outliers use wider encodings
+	unsigned char any = 0;
 
 	for (size_t i = 0; i < kByteGroupSize; ++i)
-		result += buffer[i] >= sentinel;
+		any |= buffer[i];
 
-	return result;
+	int best_bits = (any == 0) ? 1 : (any < 3) ? 2 : (any < 15) ? 4 : 8;
+	best_size = (best_bits == 1) ? 0 : kByteGroupSize * best_bits / 8;
+
+	return best_bits;
 }
 
 static unsigned char* encodeBytesGroup(unsigned char* data, const unsigned char* buffer, int bits)
@@ -232,7 +309,7 @@ static unsigned char* encodeBytesGroup(unsigned char* data, const unsigned char*
 	return data;
 }
 
-static unsigned char* encodeBytes(unsigned char* data, unsigned char* data_end, const unsigned char* buffer, size_t buffer_size)
+static unsigned char* encodeBytes(unsigned char* data, unsigned char* data_end, const unsigned char* buffer, size_t buffer_size, int level)
 {
 	assert(buffer_size % kByteGroupSize == 0);
 
@@ -253,19 +330,8 @@ static unsigned char* encodeBytes(unsigned char* data, unsigned char* data_end,
 		if (size_t(data_end - data) < kByteGroupDecodeLimit)
 			return 0;
 
-		int best_bits = 8;
-		size_t best_size = encodeBytesGroupMeasure(buffer + i, 8);
-
-		for (int bits = 1; bits < 8; bits *= 2)
-		{
-			size_t size = encodeBytesGroupMeasure(buffer + i, bits);
-
-			if (size < best_size)
-			{
-				best_bits = bits;
-				best_size = size;
-			}
-		}
+		size_t best_size = 0;
+		int best_bits = (level == 0) ? encodeBytesGroupSelectFast(buffer + i, best_size) : encodeBytesGroupSelect(buffer + i, best_size);
 
 		int bitslog2 = (best_bits == 1) ? 0 : (best_bits == 2) ? 1 : (best_bits == 4) ? 2 : 3;
 		assert((1 << bitslog2) == best_bits);
@@ -292,7 +358,7 @@ static unsigned char* encodeBytes(unsigned char* data, unsigned char* data_end,
 	return data;
 }
 
-static unsigned char* encodeVertexBlock(unsigned char* data, unsigned char* data_end, const unsigned char* vertex_data, size_t vertex_count, size_t vertex_size, unsigned char last_vertex[256])
+static unsigned char* encodeVertexBlock(unsigned char* data, unsigned char* data_end, const unsigned char* vertex_data, size_t vertex_count, size_t vertex_size, size_t vertex_stride, unsigned char last_vertex[256], int level)
 {
 	assert(vertex_count > 0 && vertex_count <= kVertexBlockMaxSize);
 
@@ -314,7 +380,7 @@ static unsigned char* encodeVertexBlock(unsigned char* data, unsigned char* data
 
 			p = vertex_data[vertex_offset];
 
-			vertex_offset += vertex_size;
+			vertex_offset += vertex_stride;
 		}
 
 #if TRACE
@@ -322,7 +388,7 @@ static unsigned char* encodeVertexBlock(unsigned char* data, unsigned char* data
 		bytestats = &vertexstats[k];
 #endif
 
-		data = encodeBytes(data, data_end, buffer, (vertex_count + kByteGroupSize - 1) & ~(kByteGroupSize - 1));
+		data = encodeBytes(data, data_end, buffer, (vertex_count + kByteGroupSize - 1) & ~(kByteGroupSize - 1), level);
 		if (!data)
 			return 0;
 
@@ -332,11 +398,156 @@ static unsigned char* encodeVertexBlock(unsigned char* data, unsigned char* data
 #endif
 	}
 
-	memcpy(last_vertex, &vertex_data[vertex_size * (vertex_count - 1)], vertex_size);
+	memcpy(last_vertex, &vertex_data[vertex_stride * (vertex_count - 1)], vertex_size);
+
+	return data;
+}
+
+static size_t encodeVertexBuffer(unsigned char* buffer, size_t buffer_size, const unsigned char* vertex_data, size_t vertex_count, size_t vertex_size, size_t vertex_stride, int level)
+{
+#if TRACE
+	memset(vertexstats, 0, sizeof(vertexstats));
+#endif
+
+	unsigned char* data = buffer;
+	unsigned char* data_end = buffer + buffer_size;
+
+	if (size_t(data_end - data) < 1 + vertex_size)
+		return 0;
+
+	int version = gEncodeVertexVersion;
+
+	*data++ = (unsigned char)(kVertexHeader | version);
+
+	unsigned char first_vertex[256] = {};
+	if (vertex_count > 0)
+		memcpy(first_vertex, vertex_data, vertex_size);
+
+	unsigned char last_vertex[256] = {};
+	memcpy(last_vertex, first_vertex, vertex_size);
+
+	size_t vertex_block_size = getVertexBlockSize(vertex_size);
+
+	size_t vertex_offset = 0;
+
+	while (vertex_offset < vertex_count)
+	{
+		size_t block_size = (vertex_offset + vertex_block_size < vertex_count) ? vertex_block_size : vertex_count - vertex_offset;
+
+		data = encodeVertexBlock(data, data_end, vertex_data + vertex_offset * vertex_stride, block_size, vertex_size, vertex_stride, last_vertex, level);
+		if (!data)
+			return 0;
+
+		vertex_offset += block_size;
+	}
+
+	size_t tail_size = vertex_size < kTailMaxSize ? kTailMaxSize : vertex_size;
+
+	if (size_t(data_end - data) < tail_size)
+		return 0;
+
+	// write first vertex to the end of the stream and pad it to 32 bytes; this is important to simplify bounds checks in decoder
+	if (vertex_size < kTailMaxSize)
+	{
+		memset(data, 0, kTailMaxSize - vertex_size);
+		data += kTailMaxSize - vertex_size;
+	}
+
+	memcpy(data, first_vertex, vertex_size);
+	data += vertex_size;
+
+	assert(data >= buffer + tail_size);
+	assert(data <= buffer + buffer_size);
+
+#if TRACE
+	size_t total_size = data - buffer;
+
+	for (size_t k = 0; k < vertex_size; ++k)
+	{
+		const Stats& vsk = vertexstats[k];
+
+		printf("%2d: %d bytes\t%.1f%%\t%.1f bpv", int(k), int(vsk.size), double(vsk.size) / double(total_size) * 100, double(vsk.size) / double(vertex_count) * 8);
+
+#if TRACE > 1
+		printf("\t\thdr %d bytes\tbit0 %d (%d bytes)\tbit1 %d (%d bytes)\tbit2 %d (%d bytes)\tbit3 %d (%d bytes)",
+		       int(vsk.header),
+		       int(vsk.bitg[0]), int(vsk.bitb[0]),
+		       int(vsk.bitg[1]), int(vsk.bitb[1]),
+		       int(vsk.bitg[2]), int(vsk.bitb[2]),
+		       int(vsk.bitg[3]), int(vsk.bitb[3]));
+#endif
+
+		printf("\n");
+	}
+#endif
+
+	return data - buffer;
+}
+
+static const unsigned char* skipBytes(const unsigned char* data, const unsigned char* data_end, size_t buffer_size)
+{
+	assert(buffer_size % kByteGroupSize == 0);
+
+	const unsigned char* header = data;
+
+	// round number of groups to 4 to get number of header bytes
+	size_t header_size = (buffer_size / kByteGroupSize + 3) / 4;
+
+	if (size_t(data_end - data) < header_size)
+		return 0;
+
+	data += header_size;
+
+	for (size_t i = 0; i < buffer_size; i += kByteGroupSize)
+	{
+		if (size_t(data_end - data) < kByteGroupDecodeLimit)
+			return 0;
+
+		size_t header_offset = i / kByteGroupSize;
+
+		int bitslog2 = (header[header_offset / 4] >> ((header_offset % 4) * 2)) & 3;
+
+		if (bitslog2 == 0 || bitslog2 == 3)
+		{
+			data += (bitslog2 == 3) ? kByteGroupSize : 0;
+			continue;
+		}
+
+		// 2-bit and 4-bit groups store a full byte after the fixed portion for every sentinel value
+		int bits = 1 << bitslog2;
+		unsigned char sentinel = (unsigned char)((1 << bits) - 1);
+
+		size_t fixed_size = kByteGroupSize * bits / 8;
+		size_t variable_size = 0;
+
+		for (size_t j = 0; j < fixed_size; ++j)
+			for (int k = 0; k < 8; k += bits)
+				variable_size += ((data[j] >> k) & sentinel) == sentinel;
+
+		data += fixed_size + variable_size;
+	}
+
+	return data;
+}
+
+static const unsigned char* skipVertexBlock(const unsigned char* data, const unsigned char* data_end, size_t vertex_count, size_t vertex_size)
+{
+	assert(vertex_count > 0 && vertex_count <= kVertexBlockMaxSize);
+
+	size_t vertex_count_aligned = (vertex_count + kByteGroupSize - 1) & ~(kByteGroupSize - 1);
+
+	for (size_t k = 0; k < vertex_size && data; ++k)
+		data = skipBytes(data, data_end, vertex_count_aligned);
 
 	return data;
 }
 
+static size_t getVertexSeekEntrySize(size_t vertex_size)
+{
+	// each entry stores 32-bit block offset followed by the vertex that precedes the block
+	return 4 + vertex_size;
+}
+
 #if defined(SIMD_FALLBACK) || (!defined(SIMD_SSE) && !defined(SIMD_NEON) && !defined(SIMD_AVX))
 static const unsigned char* decodeBytesGroup(const unsigned char* data, unsigned char* buffer, int bitslog2)
 {
@@ -487,7 +698,7 @@ static bool gDecodeBytesGroupInitialized = decodeBytesGroupBuildTables();
 #endif
 
 #ifdef SIMD_SSE
-SIMD_TARGET
+SIMD_TARGET SIMD_INLINE
 static __m128i decodeShuffleMask(unsigned char mask0, unsigned char mask1)
 {
 	__m128i sm0 = _mm_loadl_epi64(reinterpret_cast<const __m128i*>(&kDecodeBytesGroupShuffle[mask0]));
@@ -499,7 +710,7 @@ static __m128i decodeShuffleMask(unsigned char mask0, unsigned char mask1)
 	return _mm_unpacklo_epi64(sm0, sm1r);
 }
 
-SIMD_TARGET
+SIMD_TARGET SIMD_INLINE
 static const unsigned char* decodeBytesGroupSimd(const unsigned char* data, unsigned char* buffer, int bitslog2)
 {
 	switch (bitslog2)
@@ -860,7 +1071,7 @@ static const unsigned char* decodeBytesGroupSimd(const unsigned char* data, unsi
 #endif
 
 #if defined(SIMD_SSE) || defined(SIMD_AVX)
-SIMD_TARGET
+SIMD_TARGET SIMD_INLINE
 static void transpose8(__m128i& x0, __m128i& x1, __m128i& x2, __m128i& x3)
 {
 	__m128i t0 = _mm_unpacklo_epi8(x0, x1);
@@ -874,7 +1085,7 @@ static void transpose8(__m128i& x0, __m128i& x1, __m128i& x2, __m128i& x3)
 	x3 = _mm_unpackhi_epi16(t1, t3);
 }
 
-SIMD_TARGET
+SIMD_TARGET SIMD_INLINE
 static __m128i unzigzag8(__m128i v)
 {
 	__m128i xl = _mm_sub_epi8(_mm_setzero_si128(), _mm_and_si128(v, _mm_set1_epi8(1)));
@@ -935,7 +1146,7 @@ static v128_t unzigzag8(v128_t v)
 #endif
 
 #if defined(SIMD_SSE) || defined(SIMD_AVX) || defined(SIMD_NEON) || defined(SIMD_WASM)
-SIMD_TARGET
+SIMD_TARGET SIMD_INLINE
 static const unsigned char* decodeBytesSimd(const unsigned char* data, const unsigned char* data_end, unsigned char* buffer, size_t buffer_size)
 {
 	assert(buffer_size % kByteGroupSize == 0);
@@ -1080,107 +1291,273 @@ static const unsigned char* decodeVertexBlockSimd(const unsigned char* data, con
 }
 #endif
 
-#if defined(SIMD_SSE) && defined(SIMD_FALLBACK)
-static unsigned int getCpuFeatures()
+#ifdef SIMD_AVX2
+SIMD_TARGET_AVX2
+static void transpose8(__m256i& x0, __m256i& x1, __m256i& x2, __m256i& x3)
 {
-	int cpuinfo[4] = {};
-#ifdef _MSC_VER
-	__cpuid(cpuinfo, 1);
-#else
-	__cpuid(1, cpuinfo[0], cpuinfo[1], cpuinfo[2], cpuinfo[3]);
-#endif
-	return cpuinfo[2];
+	__m256i t0 = _mm256_unpacklo_epi8(x0, x1);
+	__m256i t1 = _mm256_unpackhi_epi8(x0, x1);
+	__m256i t2 = _mm256_unpacklo_epi8(x2, x3);
+	__m256i t3 = _mm256_unpackhi_epi8(x2, x3);
+
+	x0 = _mm256_unpacklo_epi16(t0, t2);
+	x1 = _mm256_unpackhi_epi16(t0, t2);
+	x2 = _mm256_unpacklo_epi16(t1, t3);
+	x3 = _mm256_unpackhi_epi16(t1, t3);
 }
 
-unsigned int cpuid = getCpuFeatures();
-#endif
+SIMD_TARGET_AVX2
+static __m256i unzigzag8(__m256i v)
+{
+	__m256i xl = _mm256_sub_epi8(_mm256_setzero_si256(), _mm256_and_si256(v, _mm256_set1_epi8(1)));
+	__m256i xr = _mm256_and_si256(_mm256_srli_epi16(v, 1), _mm256_set1_epi8(127));
 
-} // namespace meshopt
+	return _mm256_xor_si256(xl, xr);
+}
 
-size_t meshopt_encodeVertexBuffer(unsigned char* buffer, size_t buffer_size, const void* vertices, size_t vertex_count, size_t vertex_size)
+SIMD_TARGET_AVX2
+static __m256i prefix4(__m256i v)
 {
-	using namespace meshopt;
+	// computes running sums of 4 vertices in each 128-bit lane; the dependency chain across lanes is resolved separately
+	v = _mm256_add_epi8(v, _mm256_slli_si256(v, 4));
+	v = _mm256_add_epi8(v, _mm256_slli_si256(v, 8));
 
-	assert(vertex_size > 0 && vertex_size <= 256);
-	assert(vertex_size % 4 == 0);
+	return v;
+}
 
-#if TRACE
-	memset(vertexstats, 0, sizeof(vertexstats));
-#endif
+SIMD_TARGET_AVX2
+static __m128i prefix4(__m128i v)
+{
+	v = _mm_add_epi8(v, _mm_slli_si128(v, 4));
+	v = _mm_add_epi8(v, _mm_slli_si128(v, 8));
 
-	const unsigned char* vertex_data = static_cast<const unsigned char*>(vertices);
+	return v;
+}
 
-	unsigned char* data = buffer;
-	unsigned char* data_end = buffer + buffer_size;
+SIMD_TARGET_AVX2
+static const unsigned char* decodeVertexBlockAvx2(const unsigned char* data, const unsigned char* data_end, unsigned char* vertex_data, size_t vertex_count, size_t vertex_size, unsigned char last_vertex[256])
+{
+	assert(vertex_count > 0 && vertex_count <= kVertexBlockMaxSize);
 
-	if (size_t(data_end - data) < 1 + vertex_size)
-		return 0;
+	unsigned char buffer[kVertexBlockMaxSize * 4];
+	unsigned char transposed[kVertexBlockSizeBytes];
 
-	int version = gEncodeVertexVersion;
+	size_t vertex_count_aligned = (vertex_count + kByteGroupSize - 1) & ~(kByteGroupSize - 1);
 
-	*data++ = (unsigned char)(kVertexHeader | version);
+	for (size_t k = 0; k < vertex_size; k += 4)
+	{
+		for (size_t j = 0; j < 4; ++j)
+		{
+			data = decodeBytesSimd(data, data_end, buffer + j * vertex_count_aligned, vertex_count_aligned);
+			if (!data)
+				return 0;
+		}
 
-	unsigned char first_vertex[256] = {};
-	if (vertex_count > 0)
-		memcpy(first_vertex, vertex_data, vertex_size);
+		// running value of the last vertex, replicated to all 4 lanes
+		__m128i pi = _mm_set1_epi32(*reinterpret_cast<const int*>(last_vertex + k));
 
-	unsigned char last_vertex[256] = {};
-	memcpy(last_vertex, first_vertex, vertex_size);
+		unsigned char* savep = transposed + k;
 
-	size_t vertex_block_size = getVertexBlockSize(vertex_size);
+// note: buffer was just written with 128-bit stores, so we use 128-bit loads to make sure store forwarding works
+#define LOAD(i) r##i = _mm256_inserti128_si256(_mm256_castsi128_si256(_mm_loadu_si128(reinterpret_cast<const __m128i*>(buffer + j + i * vertex_count_aligned))), _mm_loadu_si128(reinterpret_cast<const __m128i*>(buffer + j + 16 + i * vertex_count_aligned)), 1)
+#define FIXD(x) x = _mm_add_epi8(x, pi), pi = _mm_shuffle_epi32(x, 0xff)
+#define SAVE(x) \
+	*reinterpret_cast<int*>(savep + vertex_size * 0) = _mm_cvtsi128_si32(x), \
+	*reinterpret_cast<int*>(savep + vertex_size * 1) = _mm_extract_epi32(x, 1), \
+	*reinterpret_cast<int*>(savep + vertex_size * 2) = _mm_extract_epi32(x, 2), \
+	*reinterpret_cast<int*>(savep + vertex_size * 3) = _mm_extract_epi32(x, 3), \
+	savep += vertex_size * 4
+#define GRP4(x) FIXD(x), SAVE(x)
+
+		size_t j = 0;
+
+		// fast-path: process 32 vertices at a time; after the transpose, each 128-bit lane contains 4 consecutive vertices
+		for (; j + 32 <= vertex_count_aligned; j += 32)
+		{
+			__m256i r0, r1, r2, r3;
 
-	size_t vertex_offset = 0;
+			LOAD(0);
+			LOAD(1);
+			LOAD(2);
+			LOAD(3);
 
-	while (vertex_offset < vertex_count)
-	{
-		size_t block_size = (vertex_offset + vertex_block_size < vertex_count) ? vertex_block_size : vertex_count - vertex_offset;
+			r0 = unzigzag8(r0);
+			r1 = unzigzag8(r1);
+			r2 = unzigzag8(r2);
+			r3 = unzigzag8(r3);
 
-		data = encodeVertexBlock(data, data_end, vertex_data + vertex_offset * vertex_size, block_size, vertex_size, last_vertex);
-		if (!data)
-			return 0;
+			transpose8(r0, r1, r2, r3);
 
-		vertex_offset += block_size;
-	}
+			r0 = prefix4(r0);
+			r1 = prefix4(r1);
+			r2 = prefix4(r2);
+			r3 = prefix4(r3);
 
-	size_t tail_size = vertex_size < kTailMaxSize ? kTailMaxSize : vertex_size;
+			__m128i t0 = _mm256_castsi256_si128(r0);
+			__m128i t1 = _mm256_castsi256_si128(r1);
+			__m128i t2 = _mm256_castsi256_si128(r2);
+			__m128i t3 = _mm256_castsi256_si128(r3);
 
-	if (size_t(data_end - data) < tail_size)
-		return 0;
+			GRP4(t0), GRP4(t1), GRP4(t2), GRP4(t3);
 
-	// write first vertex to the end of the stream and pad it to 32 bytes; this is important to simplify bounds checks in decoder
-	if (vertex_size < kTailMaxSize)
-	{
-		memset(data, 0, kTailMaxSize - vertex_size);
-		data += kTailMaxSize - vertex_size;
-	}
+			t0 = _mm256_extracti128_si256(r0, 1);
+			t1 = _mm256_extracti128_si256(r1, 1);
+			t2 = _mm256_extracti128_si256(r2, 1);
+			t3 = _mm256_extracti128_si256(r3, 1);
 
-	memcpy(data, first_vertex, vertex_size);
-	data += vertex_size;
+			GRP4(t0), GRP4(t1), GRP4(t2), GRP4(t3);
+		}
 
-	assert(data >= buffer + tail_size);
-	assert(data <= buffer + buffer_size);
+		// slow-path: process remaining 16 vertices using 128-bit operations
+		for (; j < vertex_count_aligned; j += 16)
+		{
+			__m128i t0 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(buffer + j + 0 * vertex_count_aligned));
+			__m128i t1 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(buffer + j + 1 * vertex_count_aligned));
+			__m128i t2 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(buffer + j + 2 * vertex_count_aligned));
+			__m128i t3 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(buffer + j + 3 * vertex_count_aligned));
 
-#if TRACE
-	size_t total_size = data - buffer;
+			t0 = unzigzag8(t0);
+			t1 = unzigzag8(t1);
+			t2 = unzigzag8(t2);
+			t3 = unzigzag8(t3);
 
-	for (size_t k = 0; k < vertex_size; ++k)
-	{
-		const Stats& vsk = vertexstats[k];
+			transpose8(t0, t1, t2, t3);
 
-		printf("%2d: %d bytes\t%.1f%%\t%.1f bpv", int(k), int(vsk.size), double(vsk.size) / double(total_size) * 100, double(vsk.size) / double(vertex_count) * 8);
+			t0 = prefix4(t0);
+			t1 = prefix4(t1);
+			t2 = prefix4(t2);
+			t3 = prefix4(t3);
 
-#if TRACE > 1
-		printf("\t\thdr %d bytes\tbit0 %d (%d bytes)\tbit1 %d (%d bytes)\tbit2 %d (%d bytes)\tbit3 %d (%d bytes)",
-		       int(vsk.header),
-		       int(vsk.bitg[0]), int(vsk.bitb[0]),
-		       int(vsk.bitg[1]), int(vsk.bitb[1]),
-		       int(vsk.bitg[2]), int(vsk.bitb[2]),
-		       int(vsk.bitg[3]), int(vsk.bitb[3]));
+			GRP4(t0), GRP4(t1), GRP4(t2), GRP4(t3);
+		}
+
+#undef LOAD
+#undef FIXD
+#undef SAVE
+#undef GRP4
+	}
+
+	memcpy(vertex_data, transposed, vertex_count * vertex_size);
+
+	memcpy(last_vertex, &transposed[vertex_size * (vertex_count - 1)], vertex_size);
+
+	return data;
+}
 #endif
 
-		printf("\n");
+#if defined(SIMD_SSE) && defined(SIMD_FALLBACK)
+static unsigned int getCpuFeatures()
+{
+	int cpuinfo[4] = {};
+#ifdef _MSC_VER
+	__cpuid(cpuinfo, 1);
+#else
+	__cpuid(1, cpuinfo[0], cpuinfo[1], cpuinfo[2], cpuinfo[3]);
+#endif
+	unsigned int result = cpuinfo[2];
+
+	// AVX instructions require OS support for saving YMM state (OSXSAVE + XCR0 bits 1-2); mask AVX bit if it's not available
+	if (result & (1 << 27))
+	{
+#ifdef _MSC_VER
+		unsigned long long xcr0 = _xgetbv(0);
+#else
+		unsigned int xcr0, xcr0_hi;
+		__asm__("xgetbv" : "=a"(xcr0), "=d"(xcr0_hi) : "c"(0));
+		(void)xcr0_hi;
+#endif
+		if ((xcr0 & 6) != 6)
+			result &= ~(1u << 28);
 	}
+	else
+		result &= ~(1u << 28);
+
+	return result;
+}
+
+static unsigned int getCpuFeaturesExtended()
+{
+	int cpuinfo[4] = {};
+#ifdef _MSC_VER
+	__cpuid(cpuinfo, 0);
+	if (cpuinfo[0] >= 7)
+		__cpuidex(cpuinfo, 7, 0);
+	else
+		cpuinfo[1] = 0;
+#else
+	if (__get_cpuid_max(0, 0) >= 7)
+		__cpuid_count(7, 0, cpuinfo[0], cpuinfo[1], cpuinfo[2], cpuinfo[3]);
+#endif
+	return cpuinfo[1];
+}
+
+unsigned int cpuid = getCpuFeatures();
+unsigned int cpuid7 = getCpuFeaturesExtended();
+#endif
+
+typedef const unsigned char* (*DecodeVertexBlockFn)(const unsigned char*, const unsigned char*, unsigned char*, size_t, size_t, unsigned char[256]);
+
+static DecodeVertexBlockFn getDecodeVertexBlock()
+{
+#if defined(SIMD_SSE) || defined(SIMD_NEON) || defined(SIMD_WASM)
+	assert(gDecodeBytesGroupInitialized);
+	(void)gDecodeBytesGroupInitialized;
+#endif
+
+#if defined(SIMD_SSE) && defined(SIMD_FALLBACK)
+	// AVX2 path needs SSSE3 (bit 9) and AVX (bit 28) from leaf 1 and AVX2 (bit 5) from leaf 7
+	if ((cpuid & (1 << 9)) && (cpuid & (1 << 28)) && (cpuid7 & (1 << 5)))
+		return decodeVertexBlockAvx2;
+
+	return (cpuid & (1 << 9)) ? decodeVertexBlockSimd : decodeVertexBlock;
+#elif defined(SIMD_AVX2)
+	(void)decodeVertexBlockSimd; // AVX2 is enabled through compiler settings so the 128-bit path is never used
+	return decodeVertexBlockAvx2;
+#elif defined(SIMD_SSE) || defined(SIMD_AVX) || defined(SIMD_NEON) || defined(SIMD_WASM)
+	return decodeVertexBlockSimd;
+#else
+	return decodeVertexBlock;
 #endif
+}
+
+} // namespace meshopt
+
+size_t meshopt_encodeVertexBuffer(unsigned char* buffer, size_t buffer_size, const void* vertices, size_t vertex_count, size_t vertex_size)
+{
+	return meshopt_encodeVertexBufferLevel(buffer, buffer_size, vertices, vertex_count, vertex_size, 1);
+}
+
+size_t meshopt_encodeVertexBufferLevel(unsigned char* buffer, size_t buffer_size, const void* vertices, size_t vertex_count, size_t vertex_size, int level)
+{
+	using namespace meshopt;
+
+	assert(vertex_size > 0 && vertex_size <= 256);
+	assert(vertex_size % 4 == 0);
+	assert(level >= 0 && level <= 1);
+
+	return encodeVertexBuffer(buffer, buffer_size, static_cast<const unsigned char*>(vertices), vertex_count, vertex_size, vertex_size, level);
+}
+
+size_t meshopt_encodeVertexBufferMulti(unsigned char* buffer, size_t buffer_size, size_t* stream_sizes, size_t vertex_count, const struct meshopt_Stream* streams, size_t stream_count)
+{
+	using namespace meshopt;
+
+	unsigned char* data = buffer;
+
+	for (size_t k = 0; k < stream_count; ++k)
+	{
+		assert(streams[k].size > 0 && streams[k].size <= 256);
+		assert(streams[k].size % 4 == 0);
+		assert(streams[k].size <= streams[k].stride);
+
+		// each stream is encoded from its source directly, so interleaved input doesn't need to be split into temporary buffers first
+		size_t size = encodeVertexBuffer(data, buffer + buffer_size - data, static_cast<const unsigned char*>(streams[k].data), vertex_count, streams[k].size, streams[k].stride, 1);
+		if (!size)
+			return 0;
+
+		stream_sizes[k] = size;
+		data += size;
+	}
 
 	return data - buffer;
 }
@@ -1203,6 +1580,16 @@ size_t meshopt_encodeVertexBufferBound(size_t vertex_count, size_t vertex_size)
 	return 1 + vertex_block_count * vertex_size * (vertex_block_header_size + vertex_block_data_size) + tail_size;
 }
 
+size_t meshopt_encodeVertexBufferMultiBound(size_t vertex_count, const struct meshopt_Stream* streams, size_t stream_count)
+{
+	size_t result = 0;
+
+	for (size_t k = 0; k < stream_count; ++k)
+		result += meshopt_encodeVertexBufferBound(vertex_count, streams[k].size);
+
+	return result;
+}
+
 void meshopt_encodeVertexVersion(int version)
 {
 	assert(unsigned(version) <= 0);
@@ -1211,26 +1598,18 @@ void meshopt_encodeVertexVersion(int version)
 }
 
 int meshopt_decodeVertexBuffer(void* destination, size_t vertex_count, size_t vertex_size, const unsigned char* buffer, size_t buffer_size)
+{
+	return meshopt_decodeVertexBufferFiltered(destination, vertex_count, vertex_size, buffer, buffer_size, NULL);
+}
+
+int meshopt_decodeVertexBufferFiltered(void* destination, size_t vertex_count, size_t vertex_size, const unsigned char* buffer, size_t buffer_size, void (*filter)(void*, size_t, size_t))
 {
 	using namespace meshopt;
 
 	assert(vertex_size > 0 && vertex_size <= 256);
 	assert(vertex_size % 4 == 0);
 
-	const unsigned char* (*decode)(const unsigned char*, const unsigned char*, unsigned char*, size_t, size_t, unsigned char[256]) = 0;
-
-#if defined(SIMD_SSE) && defined(SIMD_FALLBACK)
-	decode = (cpuid & (1 << 9)) ? decodeVertexBlockSimd : decodeVertexBlock;
-#elif defined(SIMD_SSE) || defined(SIMD_AVX) || defined(SIMD_NEON) || defined(SIMD_WASM)
-	decode = decodeVertexBlockSimd;
-#else
-	decode = decodeVertexBlock;
-#endif
-
-#if defined(SIMD_SSE) || defined(SIMD_NEON) || defined(SIMD_WASM)
-	assert(gDecodeBytesGroupInitialized);
-	(void)gDecodeBytesGroupInitialized;
-#endif
+	DecodeVertexBlockFn decode = getDecodeVertexBlock();
 
 	unsigned char* vertex_data = static_cast<unsigned char*>(destination);
 
@@ -1264,6 +1643,10 @@ int meshopt_decodeVertexBuffer(void* destination, size_t vertex_count, size_t ve
 		if (!data)
 			return -2;
 
+		// filter the block while it's still in cache; this is safe since last_vertex is copied from the unfiltered data
+		if (filter)
+			filter(vertex_data + vertex_offset * vertex_size, block_size, vertex_size);
+
 		vertex_offset += block_size;
 	}
 
@@ -1275,9 +1658,325 @@ int meshopt_decodeVertexBuffer(void* destination, size_t vertex_count, size_t ve
 	return 0;
 }
 
+size_t meshopt_decodeVertexBufferInPlaceMargin(size_t vertex_count, size_t vertex_size, const unsigned char* buffer, size_t buffer_size)
+{
+	using namespace meshopt;
+
+	assert(vertex_size > 0 && vertex_size <= 256);
+	assert(vertex_size % 4 == 0);
+
+	// malformed buffers fail to decode; placing the input right after the output keeps that from touching the input
+	if (buffer_size < 1 + vertex_size || (buffer[0] & 0xf0) != kVertexHeader || (buffer[0] & 0x0f) > 0)
+		return buffer_size;
+
+	const unsigned char* data = buffer + 1;
+	const unsigned char* data_end = buffer + buffer_size;
+
+	size_t decoded_size = vertex_count * vertex_size;
+
+	// the input has to fit into the allocation; the tail is read before any output is written so it doesn't need protection
+	size_t margin = buffer_size > decoded_size ? buffer_size - decoded_size : 0;
+
+	size_t vertex_block_size = getVertexBlockSize(vertex_size);
+
+	size_t vertex_offset = 0;
+
+	while (vertex_offset < vertex_count)
+	{
+		size_t block_size = (vertex_offset + vertex_block_size < vertex_count) ? vertex_block_size : vertex_count - vertex_offset;
+
+		data = skipVertexBlock(data, data_end, block_size, vertex_size);
+		if (!data)
+			return buffer_size;
+
+		vertex_offset += block_size;
+
+		// decoders read the entire block before writing it out, so the written block must end before the next block starts
+		size_t write = vertex_offset * vertex_size;
+		size_t read = data - buffer;
+
+		if (vertex_offset < vertex_count && write + buffer_size > read + decoded_size && write + buffer_size - read - decoded_size > margin)
+			margin = write + buffer_size - read - decoded_size;
+	}
+
+	return margin;
+}
+
+size_t meshopt_encodeVertexSeekTable(unsigned char* table, size_t table_size, const unsigned char* buffer, size_t buffer_size, const void* vertices, size_t vertex_count, size_t vertex_size)
+{
+	using namespace meshopt;
+
+	assert(vertex_size > 0 && vertex_size <= 256);
+	assert(vertex_size % 4 == 0);
+
+	const unsigned char* vertex_data = static_cast<const unsigned char*>(vertices);
+
+	size_t entry_size = getVertexSeekEntrySize(vertex_size);
+	size_t result = meshopt_encodeVertexSeekTableBound(vertex_count, vertex_size);
+
+	if (table_size < result)
+		return 0;
+
+	const unsigned char* data = buffer;
+	const unsigned char* data_end = buffer + buffer_size;
+
+	if (size_t(data_end - data) < 1 + vertex_size || (*data & 0xf0) != kVertexHeader)
+		return 0;
+
+	data++;
+
+	size_t vertex_block_size = getVertexBlockSize(vertex_size);
+
+	size_t vertex_offset = 0;
+
+	while (vertex_offset < vertex_count)
+	{
+		size_t block_size = (vertex_offset + vertex_block_size < vertex_count) ? vertex_block_size : vertex_count - vertex_offset;
+
+		size_t data_offset = data - buffer;
+		if (data_offset > 0xffffffff)
+			return 0;
+
+		table[0] = (unsigned char)(data_offset >> 0);
+		table[1] = (unsigned char)(data_offset >> 8);
+		table[2] = (unsigned char)(data_offset >> 16);
+		table[3] = (unsigned char)(data_offset >> 24);
+
+		// the first block uses the first vertex as a base, and all subsequent blocks use the last vertex of the previous block
+		memcpy(table + 4, vertex_data + (vertex_offset ? vertex_offset - 1 : 0) * vertex_size, vertex_size);
+		table += entry_size;
+
+		data = skipVertexBlock(data, data_end, block_size, vertex_size);
+		if (!data)
+			return 0;
+
+		vertex_offset += block_size;
+	}
+
+	return result;
+}
+
+size_t meshopt_encodeVertexSeekTableBound(size_t vertex_count, size_t vertex_size)
+{
+	using namespace meshopt;
+
+	assert(vertex_size > 0 && vertex_size <= 256);
+	assert(vertex_size % 4 == 0);
+
+	size_t vertex_block_size = getVertexBlockSize(vertex_size);
+	size_t vertex_block_count = (vertex_count + vertex_block_size - 1) / vertex_block_size;
+
+	return vertex_block_count * getVertexSeekEntrySize(vertex_size);
+}
+
+int meshopt_decodeVertexBufferRange(void* destination, size_t vertex_count, size_t vertex_size, size_t range_offset, size_t range_count, const unsigned char* buffer, size_t buffer_size, const unsigned char* table, size_t table_size)
+{
+	using namespace meshopt;
+
+	assert(vertex_size > 0 && vertex_size <= 256);
+	assert(vertex_size % 4 == 0);
+	assert(range_offset <= vertex_count && range_count <= vertex_count - range_offset);
+
+	DecodeVertexBlockFn decode = getDecodeVertexBlock();
+
+	unsigned char* vertex_data = static_cast<unsigned char*>(destination);
+
+	const unsigned char* data_end = buffer + buffer_size;
+
+	if (buffer_size < 1 + vertex_size)
+		return -2;
+
+	unsigned char data_header = buffer[0];
+
+	if ((data_header & 0xf0) != kVertexHeader)
+		return -1;
+
+	int version = data_header & 0x0f;
+	if (version > 0)
+		return -1;
+
+	if (table_size != meshopt_encodeVertexSeekTableBound(vertex_count, vertex_size))
+		return -1;
+
+	if (range_count == 0)
+		return 0;
+
+	size_t entry_size = getVertexSeekEntrySize(vertex_size);
+	size_t vertex_block_size = getVertexBlockSize(vertex_size);
+
+	size_t block_begin = range_offset / vertex_block_size;
+	size_t block_end = (range_offset + range_count + vertex_block_size - 1) / vertex_block_size;
+
+	const unsigned char* entry = table + block_begin * entry_size;
+	size_t data_offset = entry[0] | (entry[1] << 8) | (entry[2] << 16) | (size_t(entry[3]) << 24);
+
+	if (data_offset >= buffer_size)
+		return -2;
+
+	const unsigned char* data = buffer + data_offset;
+
+	unsigned char last_vertex[256];
+	memcpy(last_vertex, entry + 4, vertex_size);
+
+	for (size_t block = block_begin; block < block_end; ++block)
+	{
+		size_t vertex_offset = block * vertex_block_size;
+		size_t block_size = (vertex_offset + vertex_block_size < vertex_count) ? vertex_block_size : vertex_count - vertex_offset;
+
+		size_t copy_begin = (range_offset > vertex_offset) ? range_offset - vertex_offset : 0;
+		size_t copy_end = (range_offset + range_count < vertex_offset + block_size) ? range_offset + range_count - vertex_offset : block_size;
+
+		if (copy_begin == 0 && copy_end == block_size)
+		{
+			data = decode(data, data_end, vertex_data + vertex_offset * vertex_size, block_size, vertex_size, last_vertex);
+		}
+		else
+		{
+			// blocks that are partially covered by the range are decoded into a scratch buffer to avoid writing outside of the range
+			unsigned char scratch[kVertexBlockSizeBytes];
+
+			data = decode(data, data_end, scratch, block_size, vertex_size, last_vertex);
+
+			if (data)
+				memcpy(vertex_data + (vertex_offset + copy_begin) * vertex_size, scratch + copy_begin * vertex_size, (copy_end - copy_begin) * vertex_size);
+		}
+
+		if (!data)
+			return -2;
+	}
+
+	size_t tail_size = vertex_size < kTailMaxSize ? kTailMaxSize : vertex_size;
+
+	if (range_offset + range_count == vertex_count && size_t(data_end - data) != tail_size)
+		return -3;
+
+	return 0;
+}
+
+void meshopt_decodeVertexStreamInit(meshopt_VertexDecoder* decoder, size_t vertex_count, size_t vertex_size, const void* first_vertex)
+{
+	assert(vertex_size > 0 && vertex_size <= 256);
+	assert(vertex_size % 4 == 0);
+
+	memset(decoder, 0, sizeof(meshopt_VertexDecoder));
+
+	decoder->vertex_count = vertex_count;
+	decoder->vertex_size = vertex_size;
+
+	// without the first vertex, vertices are decoded relative to zero; since delta decoding is additive, they can be fixed up at the end
+	if (first_vertex)
+		memcpy(decoder->last_vertex, first_vertex, vertex_size);
+	else
+		decoder->delta = 1;
+}
+
+int meshopt_decodeVertexStream(meshopt_VertexDecoder* decoder, void* destination, const unsigned char* buffer, size_t buffer_size, size_t* buffer_consumed)
+{
+	using namespace meshopt;
+
+	enum
+	{
+		Stage_Header,
+		Stage_Blocks,
+		Stage_Tail,
+		Stage_Done,
+	};
+
+	size_t vertex_count = decoder->vertex_count;
+	size_t vertex_size = decoder->vertex_size;
+
+	assert(vertex_size > 0 && vertex_size <= 256);
+	assert(vertex_size % 4 == 0);
+
+	unsigned char* vertex_data = static_cast<unsigned char*>(destination);
+
+	const unsigned char* data = buffer;
+	const unsigned char* data_end = buffer + buffer_size;
+
+	*buffer_consumed = 0;
+
+	if (decoder->stage == Stage_Header)
+	{
+		if (data == data_end)
+			return 1;
+
+		unsigned char data_header = *data++;
+
+		if ((data_header & 0xf0) != kVertexHeader)
+			return -1;
+
+		int version = data_header & 0x0f;
+		if (version > 0)
+			return -1;
+
+		decoder->stage = Stage_Blocks;
+	}
+
+	if (decoder->stage == Stage_Blocks)
+	{
+		DecodeVertexBlockFn decode = getDecodeVertexBlock();
+
+		size_t vertex_block_size = getVertexBlockSize(vertex_size);
+		size_t vertex_offset = decoder->vertex_offset;
+
+		while (vertex_offset < vertex_count)
+		{
+			size_t block_size = (vertex_offset + vertex_block_size < vertex_count) ? vertex_block_size : vertex_count - vertex_offset;
+			size_t block_size_aligned = (block_size + kByteGroupSize - 1) & ~(kByteGroupSize - 1);
+
+			// the decoder can't resume from the middle of a block, so unless the chunk is large enough for a worst-case block we need to check that the block is complete
+			size_t block_bound = vertex_size * ((block_size_aligned / kByteGroupSize + 3) / 4 + block_size_aligned) + kByteGroupDecodeLimit;
+
+			if (size_t(data_end - data) < block_bound && !skipVertexBlock(data, data_end, block_size, vertex_size))
+				break;
+
+			data = decode(data, data_end, vertex_data + vertex_offset * vertex_size, block_size, vertex_size, decoder->last_vertex);
+			if (!data)
+				return -2;
+
+			vertex_offset += block_size;
+		}
+
+		decoder->vertex_offset = vertex_offset;
+
+		if (vertex_offset == vertex_count)
+			decoder->stage = Stage_Tail;
+	}
+
+	if (decoder->stage == Stage_Tail)
+	{
+		size_t tail_size = vertex_size < kTailMaxSize ? kTailMaxSize : vertex_size;
+
+		if (size_t(data_end - data) >= tail_size)
+		{
+			const unsigned char* first_vertex = data + tail_size - vertex_size;
+
+			if (decoder->delta)
+			{
+				for (size_t i = 0; i < vertex_count; ++i)
+					for (size_t k = 0; k < vertex_size; ++k)
+						vertex_data[i * vertex_size + k] += first_vertex[k];
+
+				decoder->delta = 0;
+			}
+
+			data += tail_size;
+
+			decoder->stage = Stage_Done;
+		}
+	}
+
+	*buffer_consumed = data - buffer;
+
+	return decoder->stage == Stage_Done ? 0 : 1;
+}
+
 #undef SIMD_NEON
 #undef SIMD_SSE
 #undef SIMD_AVX
+#undef SIMD_AVX2
 #undef SIMD_WASM
 #undef SIMD_FALLBACK
 #undef SIMD_TARGET
+#undef SIMD_TARGET_AVX2
+#undef SIMD_INLINE
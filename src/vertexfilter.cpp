@@ -2,6 +2,7 @@
 #include "meshoptimizer.h"
 
 #include <math.h>
+#include <string.h>
 
 // The block below auto-detects SIMD ISA that can be used on the target platform
 #ifndef MESHOPTIMIZER_NO_SIMD
@@ -157,6 +158,71 @@ static void decodeFilterExp(unsigned int* data, size_t count)
 }
 #endif
 
+#ifndef SIMD_SSE
+// only SSE has vectorized encoders at the moment; other targets use scalar kernels
+static void quantizeUnorm(int* result, const float* data, size_t count, int N)
+{
+	for (size_t i = 0; i < count; ++i)
+		result[i] = meshopt_quantizeUnorm(data[i], N);
+}
+
+static void quantizeSnorm(int* result, const float* data, size_t count, int N)
+{
+	for (size_t i = 0; i < count; ++i)
+		result[i] = meshopt_quantizeSnorm(data[i], N);
+}
+
+static void quantizeHalf(int* result, const float* data, size_t count, int N)
+{
+	(void)N;
+
+	for (size_t i = 0; i < count; ++i)
+		result[i] = meshopt_quantizeHalf(data[i]);
+}
+
+static void encodeOct(float* u, float* v, const float* x, const float* y, const float* z, size_t count)
+{
+	for (size_t i = 0; i < count; ++i)
+	{
+		// project the vector onto the octahedron |x|+|y|+|z|=1
+		float nl = fabsf(x[i]) + fabsf(y[i]) + fabsf(z[i]);
+		float ns = nl == 0.f ? 0.f : 1.f / nl;
+
+		float nx = x[i] * ns;
+		float ny = y[i] * ns;
+
+		// unfold the lower hemisphere over the diagonals
+		u[i] = (z[i] >= 0.f) ? nx : (1 - fabsf(ny)) * (nx >= 0.f ? 1.f : -1.f);
+		v[i] = (z[i] >= 0.f) ? ny : (1 - fabsf(nx)) * (ny >= 0.f ? 1.f : -1.f);
+	}
+}
+
+static void encodeQuat(float* a, float* b, float* c, int* qc, const float* x, const float* y, const float* z, const float* w, size_t count)
+{
+	const float scaler = sqrtf(2.f);
+
+	for (size_t i = 0; i < count; ++i)
+	{
+		float q[4] = {x[i], y[i], z[i], w[i]};
+
+		// establish maximum quaternion component
+		int qi = 0;
+		qi = fabsf(q[1]) > fabsf(q[qi]) ? 1 : qi;
+		qi = fabsf(q[2]) > fabsf(q[qi]) ? 2 : qi;
+		qi = fabsf(q[3]) > fabsf(q[qi]) ? 3 : qi;
+
+		// we use double-cover properties to discard the sign
+		float sign = q[qi] < 0.f ? -1.f : 1.f;
+
+		// note: we always encode a cyclical swizzle to be able to recover the order via rotation
+		a[i] = q[(qi + 1) & 3] * scaler * sign;
+		b[i] = q[(qi + 2) & 3] * scaler * sign;
+		c[i] = q[(qi + 3) & 3] * scaler * sign;
+		qc[i] = qi;
+	}
+}
+#endif
+
 #if defined(SIMD_SSE) || defined(SIMD_NEON) || defined(SIMD_WASM)
 inline uint64_t rotateleft64(uint64_t v, int x)
 {
@@ -357,6 +423,158 @@ static void decodeFilterExpSimd(unsigned int* data, size_t count)
 		_mm_storeu_ps(reinterpret_cast<float*>(&data[i]), r);
 	}
 }
+
+inline __m128 selectSimd(__m128 mask, __m128 a, __m128 b)
+{
+	return _mm_or_ps(_mm_and_ps(mask, a), _mm_andnot_ps(mask, b));
+}
+
+static void quantizeUnormSimd(int* result, const float* data, size_t count, int N)
+{
+	const __m128 scale = _mm_set1_ps(float((1 << N) - 1));
+
+	for (size_t i = 0; i < count; i += 4)
+	{
+		__m128 v = _mm_loadu_ps(&data[i]);
+
+		// clamp to [0..1]; note that max returns the second operand for NaN which matches the scalar version
+		v = _mm_min_ps(_mm_max_ps(v, _mm_setzero_ps()), _mm_set1_ps(1.f));
+
+		// rounded unsigned float->int; truncation is equivalent to floor since the value is non-negative
+		__m128i r = _mm_cvttps_epi32(_mm_add_ps(_mm_mul_ps(v, scale), _mm_set1_ps(0.5f)));
+
+		_mm_storeu_si128(reinterpret_cast<__m128i*>(&result[i]), r);
+	}
+}
+
+static void quantizeSnormSimd(int* result, const float* data, size_t count, int N)
+{
+	const __m128 sign = _mm_set1_ps(-0.f);
+	const __m128 scale = _mm_set1_ps(float((1 << (N - 1)) - 1));
+
+	for (size_t i = 0; i < count; i += 4)
+	{
+		__m128 v = _mm_loadu_ps(&data[i]);
+
+		// clamp to [-1..1]
+		v = _mm_min_ps(_mm_max_ps(v, _mm_set1_ps(-1.f)), _mm_set1_ps(1.f));
+
+		// rounded signed float->int: add 0.5 with the sign of the value and truncate
+		__m128 round = _mm_or_ps(_mm_and_ps(v, sign), _mm_set1_ps(0.5f));
+		__m128i r = _mm_cvttps_epi32(_mm_add_ps(_mm_mul_ps(v, scale), round));
+
+		_mm_storeu_si128(reinterpret_cast<__m128i*>(&result[i]), r);
+	}
+}
+
+static void quantizeHalfSimd(int* result, const float* data, size_t count, int N)
+{
+	(void)N;
+
+	for (size_t i = 0; i < count; i += 4)
+	{
+		__m128i ui = _mm_castps_si128(_mm_loadu_ps(&data[i]));
+
+		__m128i s = _mm_and_si128(_mm_srli_epi32(ui, 16), _mm_set1_epi32(0x8000));
+		__m128i em = _mm_and_si128(ui, _mm_set1_epi32(0x7fffffff));
+
+		// bias exponent and round to nearest; 112 is relative exponent bias (127-15)
+		__m128i h = _mm_srai_epi32(_mm_add_epi32(em, _mm_set1_epi32((1 << 12) - (112 << 23))), 13);
+
+		// underflow: flush to zero; 113 encodes exponent -14
+		h = _mm_andnot_si128(_mm_cmplt_epi32(em, _mm_set1_epi32(113 << 23)), h);
+
+		// overflow: infinity; 143 encodes exponent 16
+		__m128i mo = _mm_cmpgt_epi32(em, _mm_set1_epi32((143 << 23) - 1));
+		h = _mm_or_si128(_mm_andnot_si128(mo, h), _mm_and_si128(mo, _mm_set1_epi32(0x7c00)));
+
+		// NaN; note that we convert all types of NaN to qNaN
+		__m128i mn = _mm_cmpgt_epi32(em, _mm_set1_epi32(255 << 23));
+		h = _mm_or_si128(_mm_andnot_si128(mn, h), _mm_and_si128(mn, _mm_set1_epi32(0x7e00)));
+
+		_mm_storeu_si128(reinterpret_cast<__m128i*>(&result[i]), _mm_or_si128(s, h));
+	}
+}
+
+static void encodeOctSimd(float* u, float* v, const float* x, const float* y, const float* z, size_t count)
+{
+	const __m128 sign = _mm_set1_ps(-0.f);
+	const __m128 one = _mm_set1_ps(1.f);
+	const __m128 zero = _mm_setzero_ps();
+
+	for (size_t i = 0; i < count; i += 4)
+	{
+		__m128 nx = _mm_loadu_ps(&x[i]);
+		__m128 ny = _mm_loadu_ps(&y[i]);
+		__m128 nz = _mm_loadu_ps(&z[i]);
+
+		// project the vector onto the octahedron |x|+|y|+|z|=1
+		__m128 nl = _mm_add_ps(_mm_add_ps(_mm_andnot_ps(sign, nx), _mm_andnot_ps(sign, ny)), _mm_andnot_ps(sign, nz));
+		__m128 ns = _mm_and_ps(_mm_cmpneq_ps(nl, zero), _mm_div_ps(one, nl));
+
+		nx = _mm_mul_ps(nx, ns);
+		ny = _mm_mul_ps(ny, ns);
+
+		// unfold the lower hemisphere over the diagonals
+		__m128 sx = _mm_or_ps(one, _mm_andnot_ps(_mm_cmpge_ps(nx, zero), sign));
+		__m128 sy = _mm_or_ps(one, _mm_andnot_ps(_mm_cmpge_ps(ny, zero), sign));
+
+		__m128 fu = _mm_mul_ps(_mm_sub_ps(one, _mm_andnot_ps(sign, ny)), sx);
+		__m128 fv = _mm_mul_ps(_mm_sub_ps(one, _mm_andnot_ps(sign, nx)), sy);
+
+		__m128 zp = _mm_cmpge_ps(nz, zero);
+
+		_mm_storeu_ps(&u[i], selectSimd(zp, nx, fu));
+		_mm_storeu_ps(&v[i], selectSimd(zp, ny, fv));
+	}
+}
+
+static void encodeQuatSimd(float* a, float* b, float* c, int* qc, const float* x, const float* y, const float* z, const float* w, size_t count)
+{
+	const __m128 sign = _mm_set1_ps(-0.f);
+	const __m128 scaler = _mm_set1_ps(sqrtf(2.f));
+
+	for (size_t i = 0; i < count; i += 4)
+	{
+		__m128 qx = _mm_loadu_ps(&x[i]);
+		__m128 qy = _mm_loadu_ps(&y[i]);
+		__m128 qz = _mm_loadu_ps(&z[i]);
+		__m128 qw = _mm_loadu_ps(&w[i]);
+
+		// establish maximum quaternion component; the remaining components are tracked in cyclical swizzle order
+		__m128 qm = qx, r0 = qy, r1 = qz, r2 = qw;
+		__m128 qi = _mm_setzero_ps();
+
+		__m128 m1 = _mm_cmpgt_ps(_mm_andnot_ps(sign, qy), _mm_andnot_ps(sign, qm));
+		qm = selectSimd(m1, qy, qm);
+		r0 = selectSimd(m1, qz, r0);
+		r1 = selectSimd(m1, qw, r1);
+		r2 = selectSimd(m1, qx, r2);
+		qi = selectSimd(m1, _mm_set1_ps(1.f), qi);
+
+		__m128 m2 = _mm_cmpgt_ps(_mm_andnot_ps(sign, qz), _mm_andnot_ps(sign, qm));
+		qm = selectSimd(m2, qz, qm);
+		r0 = selectSimd(m2, qw, r0);
+		r1 = selectSimd(m2, qx, r1);
+		r2 = selectSimd(m2, qy, r2);
+		qi = selectSimd(m2, _mm_set1_ps(2.f), qi);
+
+		__m128 m3 = _mm_cmpgt_ps(_mm_andnot_ps(sign, qw), _mm_andnot_ps(sign, qm));
+		qm = selectSimd(m3, qw, qm);
+		r0 = selectSimd(m3, qx, r0);
+		r1 = selectSimd(m3, qy, r1);
+		r2 = selectSimd(m3, qz, r2);
+		qi = selectSimd(m3, _mm_set1_ps(3.f), qi);
+
+		// we use double-cover properties to discard the sign
+		__m128 s = _mm_xor_ps(scaler, _mm_and_ps(_mm_cmplt_ps(qm, _mm_setzero_ps()), sign));
+
+		_mm_storeu_ps(&a[i], _mm_mul_ps(r0, s));
+		_mm_storeu_ps(&b[i], _mm_mul_ps(r1, s));
+		_mm_storeu_ps(&c[i], _mm_mul_ps(r2, s));
+		_mm_storeu_si128(reinterpret_cast<__m128i*>(&qc[i]), _mm_cvttps_epi32(qi));
+	}
+}
 #endif
 
 #if defined(SIMD_NEON) && !defined(__aarch64__) && !defined(_M_ARM64)
@@ -767,6 +985,193 @@ static void decodeFilterExpSimd(unsigned int* data, size_t count)
 }
 #endif
 
+// Encoders gather input into small contiguous tiles so that the kernels above can run on arbitrary input and output strides
+const size_t kEncodeTileSize = 64;
+
+typedef void (*QuantizeKernel)(int* result, const float* data, size_t count, int N);
+
+template <typename T>
+static void scatterComponent(unsigned char* destination, size_t stride, const int* values, size_t count)
+{
+	for (size_t j = 0; j < count; ++j)
+	{
+		T v = T(values[j]);
+		memcpy(destination + j * stride, &v, sizeof(T));
+	}
+}
+
+static void writeComponent(unsigned char* destination, size_t stride, size_t component_size, const int* values, size_t count)
+{
+	if (component_size == 1)
+		scatterComponent<unsigned char>(destination, stride, values, count);
+	else
+		scatterComponent<unsigned short>(destination, stride, values, count);
+}
+
+static void fillComponent(unsigned char* destination, size_t stride, size_t component_size, int value, size_t count)
+{
+	int values[kEncodeTileSize];
+
+	for (size_t j = 0; j < count; ++j)
+		values[j] = value;
+
+	writeComponent(destination, stride, component_size, values, count);
+}
+
+template <typename T, size_t Components>
+static void quantizeBuffer(unsigned char* destination, size_t vertex_count, size_t vertex_size, const unsigned char* data, size_t data_stride, int N, QuantizeKernel kernel)
+{
+	float values[kEncodeTileSize * 4];
+	int result[kEncodeTileSize * 4];
+
+	for (size_t i = 0; i < vertex_count; i += kEncodeTileSize)
+	{
+		size_t tile_size = (vertex_count - i < kEncodeTileSize) ? vertex_count - i : kEncodeTileSize;
+		size_t value_count = tile_size * Components;
+
+		for (size_t j = 0; j < tile_size; ++j)
+			memcpy(&values[j * Components], data + (i + j) * data_stride, Components * sizeof(float));
+
+		// pad the tile so that SIMD kernels can process values in groups of 4
+		for (size_t j = value_count; j < ((value_count + 3) & ~size_t(3)); ++j)
+			values[j] = 0.f;
+
+		kernel(result, values, value_count, N);
+
+		for (size_t j = 0; j < tile_size; ++j)
+		{
+			unsigned char* vertex = destination + (i + j) * vertex_size;
+
+			for (size_t k = 0; k < Components; ++k)
+			{
+				T v = T(result[j * Components + k]);
+				memcpy(vertex + k * sizeof(T), &v, sizeof(T));
+			}
+		}
+	}
+}
+
+template <typename T>
+static void quantizeBuffer(unsigned char* destination, size_t vertex_count, size_t vertex_size, const unsigned char* data, size_t data_stride, size_t components, int N, QuantizeKernel kernel)
+{
+	// specializing on the component count lets the compiler unroll per-vertex copies into fixed size moves
+	switch (components)
+	{
+	case 1:
+		quantizeBuffer<T, 1>(destination, vertex_count, vertex_size, data, data_stride, N, kernel);
+		break;
+	case 2:
+		quantizeBuffer<T, 2>(destination, vertex_count, vertex_size, data, data_stride, N, kernel);
+		break;
+	case 3:
+		quantizeBuffer<T, 3>(destination, vertex_count, vertex_size, data, data_stride, N, kernel);
+		break;
+	default:
+		quantizeBuffer<T, 4>(destination, vertex_count, vertex_size, data, data_stride, N, kernel);
+	}
+}
+
+static void quantizeBuffer(unsigned char* destination, size_t vertex_count, size_t vertex_size, size_t component_size, const unsigned char* data, size_t data_stride, size_t components, int N, QuantizeKernel kernel)
+{
+	if (component_size == 1)
+		quantizeBuffer<unsigned char>(destination, vertex_count, vertex_size, data, data_stride, components, N, kernel);
+	else
+		quantizeBuffer<unsigned short>(destination, vertex_count, vertex_size, data, data_stride, components, N, kernel);
+}
+
+static void gatherTile(float* x, float* y, float* z, float* w, const float* data, size_t tile_size)
+{
+	for (size_t j = 0; j < tile_size; ++j)
+	{
+		x[j] = data[j * 4 + 0];
+		y[j] = data[j * 4 + 1];
+		z[j] = data[j * 4 + 2];
+		w[j] = data[j * 4 + 3];
+	}
+
+	// pad the tile so that SIMD kernels can process values in groups of 4
+	for (size_t j = tile_size; j < ((tile_size + 3) & ~size_t(3)); ++j)
+		x[j] = y[j] = z[j] = w[j] = 0.f;
+}
+
+static void encodeFilterOctBuffer(unsigned char* destination, size_t vertex_count, size_t vertex_size, int bits, const float* data)
+{
+	float x[kEncodeTileSize], y[kEncodeTileSize], z[kEncodeTileSize], w[kEncodeTileSize];
+	float u[kEncodeTileSize], v[kEncodeTileSize];
+	int ur[kEncodeTileSize], vr[kEncodeTileSize], wr[kEncodeTileSize];
+
+	size_t component_size = vertex_size / 4;
+
+	// z stores 1.0 at the same bit count which is used by the decoder to recover the scale; w uses the full component width
+	int one = meshopt_quantizeSnorm(1.f, bits);
+	int wbits = int(component_size * 8);
+
+	for (size_t i = 0; i < vertex_count; i += kEncodeTileSize)
+	{
+		size_t tile_size = (vertex_count - i < kEncodeTileSize) ? vertex_count - i : kEncodeTileSize;
+
+		gatherTile(x, y, z, w, data + i * 4, tile_size);
+
+#ifdef SIMD_SSE
+		encodeOctSimd(u, v, x, y, z, tile_size);
+		quantizeSnormSimd(ur, u, tile_size, bits);
+		quantizeSnormSimd(vr, v, tile_size, bits);
+		quantizeSnormSimd(wr, w, tile_size, wbits);
+#else
+		encodeOct(u, v, x, y, z, tile_size);
+		quantizeSnorm(ur, u, tile_size, bits);
+		quantizeSnorm(vr, v, tile_size, bits);
+		quantizeSnorm(wr, w, tile_size, wbits);
+#endif
+
+		unsigned char* vertex = destination + i * vertex_size;
+
+		writeComponent(vertex + 0 * component_size, vertex_size, component_size, ur, tile_size);
+		writeComponent(vertex + 1 * component_size, vertex_size, component_size, vr, tile_size);
+		fillComponent(vertex + 2 * component_size, vertex_size, component_size, one, tile_size);
+		writeComponent(vertex + 3 * component_size, vertex_size, component_size, wr, tile_size);
+	}
+}
+
+static void encodeFilterQuatBuffer(unsigned char* destination, size_t vertex_count, int bits, const float* data)
+{
+	float x[kEncodeTileSize], y[kEncodeTileSize], z[kEncodeTileSize], w[kEncodeTileSize];
+	float a[kEncodeTileSize], b[kEncodeTileSize], c[kEncodeTileSize];
+	int ar[kEncodeTileSize], br[kEncodeTileSize], cr[kEncodeTileSize], qc[kEncodeTileSize];
+
+	// the last component stores the scale in the high bits and the index of the reconstructed component in the low 2 bits
+	int one = meshopt_quantizeSnorm(1.f, bits) & ~3;
+
+	for (size_t i = 0; i < vertex_count; i += kEncodeTileSize)
+	{
+		size_t tile_size = (vertex_count - i < kEncodeTileSize) ? vertex_count - i : kEncodeTileSize;
+
+		gatherTile(x, y, z, w, data + i * 4, tile_size);
+
+#ifdef SIMD_SSE
+		encodeQuatSimd(a, b, c, qc, x, y, z, w, tile_size);
+		quantizeSnormSimd(ar, a, tile_size, bits);
+		quantizeSnormSimd(br, b, tile_size, bits);
+		quantizeSnormSimd(cr, c, tile_size, bits);
+#else
+		encodeQuat(a, b, c, qc, x, y, z, w, tile_size);
+		quantizeSnorm(ar, a, tile_size, bits);
+		quantizeSnorm(br, b, tile_size, bits);
+		quantizeSnorm(cr, c, tile_size, bits);
+#endif
+
+		for (size_t j = 0; j < tile_size; ++j)
+			qc[j] |= one;
+
+		unsigned char* vertex = destination + i * 8;
+
+		writeComponent(vertex + 0, 8, 2, ar, tile_size);
+		writeComponent(vertex + 2, 8, 2, br, tile_size);
+		writeComponent(vertex + 4, 8, 2, cr, tile_size);
+		writeComponent(vertex + 6, 8, 2, qc, tile_size);
+	}
+}
+
 } // namespace meshopt
 
 void meshopt_decodeFilterOct(void* buffer, size_t vertex_count, size_t vertex_size)
@@ -818,6 +1223,76 @@ void meshopt_decodeFilterExp(void* buffer, size_t vertex_count, size_t vertex_si
 #endif
 }
 
+void meshopt_encodeFilterOct(void* destination, size_t vertex_count, size_t vertex_size, int bits, const float* data)
+{
+	using namespace meshopt;
+
+	assert(vertex_size == 4 || vertex_size == 8);
+	assert(bits >= 1 && bits <= int(vertex_size * 2));
+
+	encodeFilterOctBuffer(static_cast<unsigned char*>(destination), vertex_count, vertex_size, bits, data);
+}
+
+void meshopt_encodeFilterQuat(void* destination, size_t vertex_count, size_t vertex_size, int bits, const float* data)
+{
+	using namespace meshopt;
+
+	assert(vertex_size == 8);
+	assert(bits >= 4 && bits <= 16);
+	(void)vertex_size;
+
+	encodeFilterQuatBuffer(static_cast<unsigned char*>(destination), vertex_count, bits, data);
+}
+
+void meshopt_quantizeUnormBuffer(void* destination, size_t vertex_count, size_t vertex_size, size_t component_size, const float* data, size_t data_stride, size_t components, int N)
+{
+	using namespace meshopt;
+
+	assert(component_size == 1 || component_size == 2);
+	assert(components >= 1 && components <= 4);
+	assert(components * component_size <= vertex_size);
+	assert(data_stride >= components * sizeof(float) && data_stride % sizeof(float) == 0);
+	assert(N >= 1 && N <= int(component_size * 8));
+
+#ifdef SIMD_SSE
+	quantizeBuffer(static_cast<unsigned char*>(destination), vertex_count, vertex_size, component_size, reinterpret_cast<const unsigned char*>(data), data_stride, components, N, quantizeUnormSimd);
+#else
+	quantizeBuffer(static_cast<unsigned char*>(destination), vertex_count, vertex_size, component_size, reinterpret_cast<const unsigned char*>(data), data_stride, components, N, quantizeUnorm);
+#endif
+}
+
+void meshopt_quantizeSnormBuffer(void* destination, size_t vertex_count, size_t vertex_size, size_t component_size, const float* data, size_t data_stride, size_t components, int N)
+{
+	using namespace meshopt;
+
+	assert(component_size == 1 || component_size == 2);
+	assert(components >= 1 && components <= 4);
+	assert(components * component_size <= vertex_size);
+	assert(data_stride >= components * sizeof(float) && data_stride % sizeof(float) == 0);
+	assert(N >= 1 && N <= int(component_size * 8));
+
+#ifdef SIMD_SSE
+	quantizeBuffer(static_cast<unsigned char*>(destination), vertex_count, vertex_size, component_size, reinterpret_cast<const unsigned char*>(data), data_stride, components, N, quantizeSnormSimd);
+#else
+	quantizeBuffer(static_cast<unsigned char*>(destination), vertex_count, vertex_size, component_size, reinterpret_cast<const unsigned char*>(data), data_stride, components, N, quantizeSnorm);
+#endif
+}
+
+void meshopt_quantizeHalfBuffer(void* destination, size_t vertex_count, size_t vertex_size, const float* data, size_t data_stride, size_t components)
+{
+	using namespace meshopt;
+
+	assert(components >= 1 && components <= 4);
+	assert(components * 2 <= vertex_size);
+	assert(data_stride >= components * sizeof(float) && data_stride % sizeof(float) == 0);
+
+#ifdef SIMD_SSE
+	quantizeBuffer(static_cast<unsigned char*>(destination), vertex_count, vertex_size, 2, reinterpret_cast<const unsigned char*>(data), data_stride, components, 0, quantizeHalfSimd);
+#else
+	quantizeBuffer(static_cast<unsigned char*>(destination), vertex_count, vertex_size, 2, reinterpret_cast<const unsigned char*>(data), data_stride, components, 0, quantizeHalf);
+#endif
+}
+
 #undef SIMD_SSE
 #undef SIMD_NEON
 #undef SIMD_WASM
@@ -56,3 +56,163 @@ meshopt_VertexFetchStatistics meshopt_analyzeVertexFetch(const unsigned int* ind
 
 	return result;
 }
+
+meshopt_VertexFetchStatistics meshopt_analyzeVertexFetchMulti(unsigned int* stream_bytes_fetched, const unsigned int* indices, size_t index_count, size_t vertex_count, const struct meshopt_Stream* streams, size_t stream_count, unsigned int cache_line_size, unsigned int cache_size, unsigned int cache_ways)
+{
+	assert(index_count % 3 == 0);
+	assert(stream_count > 0 && stream_count <= 16);
+	assert(cache_line_size > 0 && (cache_line_size & (cache_line_size - 1)) == 0);
+	assert(cache_ways > 0);
+	assert(cache_size >= cache_line_size * cache_ways);
+
+	for (size_t i = 0; i < stream_count; ++i)
+	{
+		assert(streams[i].size > 0 && streams[i].size <= 256);
+		assert(streams[i].size <= streams[i].stride);
+	}
+
+	meshopt_Allocator allocator;
+
+	meshopt_VertexFetchStatistics result = {};
+
+	// streams with the same stride that start within one vertex of each other point into the same interleaved buffer and share cache lines
+	size_t stream_group[16];
+	size_t group_base[16];
+
+	for (size_t i = 0; i < stream_count; ++i)
+	{
+		size_t data = reinterpret_cast<size_t>(streams[i].data);
+
+		stream_group[i] = i;
+		group_base[i] = data;
+
+		for (size_t j = 0; j < i; ++j)
+		{
+			size_t other = reinterpret_cast<size_t>(streams[j].data);
+
+			if (streams[j].stride == streams[i].stride && (data > other ? data - other : other - data) < streams[i].stride)
+			{
+				size_t group = stream_group[j];
+
+				stream_group[i] = group;
+				group_base[group] = data < group_base[group] ? data : group_base[group];
+				break;
+			}
+		}
+	}
+
+	// buffers are laid out back to back starting from address 0 so that the results don't depend on where the data is allocated
+	size_t group_address[16];
+	size_t buffer_end = 0;
+
+	for (size_t i = 0; i < stream_count; ++i)
+	{
+		if (stream_group[i] != i)
+			continue;
+
+		group_address[i] = (buffer_end + cache_line_size - 1) / cache_line_size * cache_line_size;
+		buffer_end = group_address[i] + (vertex_count + 1) * streams[i].stride;
+	}
+
+	// stream layout is copied into local arrays to keep it in registers in the inner loop
+	size_t stream_address[16];
+	size_t stream_stride[16];
+	size_t stream_size[16];
+	size_t stream_bytes[16] = {};
+
+	for (size_t i = 0; i < stream_count; ++i)
+	{
+		size_t group = stream_group[i];
+
+		stream_address[i] = group_address[group] + (reinterpret_cast<size_t>(streams[i].data) - group_base[group]);
+		stream_stride[i] = streams[i].stride;
+		stream_size[i] = streams[i].size;
+	}
+
+	unsigned char* vertex_visited = allocator.allocate<unsigned char>(vertex_count);
+	memset(vertex_visited, 0, vertex_count);
+
+	// set associative cache with LRU replacement; with a single way this matches the direct mapped model of meshopt_analyzeVertexFetch
+	size_t set_count = cache_size / (cache_line_size * cache_ways);
+
+	// line size and set count are powers of two, so tags and sets are computed with shifts and masks
+	assert((set_count & (set_count - 1)) == 0 && set_count * cache_line_size * cache_ways == cache_size);
+
+	int line_shift = 0;
+	while ((1u << line_shift) < cache_line_size)
+		line_shift++;
+
+	size_t set_mask = set_count - 1;
+
+	// every set keeps its tags ordered from most to least recently used, so the last way is evicted on a miss
+	// we store +1 since cache is filled with 0 by default, and empty lines end up at the end of the set
+	size_t* cache_tags = allocator.allocate<size_t>(set_count * cache_ways);
+	memset(cache_tags, 0, set_count * cache_ways * sizeof(size_t));
+
+	for (size_t i = 0; i < index_count; ++i)
+	{
+		unsigned int index = indices[i];
+		assert(index < vertex_count);
+
+		vertex_visited[index] = 1;
+
+		// every vertex shader invocation fetches all streams
+		for (size_t k = 0; k < stream_count; ++k)
+		{
+			size_t start_address = stream_address[k] + index * stream_stride[k];
+			size_t end_address = start_address + stream_size[k];
+
+			size_t start_tag = start_address >> line_shift;
+			size_t end_tag = (end_address + cache_line_size - 1) >> line_shift;
+
+			assert(start_tag < end_tag);
+
+			for (size_t tag = start_tag; tag < end_tag; ++tag)
+			{
+				size_t* tags = &cache_tags[(tag & set_mask) * cache_ways];
+
+				// most fetches hit the most recently used line of the set
+				if (tags[0] == tag + 1)
+					continue;
+
+				size_t way = 1;
+
+				while (way < cache_ways && tags[way] != tag + 1)
+					way++;
+
+				if (way == cache_ways)
+				{
+					// evict least recently used line
+					way = cache_ways - 1;
+					stream_bytes[k] += cache_line_size;
+				}
+
+				// move the line to the front of the set
+				for (size_t w = way; w > 0; --w)
+					tags[w] = tags[w - 1];
+
+				tags[0] = tag + 1;
+			}
+		}
+	}
+
+	size_t unique_vertex_count = 0;
+
+	for (size_t i = 0; i < vertex_count; ++i)
+		unique_vertex_count += vertex_visited[i];
+
+	size_t vertex_size = 0;
+
+	for (size_t k = 0; k < stream_count; ++k)
+	{
+		vertex_size += streams[k].size;
+		result.bytes_fetched += unsigned(stream_bytes[k]);
+
+		if (stream_bytes_fetched)
+			stream_bytes_fetched[k] = unsigned(stream_bytes[k]);
+	}
+
+	result.overfetch = unique_vertex_count == 0 ? 0 : float(result.bytes_fetched) / float(unique_vertex_count * vertex_size);
+
+	return result;
+}
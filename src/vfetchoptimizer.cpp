@@ -72,3 +72,125 @@ size_t meshopt_optimizeVertexFetch(void* destination, unsigned int* indices, siz
 
 	return next_vertex;
 }
+
+size_t meshopt_optimizeVertexFetchMulti(void* const* destinations, unsigned int* indices, size_t index_count, size_t vertex_count, const struct meshopt_Stream* streams, size_t stream_count)
+{
+	assert(index_count % 3 == 0);
+	assert(stream_count > 0 && stream_count <= 16);
+
+	size_t copy_size = 0;
+
+	for (size_t k = 0; k < stream_count; ++k)
+	{
+		assert(streams[k].size > 0 && streams[k].size <= 256);
+		assert(streams[k].size <= streams[k].stride);
+
+		if (destinations[k] == streams[k].data)
+			copy_size += vertex_count * streams[k].stride;
+	}
+
+	meshopt_Allocator allocator;
+
+	const unsigned char* sources[16];
+
+	// support in-place optimization; all copies share one allocation to keep allocator usage independent of stream count
+	unsigned char* vertices_copy = copy_size ? allocator.allocate<unsigned char>(copy_size) : 0;
+
+	for (size_t k = 0; k < stream_count; ++k)
+	{
+		sources[k] = static_cast<const unsigned char*>(streams[k].data);
+
+		if (destinations[k] == streams[k].data)
+		{
+			memcpy(vertices_copy, sources[k], vertex_count * streams[k].stride);
+			sources[k] = vertices_copy;
+			vertices_copy += vertex_count * streams[k].stride;
+		}
+	}
+
+	// build vertex remap table
+	unsigned int* vertex_remap = allocator.allocate<unsigned int>(vertex_count);
+	memset(vertex_remap, -1, vertex_count * sizeof(unsigned int));
+
+	unsigned int next_vertex = 0;
+
+	for (size_t i = 0; i < index_count; ++i)
+	{
+		unsigned int index = indices[i];
+		assert(index < vertex_count);
+
+		unsigned int& remap = vertex_remap[index];
+
+		if (remap == ~0u) // vertex was not added to destination VB
+		{
+			// add vertex to every stream
+			for (size_t k = 0; k < stream_count; ++k)
+			{
+				size_t size = streams[k].size;
+
+				memcpy(static_cast<unsigned char*>(destinations[k]) + next_vertex * size, sources[k] + index * streams[k].stride, size);
+			}
+
+			remap = next_vertex++;
+		}
+
+		// modify indices in place
+		indices[i] = remap;
+	}
+
+	assert(next_vertex <= vertex_count);
+
+	return next_vertex;
+}
+
+size_t meshopt_optimizeVertexFetchRange(void* vertices, unsigned int* indices, size_t index_count, size_t vertex_size, size_t vertex_offset, size_t vertex_range)
+{
+	assert(index_count % 3 == 0);
+	assert(vertex_size > 0 && vertex_size <= 256);
+
+	meshopt_Allocator allocator;
+
+	unsigned char* block = static_cast<unsigned char*>(vertices) + vertex_offset * vertex_size;
+
+	// only vertices in the range are moved, so the copy and the remap table are proportional to the range size
+	unsigned char* vertices_copy = allocator.allocate<unsigned char>(vertex_range * vertex_size);
+	memcpy(vertices_copy, block, vertex_range * vertex_size);
+
+	unsigned int* vertex_remap = allocator.allocate<unsigned int>(vertex_range);
+	memset(vertex_remap, -1, vertex_range * sizeof(unsigned int));
+
+	unsigned int next_vertex = 0;
+
+	for (size_t i = 0; i < index_count; ++i)
+	{
+		size_t index = size_t(indices[i]) - vertex_offset;
+
+		// vertices outside of the range keep their place
+		if (index >= vertex_range)
+			continue;
+
+		unsigned int& remap = vertex_remap[index];
+
+		if (remap == ~0u) // vertex was not added to destination VB
+		{
+			// add vertex
+			memcpy(block + next_vertex * vertex_size, vertices_copy + index * vertex_size, vertex_size);
+
+			remap = next_vertex++;
+		}
+
+		// modify indices in place
+		indices[i] = unsigned(vertex_offset + remap);
+	}
+
+	size_t result = next_vertex;
+
+	// unreferenced vertices are moved after the referenced ones in their original order
+	for (size_t i = 0; i < vertex_range; ++i)
+		if (vertex_remap[i] == ~0u)
+			memcpy(block + next_vertex++ * vertex_size, vertices_copy + i * vertex_size, vertex_size);
+
+	assert(next_vertex == vertex_range);
+
+	return result;
+}
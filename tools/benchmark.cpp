@@ -0,0 +1,1249 @@
+// This file implements a benchmark suite that times all library entry points on a reproducible corpus of meshes
+// Usage: benchmark [-w warmup] [-r repeat] [-s scale] [-f filter] [-json file] [-csv file] [files.obj]
+#include "../src/meshoptimizer.h"
+
+#include <algorithm>
+#include <string>
+#include <vector>
+
+#include <float.h>
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "../extern/fast_obj.h"
+
+#if !defined(__EMSCRIPTEN__) && !defined(_WIN32)
+#include <pthread.h>
+#include <unistd.h>
+#endif
+
+#ifdef __EMSCRIPTEN__
+#include <emscripten.h>
+
+double timestamp()
+{
+	return emscripten_get_now() * 1e-3;
+}
+#elif defined(_WIN32)
+struct LARGE_INTEGER
+{
+	__int64 QuadPart;
+};
+extern "C" __declspec(dllimport) int __stdcall QueryPerformanceCounter(LARGE_INTEGER* lpPerformanceCount);
+extern "C" __declspec(dllimport) int __stdcall QueryPerformanceFrequency(LARGE_INTEGER* lpFrequency);
+
+double timestamp()
+{
+	LARGE_INTEGER freq, counter;
+	QueryPerformanceFrequency(&freq);
+	QueryPerformanceCounter(&counter);
+	return double(counter.QuadPart) / double(freq.QuadPart);
+}
+#else
+double timestamp()
+{
+	timespec ts;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return double(ts.tv_sec) + 1e-9 * double(ts.tv_nsec);
+}
+#endif
+
+struct SchedulerWork
+{
+	void (*task)(void* task_data, size_t task_index);
+	void* task_data;
+	size_t task_count;
+
+	size_t next;
+};
+
+static void* runSchedulerWork(void* work_)
+{
+	SchedulerWork& work = *static_cast<SchedulerWork*>(work_);
+
+	for (;;)
+	{
+#if !defined(__EMSCRIPTEN__) && !defined(_WIN32)
+		size_t i = __sync_fetch_and_add(&work.next, 1);
+#else
+		size_t i = work.next++;
+#endif
+
+		if (i >= work.task_count)
+			break;
+
+		work.task(work.task_data, i);
+	}
+
+	return NULL;
+}
+
+static unsigned int getThreadCount()
+{
+#if !defined(__EMSCRIPTEN__) && !defined(_WIN32)
+	long count = sysconf(_SC_NPROCESSORS_ONLN);
+	return count > 1 ? unsigned(count) : 1;
+#else
+	return 1;
+#endif
+}
+
+// runs tasks on getThreadCount() threads, including the calling thread; threads are created for every call, which is negligible for the workloads we time
+static void threadScheduler(void* context, void (*task)(void* task_data, size_t task_index), void* task_data, size_t task_count)
+{
+	unsigned int thread_count = *static_cast<unsigned int*>(context);
+
+	SchedulerWork work = {task, task_data, task_count, 0};
+
+#if !defined(__EMSCRIPTEN__) && !defined(_WIN32)
+	pthread_t threads[64];
+	unsigned int extra_threads = thread_count - 1 < 64 ? thread_count - 1 : 64;
+
+	for (unsigned int i = 0; i < extra_threads; ++i)
+		pthread_create(&threads[i], NULL, runSchedulerWork, &work);
+
+	runSchedulerWork(&work);
+
+	for (unsigned int i = 0; i < extra_threads; ++i)
+		pthread_join(threads[i], NULL);
+#else
+	(void)thread_count;
+	runSchedulerWork(&work);
+#endif
+}
+
+struct Vertex
+{
+	float px, py, pz;
+	float nx, ny, nz;
+	float tx, ty;
+};
+
+struct PackedVertex
+{
+	unsigned short px, py, pz, pw;
+	signed char nx, ny, nz, nw;
+	unsigned short tx, ty;
+};
+
+struct Mesh
+{
+	std::string name;
+
+	std::vector<Vertex> vertices;
+	std::vector<unsigned int> indices;
+};
+
+struct Options
+{
+	int warmup;
+	int repeat;
+	float scale;
+	const char* filter;
+	const char* json;
+	const char* csv;
+};
+
+struct Result
+{
+	std::string mesh;
+	std::string name;
+
+	double triangles; // 0 if throughput in triangles doesn't make sense for the function
+	double bytes;     // 0 if throughput in bytes doesn't make sense for the function
+
+	std::vector<double> samples; // sorted
+};
+
+struct Context
+{
+	Options options;
+	const Mesh* mesh;
+
+	std::vector<Result> results;
+	int errors;
+};
+
+static double getPercentile(const std::vector<double>& samples, double p)
+{
+	// nearest-rank percentile; samples are sorted
+	size_t rank = size_t(ceil(p * double(samples.size())));
+	return samples[rank == 0 ? 0 : (rank > samples.size() ? samples.size() - 1 : rank - 1)];
+}
+
+static double getMean(const std::vector<double>& samples)
+{
+	double sum = 0;
+
+	for (size_t i = 0; i < samples.size(); ++i)
+		sum += samples[i];
+
+	return sum / double(samples.size());
+}
+
+static void printResult(const Result& result)
+{
+	double median = getPercentile(result.samples, 0.5);
+
+	printf("%-10s %-32s min %9.3f ms, p50 %9.3f ms, p90 %9.3f ms",
+	    result.mesh.c_str(), result.name.c_str(),
+	    result.samples[0] * 1000, median * 1000, getPercentile(result.samples, 0.9) * 1000);
+
+	if (result.triangles > 0)
+		printf(", %8.2f Mtri/sec", result.triangles / 1e6 / median);
+
+	if (result.bytes > 0)
+		printf(", %6.2f GB/sec", result.bytes / (1024 * 1024 * 1024) / median);
+
+	printf("\n");
+}
+
+// Runs the loop body warmup + repeat times and records the timing of the last repeat iterations:
+// for (Bench bench(context, "name", triangles, bytes); bench.next();) function();
+struct Bench
+{
+	Context& context;
+	Result result;
+
+	bool enabled;
+	int iteration;
+	double start;
+
+	Bench(Context& context_, const char* name, double triangles, double bytes)
+	    : context(context_)
+	    , iteration(0)
+	    , start(0)
+	{
+		result.mesh = context.mesh ? context.mesh->name : "-";
+		result.name = name;
+		result.triangles = triangles;
+		result.bytes = bytes;
+
+		enabled = !context.options.filter || strstr(name, context.options.filter) != NULL;
+	}
+
+	bool next()
+	{
+		double end = timestamp();
+
+		if (!enabled)
+			return false;
+
+		if (iteration > context.options.warmup)
+			result.samples.push_back(end - start);
+
+		if (iteration == context.options.warmup + context.options.repeat)
+		{
+			std::sort(result.samples.begin(), result.samples.end());
+
+			printResult(result);
+			context.results.push_back(result);
+
+			return false;
+		}
+
+		iteration++;
+		start = timestamp();
+
+		return true;
+	}
+};
+
+static void check(Context& context, bool condition, const char* name)
+{
+	if (!condition)
+	{
+		fprintf(stderr, "Error: %s failed on %s\n", name, context.mesh ? context.mesh->name.c_str() : "-");
+		context.errors++;
+	}
+}
+
+static unsigned int murmur3(unsigned int h)
+{
+	h ^= h >> 16;
+	h *= 0x85ebca6bu;
+	h ^= h >> 13;
+	h *= 0xc2b2ae35u;
+	h ^= h >> 16;
+
+	return h;
+}
+
+static Mesh generateGrid(const char* name, unsigned int N)
+{
+	Mesh result;
+	result.name = name;
+
+	result.vertices.resize((N + 1) * (N + 1));
+
+	for (unsigned int y = 0; y <= N; ++y)
+		for (unsigned int x = 0; x <= N; ++x)
+		{
+			float u = float(x) / float(N), v = float(y) / float(N);
+
+			// low-amplitude waves to make the surface non-planar for simplification and overdraw
+			float h = 0.02f * sinf(u * 31.f) * cosf(v * 17.f);
+			float dhu = 0.02f * 31.f * cosf(u * 31.f) * cosf(v * 17.f);
+			float dhv = -0.02f * 17.f * sinf(u * 31.f) * sinf(v * 17.f);
+			float nl = sqrtf(dhu * dhu + dhv * dhv + 1.f);
+
+			Vertex vertex = {u, v, h, -dhu / nl, -dhv / nl, 1.f / nl, u, v};
+			result.vertices[y * (N + 1) + x] = vertex;
+		}
+
+	result.indices.reserve(N * N * 6);
+
+	for (unsigned int y = 0; y < N; ++y)
+		for (unsigned int x = 0; x < N; ++x)
+		{
+			unsigned int i0 = y * (N + 1) + x;
+			unsigned int i1 = i0 + 1;
+			unsigned int i2 = i0 + N + 1;
+			unsigned int i3 = i2 + 1;
+
+			result.indices.push_back(i0);
+			result.indices.push_back(i1);
+			result.indices.push_back(i2);
+
+			result.indices.push_back(i2);
+			result.indices.push_back(i1);
+			result.indices.push_back(i3);
+		}
+
+	return result;
+}
+
+static Mesh generateSphere(const char* name, unsigned int U, unsigned int V, float noise)
+{
+	Mesh result;
+	result.name = name;
+
+	const float kPi = 3.14159265f;
+
+	// seam column is duplicated to get continuous texture coordinates
+	result.vertices.resize((U + 1) * (V + 1));
+
+	for (unsigned int y = 0; y <= V; ++y)
+		for (unsigned int x = 0; x <= U; ++x)
+		{
+			float theta = float(y) / float(V) * kPi;
+			float phi = float(x) / float(U) * 2 * kPi;
+
+			float nx = sinf(theta) * cosf(phi), ny = sinf(theta) * sinf(phi), nz = cosf(theta);
+
+			// noise is a function of the position on the sphere so that seam vertices stay welded
+			float r = 1.f + noise * (sinf(nx * 5.f) * sinf(ny * 7.f) * sinf(nz * 3.f) + 0.2f * sinf(nx * 41.f + ny * 37.f + nz * 43.f));
+
+			Vertex vertex = {nx * r, ny * r, nz * r, nx, ny, nz, float(x) / float(U), float(y) / float(V)};
+			result.vertices[y * (U + 1) + x] = vertex;
+		}
+
+	result.indices.reserve(U * V * 6);
+
+	for (unsigned int y = 0; y < V; ++y)
+		for (unsigned int x = 0; x < U; ++x)
+		{
+			unsigned int i0 = y * (U + 1) + x;
+			unsigned int i1 = i0 + 1;
+			unsigned int i2 = i0 + U + 1;
+			unsigned int i3 = i2 + 1;
+
+			// skip triangles that are degenerate at the poles
+			if (y != 0)
+			{
+				result.indices.push_back(i0);
+				result.indices.push_back(i2);
+				result.indices.push_back(i1);
+			}
+
+			if (y != V - 1)
+			{
+				result.indices.push_back(i1);
+				result.indices.push_back(i2);
+				result.indices.push_back(i3);
+			}
+		}
+
+	return result;
+}
+
+static void shuffleMesh(Mesh& mesh)
+{
+	// scanned and reconstructed meshes often come with no vertex or triangle locality; we emulate that with a deterministic shuffle
+	size_t vertex_count = mesh.vertices.size();
+	size_t triangle_count = mesh.indices.size() / 3;
+
+	std::vector<unsigned int> remap(vertex_count);
+
+	for (size_t i = 0; i < vertex_count; ++i)
+		remap[i] = unsigned(i);
+
+	for (size_t i = vertex_count; i > 1; --i)
+		std::swap(remap[i - 1], remap[murmur3(unsigned(i)) % i]);
+
+	std::vector<Vertex> vertices(vertex_count);
+
+	for (size_t i = 0; i < vertex_count; ++i)
+		vertices[remap[i]] = mesh.vertices[i];
+
+	mesh.vertices.swap(vertices);
+
+	for (size_t i = 0; i < mesh.indices.size(); ++i)
+		mesh.indices[i] = remap[mesh.indices[i]];
+
+	for (size_t i = triangle_count; i > 1; --i)
+	{
+		size_t j = murmur3(unsigned(i) ^ 0x9e3779b9u) % i;
+
+		for (int k = 0; k < 3; ++k)
+			std::swap(mesh.indices[(i - 1) * 3 + k], mesh.indices[j * 3 + k]);
+	}
+}
+
+static bool loadObj(Mesh& result, const char* path)
+{
+	fastObjMesh* obj = fast_obj_read(path);
+	if (!obj)
+		return false;
+
+	size_t total_indices = 0;
+
+	for (unsigned int i = 0; i < obj->face_count; ++i)
+		total_indices += 3 * (obj->face_vertices[i] - 2);
+
+	std::vector<Vertex> vertices(total_indices);
+
+	size_t vertex_offset = 0;
+	size_t index_offset = 0;
+
+	for (unsigned int i = 0; i < obj->face_count; ++i)
+	{
+		for (unsigned int j = 0; j < obj->face_vertices[i]; ++j)
+		{
+			fastObjIndex gi = obj->indices[index_offset + j];
+
+			// note: fast_obj stores a default zero entry at index 0 so missing attributes are safe to read
+			Vertex v =
+			    {
+			        obj->positions[gi.p * 3 + 0],
+			        obj->positions[gi.p * 3 + 1],
+			        obj->positions[gi.p * 3 + 2],
+			        obj->normals[gi.n * 3 + 0],
+			        obj->normals[gi.n * 3 + 1],
+			        obj->normals[gi.n * 3 + 2],
+			        obj->texcoords[gi.t * 2 + 0],
+			        obj->texcoords[gi.t * 2 + 1],
+			    };
+
+			// triangulate polygon on the fly; offset-3 is always the first polygon vertex
+			if (j >= 3)
+			{
+				vertices[vertex_offset + 0] = vertices[vertex_offset - 3];
+				vertices[vertex_offset + 1] = vertices[vertex_offset - 1];
+				vertex_offset += 2;
+			}
+
+			vertices[vertex_offset] = v;
+			vertex_offset++;
+		}
+
+		index_offset += obj->face_vertices[i];
+	}
+
+	fast_obj_destroy(obj);
+
+	if (total_indices == 0)
+		return false;
+
+	std::vector<unsigned int> remap(total_indices);
+	size_t total_vertices = meshopt_generateVertexRemap(&remap[0], NULL, total_indices, &vertices[0], total_indices, sizeof(Vertex));
+
+	result.indices.resize(total_indices);
+	meshopt_remapIndexBuffer(&result.indices[0], NULL, total_indices, &remap[0]);
+
+	result.vertices.resize(total_vertices);
+	meshopt_remapVertexBuffer(&result.vertices[0], &vertices[0], total_indices, sizeof(Vertex), &remap[0]);
+
+	// use file name without the directory as a mesh name
+	const char* slash = strrchr(path, '/');
+	const char* backslash = strrchr(path, '\\');
+	const char* name = slash > backslash ? slash + 1 : backslash ? backslash + 1 : path;
+
+	result.name = name;
+
+	return true;
+}
+
+static void packVertices(std::vector<PackedVertex>& result, const std::vector<Vertex>& vertices)
+{
+	float minv[3] = {+1e30f, +1e30f, +1e30f};
+	float maxv[3] = {-1e30f, -1e30f, -1e30f};
+
+	for (size_t i = 0; i < vertices.size(); ++i)
+	{
+		const float* p = &vertices[i].px;
+
+		for (int k = 0; k < 3; ++k)
+		{
+			minv[k] = std::min(minv[k], p[k]);
+			maxv[k] = std::max(maxv[k], p[k]);
+		}
+	}
+
+	float extent = std::max(maxv[0] - minv[0], std::max(maxv[1] - minv[1], maxv[2] - minv[2]));
+	float scale = extent == 0 ? 0.f : 1.f / extent;
+
+	result.resize(vertices.size());
+
+	for (size_t i = 0; i < vertices.size(); ++i)
+	{
+		const Vertex& v = vertices[i];
+		PackedVertex& pv = result[i];
+
+		pv.px = (unsigned short)meshopt_quantizeUnorm((v.px - minv[0]) * scale, 16);
+		pv.py = (unsigned short)meshopt_quantizeUnorm((v.py - minv[1]) * scale, 16);
+		pv.pz = (unsigned short)meshopt_quantizeUnorm((v.pz - minv[2]) * scale, 16);
+		pv.pw = 0;
+
+		pv.nx = (signed char)meshopt_quantizeSnorm(v.nx, 8);
+		pv.ny = (signed char)meshopt_quantizeSnorm(v.ny, 8);
+		pv.nz = (signed char)meshopt_quantizeSnorm(v.nz, 8);
+		pv.nw = 0;
+
+		pv.tx = meshopt_quantizeHalf(v.tx);
+		pv.ty = meshopt_quantizeHalf(v.ty);
+	}
+}
+
+static void benchIndexing(Context& context, const Mesh& mesh)
+{
+	size_t index_count = mesh.indices.size();
+	size_t vertex_count = mesh.vertices.size();
+	double triangles = double(index_count / 3);
+
+	// remap generation takes unindexed data as an input, similarly to mesh loading
+	std::vector<Vertex> corners;
+	corners.reserve(index_count);
+
+	for (size_t i = 0; i < index_count; ++i)
+		corners.push_back(mesh.vertices[mesh.indices[i]]);
+
+	std::vector<unsigned int> remap(index_count);
+	std::vector<unsigned int> indices(index_count);
+	std::vector<Vertex> vertices(index_count);
+
+	size_t unique = 0;
+
+	for (Bench bench(context, "generateVertexRemap", triangles, double(index_count * sizeof(Vertex))); bench.next();)
+		unique = meshopt_generateVertexRemap(&remap[0], NULL, index_count, &corners[0], index_count, sizeof(Vertex));
+
+	for (Bench bench(context, "generateVertexRemapParallel", triangles, double(index_count * sizeof(Vertex))); bench.next();)
+		unique = meshopt_generateVertexRemapParallel(&remap[0], NULL, index_count, &corners[0], index_count, sizeof(Vertex), NULL, NULL);
+
+	meshopt_generateVertexRemap(&remap[0], NULL, index_count, &corners[0], index_count, sizeof(Vertex));
+
+	for (Bench bench(context, "remapIndexBuffer", triangles, double(index_count * 4)); bench.next();)
+		meshopt_remapIndexBuffer(&indices[0], NULL, index_count, &remap[0]);
+
+	for (Bench bench(context, "remapVertexBuffer", triangles, double(index_count * sizeof(Vertex))); bench.next();)
+		meshopt_remapVertexBuffer(&vertices[0], &corners[0], index_count, sizeof(Vertex), &remap[0]);
+
+	for (Bench bench(context, "generateShadowIndexBuffer", triangles, double(vertex_count * sizeof(float) * 3)); bench.next();)
+		meshopt_generateShadowIndexBuffer(&indices[0], &mesh.indices[0], index_count, &mesh.vertices[0], vertex_count, sizeof(float) * 3, sizeof(Vertex));
+
+	for (Bench bench(context, "generateVertexRemapShadow", triangles, double(vertex_count * sizeof(Vertex))); bench.next();)
+		unique = meshopt_generateVertexRemapShadow(&remap[0], &indices[0], &mesh.indices[0], index_count, &mesh.vertices[0], vertex_count, sizeof(Vertex), sizeof(float) * 3, NULL, NULL);
+
+	(void)unique;
+}
+
+static void benchVertexCache(Context& context, const Mesh& mesh, const std::vector<unsigned int>& cache)
+{
+	size_t index_count = mesh.indices.size();
+	size_t vertex_count = mesh.vertices.size();
+	double triangles = double(index_count / 3);
+
+	std::vector<unsigned int> indices(index_count);
+
+	for (Bench bench(context, "optimizeVertexCache", triangles, 0); bench.next();)
+		meshopt_optimizeVertexCache(&indices[0], &mesh.indices[0], index_count, vertex_count);
+
+	for (Bench bench(context, "optimizeVertexCacheStrip", triangles, 0); bench.next();)
+		meshopt_optimizeVertexCacheStrip(&indices[0], &mesh.indices[0], index_count, vertex_count);
+
+	for (Bench bench(context, "optimizeVertexCacheFifo", triangles, 0); bench.next();)
+		meshopt_optimizeVertexCacheFifo(&indices[0], &mesh.indices[0], index_count, vertex_count, 16);
+
+	for (Bench bench(context, "optimizeVertexCacheProfile", triangles, 0); bench.next();)
+		meshopt_optimizeVertexCacheProfile(&indices[0], &mesh.indices[0], index_count, vertex_count, meshopt_VertexCacheIntel);
+
+	// partitioned optimization expects spatially coherent input
+	std::vector<unsigned int> sorted(index_count);
+	meshopt_spatialSortTriangles(&sorted[0], &mesh.indices[0], index_count, &mesh.vertices[0].px, vertex_count, sizeof(Vertex));
+
+	for (Bench bench(context, "optimizeVertexCachePartitioned", triangles, 0); bench.next();)
+		meshopt_optimizeVertexCachePartitioned(&indices[0], &sorted[0], index_count, vertex_count, 8, NULL, NULL);
+
+	// incremental optimization of a small edit in the middle of an optimized mesh; the cost should be proportional to the range size
+	size_t range_offset = index_count / 3 / 2 * 3;
+	size_t range_count = (index_count / 3 / 100 + 1) * 3;
+	range_count = range_offset + range_count > index_count ? index_count - range_offset : range_count;
+
+	indices = cache;
+
+	for (Bench bench(context, "optimizeVertexCacheRange", double(range_count / 3), 0); bench.next();)
+	{
+		memcpy(&indices[range_offset], &mesh.indices[range_offset], range_count * sizeof(unsigned int));
+		meshopt_optimizeVertexCacheRange(&indices[0], index_count, vertex_count, range_offset, range_count);
+	}
+
+	unsigned int transformed = 0;
+
+	for (Bench bench(context, "analyzeVertexCache", triangles, 0); bench.next();)
+		transformed += meshopt_analyzeVertexCache(&cache[0], index_count, vertex_count, 16, 0, 0).vertices_transformed;
+
+	for (Bench bench(context, "analyzeVertexCacheProfile", triangles, 0); bench.next();)
+		transformed += meshopt_analyzeVertexCacheProfile(&cache[0], index_count, vertex_count, meshopt_VertexCacheNvidia).vertices_transformed;
+
+	(void)transformed;
+}
+
+static void benchOverdraw(Context& context, const Mesh& mesh, const std::vector<unsigned int>& cache)
+{
+	size_t index_count = mesh.indices.size();
+	size_t vertex_count = mesh.vertices.size();
+	double triangles = double(index_count / 3);
+
+	std::vector<unsigned int> indices(index_count);
+
+	for (Bench bench(context, "optimizeOverdraw", triangles, 0); bench.next();)
+		meshopt_optimizeOverdraw(&indices[0], &cache[0], index_count, &mesh.vertices[0].px, vertex_count, sizeof(Vertex), 1.05f);
+
+	for (Bench bench(context, "optimizeOverdrawParallel", triangles, 0); bench.next();)
+		meshopt_optimizeOverdrawParallel(&indices[0], &cache[0], index_count, &mesh.vertices[0].px, vertex_count, sizeof(Vertex), 1.05f, NULL, NULL);
+
+	unsigned int shaded = 0;
+
+	for (Bench bench(context, "analyzeOverdraw", triangles, 0); bench.next();)
+		shaded += meshopt_analyzeOverdraw(&cache[0], index_count, &mesh.vertices[0].px, vertex_count, sizeof(Vertex)).pixels_shaded;
+
+	for (Bench bench(context, "analyzeOverdrawParallel", triangles, 0); bench.next();)
+		shaded += meshopt_analyzeOverdrawParallel(&cache[0], index_count, &mesh.vertices[0].px, vertex_count, sizeof(Vertex), 256, 3, NULL, NULL).pixels_shaded;
+
+	(void)shaded;
+}
+
+static void benchVertexFetch(Context& context, const Mesh& mesh, const std::vector<unsigned int>& cache)
+{
+	size_t index_count = mesh.indices.size();
+	size_t vertex_count = mesh.vertices.size();
+	double triangles = double(index_count / 3);
+
+	std::vector<unsigned int> indices(index_count);
+	std::vector<unsigned int> remap(vertex_count);
+	std::vector<Vertex> vertices(vertex_count);
+
+	// optimizeVertexFetch modifies indices in place so we need to restore them on every iteration; the copy is negligible compared to the optimization
+	for (Bench bench(context, "optimizeVertexFetch", triangles, double(vertex_count * sizeof(Vertex))); bench.next();)
+	{
+		indices = cache;
+		meshopt_optimizeVertexFetch(&vertices[0], &indices[0], index_count, &mesh.vertices[0], vertex_count, sizeof(Vertex));
+	}
+
+	for (Bench bench(context, "optimizeVertexFetchRemap", triangles, 0); bench.next();)
+		meshopt_optimizeVertexFetchRemap(&remap[0], &cache[0], index_count, vertex_count);
+
+	// deinterleaved output with position and normal+uv streams read from the interleaved source
+	std::vector<float> positions(vertex_count * 3);
+	std::vector<float> attributes(vertex_count * 5);
+
+	meshopt_Stream streams[] = {{&mesh.vertices[0].px, sizeof(float) * 3, sizeof(Vertex)}, {&mesh.vertices[0].nx, sizeof(float) * 5, sizeof(Vertex)}};
+	void* destinations[] = {&positions[0], &attributes[0]};
+
+	for (Bench bench(context, "optimizeVertexFetchMulti", triangles, double(vertex_count * sizeof(Vertex))); bench.next();)
+	{
+		indices = cache;
+		meshopt_optimizeVertexFetchMulti(destinations, &indices[0], index_count, vertex_count, streams, 2);
+	}
+
+	meshopt_optimizeVertexFetchRemap(&remap[0], &cache[0], index_count, vertex_count);
+
+	for (Bench bench(context, "remapVertexBufferMulti", triangles, double(vertex_count * sizeof(Vertex))); bench.next();)
+		meshopt_remapVertexBufferMulti(destinations, vertex_count, streams, 2, &remap[0]);
+
+	unsigned int fetched = 0;
+
+	for (Bench bench(context, "analyzeVertexFetch", triangles, 0); bench.next();)
+		fetched += meshopt_analyzeVertexFetch(&cache[0], index_count, vertex_count, sizeof(Vertex)).bytes_fetched;
+
+	for (Bench bench(context, "analyzeVertexFetchMulti", triangles, 0); bench.next();)
+		fetched += meshopt_analyzeVertexFetchMulti(NULL, &cache[0], index_count, vertex_count, streams, 2, 64, 16 * 1024, 4).bytes_fetched;
+
+	(void)fetched;
+}
+
+static void benchSimplify(Context& context, const Mesh& mesh)
+{
+	size_t index_count = mesh.indices.size();
+	size_t vertex_count = mesh.vertices.size();
+	double triangles = double(index_count / 3);
+
+	size_t target_index_count = size_t(index_count * 0.25f) / 3 * 3;
+	const float target_error = 1e-2f;
+
+	std::vector<unsigned int> indices(index_count);
+
+	size_t result = 0;
+
+	for (Bench bench(context, "simplify", triangles, 0); bench.next();)
+		result += meshopt_simplify(&indices[0], &mesh.indices[0], index_count, &mesh.vertices[0].px, vertex_count, sizeof(Vertex), target_index_count, target_error);
+
+	const float attribute_weights[3] = {0.5f, 0.5f, 0.5f};
+
+	for (Bench bench(context, "simplifyWithAttributes", triangles, 0); bench.next();)
+		result += meshopt_simplifyWithAttributes(&indices[0], &mesh.indices[0], index_count, &mesh.vertices[0].px, vertex_count, sizeof(Vertex), &mesh.vertices[0].nx, sizeof(Vertex), attribute_weights, 3, target_index_count, target_error);
+
+	// LOD chain with 3 levels, including simplifier setup
+	for (Bench bench(context, "simplifyNext", triangles, 0); bench.next();)
+	{
+		meshopt_Simplifier* simplifier = meshopt_createSimplifier(&mesh.indices[0], index_count, &mesh.vertices[0].px, vertex_count, sizeof(Vertex));
+
+		result += meshopt_simplifyNext(simplifier, &indices[0], index_count / 2 / 3 * 3, target_error);
+		result += meshopt_simplifyNext(simplifier, &indices[0], index_count / 4 / 3 * 3, target_error);
+		result += meshopt_simplifyNext(simplifier, &indices[0], index_count / 8 / 3 * 3, target_error);
+
+		meshopt_destroySimplifier(simplifier);
+	}
+
+	for (Bench bench(context, "simplifyPartitioned", triangles, 0); bench.next();)
+		result += meshopt_simplifyPartitioned(&indices[0], &mesh.indices[0], index_count, &mesh.vertices[0].px, vertex_count, sizeof(Vertex), target_index_count, target_error, 8, NULL, NULL);
+
+	for (Bench bench(context, "simplifySloppy", triangles, 0); bench.next();)
+		result += meshopt_simplifySloppy(&indices[0], &mesh.indices[0], index_count, &mesh.vertices[0].px, vertex_count, sizeof(Vertex), target_index_count, FLT_MAX, NULL);
+
+	for (Bench bench(context, "simplifySloppyError", triangles, 0); bench.next();)
+		result += meshopt_simplifySloppy(&indices[0], &mesh.indices[0], index_count, &mesh.vertices[0].px, vertex_count, sizeof(Vertex), 0, target_error, NULL);
+
+	std::vector<unsigned int> points(vertex_count);
+
+	for (Bench bench(context, "simplifyPoints", triangles, 0); bench.next();)
+		result += meshopt_simplifyPoints(&points[0], &mesh.vertices[0].px, vertex_count, sizeof(Vertex), vertex_count / 4);
+
+	float box_min[3] = {+1e30f, +1e30f, +1e30f};
+	float box_max[3] = {-1e30f, -1e30f, -1e30f};
+
+	for (size_t i = 0; i < vertex_count; ++i)
+	{
+		const float* p = &mesh.vertices[i].px;
+
+		for (int k = 0; k < 3; ++k)
+		{
+			box_min[k] = std::min(box_min[k], p[k]);
+			box_max[k] = std::max(box_max[k], p[k]);
+		}
+	}
+
+	std::vector<float> stream_vertices(vertex_count * 3);
+	int stream_error = 0;
+
+	for (Bench bench(context, "sloppyStream", triangles, 0); bench.next();)
+	{
+		meshopt_SloppyStream* stream = meshopt_createSloppyStream(box_min, box_max, 256, vertex_count, index_count / 3);
+
+		stream_error |= meshopt_sloppyStreamAddTriangles(stream, &mesh.indices[0], index_count, &mesh.vertices[0].px, vertex_count, sizeof(Vertex));
+
+		result += meshopt_sloppyStreamGetVertices(stream, &stream_vertices[0]);
+		result += meshopt_sloppyStreamGetIndices(stream, &indices[0]);
+
+		meshopt_destroySloppyStream(stream);
+	}
+
+	check(context, stream_error == 0, "sloppyStream");
+
+	(void)result;
+}
+
+static void benchMeshlets(Context& context, const Mesh& mesh)
+{
+	size_t index_count = mesh.indices.size();
+	size_t vertex_count = mesh.vertices.size();
+	double triangles = double(index_count / 3);
+
+	const size_t max_vertices = 64;
+	const size_t max_triangles = 124;
+	const float cone_weight = 0.25f;
+
+	size_t max_meshlets = meshopt_buildMeshletsBound(index_count, max_vertices, max_triangles);
+
+	std::vector<meshopt_Meshlet> meshlets(max_meshlets);
+	size_t meshlet_count = 0;
+
+	for (Bench bench(context, "buildMeshlets", triangles, 0); bench.next();)
+		meshlet_count = meshopt_buildMeshlets(&meshlets[0], &mesh.indices[0], index_count, vertex_count, max_vertices, max_triangles);
+
+	for (Bench bench(context, "buildMeshletsSpatial", triangles, 0); bench.next();)
+		meshlet_count = meshopt_buildMeshletsSpatial(&meshlets[0], &mesh.indices[0], index_count, &mesh.vertices[0].px, vertex_count, sizeof(Vertex), max_vertices, max_triangles, cone_weight);
+
+	// benchmarks can be skipped by the filter, so inputs for the following benchmarks are computed separately
+	meshlet_count = meshopt_buildMeshletsSpatial(&meshlets[0], &mesh.indices[0], index_count, &mesh.vertices[0].px, vertex_count, sizeof(Vertex), max_vertices, max_triangles, cone_weight);
+
+	std::vector<meshopt_Bounds> bounds(max_meshlets);
+
+	for (Bench bench(context, "computeMeshletBounds", triangles, 0); bench.next();)
+		for (size_t i = 0; i < meshlet_count; ++i)
+			bounds[i] = meshopt_computeMeshletBounds(&meshlets[i], &mesh.vertices[0].px, vertex_count, sizeof(Vertex));
+
+	std::vector<meshopt_PackedMeshlet> packed(max_meshlets);
+	std::vector<unsigned int> meshlet_vertices(max_meshlets * max_vertices);
+	std::vector<unsigned char> meshlet_triangles(max_meshlets * ((max_triangles * 3 + 3) & ~3));
+
+	size_t packed_count = 0;
+
+	for (Bench bench(context, "buildMeshletsPacked", triangles, 0); bench.next();)
+		packed_count = meshopt_buildMeshletsPacked(&packed[0], &meshlet_vertices[0], &meshlet_triangles[0], &mesh.indices[0], index_count, &mesh.vertices[0].px, vertex_count, sizeof(Vertex), max_vertices, max_triangles, cone_weight);
+
+	packed_count = meshopt_buildMeshletsPacked(&packed[0], &meshlet_vertices[0], &meshlet_triangles[0], &mesh.indices[0], index_count, &mesh.vertices[0].px, vertex_count, sizeof(Vertex), max_vertices, max_triangles, cone_weight);
+
+	for (Bench bench(context, "computeMeshletBoundsPacked", triangles, 0); bench.next();)
+		meshopt_computeMeshletBoundsPacked(&bounds[0], &packed[0], packed_count, &meshlet_vertices[0], &meshlet_triangles[0], &mesh.vertices[0].px, vertex_count, sizeof(Vertex), NULL, NULL);
+
+	// 16-bit precision relative to the mesh extent
+	float extent = 0;
+
+	for (size_t i = 0; i < vertex_count; ++i)
+		for (int k = 0; k < 3; ++k)
+			extent = std::max(extent, fabsf((&mesh.vertices[i].px)[k]));
+
+	float grid_step = extent > 0 ? extent / 32768.f : 1.f;
+
+	std::vector<meshopt_EncodedMeshlet> encoded(packed_count);
+	std::vector<unsigned int> encoded_data(meshopt_encodeMeshletsBound(packed_count, max_vertices, max_triangles));
+	size_t encoded_size = 0;
+
+	for (Bench bench(context, "encodeMeshlets", triangles, 0); bench.next();)
+		encoded_size = meshopt_encodeMeshlets(&encoded[0], &encoded_data[0], encoded_data.size(), &packed[0], packed_count, &meshlet_vertices[0], &meshlet_triangles[0], &mesh.vertices[0].px, vertex_count, sizeof(Vertex), grid_step);
+
+	encoded_size = meshopt_encodeMeshlets(&encoded[0], &encoded_data[0], encoded_data.size(), &packed[0], packed_count, &meshlet_vertices[0], &meshlet_triangles[0], &mesh.vertices[0].px, vertex_count, sizeof(Vertex), grid_step);
+
+	check(context, encoded_size > 0, "encodeMeshlets");
+
+	std::vector<float> decoded_positions(255 * 3);
+	std::vector<unsigned char> decoded_triangles(512 * 3);
+
+	for (Bench bench(context, "decodeMeshlet", triangles, double(encoded_size * 4)); bench.next();)
+		for (size_t i = 0; i < packed_count; ++i)
+			meshopt_decodeMeshlet(&decoded_positions[0], &decoded_triangles[0], &encoded[i], &encoded_data[0]);
+
+	size_t max_lod_clusters = meshopt_buildClusterLodBound(index_count, max_vertices, max_triangles, 4);
+
+	std::vector<meshopt_LodCluster> lod_clusters(max_lod_clusters);
+	std::vector<unsigned int> lod_vertices(max_lod_clusters * max_vertices);
+	std::vector<unsigned char> lod_triangles(max_lod_clusters * ((max_triangles * 3 + 3) & ~3));
+	std::vector<unsigned int> lod_children(max_lod_clusters);
+
+	for (Bench bench(context, "buildClusterLod", triangles, 0); bench.next();)
+		meshopt_buildClusterLod(&lod_clusters[0], &lod_vertices[0], &lod_triangles[0], &lod_children[0], &mesh.indices[0], index_count, &mesh.vertices[0].px, vertex_count, sizeof(Vertex), max_vertices, max_triangles, 4);
+}
+
+static void benchSpatial(Context& context, const Mesh& mesh)
+{
+	size_t index_count = mesh.indices.size();
+	size_t vertex_count = mesh.vertices.size();
+	double triangles = double(index_count / 3);
+
+	std::vector<unsigned int> remap(vertex_count);
+	std::vector<unsigned int> indices(index_count);
+
+	for (Bench bench(context, "spatialSortRemap", triangles, 0); bench.next();)
+		meshopt_spatialSortRemap(&remap[0], &mesh.vertices[0].px, vertex_count, sizeof(Vertex));
+
+	for (Bench bench(context, "spatialSortRemapParallel", triangles, 0); bench.next();)
+		meshopt_spatialSortRemapParallel(&remap[0], NULL, 0, &mesh.vertices[0].px, vertex_count, sizeof(Vertex), NULL, NULL);
+
+	for (Bench bench(context, "spatialSortTriangles", triangles, 0); bench.next();)
+		meshopt_spatialSortTriangles(&indices[0], &mesh.indices[0], index_count, &mesh.vertices[0].px, vertex_count, sizeof(Vertex));
+}
+
+static void benchStripify(Context& context, const Mesh& mesh)
+{
+	size_t index_count = mesh.indices.size();
+	size_t vertex_count = mesh.vertices.size();
+	double triangles = double(index_count / 3);
+
+	std::vector<unsigned int> strip(meshopt_stripifyBound(index_count));
+	size_t strip_size = 0;
+
+	for (Bench bench(context, "stripify", triangles, 0); bench.next();)
+		strip_size = meshopt_stripify(&strip[0], &mesh.indices[0], index_count, vertex_count, ~0u);
+
+	std::vector<unsigned int> strip_parallel(meshopt_stripifyParallelBound(index_count, 4096));
+
+	for (Bench bench(context, "stripifyParallel", triangles, 0); bench.next();)
+		meshopt_stripifyParallel(&strip_parallel[0], &mesh.indices[0], index_count, vertex_count, ~0u, 4096, NULL, NULL);
+
+	// chunks are independent, so on multiple cores this should be faster than stripify; compare with the serial numbers above
+	unsigned int thread_count = getThreadCount();
+
+	for (Bench bench(context, "stripifyParallelThreaded", triangles, 0); bench.next();)
+		meshopt_stripifyParallel(&strip_parallel[0], &mesh.indices[0], index_count, vertex_count, ~0u, 4096, threadScheduler, &thread_count);
+
+	// benchmarks can be skipped by the filter, so inputs for the following benchmarks are computed separately
+	strip_size = meshopt_stripify(&strip[0], &mesh.indices[0], index_count, vertex_count, ~0u);
+
+	std::vector<unsigned int> indices(meshopt_unstripifyBound(strip_size));
+
+	for (Bench bench(context, "unstripify", triangles, 0); bench.next();)
+		meshopt_unstripify(&indices[0], &strip[0], strip_size, ~0u);
+}
+
+static void benchCodecs(Context& context, const Mesh& mesh)
+{
+	size_t index_count = mesh.indices.size();
+	size_t vertex_count = mesh.vertices.size();
+	double triangles = double(index_count / 3);
+
+	std::vector<PackedVertex> vertices;
+	packVertices(vertices, mesh.vertices);
+
+	double index_bytes = double(index_count * 4);
+	double vertex_bytes = double(vertex_count * sizeof(PackedVertex));
+
+	// version 2 is required for parallel decoding; it is slightly larger, but decoding speed is the same
+	meshopt_encodeIndexVersion(2);
+
+	std::vector<unsigned char> ib(meshopt_encodeIndexBufferBound(index_count, vertex_count));
+	size_t ib_size = 0;
+
+	for (Bench bench(context, "encodeIndexBuffer", triangles, index_bytes); bench.next();)
+		ib_size = meshopt_encodeIndexBuffer(&ib[0], ib.size(), &mesh.indices[0], index_count);
+
+	std::vector<unsigned char> is(meshopt_encodeIndexSequenceBound(index_count, vertex_count));
+	size_t is_size = 0;
+
+	for (Bench bench(context, "encodeIndexSequence", triangles, index_bytes); bench.next();)
+		is_size = meshopt_encodeIndexSequence(&is[0], is.size(), &mesh.indices[0], index_count);
+
+	std::vector<unsigned char> vb(meshopt_encodeVertexBufferBound(vertex_count, sizeof(PackedVertex)));
+	size_t vb_size = 0;
+
+	for (Bench bench(context, "encodeVertexBuffer", 0, vertex_bytes); bench.next();)
+		vb_size = meshopt_encodeVertexBuffer(&vb[0], vb.size(), &vertices[0], vertex_count, sizeof(PackedVertex));
+
+	for (Bench bench(context, "encodeVertexBufferLevel0", 0, vertex_bytes); bench.next();)
+		meshopt_encodeVertexBufferLevel(&vb[0], vb.size(), &vertices[0], vertex_count, sizeof(PackedVertex), 0);
+
+	// position, normal and uv streams encoded separately from interleaved data
+	meshopt_Stream streams[] = {{&vertices[0].px, 8, sizeof(PackedVertex)}, {&vertices[0].nx, 4, sizeof(PackedVertex)}, {&vertices[0].tx, 4, sizeof(PackedVertex)}};
+
+	std::vector<unsigned char> vbm(meshopt_encodeVertexBufferMultiBound(vertex_count, streams, 3));
+	size_t vbm_sizes[3];
+
+	for (Bench bench(context, "encodeVertexBufferMulti", 0, vertex_bytes); bench.next();)
+		meshopt_encodeVertexBufferMulti(&vbm[0], vbm.size(), vbm_sizes, vertex_count, streams, 3);
+
+	// benchmarks can be skipped by the filter (and level 0 output overwrites the default encoding), so inputs for decoding are computed separately
+	ib_size = meshopt_encodeIndexBuffer(&ib[0], ib.size(), &mesh.indices[0], index_count);
+	is_size = meshopt_encodeIndexSequence(&is[0], is.size(), &mesh.indices[0], index_count);
+	vb_size = meshopt_encodeVertexBuffer(&vb[0], vb.size(), &vertices[0], vertex_count, sizeof(PackedVertex));
+
+	check(context, ib_size > 0 && is_size > 0 && vb_size > 0, "encode");
+
+	std::vector<unsigned int> indices(index_count);
+	std::vector<PackedVertex> decoded(vertex_count);
+
+	int rc = 0;
+
+	for (Bench bench(context, "decodeIndexBuffer", triangles, index_bytes); bench.next();)
+		rc |= meshopt_decodeIndexBuffer(&indices[0], index_count, 4, &ib[0], ib_size);
+
+	for (Bench bench(context, "decodeIndexBufferParallel", triangles, index_bytes); bench.next();)
+		rc |= meshopt_decodeIndexBufferParallel(&indices[0], index_count, 4, &ib[0], ib_size, NULL, NULL);
+
+	for (Bench bench(context, "decodeIndexSequence", triangles, index_bytes); bench.next();)
+		rc |= meshopt_decodeIndexSequence(&indices[0], index_count, 4, &is[0], is_size);
+
+	for (Bench bench(context, "decodeVertexBuffer", 0, vertex_bytes); bench.next();)
+		rc |= meshopt_decodeVertexBuffer(&decoded[0], vertex_count, sizeof(PackedVertex), &vb[0], vb_size);
+
+	// stream decoding in 64 KB chunks, which is a typical network read size
+	for (Bench bench(context, "decodeVertexStream", 0, vertex_bytes); bench.next();)
+	{
+		meshopt_VertexDecoder decoder;
+		meshopt_decodeVertexStreamInit(&decoder, vertex_count, sizeof(PackedVertex), NULL);
+
+		size_t offset = 0;
+		int result = 1;
+
+		while (result > 0)
+		{
+			size_t consumed = 0;
+			result = meshopt_decodeVertexStream(&decoder, &decoded[0], &vb[offset], std::min(vb_size - offset, size_t(65536)), &consumed);
+			offset += consumed;
+		}
+
+		rc |= result;
+	}
+
+	// benchmarks can be skipped by the filter, so round trip is validated separately; note that index buffer codec may rotate triangles so we validate the sequence codec
+	rc |= meshopt_decodeIndexBuffer(&indices[0], index_count, 4, &ib[0], ib_size);
+	rc |= meshopt_decodeIndexSequence(&indices[0], index_count, 4, &is[0], is_size);
+	rc |= meshopt_decodeVertexBuffer(&decoded[0], vertex_count, sizeof(PackedVertex), &vb[0], vb_size);
+
+	check(context, rc == 0, "decode");
+	check(context, indices == mesh.indices, "index codec");
+	check(context, memcmp(&decoded[0], &vertices[0], vertex_count * sizeof(PackedVertex)) == 0, "vertex codec");
+
+	meshopt_encodeIndexVersion(0);
+}
+
+static void benchFilters(Context& context, size_t count)
+{
+	// note: the filters are branchless so we just run them on runs of zeroes, which also stay valid encoded data after decoding in place
+	size_t count4 = (count + 3) & ~3;
+	std::vector<unsigned char> d4(count4 * 4);
+	std::vector<unsigned char> d8(count4 * 8);
+
+	for (Bench bench(context, "decodeFilterOct8", 0, double(d4.size())); bench.next();)
+		meshopt_decodeFilterOct(&d4[0], count4, 4);
+
+	for (Bench bench(context, "decodeFilterOct12", 0, double(d8.size())); bench.next();)
+		meshopt_decodeFilterOct(&d8[0], count4, 8);
+
+	std::fill(d8.begin(), d8.end(), 0);
+
+	for (Bench bench(context, "decodeFilterQuat12", 0, double(d8.size())); bench.next();)
+		meshopt_decodeFilterQuat(&d8[0], count4, 8);
+
+	std::fill(d8.begin(), d8.end(), 0);
+
+	for (Bench bench(context, "decodeFilterExp", 0, double(d8.size())); bench.next();)
+		meshopt_decodeFilterExp(&d8[0], count4, 8);
+
+	// encoders take 4 floats per element; we use a simple pattern of unit vectors that covers both hemispheres
+	std::vector<float> f4(count * 4);
+
+	for (size_t i = 0; i < count; ++i)
+	{
+		float x = float(int(i % 17) - 8), y = float(int(i % 13) - 6), z = float(int(i % 11) - 5), w = float(int(i % 7) - 3) + 0.5f;
+		float s = 1.f / sqrtf(x * x + y * y + z * z + w * w);
+
+		f4[i * 4 + 0] = x * s;
+		f4[i * 4 + 1] = y * s;
+		f4[i * 4 + 2] = z * s;
+		f4[i * 4 + 3] = w * s;
+	}
+
+	for (Bench bench(context, "encodeFilterOct8", 0, double(f4.size() * sizeof(float))); bench.next();)
+		meshopt_encodeFilterOct(&d4[0], count, 4, 8, &f4[0]);
+
+	for (Bench bench(context, "encodeFilterQuat12", 0, double(f4.size() * sizeof(float))); bench.next();)
+		meshopt_encodeFilterQuat(&d8[0], count, 8, 12, &f4[0]);
+
+	for (Bench bench(context, "quantizeSnormBuffer", 0, double(f4.size() * sizeof(float))); bench.next();)
+		meshopt_quantizeSnormBuffer(&d8[0], count, 8, 2, &f4[0], 16, 3, 12);
+
+	for (Bench bench(context, "quantizeHalfBuffer", 0, double(f4.size() * sizeof(float))); bench.next();)
+		meshopt_quantizeHalfBuffer(&d8[0], count, 8, &f4[0], 16, 4);
+}
+
+static void benchMesh(Context& context, const Mesh& mesh)
+{
+	context.mesh = &mesh;
+
+	printf("%-10s %d vertices, %d triangles\n", mesh.name.c_str(), int(mesh.vertices.size()), int(mesh.indices.size() / 3));
+
+	// most algorithms expect the input to be optimized for vertex cache and fetch, which is what the pipeline would produce
+	Mesh optimized;
+	optimized.name = mesh.name;
+	optimized.indices.resize(mesh.indices.size());
+	optimized.vertices.resize(mesh.vertices.size());
+
+	meshopt_optimizeVertexCache(&optimized.indices[0], &mesh.indices[0], mesh.indices.size(), mesh.vertices.size());
+
+	std::vector<unsigned int> cache = optimized.indices;
+
+	optimized.vertices.resize(meshopt_optimizeVertexFetch(&optimized.vertices[0], &optimized.indices[0], optimized.indices.size(), &mesh.vertices[0], mesh.vertices.size(), sizeof(Vertex)));
+
+	benchIndexing(context, mesh);
+	benchVertexCache(context, mesh, cache);
+	benchOverdraw(context, mesh, cache);
+	benchVertexFetch(context, mesh, cache);
+	benchSpatial(context, mesh);
+
+	context.mesh = &optimized;
+
+	benchSimplify(context, optimized);
+	benchMeshlets(context, optimized);
+	benchStripify(context, optimized);
+	benchCodecs(context, optimized);
+
+	context.mesh = NULL;
+}
+
+static void writeString(FILE* file, const std::string& value)
+{
+	fputc('"', file);
+
+	for (size_t i = 0; i < value.size(); ++i)
+	{
+		if (value[i] == '"' || value[i] == '\\')
+			fputc('\\', file);
+
+		fputc(value[i], file);
+	}
+
+	fputc('"', file);
+}
+
+static void writeThroughput(FILE* file, double value, double time, double unit, const char* null)
+{
+	if (value > 0)
+		fprintf(file, "%.4f", value / unit / time);
+	else
+		fprintf(file, "%s", null);
+}
+
+static bool writeJson(const Context& context, const char* path)
+{
+	FILE* file = fopen(path, "w");
+	if (!file)
+		return false;
+
+	fprintf(file, "{\n\t\"version\": %d,\n\t\"pointer_size\": %d,\n", MESHOPTIMIZER_VERSION, int(sizeof(void*) * 8));
+	fprintf(file, "\t\"warmup\": %d,\n\t\"repeat\": %d,\n\t\"scale\": %g,\n", context.options.warmup, context.options.repeat, context.options.scale);
+	fprintf(file, "\t\"results\": [\n");
+
+	for (size_t i = 0; i < context.results.size(); ++i)
+	{
+		const Result& result = context.results[i];
+		double median = getPercentile(result.samples, 0.5);
+
+		fprintf(file, "\t\t{\"mesh\": ");
+		writeString(file, result.mesh);
+		fprintf(file, ", \"name\": ");
+		writeString(file, result.name);
+		fprintf(file, ", \"samples\": %d, \"min_ms\": %.4f, \"median_ms\": %.4f, \"p90_ms\": %.4f, \"max_ms\": %.4f, \"mean_ms\": %.4f",
+		    int(result.samples.size()), result.samples[0] * 1000, median * 1000, getPercentile(result.samples, 0.9) * 1000,
+		    result.samples.back() * 1000, getMean(result.samples) * 1000);
+		fprintf(file, ", \"mtri_per_sec\": ");
+		writeThroughput(file, result.triangles, median, 1e6, "null");
+		fprintf(file, ", \"gb_per_sec\": ");
+		writeThroughput(file, result.bytes, median, 1024 * 1024 * 1024, "null");
+		fprintf(file, "}%s\n", i + 1 < context.results.size() ? "," : "");
+	}
+
+	fprintf(file, "\t]\n}\n");
+
+	return fclose(file) == 0;
+}
+
+static bool writeCsv(const Context& context, const char* path)
+{
+	FILE* file = fopen(path, "w");
+	if (!file)
+		return false;
+
+	fprintf(file, "mesh,name,samples,min_ms,median_ms,p90_ms,max_ms,mean_ms,mtri_per_sec,gb_per_sec\n");
+
+	for (size_t i = 0; i < context.results.size(); ++i)
+	{
+		const Result& result = context.results[i];
+		double median = getPercentile(result.samples, 0.5);
+
+		writeString(file, result.mesh);
+		fprintf(file, ",%s,%d,%.4f,%.4f,%.4f,%.4f,%.4f,", result.name.c_str(),
+		    int(result.samples.size()), result.samples[0] * 1000, median * 1000, getPercentile(result.samples, 0.9) * 1000,
+		    result.samples.back() * 1000, getMean(result.samples) * 1000);
+		writeThroughput(file, result.triangles, median, 1e6, "");
+		fprintf(file, ",");
+		writeThroughput(file, result.bytes, median, 1024 * 1024 * 1024, "");
+		fprintf(file, "\n");
+	}
+
+	return fclose(file) == 0;
+}
+
+int main(int argc, char** argv)
+{
+	Context context;
+	context.options.warmup = 1;
+	context.options.repeat = 5;
+	context.options.scale = 1.f;
+	context.options.filter = NULL;
+	context.options.json = NULL;
+	context.options.csv = NULL;
+	context.mesh = NULL;
+	context.errors = 0;
+
+	std::vector<const char*> files;
+
+	for (int i = 1; i < argc; ++i)
+	{
+		const char* arg = argv[i];
+
+		if (strcmp(arg, "-w") == 0 && i + 1 < argc)
+			context.options.warmup = atoi(argv[++i]);
+		else if (strcmp(arg, "-r") == 0 && i + 1 < argc)
+			context.options.repeat = std::max(atoi(argv[++i]), 1);
+		else if (strcmp(arg, "-s") == 0 && i + 1 < argc)
+			context.options.scale = float(atof(argv[++i]));
+		else if (strcmp(arg, "-f") == 0 && i + 1 < argc)
+			context.options.filter = argv[++i];
+		else if (strcmp(arg, "-json") == 0 && i + 1 < argc)
+			context.options.json = argv[++i];
+		else if (strcmp(arg, "-csv") == 0 && i + 1 < argc)
+			context.options.csv = argv[++i];
+		else if (arg[0] == '-')
+		{
+			fprintf(stderr, "Usage: %s [-w warmup] [-r repeat] [-s scale] [-f filter] [-json file] [-csv file] [files.obj]\n", argv[0]);
+			return 1;
+		}
+		else
+			files.push_back(arg);
+	}
+
+	std::vector<Mesh> meshes;
+
+	for (size_t i = 0; i < files.size(); ++i)
+	{
+		Mesh mesh;
+
+		if (!loadObj(mesh, files[i]))
+		{
+			fprintf(stderr, "Error loading %s\n", files[i]);
+			return 2;
+		}
+
+		meshes.push_back(mesh);
+	}
+
+	// generated meshes are deterministic so that results are comparable across runs and releases; scale controls the triangle count
+	float size = sqrtf(std::max(context.options.scale, 1e-3f));
+
+	meshes.push_back(generateGrid("grid", unsigned(std::max(512 * size, 1.f))));
+	meshes.push_back(generateSphere("sphere", unsigned(std::max(512 * size, 3.f)), unsigned(std::max(256 * size, 3.f)), 0.f));
+	meshes.push_back(generateSphere("scan", unsigned(std::max(724 * size, 3.f)), unsigned(std::max(362 * size, 3.f)), 0.1f));
+	shuffleMesh(meshes.back());
+
+	for (size_t i = 0; i < meshes.size(); ++i)
+		benchMesh(context, meshes[i]);
+
+	benchFilters(context, size_t(1024 * 1024 * context.options.scale));
+
+	if (context.options.json && !writeJson(context, context.options.json))
+	{
+		fprintf(stderr, "Error writing %s\n", context.options.json);
+		return 2;
+	}
+
+	if (context.options.csv && !writeCsv(context, context.options.csv))
+	{
+		fprintf(stderr, "Error writing %s\n", context.options.csv);
+		return 2;
+	}
+
+	return context.errors ? 3 : 0;
+}
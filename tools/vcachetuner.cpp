@@ -14,17 +14,6 @@
 const int kCacheSizeMax = 16;
 const int kValenceMax = 8;
 
-namespace meshopt
-{
-	struct VertexScoreTable
-	{
-		float cache[1 + kCacheSizeMax];
-		float live[1 + kValenceMax];
-	};
-} // namespace meshopt
-
-void meshopt_optimizeVertexCacheTable(unsigned int* destination, const unsigned int* indices, size_t index_count, size_t vertex_count, const meshopt::VertexScoreTable* table);
-
 struct Profile
 {
 	float weight;
@@ -40,6 +29,8 @@ Profile profiles[] =
 	// {1.f, 32, 32, 32},  // NVidia Pascal
 	// {1.f, 16, 32, 32}, // NVidia Kepler, Maxwell
 	// {1.f, 128, 0, 0}, // Intel
+	// {1.f, 32, 32, 0}, // Apple
+	// {1.f, 16, 16, 0}, // Mali, Adreno
 };
 
 const int Profile_Count = sizeof(profiles) / sizeof(profiles[0]);
@@ -207,7 +198,7 @@ void compute_metric(const State* state, const Mesh& mesh, float result[Profile_C
 
 	if (state)
 	{
-		meshopt::VertexScoreTable table = {};
+		meshopt_VertexScoreTable table = {};
 		memcpy(table.cache + 1, state->cache, kCacheSizeMax * sizeof(float));
 		memcpy(table.live + 1, state->live, kValenceMax * sizeof(float));
 		meshopt_optimizeVertexCacheTable(&indices[0], &mesh.indices[0], mesh.indices.size(), mesh.vertex_count, &table);
@@ -217,7 +208,9 @@ void compute_metric(const State* state, const Mesh& mesh, float result[Profile_C
 		meshopt_optimizeVertexCache(&indices[0], &mesh.indices[0], mesh.indices.size(), mesh.vertex_count);
 	}
 
-	meshopt_optimizeVertexFetch(NULL, &indices[0], indices.size(), NULL, mesh.vertex_count, 0);
+	std::vector<unsigned int> remap(mesh.vertex_count);
+	meshopt_optimizeVertexFetchRemap(&remap[0], &indices[0], indices.size(), mesh.vertex_count);
+	meshopt_remapIndexBuffer(&indices[0], &indices[0], indices.size(), &remap[0]);
 
 	std::vector<unsigned char> ibuf;
 